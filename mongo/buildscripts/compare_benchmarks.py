@@ -0,0 +1,64 @@
+#!/usr/bin/env python
+
+"""
+Compares the JSON results written by two runs of a benchmark binary's --out option, e.g. of the
+previous and the candidate release, and reports the change in time per iteration.
+
+Exits with a non-zero status if any benchmark got slower by more than the threshold.
+"""
+
+from __future__ import absolute_import
+from __future__ import print_function
+
+import json
+import sys
+from optparse import OptionParser
+
+
+def load_results(path):
+    with open(path) as fh:
+        doc = json.load(fh)
+    return doc.get("context", {}), dict((b["name"], b) for b in doc["benchmarks"])
+
+
+def main():
+    usage = "usage: %prog [options] BASELINE_FILE CANDIDATE_FILE"
+    parser = OptionParser(usage=usage)
+    parser.add_option("--threshold", dest="threshold", type="float", default=10.0,
+                      help="Percentage by which a benchmark may slow down before it is reported"
+                           " as a regression [default: %default].")
+    (options, args) = parser.parse_args()
+
+    if len(args) != 2:
+        parser.error("Must specify a baseline and a candidate results file.")
+
+    base_context, base = load_results(args[0])
+    cand_context, cand = load_results(args[1])
+
+    print("Baseline:  %s (%s)" % (base_context.get("version"), base_context.get("gitVersion")))
+    print("Candidate: %s (%s)" % (cand_context.get("version"), cand_context.get("gitVersion")))
+    print("%-48s %16s %16s %9s" % ("Benchmark", "baseline ns", "candidate ns", "change"))
+
+    regressions = []
+    for name in sorted(set(base) & set(cand)):
+        base_ns = base[name]["nsPerIteration"]
+        cand_ns = cand[name]["nsPerIteration"]
+        change = (cand_ns - base_ns) * 100.0 / base_ns if base_ns else 0.0
+        flag = ""
+        if change > options.threshold:
+            regressions.append(name)
+            flag = "  REGRESSION"
+        print("%-48s %16.1f %16.1f %+8.1f%%%s" % (name, base_ns, cand_ns, change, flag))
+
+    for name in sorted(set(base) ^ set(cand)):
+        print("%-48s only in the %s" % (name, "baseline" if name in base else "candidate"))
+
+    if regressions:
+        print("%d benchmark(s) slowed down by more than %.1f%%" %
+              (len(regressions), options.threshold))
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
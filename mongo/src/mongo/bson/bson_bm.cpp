@@ -0,0 +1,144 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <string>
+#include <vector>
+
+#include "mongo/bson/bson_validate.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/unittest/benchmark.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+namespace {
+
+using unittest::BenchmarkState;
+
+std::vector<std::string> makeFieldNames(long long numFields) {
+    std::vector<std::string> names;
+    for (long long i = 0; i < numFields - 1; ++i) {
+        names.push_back(str::stream() << "field" << i);
+    }
+    names.push_back("last");
+    return names;
+}
+
+/**
+ * Appends the fields of a typical small document to 'builder', one for each of 'names'.
+ */
+void appendTypicalFields(BSONObjBuilder* builder, const std::vector<std::string>& names) {
+    for (std::size_t i = 0; i < names.size(); ++i) {
+        switch (i % 4) {
+            case 0:
+                builder->append(names[i], static_cast<int>(i));
+                break;
+            case 1:
+                builder->append(names[i], "a short string value");
+                break;
+            case 2:
+                builder->append(names[i], i * 1.5);
+                break;
+            default:
+                builder->append(names[i], BSON("x" << static_cast<int>(i) << "y" << true));
+                break;
+        }
+    }
+}
+
+BSONObj makeTypicalDocument(long long numFields) {
+    BSONObjBuilder builder;
+    appendTypicalFields(&builder, makeFieldNames(numFields));
+    return builder.obj();
+}
+
+void BM_BSONObjBuild(BenchmarkState& state) {
+    const auto names = makeFieldNames(state.range());
+    long long bytes = 0;
+    while (state.keepRunning()) {
+        BSONObjBuilder builder;
+        appendTypicalFields(&builder, names);
+        auto obj = builder.done();
+        bytes += obj.objsize();
+        unittest::doNotOptimize(obj);
+    }
+    state.setItemsProcessed(state.iterations());
+    state.setBytesProcessed(bytes);
+}
+
+void BM_BSONObjIterate(BenchmarkState& state) {
+    const auto obj = makeTypicalDocument(state.range());
+    while (state.keepRunning()) {
+        long long sum = 0;
+        for (auto&& elem : obj) {
+            sum += elem.size() + elem.fieldNameSize();
+        }
+        unittest::doNotOptimize(sum);
+    }
+    state.setItemsProcessed(state.iterations());
+    state.setBytesProcessed(static_cast<long long>(state.iterations()) * obj.objsize());
+}
+
+void BM_BSONObjGetField(BenchmarkState& state) {
+    const auto obj = makeTypicalDocument(state.range());
+    while (state.keepRunning()) {
+        auto elem = obj.getField("last");
+        unittest::doNotOptimize(elem);
+    }
+    state.setItemsProcessed(state.iterations());
+}
+
+void BM_BSONValidate(BenchmarkState& state) {
+    const auto obj = makeTypicalDocument(state.range());
+    while (state.keepRunning()) {
+        auto status = validateBSON(obj.objdata(), obj.objsize(), BSONVersion::kLatest);
+        unittest::doNotOptimize(status);
+    }
+    state.setItemsProcessed(state.iterations());
+    state.setBytesProcessed(static_cast<long long>(state.iterations()) * obj.objsize());
+}
+
+void BM_BSONObjWoCompare(BenchmarkState& state) {
+    const auto left = makeTypicalDocument(state.range());
+    const auto right = makeTypicalDocument(state.range());
+    while (state.keepRunning()) {
+        auto result = left.woCompare(right);
+        unittest::doNotOptimize(result);
+    }
+    state.setItemsProcessed(state.iterations());
+}
+
+MONGO_BENCHMARK(BM_BSONObjBuild)->range(1, 256);
+MONGO_BENCHMARK(BM_BSONObjIterate)->range(1, 256);
+MONGO_BENCHMARK(BM_BSONObjGetField)->range(1, 256);
+MONGO_BENCHMARK(BM_BSONValidate)->range(1, 256);
+MONGO_BENCHMARK(BM_BSONObjWoCompare)->range(1, 256);
+
+}  // namespace
+}  // namespace mongo
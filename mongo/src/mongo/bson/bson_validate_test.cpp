@@ -35,6 +35,7 @@
 #include "mongo/platform/random.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/log.h"
+#include "mongo/util/timer.h"
 
 namespace {
 
@@ -354,4 +355,79 @@ TEST(BSONValidateBool, BoolValuesAreValidated) {
     }
 }
 
+TEST(BSONValidateFast, FieldNamesOfAllLengths) {
+    // Exercises the inline NUL scan on both sides of each 16 byte block and past its end
+    for (size_t len = 1; len < 100; ++len) {
+        const std::string fieldName(len, 'f');
+        const BSONObj obj = BSON(fieldName << 1 << "y" << fieldName);
+        ASSERT_OK(validateBSON(obj.objdata(), obj.objsize(), BSONVersion::kLatest));
+
+        // Cutting the buffer inside the field name must not find a terminator past the end
+        ASSERT_NOT_OK(validateBSON(obj.objdata(), 5 + len, BSONVersion::kLatest));
+    }
+}
+
+TEST(BSONValidateFast, StringLengthPastEndOfBuffer) {
+    const BSONObj obj = BSON("x"
+                             << "abc");
+    std::string data(obj.objdata(), obj.objsize());
+
+    // Point the string length one byte past the end of the object
+    const int offset = 4 + 1 + 2;
+    DataView(&data[0]).write(tagLittleEndian(obj.objsize() - offset - 4 + 1), offset);
+    ASSERT_NOT_OK(validateBSON(data.data(), data.size(), BSONVersion::kLatest));
+}
+
+/**
+ * Validates each corpus repeatedly and logs the throughput, to compare validation speed across
+ * the kinds of documents seen in bulk inserts.
+ */
+TEST(BSONValidateBenchmark, Corpora) {
+    const int kDocsPerCorpus = 1000;
+    const int kIterations = 20;
+
+    const std::string shortString(16, 's');
+    const std::string longString(4096, 'l');
+    const std::vector<char> binData(4096, 'b');
+
+    std::vector<std::pair<std::string, std::vector<BSONObj>>> corpora(4);
+    corpora[0].first = "scalars";
+    corpora[1].first = "strings";
+    corpora[2].first = "binData";
+    corpora[3].first = "nested";
+
+    for (int i = 0; i < kDocsPerCorpus; ++i) {
+        corpora[0].second.push_back(BSON("_id" << i << "a" << 1.5 << "b" << (long long)i << "c"
+                                               << true
+                                               << "d"
+                                               << Date_t::now()
+                                               << "e"
+                                               << BSON_ARRAY(1 << 2 << 3 << 4 << 5 << 6)));
+        corpora[1].second.push_back(
+            BSON("_id" << i << "name" << shortString << "description" << longString << "tags"
+                       << BSON_ARRAY(shortString << shortString << shortString)));
+        corpora[2].second.push_back(BSON(
+            "_id" << i << "payload" << BSONBinData(binData.data(), binData.size(), BinDataGeneral)));
+        corpora[3].second.push_back(
+            BSON("_id" << i << "a" << BSON("b" << BSON("c" << BSON("d" << shortString << "e" << i)))
+                       << "list"
+                       << BSON_ARRAY(BSON("x" << i) << BSON("x" << i) << BSON("x" << i))));
+    }
+
+    for (const auto& corpus : corpora) {
+        long long totalBytes = 0;
+        Timer timer;
+        for (int iteration = 0; iteration < kIterations; ++iteration) {
+            for (const auto& doc : corpus.second) {
+                ASSERT_OK(validateBSON(doc.objdata(), doc.objsize(), BSONVersion::kLatest));
+                totalBytes += doc.objsize();
+            }
+        }
+
+        const long long micros = std::max(timer.micros(), 1LL);
+        log() << "validateBSON " << corpus.first << ": " << totalBytes / micros << " MB/s, "
+              << (kIterations * kDocsPerCorpus * 1000LL) / micros << "k docs/s";
+    }
+}
+
 }  // namespace
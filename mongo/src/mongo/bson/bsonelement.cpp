@@ -57,12 +57,25 @@ using std::string;
 
 string BSONElement::jsonString(JsonStringFormat format, bool includeFieldNames, int pretty) const {
     std::stringstream s;
-    if (includeFieldNames)
-        s << '"' << escape(fieldName()) << "\" : ";
+    jsonStringStream(format, includeFieldNames, pretty, s);
+    return s.str();
+}
+
+void BSONElement::jsonStringStream(JsonStringFormat format,
+                                   bool includeFieldNames,
+                                   int pretty,
+                                   std::stringstream& s) const {
+    if (includeFieldNames) {
+        s << '"';
+        writeEscaped(s, fieldNameStringData());
+        s << "\" : ";
+    }
     switch (type()) {
         case mongo::String:
         case Symbol:
-            s << '"' << escape(string(valuestr(), valuestrsize() - 1)) << '"';
+            s << '"';
+            writeEscaped(s, StringData(valuestr(), valuestrsize() - 1));
+            s << '"';
             break;
         case NumberLong:
             if (format == TenGen) {
@@ -129,7 +142,7 @@ string BSONElement::jsonString(JsonStringFormat format, bool includeFieldNames,
             }
             break;
         case Object:
-            s << embeddedObject().jsonString(format, pretty);
+            embeddedObject().jsonStringStream(format, pretty, false, s);
             break;
         case mongo::Array: {
             if (embeddedObject().isEmpty()) {
@@ -151,7 +164,7 @@ string BSONElement::jsonString(JsonStringFormat format, bool includeFieldNames,
                     if (strtol(e.fieldName(), 0, 10) > count) {
                         s << "undefined";
                     } else {
-                        s << e.jsonString(format, false, pretty ? pretty + 1 : 0);
+                        e.jsonStringStream(format, false, pretty ? pretty + 1 : 0, s);
                         e = i.next();
                     }
                     count++;
@@ -200,8 +213,9 @@ string BSONElement::jsonString(JsonStringFormat format, bool includeFieldNames,
             base64::encode(s, reader.view(), len);
             s << "\", \"$type\" : \"" << hex;
             s.width(2);
-            s.fill('0');
+            const char oldFill = s.fill('0');
             s << type << dec;
+            s.fill(oldFill);
             s << "\" }";
             break;
         }
@@ -246,10 +260,13 @@ string BSONElement::jsonString(JsonStringFormat format, bool includeFieldNames,
             break;
         case RegEx:
             if (format == Strict) {
-                s << "{ \"$regex\" : \"" << escape(regex());
+                s << "{ \"$regex\" : \"";
+                writeEscaped(s, regex());
                 s << "\", \"$options\" : \"" << regexFlags() << "\" }";
             } else {
-                s << "/" << escape(regex(), true) << "/";
+                s << "/";
+                writeEscaped(s, regex(), true);
+                s << "/";
                 // FIXME Worry about alpha order?
                 for (const char* f = regexFlags(); *f; ++f) {
                     switch (*f) {
@@ -267,14 +284,20 @@ string BSONElement::jsonString(JsonStringFormat format, bool includeFieldNames,
         case CodeWScope: {
             BSONObj scope = codeWScopeObject();
             if (!scope.isEmpty()) {
-                s << "{ \"$code\" : \"" << escape(_asCode()) << "\" , "
-                  << "\"$scope\" : " << scope.jsonString() << " }";
+                s << "{ \"$code\" : \"";
+                writeEscaped(s, _asCode());
+                s << "\" , "
+                  << "\"$scope\" : ";
+                scope.jsonStringStream(Strict, 0, false, s);
+                s << " }";
                 break;
             }
         }
 
         case Code:
-            s << "\"" << escape(_asCode()) << "\"";
+            s << "\"";
+            writeEscaped(s, _asCode());
+            s << "\"";
             break;
 
         case bsonTimestamp:
@@ -303,7 +326,6 @@ string BSONElement::jsonString(JsonStringFormat format, bool includeFieldNames,
             string message = ss.str();
             massert(10312, message.c_str(), false);
     }
-    return s.str();
 }
 
 namespace {
@@ -31,6 +31,7 @@
 
 #include <cmath>
 #include <cstdint>
+#include <iosfwd>
 #include <string.h>  // strlen
 #include <string>
 #include <vector>
@@ -210,6 +211,15 @@ public:
     std::string jsonString(JsonStringFormat format,
                            bool includeFieldNames = true,
                            int pretty = 0) const;
+
+    /**
+     * Same as jsonString(), but writes into 's' so that serializing a whole document shares one
+     * stream rather than building and copying a string per element.
+     */
+    void jsonStringStream(JsonStringFormat format,
+                          bool includeFieldNames,
+                          int pretty,
+                          std::stringstream& s) const;
     operator std::string() const {
         return toString();
     }
@@ -65,8 +65,8 @@ enum {
     ID_RESERVE_SIZE = 64,
     PAT_RESERVE_SIZE = 4096,
     OPT_RESERVE_SIZE = 64,
-    FIELD_RESERVE_SIZE = 4096,
-    STRINGVAL_RESERVE_SIZE = 4096,
+    FIELD_RESERVE_SIZE = 64,
+    STRINGVAL_RESERVE_SIZE = 64,
     BINDATA_RESERVE_SIZE = 4096,
     BINDATATYPE_RESERVE_SIZE = 4096,
     NS_RESERVE_SIZE = 64,
@@ -95,16 +95,32 @@ Status JParse::parseError(StringData msg) {
 
 Status JParse::value(StringData fieldName, BSONObjBuilder& builder) {
     MONGO_JSON_DEBUG("fieldName: " << fieldName);
-    if (peekToken(LBRACE)) {
+    // Objects, arrays, strings and numbers can be told apart by their first character, so only
+    // try the keywords one by one for anything else.
+    const char next = peekChar();
+    if (next == '{') {
         Status ret = object(fieldName, builder);
         if (ret != Status::OK()) {
             return ret;
         }
-    } else if (peekToken(LBRACKET)) {
+    } else if (next == '[') {
         Status ret = array(fieldName, builder);
         if (ret != Status::OK()) {
             return ret;
         }
+    } else if (next == '"' || next == '\'') {
+        std::string valueString;
+        valueString.reserve(STRINGVAL_RESERVE_SIZE);
+        Status ret = quotedString(&valueString);
+        if (ret != Status::OK()) {
+            return ret;
+        }
+        builder.append(fieldName, valueString);
+    } else if ('0' <= next && next <= '9') {
+        Status ret = number(fieldName, builder);
+        if (ret != Status::OK()) {
+            return ret;
+        }
     } else if (readToken("new")) {
         Status ret = constructor(fieldName, builder);
         if (ret != Status::OK()) {
@@ -150,14 +166,6 @@ Status JParse::value(StringData fieldName, BSONObjBuilder& builder) {
         if (ret != Status::OK()) {
             return ret;
         }
-    } else if (peekToken(DOUBLEQUOTE) || peekToken(SINGLEQUOTE)) {
-        std::string valueString;
-        valueString.reserve(STRINGVAL_RESERVE_SIZE);
-        Status ret = quotedString(&valueString);
-        if (ret != Status::OK()) {
-            return ret;
-        }
-        builder.append(fieldName, valueString);
     } else if (readToken("true")) {
         builder.append(fieldName, true);
     } else if (readToken("false")) {
@@ -314,9 +322,10 @@ Status JParse::object(StringData fieldName, BSONObjBuilder& builder, bool subObj
         if (valueRet != Status::OK()) {
             return valueRet;
         }
+        std::string fieldName;
+        fieldName.reserve(FIELD_RESERVE_SIZE);
         while (readToken(COMMA)) {
-            std::string fieldName;
-            fieldName.reserve(FIELD_RESERVE_SIZE);
+            fieldName.clear();
             Status fieldRet = field(&fieldName);
             if (fieldRet != Status::OK()) {
                 return fieldRet;
@@ -998,7 +1007,43 @@ Status JParse::regexOptCheck(StringData opt) {
     return Status::OK();
 }
 
+bool JParse::simpleInteger(StringData fieldName, BSONObjBuilder& builder) {
+    const char* q = _input;
+    const bool negative = q < _input_end && *q == '-';
+    if (negative) {
+        ++q;
+    }
+    const char* const digitsStart = q;
+    long long value = 0;
+    while (q < _input_end && '0' <= *q && *q <= '9') {
+        value = value * 10 + (*q - '0');
+        ++q;
+    }
+    // 18 digits always fit in a long long. The number must be followed by something which cannot
+    // continue it, or strtod might have read more of it (e.g. "1e5" or "0x1F").
+    if (q == digitsStart || q - digitsStart > 18 || q >= _input_end ||
+        !match(*q, ",}]) \t\n\r")) {
+        return false;
+    }
+    if (negative) {
+        value = -value;
+    }
+    if (value == static_cast<int>(value)) {
+        MONGO_JSON_DEBUG("Type: 32 bit int");
+        builder.append(fieldName, static_cast<int>(value));
+    } else {
+        MONGO_JSON_DEBUG("Type: 64 bit int");
+        builder.append(fieldName, value);
+    }
+    _input = q;
+    return true;
+}
+
 Status JParse::number(StringData fieldName, BSONObjBuilder& builder) {
+    if (simpleInteger(fieldName, builder)) {
+        return Status::OK();
+    }
+
     char* endptrll;
     char* endptrd;
     long long retll;
@@ -1062,7 +1107,17 @@ Status JParse::field(std::string* result) {
         if (!match(*_input, ALPHA "_$")) {
             return parseError("First character in field must be [A-Za-z$_]");
         }
-        return chars(result, "", ALPHA DIGIT "_$");
+        const char* q = _input;
+        while (q < _input_end && (('a' <= *q && *q <= 'z') || ('A' <= *q && *q <= 'Z') ||
+                                  ('0' <= *q && *q <= '9') || *q == '_' || *q == '$')) {
+            ++q;
+        }
+        if (q >= _input_end) {
+            return parseError("Unexpected end of input");
+        }
+        result->append(_input, q - _input);
+        _input = q;
+        return Status::OK();
     }
 }
 
@@ -1099,9 +1154,25 @@ Status JParse::chars(std::string* result, const char* terminalSet, const char* a
     if (_input >= _input_end) {
         return parseError("Unexpected end of input");
     }
+    // With a single terminal character and no allowed set (i.e. a quoted string), copy runs of
+    // characters needing no special handling in one go.
+    const char terminal = (allowedSet == NULL && terminalSet[0] != '\0' && terminalSet[1] == '\0')
+        ? terminalSet[0]
+        : '\0';
     const char* q = _input;
     while (q < _input_end && !match(*q, terminalSet)) {
         MONGO_JSON_DEBUG("q: " << q);
+        if (terminal != '\0') {
+            const char* runStart = q;
+            while (q < _input_end && *q != terminal && *q != '\\' &&
+                   static_cast<unsigned char>(*q) > 0x1F) {
+                ++q;
+            }
+            result->append(runStart, q - runStart);
+            if (q >= _input_end || match(*q, terminalSet)) {
+                break;
+            }
+        }
         if (allowedSet != NULL) {
             if (!match(*q, allowedSet)) {
                 _input = q;
@@ -1209,6 +1280,16 @@ std::string JParse::encodeUTF8(unsigned char first, unsigned char second) const
     return oss.str();
 }
 
+char JParse::peekChar() {
+    // 'isspace()' takes an 'int' (signed), so (default signed) 'char's get sign-extended
+    // and therefore 'corrupted' unless we force them to be unsigned ... 0x80 becomes
+    // 0xffffff80 as seen by isspace when sign-extended ... we want it to be 0x00000080
+    while (_input < _input_end && isspace(*reinterpret_cast<const unsigned char*>(_input))) {
+        ++_input;
+    }
+    return _input < _input_end ? *_input : '\0';
+}
+
 inline bool JParse::peekToken(const char* token) {
     return readTokenImpl(token, false);
 }
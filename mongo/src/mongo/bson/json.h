@@ -443,6 +443,20 @@ private:
      */
     bool readTokenImpl(const char* token, bool advance = true);
 
+    /**
+     * Skips whitespace and returns the next character in our buffer without
+     * consuming it, or '\0' if we reach the end of our buffer.
+     */
+    char peekChar();
+
+    /**
+     * Parses a plain base 10 integer of up to 18 digits followed by a
+     * delimiter, which covers most numbers without going through strtod and
+     * strtoll.  Returns false without consuming anything if the number does
+     * not have that form.
+     */
+    bool simpleInteger(StringData fieldName, BSONObjBuilder&);
+
     /**
      * @return true if the next field in our stream matches field.
      * Handles single quoted, double quoted, and unquoted field names
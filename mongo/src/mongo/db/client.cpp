@@ -41,6 +41,7 @@
 #include <vector>
 
 #include "mongo/base/status.h"
+#include "mongo/db/client_resource_usage.h"
 #include "mongo/db/lasterror.h"
 #include "mongo/db/service_context.h"
 #include "mongo/stdx/thread.h"
@@ -90,6 +91,7 @@ void Client::initThread(StringData desc, //desc
     // Create the client obj, attach to thread
     //ServiceContext::makeClient
     currentClient = service->makeClient(fullDesc, std::move(session));
+    ClientResourceUsage::onAttach(currentClient.get());
 }
 
 void Client::destroy() {
@@ -176,12 +178,14 @@ bool haveClient() {
 
 ServiceContext::UniqueClient Client::releaseCurrent() {
     invariant(haveClient());
+    ClientResourceUsage::onDetach(currentClient.get());
     return std::move(currentClient);
 }
 
 void Client::setCurrent(ServiceContext::UniqueClient client) {
     invariant(!haveClient());
     currentClient = std::move(client);
+    ClientResourceUsage::onAttach(currentClient.get());
 }
 
 }  // namespace mongo
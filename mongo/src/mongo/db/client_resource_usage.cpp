@@ -0,0 +1,132 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/client_resource_usage.h"
+
+#ifdef __linux__
+#include <pthread.h>
+#endif
+
+#include "mongo/db/client.h"
+#include "mongo/util/allocation_counter.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+namespace {
+
+const auto getClientResourceUsage = Client::declareDecoration<ClientResourceUsage>();
+
+}  // namespace
+
+ClientResourceUsage::Totals ClientResourceUsage::Totals::since(const Totals& earlier) const {
+    Totals usage;
+    if (cpuNanos >= 0 && earlier.cpuNanos >= 0) {
+        usage.cpuNanos = cpuNanos - earlier.cpuNanos;
+    }
+    if (allocBytes >= 0 && earlier.allocBytes >= 0) {
+        usage.allocBytes = allocBytes - earlier.allocBytes;
+    }
+    return usage;
+}
+
+ClientResourceUsage& ClientResourceUsage::get(Client* client) {
+    return getClientResourceUsage(client);
+}
+
+void ClientResourceUsage::onAttach(Client* client) {
+    auto& usage = get(client);
+    stdx::lock_guard<Client> lk(*client);
+    invariant(!usage._attached);
+
+#ifdef __linux__
+    if (pthread_getcpuclockid(pthread_self(), &usage._threadClock) != 0) {
+        usage._threadClock = CLOCK_THREAD_CPUTIME_ID;
+    }
+#endif
+    if (AllocationCounter::isActive()) {
+        usage._threadAllocCounter = AllocationCounter::forCurrentThread();
+    }
+
+    usage._attached = true;
+    usage._segmentStartCpuNanos = usage._currentThreadCpuNanos();
+    usage._segmentStartAllocBytes = usage._currentThreadAllocBytes();
+}
+
+void ClientResourceUsage::onDetach(Client* client) {
+    auto& usage = get(client);
+    stdx::lock_guard<Client> lk(*client);
+    invariant(usage._attached);
+
+    usage._cpuNanos += usage._currentThreadCpuNanos() - usage._segmentStartCpuNanos;
+    usage._allocBytes += usage._currentThreadAllocBytes() - usage._segmentStartAllocBytes;
+
+    usage._attached = false;
+    usage._threadAllocCounter = nullptr;
+}
+
+ClientResourceUsage::Totals ClientResourceUsage::getTotals() const {
+    Totals totals;
+#ifdef __linux__
+    totals.cpuNanos = _cpuNanos;
+#endif
+    if (AllocationCounter::isActive()) {
+        totals.allocBytes = _allocBytes;
+    }
+
+    if (_attached) {
+        if (totals.cpuNanos >= 0) {
+            totals.cpuNanos += _currentThreadCpuNanos() - _segmentStartCpuNanos;
+        }
+        if (totals.allocBytes >= 0) {
+            totals.allocBytes += _currentThreadAllocBytes() - _segmentStartAllocBytes;
+        }
+    }
+    return totals;
+}
+
+long long ClientResourceUsage::_currentThreadCpuNanos() const {
+#ifdef __linux__
+    // Reads the clock of the thread the Client is attached to, which is not necessarily the calling
+    // thread. That thread cannot detach the Client, and so cannot exit, while the caller holds the
+    // Client lock or is that thread.
+    struct timespec t;
+    if (clock_gettime(_threadClock, &t) == 0) {
+        return t.tv_sec * 1000LL * 1000 * 1000 + t.tv_nsec;
+    }
+#endif
+    return 0;
+}
+
+long long ClientResourceUsage::_currentThreadAllocBytes() const {
+    return _threadAllocCounter ? _threadAllocCounter->load() : 0;
+}
+
+}  // namespace mongo
@@ -0,0 +1,105 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#pragma once
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/platform/atomic_word.h"
+
+#ifdef __linux__
+#include <time.h>
+#endif
+
+namespace mongo {
+
+class Client;
+
+/**
+ * Accumulates the thread CPU time and the bytes allocated by the work done for a Client, from which
+ * the resources consumed by each of its operations are derived.
+ *
+ * That work is done in segments, each on the thread the Client is attached to at the time. With the
+ * adaptive service executor successive segments of a connection may run on different threads, so
+ * the usage of each segment is measured on its own thread and added to the totals when the Client
+ * is detached from it.
+ *
+ * CPU time is only measured on Linux, and allocations only while the AllocationCounter is active.
+ * Resources which are not measured are reported as -1.
+ *
+ * Segments begin and end on the thread the Client is attached to, with the Client locked.
+ * getTotals() may be called by that thread or by any thread which has locked the Client.
+ */
+class ClientResourceUsage {
+    MONGO_DISALLOW_COPYING(ClientResourceUsage);
+
+public:
+    struct Totals {
+        /**
+         * Returns the usage between 'earlier' and these totals.
+         */
+        Totals since(const Totals& earlier) const;
+
+        long long cpuNanos = -1;
+        long long allocBytes = -1;
+    };
+
+    ClientResourceUsage() = default;
+
+    static ClientResourceUsage& get(Client* client);
+
+    /**
+     * Called when 'client' has just been attached to the current thread and when it is about to be
+     * detached from it.
+     */
+    static void onAttach(Client* client);
+    static void onDetach(Client* client);
+
+    /**
+     * Returns the usage of all completed segments plus that of the current segment so far.
+     */
+    Totals getTotals() const;
+
+private:
+    long long _currentThreadCpuNanos() const;
+    long long _currentThreadAllocBytes() const;
+
+    // Usage of the completed segments.
+    long long _cpuNanos = 0;
+    long long _allocBytes = 0;
+
+    // State of the current segment, if the Client is attached to a thread.
+    bool _attached = false;
+#ifdef __linux__
+    clockid_t _threadClock;
+#endif
+    const AtomicInt64* _threadAllocCounter = nullptr;
+    long long _segmentStartCpuNanos = 0;
+    long long _segmentStartAllocBytes = 0;
+};
+
+}  // namespace mongo
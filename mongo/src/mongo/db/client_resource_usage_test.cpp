@@ -0,0 +1,94 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/client_resource_usage.h"
+
+#include "mongo/db/client.h"
+#include "mongo/db/service_context_noop.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+namespace {
+
+void burnCpu(Milliseconds duration) {
+    const Date_t end = Date_t::now() + duration;
+    volatile long long sink = 0;
+    while (Date_t::now() < end) {
+        for (int i = 0; i < 1000; i++) {
+            sink = sink + i;
+        }
+    }
+}
+
+TEST(ClientResourceUsageTest, SinceLeavesUnmeasuredResourcesUnmeasured) {
+    ClientResourceUsage::Totals earlier;
+    earlier.cpuNanos = 100;
+
+    ClientResourceUsage::Totals later;
+    later.cpuNanos = 350;
+    later.allocBytes = 4096;
+
+    const auto usage = later.since(earlier);
+    ASSERT_EQ(250, usage.cpuNanos);
+    ASSERT_EQ(-1, usage.allocBytes);
+}
+
+#ifdef __linux__
+TEST(ClientResourceUsageTest, CpuTimeIsSummedAcrossThreads) {
+    ServiceContextNoop serviceContext;
+    Client::setCurrent(serviceContext.makeClient("ClientResourceUsageTest"));
+    burnCpu(Milliseconds(20));
+    auto client = Client::releaseCurrent();
+    auto& usage = ClientResourceUsage::get(client.get());
+
+    const long long afterFirstSegment = usage.getTotals().cpuNanos;
+    ASSERT_GTE(afterFirstSegment, 0);
+
+    // Detached Clients accumulate nothing.
+    burnCpu(Milliseconds(20));
+    ASSERT_EQ(afterFirstSegment, usage.getTotals().cpuNanos);
+
+    stdx::thread([&] {
+        Client::setCurrent(std::move(client));
+        burnCpu(Milliseconds(20));
+
+        // The current segment is included while it is in progress.
+        ASSERT_GT(usage.getTotals().cpuNanos, afterFirstSegment);
+        client = Client::releaseCurrent();
+    }).join();
+
+    ASSERT_GTE(usage.getTotals().cpuNanos, afterFirstSegment + 10 * 1000 * 1000);
+}
+#endif
+
+}  // namespace
+}  // namespace mongo
@@ -183,6 +183,30 @@ public:
         _pos = n;
     }
 
+    /**
+     * Returns the size in bytes of the last batch returned by this cursor, or 0 if no batch has
+     * been returned yet. Used as a hint when sizing the reply buffer for the next getMore.
+     */
+    int lastBatchBytes() const {
+        return _lastBatchBytes;
+    }
+
+    void setLastBatchBytes(int bytes) {
+        _lastBatchBytes = bytes;
+    }
+
+    /**
+     * Returns the shape under which QueryStatsStore records the cursor's getMores, or an empty
+     * string if it hasn't been computed yet.
+     */
+    const std::string& queryShape() const {
+        return _queryShape;
+    }
+
+    void setQueryShape(std::string queryShape) {
+        _queryShape = std::move(queryShape);
+    }
+
     //
     // Timing.
     //
@@ -307,6 +331,12 @@ private:
     // Tracks the number of results returned by this cursor so far.
     long long _pos = 0;
 
+    // Size of the last batch returned by this cursor, see lastBatchBytes().
+    int _lastBatchBytes = 0;
+
+    // See queryShape().
+    std::string _queryShape;
+
     // Holds an owned copy of the command specification received from the client.
     const BSONObj _originatingCommand;
 
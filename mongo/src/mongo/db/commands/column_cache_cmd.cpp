@@ -0,0 +1,169 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/db/auth/action_set.h"
+#include "mongo/db/auth/action_type.h"
+#include "mongo/db/auth/privilege.h"
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/commands.h"
+#include "mongo/db/concurrency/d_concurrency.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/pipeline/column_cache.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/storage/record_store.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+namespace {
+
+// Memory a single collection's column cache may use before it is dropped.
+MONGO_EXPORT_SERVER_PARAMETER(columnCacheMaxBytesPerCollection, long long, 256 * 1024 * 1024);
+
+const size_t kMaxCachedFields = 32;
+
+class ConfigureColumnCacheCmd : public BasicCommand {
+public:
+    ConfigureColumnCacheCmd() : BasicCommand("configureColumnCache") {}
+
+    bool slaveOk() const override {
+        return true;
+    }
+
+    bool supportsWriteConcern(const BSONObj& cmd) const override {
+        return false;
+    }
+
+    void help(std::stringstream& help) const override {
+        help << "keep an in-memory columnar copy of some top-level fields of a collection\n"
+                "{ configureColumnCache : <collection>, fields : [<field>, ...] }\n"
+                "aggregations needing only these fields (and _id) are then answered from the\n"
+                "cache. The cache is local to this node and is lost on restart. Building it\n"
+                "blocks writes to the collection. An empty fields array removes the cache.\n";
+    }
+
+    void addRequiredPrivileges(const std::string& dbname,
+                               const BSONObj& cmdObj,
+                               std::vector<Privilege>* out) override {
+        ActionSet actions;
+        actions.addAction(ActionType::collMod);
+        out->push_back(Privilege(parseResourcePattern(dbname, cmdObj), actions));
+    }
+
+    bool run(OperationContext* opCtx,
+             const std::string& dbname,
+             const BSONObj& cmdObj,
+             BSONObjBuilder& result) override {
+        const NamespaceString nss = parseNsCollectionRequired(dbname, cmdObj);
+        uassert(ErrorCodes::InvalidNamespace,
+                str::stream() << "cannot cache the fields of " << nss.ns(),
+                nss.isNormal() && !nss.isSystem());
+
+        BSONElement fieldsElem = cmdObj["fields"];
+        uassert(ErrorCodes::TypeMismatch,
+                "'fields' must be an array of field names",
+                fieldsElem.type() == Array);
+
+        std::vector<std::string> fieldNames;
+        for (auto&& elem : fieldsElem.Obj()) {
+            uassert(ErrorCodes::TypeMismatch,
+                    "'fields' must be an array of field names",
+                    elem.type() == String);
+            const std::string name = elem.String();
+            uassert(ErrorCodes::BadValue,
+                    str::stream() << "cannot cache field '" << name
+                                  << "'; only top-level fields other than _id can be cached",
+                    !name.empty() && name[0] != '$' && name.find('.') == std::string::npos &&
+                        name != "_id");
+            uassert(ErrorCodes::BadValue,
+                    str::stream() << "field '" << name << "' is listed more than once",
+                    std::find(fieldNames.begin(), fieldNames.end(), name) == fieldNames.end());
+            fieldNames.push_back(name);
+        }
+        uassert(ErrorCodes::BadValue,
+                str::stream() << "at most " << kMaxCachedFields << " fields can be cached",
+                fieldNames.size() <= kMaxCachedFields);
+
+        auto catalog = ColumnCacheCatalog::get(opCtx);
+
+        // Hold the collection in MODE_S so that no write can slip in between the scan and the
+        // cache being installed, after which the OpObserver keeps it up to date.
+        AutoGetCollection autoColl(opCtx, nss, MODE_IS, MODE_S);
+        Collection* collection = autoColl.getCollection();
+        uassert(ErrorCodes::NamespaceNotFound,
+                str::stream() << "collection " << nss.ns() << " does not exist",
+                collection);
+        uassert(ErrorCodes::InvalidOptions,
+                "cannot cache the fields of a capped collection",
+                !collection->isCapped());
+
+        if (fieldNames.empty()) {
+            catalog->remove(nss);
+            return true;
+        }
+
+        auto cache = std::make_shared<ColumnCache>(
+            nss, std::move(fieldNames), columnCacheMaxBytesPerCollection.load());
+
+        auto cursor = collection->getCursor(opCtx);
+        long long scanned = 0;
+        while (auto record = cursor->next()) {
+            if (++scanned % 1024 == 0) {
+                opCtx->checkForInterrupt();
+            }
+
+            const BSONObj doc = record->data.releaseToBson();
+            const BSONElement id = doc["_id"];
+            uassert(ErrorCodes::InvalidOptions,
+                    "cannot cache the fields of a collection with documents lacking an _id",
+                    !id.eoo());
+            cache->replace(id, doc);
+            uassert(ErrorCodes::ExceededMemoryLimit,
+                    str::stream() << "column cache for " << nss.ns() << " would exceed "
+                                  << columnCacheMaxBytesPerCollection.load()
+                                  << " bytes; see the columnCacheMaxBytesPerCollection parameter",
+                    cache->isValid());
+        }
+
+        catalog->install(cache);
+
+        result.appendNumber("numRows", static_cast<long long>(cache->numRows()));
+        result.appendNumber("approximateBytes", static_cast<long long>(cache->approximateBytes()));
+        return true;
+    }
+} configureColumnCacheCmd;
+
+}  // namespace
+}  // namespace mongo
@@ -0,0 +1,214 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kControl
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/commands/cpu_sampling_profiler.h"
+
+#include "mongo/base/parse_number.h"
+#include "mongo/bson/util/bson_extract.h"
+#include "mongo/db/auth/action_set.h"
+#include "mongo/db/auth/action_type.h"
+#include "mongo/db/auth/privilege.h"
+#include "mongo/db/commands.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/sampling_profiler.h"
+
+namespace mongo {
+
+namespace {
+
+// Collapsed stacks are returned until the reply reaches this size, which keeps it well under the
+// size of the documents drivers accept.
+const int kMaxStacksBytes = 15 * 1024 * 1024;
+
+/**
+ * The cpuSamplingProfilerHz server parameter, which is the number of samples the sampling CPU
+ * profiler takes per second of CPU time, or 0 to disable it.
+ */
+class CpuSamplingProfilerHzParameter : public ServerParameter {
+public:
+    CpuSamplingProfilerHzParameter()
+        : ServerParameter(ServerParameterSet::getGlobal(), "cpuSamplingProfilerHz", true, true) {}
+
+    void append(OperationContext* opCtx, BSONObjBuilder& b, const std::string& name) final {
+        b.append(name, _frequencyHz.load());
+    }
+
+    Status set(const BSONElement& newValueElement) final {
+        int newValue;
+        if (!newValueElement.coerce(&newValue)) {
+            return Status(ErrorCodes::BadValue,
+                          str::stream() << "Invalid value for cpuSamplingProfilerHz: "
+                                        << newValueElement);
+        }
+        return _set(newValue);
+    }
+
+    Status setFromString(const std::string& str) final {
+        int newValue;
+        Status status = parseNumberFromString(str, &newValue);
+        if (!status.isOK()) {
+            return status;
+        }
+        return _set(newValue);
+    }
+
+    /**
+     * Starts the profiler at the frequency set so far, and applies later changes immediately.
+     */
+    void start() {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _started = true;
+        const int frequencyHz = _frequencyHz.load();
+        if (frequencyHz) {
+            Status status = SamplingProfiler::get().setFrequency(frequencyHz);
+            if (!status.isOK()) {
+                warning() << "Failed to start the sampling CPU profiler: " << status;
+                _frequencyHz.store(0);
+            }
+        }
+    }
+
+private:
+    Status _set(int frequencyHz) {
+        if (frequencyHz < 0 || frequencyHz > 1000) {
+            return Status(ErrorCodes::BadValue,
+                          "cpuSamplingProfilerHz must be between 0 and 1000");
+        }
+
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (_started) {
+            Status status = SamplingProfiler::get().setFrequency(frequencyHz);
+            if (!status.isOK()) {
+                return status;
+            }
+        }
+        _frequencyHz.store(frequencyHz);
+        return Status::OK();
+    }
+
+    // Serializes changes of the frequency with starting the profiler.
+    stdx::mutex _mutex;
+    bool _started = false;
+
+    AtomicInt32 _frequencyHz{0};
+} cpuSamplingProfilerHzParameter;
+
+/**
+ * Returns the collapsed stacks counted by the sampling CPU profiler, for flamegraph tools.
+ *
+ *     db.adminCommand({getCpuProfile: 1, reset: <bool>})
+ *
+ * returns
+ *
+ *     {frequencyHz: <int>, samples: <long>, droppedSamples: <long>, truncated: <bool>,
+ *      stacks: ["thread;opType;ns;outermostFrame;...;innermostFrame count", ...]}
+ *
+ * with the stacks which have the most samples first. If 'reset' is true, the counts restart from
+ * zero once returned.
+ */
+class CmdGetCpuProfile : public BasicCommand {
+public:
+    CmdGetCpuProfile() : BasicCommand("getCpuProfile") {}
+
+    bool slaveOk() const final {
+        return true;
+    }
+
+    bool adminOnly() const final {
+        return true;
+    }
+
+    bool supportsWriteConcern(const BSONObj& cmd) const final {
+        return false;
+    }
+
+    void addRequiredPrivileges(const std::string& dbname,
+                               const BSONObj& cmdObj,
+                               std::vector<Privilege>* out) final {
+        ActionSet actions;
+        actions.addAction(ActionType::cpuProfiler);
+        out->push_back(Privilege(ResourcePattern::forClusterResource(), actions));
+    }
+
+    void help(std::stringstream& help) const final {
+        help << "Returns the collapsed stacks counted by the sampling CPU profiler, which is "
+                "started by setting cpuSamplingProfilerHz.\n"
+                "{ getCpuProfile: 1, reset: <bool> }";
+    }
+
+    bool run(OperationContext* opCtx,
+             const std::string& dbname,
+             const BSONObj& cmdObj,
+             BSONObjBuilder& result) final {
+        bool reset;
+        Status status = bsonExtractBooleanFieldWithDefault(cmdObj, "reset", false, &reset);
+        if (!status.isOK()) {
+            return appendCommandStatus(result, status);
+        }
+
+        auto& profiler = SamplingProfiler::get();
+        long long samples;
+        long long droppedSamples;
+        auto stacks = profiler.getCollapsedStacks(reset, &samples, &droppedSamples);
+
+        result.append("frequencyHz", profiler.getFrequency());
+        result.append("samples", samples);
+        result.append("droppedSamples", droppedSamples);
+
+        bool truncated = false;
+        {
+            BSONArrayBuilder stacksBuilder(result.subarrayStart("stacks"));
+            for (auto&& stack : stacks) {
+                // The array shares the reply's buffer, so the reply's length includes it.
+                if (result.len() + static_cast<int>(stack.size()) > kMaxStacksBytes) {
+                    truncated = true;
+                    break;
+                }
+                stacksBuilder.append(stack);
+            }
+        }
+        result.append("truncated", truncated);
+        return true;
+    }
+} cmdGetCpuProfile;
+
+}  // namespace
+
+void startCpuSamplingProfiler() {
+    cpuSamplingProfilerHzParameter.start();
+}
+
+}  // namespace mongo
@@ -30,6 +30,7 @@
 
 #include "mongo/platform/basic.h"
 
+#include <algorithm>
 #include <memory>
 #include <string>
 
@@ -47,12 +48,14 @@
 #include "mongo/db/query/find.h"
 #include "mongo/db/query/find_common.h"
 #include "mongo/db/query/getmore_request.h"
+#include "mongo/db/query/plan_cache.h"
 #include "mongo/db/query/plan_executor.h"
 #include "mongo/db/query/plan_summary_stats.h"
 #include "mongo/db/repl/oplog.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/stats/counters.h"
+#include "mongo/db/stats/query_stats_store.h"
 #include "mongo/db/stats/top.h"
 #include "mongo/s/chunk_version.h"
 #include "mongo/stdx/memory.h"
@@ -67,6 +70,10 @@ namespace {
 
 MONGO_FP_DECLARE(rsStopGetMoreCmd);
 
+// Bytes reserved for the reply to the first getMore on a cursor. Together with the reply header it
+// stays within the 1MB size class, the largest which MessageBufferPool recycles.
+const int kFirstBatchReserveBytes = 512 * 1024;
+
 /**
  * A command for running getMore() against an existing cursor registered with a CursorManager.
  * Used to generate the next batch of results for a ClientCursor.
@@ -119,10 +126,27 @@ public:
     }
 
     std::size_t reserveBytesForReply() const override {
+        // The reply buffer is sized in runParsed() once the cursor is known, see
+        // reserveBytesForBatch().
+        return FindCommon::kInitReplyBufferSize;
+    }
+
+    /**
+     * Returns how many bytes to reserve for the next batch of 'cursor'. Reserving the maximum
+     * batch size up front means every getMore, including small awaitData ones, allocates a 32MB
+     * buffer, so we size the buffer after the cursor's last batch, or start from
+     * kFirstBatchReserveBytes if it hasn't returned one yet.
+     */
+    static int reserveBytesForBatch(const ClientCursor* cursor) {
         // The extra 1K is an artifact of how we construct batches. We consider a batch to be full
         // when it exceeds the goal batch size. In the case that we are just below the limit and
         // then read a large document, the extra 1K helps prevent a final realloc+memcpy.
-        return FindCommon::kMaxBytesToReturnToClientAtOnce + 1024u;
+        const int maxBytes = FindCommon::kMaxBytesToReturnToClientAtOnce + 1024;
+        const int lastBatchBytes = cursor->lastBatchBytes();
+        if (lastBatchBytes == 0) {
+            return kFirstBatchReserveBytes;
+        }
+        return std::min(lastBatchBytes + lastBatchBytes / 4 + 1024, maxBytes);
     }
 
     /**
@@ -320,7 +344,23 @@ public:
             }
         }
 
+        // Record the getMore under the shape of the query which created the cursor, which is only
+        // computed by the cursor's first getMore.
+        if (readLock && QueryStatsStore::isEnabled()) {
+            if (const CanonicalQuery* cq = exec->getCanonicalQuery()) {
+                if (cursor->queryShape().empty()) {
+                    PlanCache* planCache = readLock->getCollection()->infoCache()->getPlanCache();
+                    cursor->setQueryShape(planCache->computeKey(*cq));
+                }
+                curOp->debug().queryShapeNs = cq->ns();
+                curOp->debug().queryShape = cursor->queryShape();
+            }
+        }
+
         CursorId respondWithId = 0;
+        const int reserveBytes = reserveBytesForBatch(cursor);
+        result.bb().reserveBytes(reserveBytes);
+        result.bb().claimReservedBytes(reserveBytes);
         CursorResponseBuilder nextBatch(/*isInitialResponse*/ false, &result);
         BSONObj obj;
         PlanExecutor::ExecState state = PlanExecutor::ADVANCED;
@@ -374,6 +414,7 @@ public:
             }
 
             cursor->incPos(numResults);
+            cursor->setLastBatchBytes(nextBatch.bytesUsed());
         } else {
             curOp->debug().cursorExhausted = true;
         }
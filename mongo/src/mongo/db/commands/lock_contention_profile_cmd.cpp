@@ -0,0 +1,218 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <algorithm>
+#include <list>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "mongo/db/auth/action_set.h"
+#include "mongo/db/auth/action_type.h"
+#include "mongo/db/auth/privilege.h"
+#include "mongo/db/catalog/database.h"
+#include "mongo/db/catalog/database_catalog_entry.h"
+#include "mongo/db/catalog/database_holder.h"
+#include "mongo/db/commands.h"
+#include "mongo/db/concurrency/d_concurrency.h"
+#include "mongo/db/concurrency/lock_contention_profile.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/storage/storage_engine.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * Maps the database, collection and metadata resources among 'resIds' to the names of the
+ * databases and collections they lock. Resources of dropped collections are left out.
+ *
+ * The locks needed to list the databases and their collections are only taken if they are free, so
+ * that the command never waits behind the contention it reports. Resources which can't be resolved
+ * without waiting are left out too, and reported by their raw ids.
+ */
+std::map<ResourceId, std::string> resolveResourceNames(OperationContext* opCtx,
+                                                       const std::set<ResourceId>& resIds) {
+    std::map<ResourceId, std::string> names;
+
+    Lock::GlobalLock globalLock(opCtx, MODE_IS, 0);
+    if (!globalLock.isLocked()) {
+        return names;
+    }
+
+    std::vector<std::string> dbNames;
+    getGlobalServiceContext()->getGlobalStorageEngine()->listDatabases(&dbNames);
+
+    size_t unresolvedCollections = std::count_if(resIds.begin(), resIds.end(), [](ResourceId id) {
+        return id.getType() == RESOURCE_COLLECTION || id.getType() == RESOURCE_METADATA;
+    });
+
+    for (auto&& dbName : dbNames) {
+        const ResourceId dbResId(RESOURCE_DATABASE, dbName);
+        if (resIds.count(dbResId)) {
+            names[dbResId] = dbName;
+        }
+
+        if (unresolvedCollections == 0) {
+            continue;
+        }
+
+        if (opCtx->lockState()->lock(dbResId, MODE_IS, Milliseconds(0)) != LOCK_OK) {
+            continue;
+        }
+        ON_BLOCK_EXIT([&] { opCtx->lockState()->unlock(dbResId); });
+
+        Database* db = dbHolder().get(opCtx, dbName);
+        if (!db) {
+            continue;
+        }
+
+        std::list<std::string> collectionNames;
+        db->getDatabaseCatalogEntry()->getCollectionNamespaces(&collectionNames);
+        for (auto&& ns : collectionNames) {
+            for (ResourceType type : {RESOURCE_COLLECTION, RESOURCE_METADATA}) {
+                const ResourceId resId(type, ns);
+                if (resIds.count(resId)) {
+                    names[resId] = ns;
+                    unresolvedCollections--;
+                }
+            }
+        }
+    }
+
+    return names;
+}
+
+const char* holderName(const LockContentionProfile::Entry& entry) {
+    return entry.holderFound ? logicalOpToString(entry.holderOp) : "pending";
+}
+
+class LockContentionProfileCmd : public BasicCommand {
+public:
+    LockContentionProfileCmd() : BasicCommand("lockContentionProfile") {}
+
+    bool slaveOk() const override {
+        return true;
+    }
+
+    bool adminOnly() const override {
+        return true;
+    }
+
+    bool supportsWriteConcern(const BSONObj& cmd) const override {
+        return false;
+    }
+
+    void help(std::stringstream& help) const override {
+        help << "returns which types of operations blocked which others on each resource, for the\n"
+                "most recent lock waits longer than lockContentionProfileThresholdMillis, and the\n"
+                "write conflict retries per namespace.\n"
+                "{ lockContentionProfile: 1, reset: <bool> }\n"
+                "A holder of 'none' is an internal operation, and of 'pending' means that the\n"
+                "waiter was queued behind other waiting requests.\n";
+    }
+
+    void addRequiredPrivileges(const std::string& dbname,
+                               const BSONObj& cmdObj,
+                               std::vector<Privilege>* out) override {
+        ActionSet actions;
+        actions.addAction(ActionType::serverStatus);
+        out->push_back(Privilege(ResourcePattern::forClusterResource(), actions));
+    }
+
+    bool run(OperationContext* opCtx,
+             const std::string& dbname,
+             const BSONObj& cmdObj,
+             BSONObjBuilder& result) override {
+        LockContentionProfile& profile = LockContentionProfile::get();
+        const auto table = profile.getBlockingTable();
+        auto writeConflicts = profile.getWriteConflicts();
+        const long long otherWriteConflicts = profile.getWriteConflictsInOtherNamespaces();
+        if (cmdObj["reset"].trueValue()) {
+            profile.reset();
+        }
+
+        // Group the table by resource, keeping the order of decreasing total wait time.
+        std::vector<ResourceId> resources;
+        std::map<ResourceId, std::vector<const LockContentionProfile::Entry*>> byResource;
+        std::map<ResourceId, long long> resourceWaitMicros;
+        for (auto&& entry : table) {
+            auto& entries = byResource[entry.resId];
+            if (entries.empty()) {
+                resources.push_back(entry.resId);
+            }
+            entries.push_back(&entry);
+            resourceWaitMicros[entry.resId] += entry.totalWaitMicros;
+        }
+        std::stable_sort(resources.begin(), resources.end(), [&](ResourceId a, ResourceId b) {
+            return resourceWaitMicros[a] > resourceWaitMicros[b];
+        });
+
+        const auto names = resolveResourceNames(
+            opCtx, std::set<ResourceId>(resources.begin(), resources.end()));
+
+        BSONArrayBuilder resourcesBuilder(result.subarrayStart("resources"));
+        for (auto&& resId : resources) {
+            BSONObjBuilder resourceBuilder(resourcesBuilder.subobjStart());
+            auto name = names.find(resId);
+            resourceBuilder.append("resource",
+                                   name != names.end() ? name->second : resId.toString());
+            resourceBuilder.append("type", resourceTypeName(resId.getType()));
+            resourceBuilder.append("totalWaitMicros", resourceWaitMicros[resId]);
+
+            BSONArrayBuilder blockingBuilder(resourceBuilder.subarrayStart("blocking"));
+            for (auto&& entry : byResource[resId]) {
+                BSONObjBuilder entryBuilder(blockingBuilder.subobjStart());
+                entryBuilder.append("waiter", logicalOpToString(entry->waiterOp));
+                entryBuilder.append("holder", holderName(*entry));
+                entryBuilder.append("count", entry->count);
+                entryBuilder.append("totalWaitMicros", entry->totalWaitMicros);
+                entryBuilder.append("maxWaitMicros", entry->maxWaitMicros);
+            }
+        }
+        resourcesBuilder.doneFast();
+
+        std::sort(writeConflicts.begin(), writeConflicts.end(), [](const auto& a, const auto& b) {
+            return a.second > b.second;
+        });
+        BSONArrayBuilder writeConflictsBuilder(result.subarrayStart("writeConflicts"));
+        for (auto&& writeConflict : writeConflicts) {
+            writeConflictsBuilder.append(
+                BSON("ns" << writeConflict.first << "count" << writeConflict.second));
+        }
+        writeConflictsBuilder.doneFast();
+        result.append("writeConflictsInOtherNamespaces", otherWriteConflicts);
+        return true;
+    }
+} lockContentionProfileCmd;
+
+}  // namespace
+}  // namespace mongo
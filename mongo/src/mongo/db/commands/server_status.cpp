@@ -51,6 +51,7 @@
 #include "mongo/transport/service_entry_point.h"
 #include "mongo/util/log.h"
 #include "mongo/util/net/hostname_canonicalization.h"
+#include "mongo/util/net/message_buffer_pool.h"
 #include "mongo/util/net/sock.h"
 #include "mongo/util/net/ssl_manager.h"
 #include "mongo/util/processinfo.h"
@@ -118,6 +119,11 @@ public:
 
         // --- all sections
 
+        // With defaultSections: false, only the sections which are explicitly requested are
+        // included, so frequent callers can get a few cheap sections.
+        const bool includeDefaults =
+            !cmdObj["defaultSections"].type() || cmdObj["defaultSections"].trueValue();
+
         for (SectionMap::const_iterator i = _sections.begin(); i != _sections.end(); ++i) {
             ServerStatusSection* section = i->second;
 
@@ -126,7 +132,7 @@ public:
             if (!authSession->isAuthorizedForPrivileges(requiredPrivileges))
                 continue;
 
-            bool include = section->includeByDefault();
+            bool include = includeDefaults && section->includeByDefault();
             const auto& elem = cmdObj[section->getSectionName()];
             if (elem.type()) {
                 include = elem.trueValue();
@@ -144,8 +150,10 @@ public:
 
         // --- counters
         bool includeMetricTree = MetricTree::theMetricTree != NULL;
-        if (cmdObj["metrics"].type() && !cmdObj["metrics"].trueValue())
-            includeMetricTree = false;
+        if (cmdObj["metrics"].type())
+            includeMetricTree = includeMetricTree && cmdObj["metrics"].trueValue();
+        else
+            includeMetricTree = includeMetricTree && includeDefaults;
 
         if (includeMetricTree) {
             MetricTree::theMetricTree->appendTo(result);
@@ -301,6 +309,7 @@ public:
         BSONObjBuilder b;
         networkCounter.append(b); //NetworkCounter::append
         appendMessageCompressionStats(&b);
+        MessageBufferPool::appendStats(&b);
         auto executor = opCtx->getServiceContext()->getServiceExecutor();
         if (executor)
             executor->appendStats(&b);
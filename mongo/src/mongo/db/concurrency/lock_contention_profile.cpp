@@ -0,0 +1,153 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/concurrency/lock_contention_profile.h"
+
+#include <algorithm>
+#include <map>
+#include <tuple>
+
+#include "mongo/db/server_parameters.h"
+
+namespace mongo {
+
+namespace {
+
+// Lock waits lasting at least this long are attributed, a negative value disables the profile.
+MONGO_EXPORT_SERVER_PARAMETER(lockContentionProfileThresholdMillis, int, 100);
+
+LockContentionProfile globalLockContentionProfile;
+
+}  // namespace
+
+LockContentionProfile& LockContentionProfile::get() {
+    return globalLockContentionProfile;
+}
+
+bool LockContentionProfile::isEnabled() {
+    return lockContentionProfileThresholdMillis.load() >= 0;
+}
+
+bool LockContentionProfile::shouldRecord(uint64_t waitMicros) {
+    const int thresholdMillis = lockContentionProfileThresholdMillis.load();
+    return thresholdMillis >= 0 && waitMicros >= static_cast<uint64_t>(thresholdMillis) * 1000;
+}
+
+void LockContentionProfile::recordWait(LockerId waiterId, const Wait& wait) {
+    Partition& partition = _getPartition(waiterId);
+
+    stdx::lock_guard<stdx::mutex> lk(partition.mutex);
+    if (partition.waits.size() < kPartitionCapacity) {
+        partition.waits.push_back(wait);
+        return;
+    }
+
+    partition.waits[partition.next] = wait;
+    partition.next = (partition.next + 1) % kPartitionCapacity;
+}
+
+void LockContentionProfile::recordWriteConflict(StringData ns) {
+    stdx::lock_guard<stdx::mutex> lk(_writeConflictsMutex);
+    auto it = _writeConflicts.find(ns);
+    if (it != _writeConflicts.end()) {
+        it->second++;
+    } else if (_writeConflicts.size() < kMaxWriteConflictNamespaces) {
+        _writeConflicts[ns] = 1;
+    } else {
+        _writeConflictsInOtherNamespaces++;
+    }
+}
+
+std::vector<LockContentionProfile::Entry> LockContentionProfile::getBlockingTable() const {
+    using Key = std::tuple<uint64_t, LogicalOp, LogicalOp, bool>;
+    std::map<Key, Entry> entries;
+
+    for (const Partition& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> lk(partition.mutex);
+        for (const Wait& wait : partition.waits) {
+            const Key key(wait.resId, wait.waiterOp, wait.holderOp, wait.holderFound);
+            auto it = entries.find(key);
+            if (it == entries.end()) {
+                Entry entry;
+                entry.resId = wait.resId;
+                entry.waiterOp = wait.waiterOp;
+                entry.holderOp = wait.holderOp;
+                entry.holderFound = wait.holderFound;
+                it = entries.emplace(key, entry).first;
+            }
+
+            Entry& entry = it->second;
+            const long long waitMicros = static_cast<long long>(wait.waitMicros);
+            entry.count++;
+            entry.totalWaitMicros += waitMicros;
+            entry.maxWaitMicros = std::max(entry.maxWaitMicros, waitMicros);
+        }
+    }
+
+    std::vector<Entry> table;
+    table.reserve(entries.size());
+    for (auto&& entry : entries) {
+        table.push_back(entry.second);
+    }
+    std::stable_sort(table.begin(), table.end(), [](const Entry& a, const Entry& b) {
+        return a.totalWaitMicros > b.totalWaitMicros;
+    });
+    return table;
+}
+
+std::vector<std::pair<std::string, long long>> LockContentionProfile::getWriteConflicts() const {
+    std::vector<std::pair<std::string, long long>> counts;
+
+    stdx::lock_guard<stdx::mutex> lk(_writeConflictsMutex);
+    counts.reserve(_writeConflicts.size());
+    for (auto&& entry : _writeConflicts) {
+        counts.emplace_back(entry.first, entry.second);
+    }
+    return counts;
+}
+
+long long LockContentionProfile::getWriteConflictsInOtherNamespaces() const {
+    stdx::lock_guard<stdx::mutex> lk(_writeConflictsMutex);
+    return _writeConflictsInOtherNamespaces;
+}
+
+void LockContentionProfile::reset() {
+    for (Partition& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> lk(partition.mutex);
+        partition.waits.clear();
+        partition.next = 0;
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_writeConflictsMutex);
+    _writeConflicts.clear();
+    _writeConflictsInOtherNamespaces = 0;
+}
+
+}  // namespace mongo
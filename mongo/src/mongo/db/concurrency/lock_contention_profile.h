@@ -0,0 +1,151 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
+#include "mongo/db/concurrency/lock_manager_defs.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/new.h"
+#include "mongo/util/net/message.h"
+#include "mongo/util/string_map.h"
+
+namespace mongo {
+
+/**
+ * Attributes lock waits to the types of the operations involved, so that it can be seen which
+ * operations block which others on each resource, and counts write conflict retries per namespace.
+ *
+ * A lock wait lasting at least lockContentionProfileThresholdMillis is recorded along with the
+ * type of the waiting operation and of an operation which held the resource in a conflicting mode
+ * when the wait began. Waits are recorded into one of a fixed number of partitions chosen by the
+ * waiter's LockerId, each of which keeps its most recent kPartitionCapacity waits, and are only
+ * aggregated when the profile is read. A negative threshold disables the profile, in which case
+ * lock waits don't look up their holders at all.
+ */
+class LockContentionProfile {
+    MONGO_DISALLOW_COPYING(LockContentionProfile);
+
+public:
+    static const size_t kPartitionCapacity = 1024;
+
+    // Namespaces beyond this many are counted together in getWriteConflictsInOtherNamespaces().
+    static const size_t kMaxWriteConflictNamespaces = 1000;
+
+    struct Wait {
+        ResourceId resId;
+        LogicalOp waiterOp;
+        LogicalOp holderOp;
+
+        // False if no conflicting holder was found, which means the request was queued behind
+        // other pending requests.
+        bool holderFound;
+
+        uint64_t waitMicros;
+    };
+
+    /**
+     * The waits recorded on one resource between operations of one type waiting and another
+     * holding the resource.
+     */
+    struct Entry {
+        ResourceId resId;
+        LogicalOp waiterOp;
+        LogicalOp holderOp;
+        bool holderFound;
+
+        long long count = 0;
+        long long totalWaitMicros = 0;
+        long long maxWaitMicros = 0;
+    };
+
+    LockContentionProfile() = default;
+
+    static LockContentionProfile& get();
+
+    /**
+     * Returns whether lock waits should look up the holders of the resource they wait for.
+     */
+    static bool isEnabled();
+
+    /**
+     * Returns whether a lock wait which lasted 'waitMicros' is long enough to be recorded.
+     */
+    static bool shouldRecord(uint64_t waitMicros);
+
+    void recordWait(LockerId waiterId, const Wait& wait);
+
+    /**
+     * Counts one write conflict retry on 'ns'.
+     */
+    void recordWriteConflict(StringData ns);
+
+    /**
+     * Aggregates the recorded waits by resource, waiter and holder type, ordered by decreasing
+     * total wait time.
+     */
+    std::vector<Entry> getBlockingTable() const;
+
+    /**
+     * Returns the write conflict retry counts per namespace, in no particular order.
+     */
+    std::vector<std::pair<std::string, long long>> getWriteConflicts() const;
+    long long getWriteConflictsInOtherNamespaces() const;
+
+    void reset();
+
+private:
+    // Aligned so that partitions used by different threads don't share cache lines.
+    struct alignas(stdx::hardware_destructive_interference_size) Partition {
+        mutable stdx::mutex mutex;
+        std::vector<Wait> waits;
+
+        // Where the next wait goes once 'waits' has reached kPartitionCapacity.
+        size_t next = 0;
+    };
+
+    enum { NumPartitions = 8 };
+
+    Partition& _getPartition(LockerId id) {
+        return _partitions[id % NumPartitions];
+    }
+
+    Partition _partitions[NumPartitions];
+
+    mutable stdx::mutex _writeConflictsMutex;
+    StringMap<long long> _writeConflicts;
+    long long _writeConflictsInOtherNamespaces = 0;
+};
+
+}  // namespace mongo
@@ -0,0 +1,150 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/concurrency/lock_contention_profile.h"
+
+#include <algorithm>
+
+#include "mongo/db/concurrency/lock_manager_test_help.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace {
+
+void setThresholdMillis(int millis) {
+    auto& params = ServerParameterSet::getGlobal()->getMap();
+    auto it = params.find("lockContentionProfileThresholdMillis");
+    invariant(it != params.end());
+    ASSERT_OK(it->second->setFromString(std::to_string(millis)));
+}
+
+LockContentionProfile::Wait makeWait(ResourceId resId,
+                                     LogicalOp waiterOp,
+                                     LogicalOp holderOp,
+                                     uint64_t waitMicros) {
+    return {resId, waiterOp, holderOp, true, waitMicros};
+}
+
+TEST(LockContentionProfile, AggregatesByResourceAndOperationTypes) {
+    const ResourceId resA(RESOURCE_COLLECTION, std::string("LockContentionProfile.a"));
+    const ResourceId resB(RESOURCE_COLLECTION, std::string("LockContentionProfile.b"));
+
+    LockContentionProfile profile;
+    profile.recordWait(1, makeWait(resA, LogicalOp::opInsert, LogicalOp::opCommand, 100));
+    profile.recordWait(2, makeWait(resA, LogicalOp::opInsert, LogicalOp::opCommand, 300));
+    profile.recordWait(3, makeWait(resA, LogicalOp::opQuery, LogicalOp::opCommand, 50));
+    profile.recordWait(4, makeWait(resB, LogicalOp::opInsert, LogicalOp::opCommand, 1000));
+
+    const auto table = profile.getBlockingTable();
+    ASSERT_EQ(table.size(), 3U);
+
+    ASSERT_EQ(table[0].resId, resB);
+    ASSERT_EQ(table[0].count, 1);
+
+    ASSERT_EQ(table[1].resId, resA);
+    ASSERT(table[1].waiterOp == LogicalOp::opInsert);
+    ASSERT(table[1].holderOp == LogicalOp::opCommand);
+    ASSERT_EQ(table[1].count, 2);
+    ASSERT_EQ(table[1].totalWaitMicros, 400);
+    ASSERT_EQ(table[1].maxWaitMicros, 300);
+
+    ASSERT_EQ(table[2].resId, resA);
+    ASSERT(table[2].waiterOp == LogicalOp::opQuery);
+    ASSERT_EQ(table[2].totalWaitMicros, 50);
+
+    profile.reset();
+    ASSERT(profile.getBlockingTable().empty());
+}
+
+TEST(LockContentionProfile, PartitionKeepsMostRecentWaits) {
+    const ResourceId resOld(RESOURCE_COLLECTION, std::string("LockContentionProfile.old"));
+    const ResourceId resNew(RESOURCE_COLLECTION, std::string("LockContentionProfile.new"));
+
+    LockContentionProfile profile;
+    profile.recordWait(1, makeWait(resOld, LogicalOp::opUpdate, LogicalOp::opUpdate, 10));
+    for (size_t i = 0; i < LockContentionProfile::kPartitionCapacity; i++) {
+        profile.recordWait(1, makeWait(resNew, LogicalOp::opUpdate, LogicalOp::opUpdate, 10));
+    }
+
+    const auto table = profile.getBlockingTable();
+    ASSERT_EQ(table.size(), 1U);
+    ASSERT_EQ(table[0].resId, resNew);
+    ASSERT_EQ(table[0].count, static_cast<long long>(LockContentionProfile::kPartitionCapacity));
+}
+
+TEST(LockContentionProfile, CountsWriteConflictsPerNamespace) {
+    LockContentionProfile profile;
+    profile.recordWriteConflict("test.a");
+    profile.recordWriteConflict("test.b");
+    profile.recordWriteConflict("test.a");
+
+    auto counts = profile.getWriteConflicts();
+    std::sort(counts.begin(), counts.end());
+    ASSERT_EQ(counts.size(), 2U);
+    ASSERT_EQ(counts[0].first, "test.a");
+    ASSERT_EQ(counts[0].second, 2);
+    ASSERT_EQ(counts[1].first, "test.b");
+    ASSERT_EQ(counts[1].second, 1);
+    ASSERT_EQ(profile.getWriteConflictsInOtherNamespaces(), 0);
+}
+
+TEST(LockContentionProfile, LockWaitIsAttributedToConflictingHolder) {
+    const ResourceId resId(RESOURCE_COLLECTION, std::string("LockContentionProfile.holder"));
+
+    setThresholdMillis(0);
+    ON_BLOCK_EXIT([] { setThresholdMillis(100); });
+    LockContentionProfile::get().reset();
+
+    LockerForTests holder(MODE_IX);
+    holder.setLogicalOp(LogicalOp::opCommand);
+    holder.lock(resId, MODE_X);
+
+    {
+        LockerForTests waiter(MODE_IX);
+        waiter.setLogicalOp(LogicalOp::opInsert);
+        ASSERT_EQUALS(LOCK_WAITING, waiter.lockBegin(resId, MODE_IX));
+        ASSERT_EQUALS(LOCK_TIMEOUT, waiter.lockComplete(resId, MODE_IX, Milliseconds(1), false));
+    }
+
+    const auto table = LockContentionProfile::get().getBlockingTable();
+    ASSERT_EQ(table.size(), 1U);
+    ASSERT_EQ(table[0].resId, resId);
+    ASSERT(table[0].waiterOp == LogicalOp::opInsert);
+    ASSERT(table[0].holderFound);
+    ASSERT(table[0].holderOp == LogicalOp::opCommand);
+    ASSERT_EQ(table[0].count, 1);
+
+    holder.unlock(resId);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -1202,6 +1202,30 @@ featdoc:PRIMARY>
 */
 
 //CmdLockInfo::run    db.runCommand({lockInfo: 1})ȡϢ
+bool LockManager::getConflictingHolderOp(ResourceId resId,
+                                         LockMode mode,
+                                         const Locker* waiter,
+                                         LogicalOp* holderOp) {
+    LockBucket* bucket = _getBucket(resId);
+    stdx::lock_guard<SimpleMutex> scopedLock(bucket->mutex);
+
+    LockBucket::Map::const_iterator it = bucket->data.find(resId);
+    if (it == bucket->data.end()) {
+        return false;
+    }
+
+    // Requests granted in intent modes may still be in partitioned lock heads, but those don't
+    // conflict with each other and are migrated to the lock head by any conflicting request.
+    for (const LockRequest* iter = it->second->grantedList._front; iter != nullptr;
+         iter = iter->next) {
+        if (iter->locker != waiter && conflicts(mode, modeMask(iter->mode))) {
+            *holderOp = iter->locker->getLogicalOp();
+            return true;
+        }
+    }
+    return false;
+}
+
 void LockManager::getLockInfoBSON(const std::map<LockerId, BSONObj>& lockToClientMap,
                                   BSONObjBuilder* result) {
     BSONArrayBuilder lockInfo;
@@ -43,6 +43,7 @@
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/util/concurrency/mutex.h"
+#include "mongo/util/net/message.h"
 
 namespace mongo {
 
@@ -220,6 +221,16 @@ public:
     void getLockInfoBSON(const std::map<LockerId, BSONObj>& lockToClientMap,
                          BSONObjBuilder* result);
 
+    /**
+     * Looks for a request granted on 'resId' in a mode conflicting with 'mode' which does not
+     * belong to 'waiter'. If there is one, stores the type of the operation owning it in
+     * 'holderOp' and returns true. Used by the lock contention profile to attribute lock waits.
+     */
+    bool getConflictingHolderOp(ResourceId resId,
+                                LockMode mode,
+                                const Locker* waiter,
+                                LogicalOp* holderOp);
+
 private:
     // The deadlock detector needs to access the buckets and locks directly
     friend class DeadlockDetector;
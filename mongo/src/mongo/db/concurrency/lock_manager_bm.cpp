@@ -0,0 +1,123 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <vector>
+
+#include "mongo/db/concurrency/lock_manager.h"
+#include "mongo/db/concurrency/lock_manager_test_help.h"
+#include "mongo/db/concurrency/lock_state.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/benchmark.h"
+
+namespace mongo {
+namespace {
+
+using unittest::BenchmarkState;
+
+const ResourceId resIdDb(RESOURCE_DATABASE, std::string("benchmarkDb"));
+const ResourceId resIdColl(RESOURCE_COLLECTION, std::string("benchmarkDb.coll"));
+
+/**
+ * Takes and releases the locks a CRUD operation on a single collection takes.
+ */
+void lockAndUnlockCollection(DefaultLockerImpl* locker, LockMode mode) {
+    const LockMode intentMode = isSharedLockMode(mode) ? MODE_IS : MODE_IX;
+    invariant(locker->lockGlobal(intentMode) == LOCK_OK);
+    invariant(locker->lock(resIdDb, intentMode) == LOCK_OK);
+    invariant(locker->lock(resIdColl, mode) == LOCK_OK);
+    locker->unlock(resIdColl);
+    locker->unlock(resIdDb);
+    locker->unlockGlobal();
+}
+
+// Acquires and releases a lock directly through the LockManager, without a Locker's bookkeeping.
+void BM_LockManagerLockUnlock(BenchmarkState& state) {
+    LockManager lockManager;
+    LockerForTests locker(MODE_IX);
+    LockRequestCombo request(&locker);
+    while (state.keepRunning()) {
+        invariant(lockManager.lock(resIdColl, &request, MODE_IX) == LOCK_OK);
+        lockManager.unlock(&request);
+    }
+    state.setItemsProcessed(state.iterations());
+}
+
+void BM_LockerCollectionLocks(BenchmarkState& state) {
+    const auto mode = static_cast<LockMode>(state.range());
+    state.setLabel(modeName(mode));
+    DefaultLockerImpl locker;
+    while (state.keepRunning()) {
+        lockAndUnlockCollection(&locker, mode);
+    }
+    state.setItemsProcessed(state.iterations());
+}
+
+// Measures the thread running the benchmark while range() - 1 other threads lock and unlock the
+// same collection in the same mode, which is compatible, so only contention on the lock manager's
+// internal state slows it down.
+void BM_LockerCollectionLocksContended(BenchmarkState& state) {
+    const auto mode = static_cast<LockMode>(state.range(0));
+    const auto numOtherThreads = state.range(1) - 1;
+    state.setLabel(modeName(mode));
+
+    AtomicWord<bool> done(false);
+    std::vector<stdx::thread> threads;
+    for (long long i = 0; i < numOtherThreads; ++i) {
+        threads.emplace_back([&] {
+            DefaultLockerImpl locker;
+            while (!done.load()) {
+                lockAndUnlockCollection(&locker, mode);
+            }
+        });
+    }
+
+    DefaultLockerImpl locker;
+    while (state.keepRunning()) {
+        lockAndUnlockCollection(&locker, mode);
+    }
+
+    done.store(true);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    state.setItemsProcessed(state.iterations());
+}
+
+MONGO_BENCHMARK(BM_LockManagerLockUnlock);
+MONGO_BENCHMARK(BM_LockerCollectionLocks)->arg(MODE_IS)->arg(MODE_IX)->arg(MODE_S)->arg(MODE_X);
+MONGO_BENCHMARK(BM_LockerCollectionLocksContended)
+    ->args({MODE_IS, 2})
+    ->args({MODE_IS, 8})
+    ->args({MODE_IX, 2})
+    ->args({MODE_IX, 8});
+
+}  // namespace
+}  // namespace mongo
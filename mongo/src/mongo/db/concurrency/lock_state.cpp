@@ -34,7 +34,9 @@
 
 #include <vector>
 
+#include "mongo/db/concurrency/lock_contention_profile.h"
 #include "mongo/db/namespace_string.h"
+#include "mongo/db/operation_trace.h"
 #include "mongo/db/service_context.h"
 #include "mongo/platform/compiler.h"
 #include "mongo/stdx/new.h"
@@ -467,6 +469,7 @@ LockResult LockerImpl<IsForMMAPV1>::_lockGlobalBegin(LockMode mode, Milliseconds
 		//⼸͵
 		
             _clientState.store(reader ? kQueuedReader : kQueuedWriter); 
+            OperationTrace::Span traceSpan(OperationTrace::Phase::kTicketWait);
 			//ȴڼΪQueued״̬ȡΪActive״̬ȡʱΪinactive
             if (timeout == Milliseconds::max()) {
 				//TicketHolder::waitForTicketһֱź
@@ -969,6 +972,8 @@ LockResult LockerImpl<IsForMMAPV1>::lockComplete(ResourceId resId,
                                                  LockMode mode,
                                                  Milliseconds timeout,
                                                  bool checkDeadlock) {
+    OperationTrace::Span traceSpan(OperationTrace::Phase::kLockWait);
+
     // Under MMAP V1 engine a deadlock can occur if a thread goes to sleep waiting on
     // DB lock, while holding the flush lock, so it has to be released. This is only
     // correct to do if not in a write unit of work.
@@ -982,6 +987,15 @@ LockResult LockerImpl<IsForMMAPV1>::lockComplete(ResourceId resId,
 
     LockResult result;
 
+    // The holders have to be looked up now, before they release the resource, but are only
+    // recorded if the wait turns out to be long enough.
+    LockContentionProfile::Wait contention{resId, getLogicalOp(), LogicalOp::opInvalid, false, 0};
+    const bool profileContention = LockContentionProfile::isEnabled();
+    if (profileContention) {
+        contention.holderFound =
+            globalLockManager.getConflictingHolderOp(resId, mode, this, &contention.holderOp);
+    }
+
     // Don't go sleeping without bound in order to be able to report long waits or wake up for
     // deadlock detection.
     Milliseconds waitTime = std::min(timeout, DeadlockTimeout);
@@ -1035,6 +1049,13 @@ LockResult LockerImpl<IsForMMAPV1>::lockComplete(ResourceId resId,
         }
     }
 
+    if (profileContention) {
+        contention.waitMicros = curTimeMicros64() - startOfTotalWaitTime;
+        if (LockContentionProfile::shouldRecord(contention.waitMicros)) {
+            LockContentionProfile::get().recordWait(_id, contention);
+        }
+    }
+
     // Cleanup the state, since this is an unused lock now
     if (result != LOCK_OK) {
         LockRequestsMap::Iterator it = _requests.find(resId);
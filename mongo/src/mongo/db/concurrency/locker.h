@@ -33,7 +33,9 @@
 
 #include "mongo/db/concurrency/lock_manager.h"
 #include "mongo/db/concurrency/lock_stats.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/thread.h"
+#include "mongo/util/net/message.h"
 
 namespace mongo {
 
@@ -361,6 +363,18 @@ public:
         return _shouldConflictWithSecondaryBatchApplication;
     }
 
+    /**
+     * The type of the operation using this locker, which the lock contention profile attributes
+     * lock waits to. May be read by other threads while they wait for a lock held by this locker.
+     */
+    void setLogicalOp(LogicalOp logicalOp) {
+        _logicalOp.store(static_cast<int>(logicalOp));
+    }
+
+    LogicalOp getLogicalOp() const {
+        return static_cast<LogicalOp>(_logicalOp.load());
+    }
+
 protected:
     Locker() {}
 
@@ -368,6 +382,8 @@ private:
     //ͬأοLock::ParallelBatchWriterMode::ParallelBatchWriterMode
     //ParallelBatchWriterModeĶ
     bool _shouldConflictWithSecondaryBatchApplication = true;
+
+    AtomicInt32 _logicalOp{static_cast<int>(LogicalOp::opInvalid)};
 };
 
 }  // namespace mongo
@@ -49,7 +49,8 @@ public:
 
     /**
      * Will log a message if sensible and will do an exponential backoff to make sure
-     * we don't hammer the same doc over and over.
+     * we don't hammer the same doc over and over. Also counts the retry against 'ns' in the
+     * LockContentionProfile.
      * @param attempt - what attempt is this, 1 based
      * @param operation - e.g. "update"
      */
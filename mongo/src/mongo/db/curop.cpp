@@ -40,11 +40,13 @@
 #include "mongo/db/commands.h"
 #include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/json.h"
+#include "mongo/db/operation_trace.h"
 #include "mongo/db/query/getmore_request.h"
 #include "mongo/db/query/plan_summary_stats.h"
 #include "mongo/rpc/metadata/client_metadata.h"
 #include "mongo/rpc/metadata/client_metadata_ismaster.h"
 #include "mongo/util/log.h"
+#include "mongo/util/sampling_profiler.h"
 #include "mongo/util/stringutils.h"
 
 namespace mongo {
@@ -263,22 +265,58 @@ ProgressMeter& CurOp::setMessage_inlock(const char* msg,
 
 CurOp::~CurOp() {
     invariant(this == _stack->pop());
+
+    if (_client && haveClient() && _client == &cc()) {
+        CurOp* parent = _stack->top();
+        if (parent && parent->_client == _client) {
+            parent->_updateSamplingProfilerTags();
+        } else {
+            SamplingProfiler::clearOperationTags();
+        }
+    }
+}
+
+void CurOp::_updateSamplingProfilerTags() const {
+    // The tags belong to the current thread, which may not be the one running this operation.
+    if (!_client || !haveClient() || _client != &cc() || _stack->top() != this) {
+        return;
+    }
+    SamplingProfiler::setOperationTags(
+        _command ? StringData(_command->getName()) : StringData(logicalOpToString(_logicalOp)),
+        _ns);
 }
 
 void CurOp::setNS_inlock(StringData ns) {
     _ns = ns.toString();
+    _updateSamplingProfilerTags();
 }
 
 //execCommandDatabase   ServiceEntryPointMongod::handleRequest
 void CurOp::ensureStarted() { //runQueryл
     if (_start == 0) {
         _start = curTimeMicros64();
+        if (haveClient()) {
+            _client = &cc();
+            _resourceUsageAtStart = ClientResourceUsage::get(_client).getTotals();
+            _updateSamplingProfilerTags();
+        }
+    }
+}
+
+void CurOp::done() {
+    _end = curTimeMicros64();
+    if (_client) {
+        const auto usage =
+            ClientResourceUsage::get(_client).getTotals().since(_resourceUsageAtStart);
+        _debug.cpuNanos = usage.cpuNanos;
+        _debug.allocBytes = usage.allocBytes;
     }
 }
 
 void CurOp::enter_inlock(const char* ns, boost::optional<int> dbProfileLevel) {
     ensureStarted();
     _ns = ns;
+    _updateSamplingProfilerTags();
     if (dbProfileLevel) {
         raiseDbProfileLevel(*dbProfileLevel);
     }
@@ -411,6 +449,17 @@ void CurOp::reportState(BSONObjBuilder* builder, bool truncateOps) {
     }
 
     builder->append("numYields", _numYields);
+
+    if (_client) {
+        const auto usage =
+            ClientResourceUsage::get(_client).getTotals().since(_resourceUsageAtStart);
+        if (usage.cpuNanos >= 0) {
+            builder->append("cpuNanos", usage.cpuNanos);
+        }
+        if (usage.allocBytes >= 0) {
+            builder->append("allocBytes", usage.allocBytes);
+        }
+    }
 }
 
 namespace {
@@ -536,6 +585,8 @@ string OpDebug::report(Client* client,
     }
 
     s << " numYields:" << curop.numYields();
+    OPDEBUG_TOSTRING_HELP(cpuNanos);
+    OPDEBUG_TOSTRING_HELP(allocBytes);
 
     OPDEBUG_TOSTRING_HELP(nreturned);
     if (responseLength > 0) {
@@ -557,6 +608,10 @@ string OpDebug::report(Client* client,
         s << " protocol:" << getProtoString(networkOp);
     }
 
+    if (const OperationTrace* trace = OperationTrace::get(client)) {
+        s << " trace:" << trace->toBSON().toString();
+    }
+
 	//executionTimeMicrosֵelapsedTimeExcludingPauses
     s << " " << (executionTimeMicros / 1000) << "ms";
 
@@ -627,6 +682,8 @@ void OpDebug::append(const CurOp& curop,
     }
 
     b.appendNumber("numYield", curop.numYields());
+    OPDEBUG_APPEND_NUMBER(cpuNanos);
+    OPDEBUG_APPEND_NUMBER(allocBytes);
 
     {
         BSONObjBuilder locks(b.subobjStart("locks"));
@@ -32,6 +32,7 @@
 #pragma once
 
 #include "mongo/base/disallow_copying.h"
+#include "mongo/db/client_resource_usage.h"
 #include "mongo/db/commands.h"
 #include "mongo/db/cursor_id.h"
 #include "mongo/db/operation_context.h"
@@ -105,6 +106,12 @@ public:
     // True if a replan was triggered during the execution of this operation.
     bool replanned{false};
 
+    // The namespace and plan cache key of the first query planned by this operation, under which
+    // the operation is recorded in the QueryStatsStore when it finishes. Only set while the store
+    // is enabled.
+    std::string queryShapeNs;
+    std::string queryShape;
+
     //ͳƼrecordCurOpMetrics
     long long nMatched{-1};   // number of records that match the query
     long long nModified{-1};  // number of records written (no no-ops)
@@ -133,6 +140,10 @@ public:
     // response info
     //ֵelapsedTimeExcludingPauses
     long long executionTimeMicros{0};
+    // Thread CPU time and bytes allocated between the start of the operation and done(), or -1 if
+    // they are not measured. See ClientResourceUsage.
+    long long cpuNanos{-1};
+    long long allocBytes{-1};
     long long nreturned{-1};
     int responseLength{-1};
 };
@@ -208,6 +219,7 @@ public:
     void setLogicalOp_inlock(LogicalOp op) {
         _logicalOp = op;
         _debug.logicalOp = op;
+        _updateSamplingProfilerTags();
     }
 
     /**
@@ -296,9 +308,7 @@ public:
         return _start; //_startֵCurOp::ensureStarted
     }
     //ʱ  finishCurOp(delete  update)   performInserts(insert)  ServiceEntryPointMongod::handleRequestִ
-    void done() { //_startֵCurOp::ensureStarted
-        _end = curTimeMicros64();
-    }
+    void done(); //_startֵCurOp::ensureStarted
     bool isDone() const {
         return _end > 0;
     }
@@ -388,6 +398,7 @@ public:
     }
     void setCommand_inlock(Command* command) {
         _command = command;
+        _updateSamplingProfilerTags();
     }
 
     /**
@@ -469,6 +480,12 @@ private:
 
     CurOp(OperationContext*, CurOpStack*);
 
+    /**
+     * Tags the CPU samples of the current thread with the type and namespace of this operation, if
+     * the thread is running it and it is the innermost operation of its Client.
+     */
+    void _updateSamplingProfilerTags() const;
+
     CurOpStack* _stack;
     CurOp* _parent{nullptr};
     Command* _command{nullptr};
@@ -487,6 +504,11 @@ private:
     // The cumulative duration for which the timer has been paused.
     Microseconds _totalPausedDuration{0};
 
+    // The Client running this operation and its resource usage when the operation started, if it
+    // was started by a thread with a Client.
+    Client* _client{nullptr};
+    ClientResourceUsage::Totals _resourceUsageAtStart;
+
     // _networkOp represents the network-level op code: OP_QUERY, OP_GET_MORE, OP_COMMAND, etc.
     NetworkOp _networkOp{opInvalid};  // only set this through setNetworkOp_inlock() to keep synced
     // _logicalOp is the logical operation type, ie 'dbQuery' regardless of whether this is an
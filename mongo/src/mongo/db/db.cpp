@@ -59,6 +59,7 @@
 #include "mongo/db/catalog/index_key_validate.h"
 #include "mongo/db/client.h"
 #include "mongo/db/clientcursor.h"
+#include "mongo/db/commands/cpu_sampling_profiler.h"
 #include "mongo/db/commands/feature_compatibility_version.h"
 #include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/concurrency/lock_state.h"
@@ -945,6 +946,8 @@ ExitCode _initAndListen(int listenPort) {
         waitForShardRegistryReload(startupOpCtx.get()).transitional_ignore();
     }
 
+    startCpuSamplingProfiler();
+
     if (!storageGlobalParams.readOnly) {
         logStartup(startupOpCtx.get());
 
@@ -42,6 +42,7 @@
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/operation_trace.h"
 #include "mongo/db/query/explain.h"
 #include "mongo/db/query/plan_cache.h"
 #include "mongo/db/query/plan_ranker.h"
@@ -249,6 +250,7 @@ Status MultiPlanStage::pickBestPlan(PlanYieldPolicy* yieldPolicy) {
     // execution work that happens here, so this is needed for the time accounting to
     // make sense.
     ScopedTimer timer(getClock(), &_commonStats.executionTimeMillis); 
+    OperationTrace::Span traceSpan(OperationTrace::Phase::kPlanSelection);
 
 	//ȡcollectionܼ¼*0.2910000Сɨ10000Σ10000ôɨcollection*0.29Ρ  
     size_t numWorks = getTrialPeriodWorks(getOpCtx(), _collection);
@@ -0,0 +1,147 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <vector>
+
+#include "mongo/db/exec/queued_data_stage.h"
+#include "mongo/db/exec/sort.h"
+#include "mongo/db/exec/sort_key_generator.h"
+#include "mongo/db/exec/working_set.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/service_context_noop.h"
+#include "mongo/platform/random.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/unittest/benchmark.h"
+#include "mongo/util/clock_source_mock.h"
+
+namespace mongo {
+namespace {
+
+using unittest::BenchmarkState;
+
+/**
+ * The service context, client and operation context the stages run with.
+ */
+class StageFixture {
+public:
+    StageFixture() {
+        _service.setFastClockSource(stdx::make_unique<ClockSourceMock>());
+        _client = _service.makeClient("benchmark");
+        _opCtx = _client->makeOperationContext();
+    }
+
+    OperationContext* opCtx() {
+        return _opCtx.get();
+    }
+
+private:
+    ServiceContextNoop _service;
+    ServiceContext::UniqueClient _client;
+    ServiceContext::UniqueOperationContext _opCtx;
+};
+
+std::vector<BSONObj> makeDocuments(long long count) {
+    PseudoRandom random(static_cast<int64_t>(count));
+    std::vector<BSONObj> docs;
+    docs.reserve(count);
+    for (long long i = 0; i < count; ++i) {
+        docs.push_back(BSON("_id" << i << "a" << random.nextInt32(1000) << "b"
+                                  << "a short string value"
+                                  << "c"
+                                  << random.nextInt64()));
+    }
+    return docs;
+}
+
+/**
+ * Queues each of 'docs' as an owned object in 'ws'.
+ */
+std::unique_ptr<QueuedDataStage> queueDocuments(OperationContext* opCtx,
+                                                WorkingSet* ws,
+                                                const std::vector<BSONObj>& docs) {
+    auto stage = stdx::make_unique<QueuedDataStage>(opCtx, ws);
+    for (auto&& doc : docs) {
+        WorkingSetID id = ws->allocate();
+        WorkingSetMember* member = ws->get(id);
+        member->obj = Snapshotted<BSONObj>(SnapshotId(), doc);
+        member->transitionToOwnedObj();
+        stage->pushBack(id);
+    }
+    return stage;
+}
+
+// Allocates and frees range() members at a time, as stages that buffer results do.
+void BM_WorkingSetAllocateFree(BenchmarkState& state) {
+    WorkingSet ws;
+    std::vector<WorkingSetID> ids(state.range());
+    while (state.keepRunning()) {
+        for (auto& id : ids) {
+            id = ws.allocate();
+        }
+        for (auto id : ids) {
+            ws.free(id);
+        }
+    }
+    state.setItemsProcessed(static_cast<long long>(state.iterations()) * ids.size());
+}
+
+// Runs a blocking sort of range() documents on two fields through the SortKeyGeneratorStage and
+// SortStage, the way a query without a suitable index does.
+void BM_SortStage(BenchmarkState& state) {
+    StageFixture fixture;
+    const auto docs = makeDocuments(state.range());
+    SortStageParams params;
+    params.pattern = BSON("a" << 1 << "c" << -1);
+
+    while (state.keepRunning()) {
+        state.pauseTiming();
+        WorkingSet ws;
+        auto queued = queueDocuments(fixture.opCtx(), &ws, docs);
+        state.resumeTiming();
+
+        auto sortKeyGen = stdx::make_unique<SortKeyGeneratorStage>(
+            fixture.opCtx(), queued.release(), &ws, params.pattern, nullptr);
+        SortStage sort(fixture.opCtx(), params, &ws, sortKeyGen.release());
+
+        WorkingSetID id = WorkingSet::INVALID_ID;
+        PlanStage::StageState stageState;
+        while ((stageState = sort.work(&id)) != PlanStage::IS_EOF) {
+            invariant(stageState == PlanStage::ADVANCED || stageState == PlanStage::NEED_TIME);
+        }
+    }
+    state.setItemsProcessed(static_cast<long long>(state.iterations()) * docs.size());
+}
+
+MONGO_BENCHMARK(BM_WorkingSetAllocateFree)->range(1, 1024);
+MONGO_BENCHMARK(BM_SortStage)->range(64, 64 * 1024);
+
+}  // namespace
+}  // namespace mongo
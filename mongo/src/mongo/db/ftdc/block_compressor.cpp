@@ -30,6 +30,7 @@
 
 #include "mongo/db/ftdc/block_compressor.h"
 
+#include <snappy.h>
 #include <zlib.h>
 
 #include "mongo/util/mongoutils/str.h"
@@ -116,4 +117,40 @@ StatusWith<ConstDataRange> BlockCompressor::uncompress(ConstDataRange source,
     return ConstDataRange(reinterpret_cast<char*>(_buffer.data()), stream.total_out);
 }
 
+StatusWith<ConstDataRange> BlockCompressor::compressSnappy(ConstDataRange source) {
+    _buffer.resize(snappy::MaxCompressedLength(source.length()));
+
+    size_t compressedLength = 0;
+    snappy::RawCompress(source.data(),
+                        source.length(),
+                        reinterpret_cast<char*>(_buffer.data()),
+                        &compressedLength);
+
+    return ConstDataRange(reinterpret_cast<char*>(_buffer.data()), compressedLength);
+}
+
+StatusWith<ConstDataRange> BlockCompressor::uncompressSnappy(ConstDataRange source,
+                                                             size_t maxUncompressedLength) {
+    size_t uncompressedLength = 0;
+    if (!snappy::GetUncompressedLength(source.data(), source.length(), &uncompressedLength)) {
+        return {ErrorCodes::BadValue, "Snappy compressed block is corrupt"};
+    }
+
+    if (uncompressedLength > maxUncompressedLength) {
+        return {ErrorCodes::BadValue,
+                str::stream() << "Snappy compressed block uncompresses to " << uncompressedLength
+                              << " bytes, more than the expected "
+                              << maxUncompressedLength};
+    }
+
+    _buffer.resize(uncompressedLength);
+
+    if (!snappy::RawUncompress(
+            source.data(), source.length(), reinterpret_cast<char*>(_buffer.data()))) {
+        return {ErrorCodes::BadValue, "Snappy compressed block is corrupt"};
+    }
+
+    return ConstDataRange(reinterpret_cast<char*>(_buffer.data()), uncompressedLength);
+}
+
 }  // namespace mongo
@@ -38,7 +38,8 @@
 namespace mongo {
 
 /**
- * Compesses and uncompresses a block of buffer using zlib.
+ * Compesses and uncompresses a block of buffer using zlib, or snappy which is several times faster
+ * at the cost of a worse compression ratio.
  */
 class BlockCompressor {
     MONGO_DISALLOW_COPYING(BlockCompressor);
@@ -65,6 +66,17 @@ public:
      */
     StatusWith<ConstDataRange> uncompress(ConstDataRange source, size_t maxUncompressedLength);
 
+    /**
+     * Compress a buffer of data using snappy. See compress().
+     */
+    StatusWith<ConstDataRange> compressSnappy(ConstDataRange source);
+
+    /**
+     * Uncompress a buffer of data compressed by compressSnappy(). See uncompress().
+     */
+    StatusWith<ConstDataRange> uncompressSnappy(ConstDataRange source,
+                                                size_t maxUncompressedLength);
+
 private:
     std::vector<std::uint8_t> _buffer;
 };
@@ -0,0 +1,192 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/ftdc/block_packing.h"
+
+#include <algorithm>
+
+#include "mongo/base/data_type_endian.h"
+#include "mongo/base/data_view.h"
+#include "mongo/db/ftdc/varint.h"
+#include "mongo/platform/bits.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+namespace FTDCBlockPacking {
+
+namespace {
+
+bool isZeroBlock(const std::uint64_t* values, std::size_t count) {
+    std::uint64_t bits = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        bits |= values[i];
+    }
+    return bits == 0;
+}
+
+void packBlock(const std::uint64_t (&block)[kBlockSize], int width, BufBuilder* builder) {
+    char out[kBlockSize * sizeof(std::uint64_t)];
+    std::size_t outLength = 0;
+
+    std::uint64_t word = 0;
+    int wordBits = 0;
+    for (std::size_t i = 0; i < kBlockSize; ++i) {
+        const std::uint64_t value = block[i];
+        word |= value << wordBits;
+        wordBits += width;
+        if (wordBits >= 64) {
+            DataView(out + outLength).write<LittleEndian<std::uint64_t>>(word);
+            outLength += sizeof(std::uint64_t);
+            wordBits -= 64;
+            // The high bits of the value which did not fit into the word start the next one.
+            word = wordBits ? value >> (width - wordBits) : 0;
+        }
+    }
+
+    // The block takes 2 * width bytes, so what remains is a whole number of bytes.
+    for (int shift = 0; shift < wordBits; shift += 8) {
+        out[outLength++] = static_cast<char>(word >> shift);
+    }
+
+    builder->appendBuf(out, outLength);
+}
+
+void unpackBlock(const unsigned char* in, int width, std::uint64_t (&block)[kBlockSize]) {
+    for (std::size_t i = 0; i < kBlockSize; ++i) {
+        const std::size_t firstBit = i * width;
+        std::uint64_t value = 0;
+        for (int bits = 0; bits < width;) {
+            const std::size_t bit = firstBit + bits;
+            const int shift = bit % 8;
+            const int take = std::min(8 - shift, width - bits);
+            const std::uint64_t part = (in[bit / 8] >> shift) & ((1u << take) - 1);
+            value |= part << bits;
+            bits += take;
+        }
+        block[i] = value;
+    }
+}
+
+}  // namespace
+
+void encode(const std::uint64_t* values, std::size_t count, BufBuilder* builder) {
+    std::size_t pos = 0;
+    while (pos < count) {
+        const std::size_t length = std::min(kBlockSize, count - pos);
+
+        std::uint64_t block[kBlockSize] = {};
+        std::copy(values + pos, values + pos + length, block);
+        pos += length;
+
+        std::uint64_t bits = 0;
+        for (std::size_t i = 0; i < kBlockSize; ++i) {
+            bits |= block[i];
+        }
+
+        if (bits == 0) {
+            std::uint64_t zeroBlocks = 0;
+            while (pos < count) {
+                const std::size_t nextLength = std::min(kBlockSize, count - pos);
+                if (!isZeroBlock(values + pos, nextLength)) {
+                    break;
+                }
+                pos += nextLength;
+                ++zeroBlocks;
+            }
+
+            char buf[FTDCVarInt::kMaxSizeBytes64];
+            DataRangeCursor cursor(buf, buf + sizeof(buf));
+            invariantOK(cursor.writeAndAdvance(FTDCVarInt(zeroBlocks)));
+
+            builder->appendUChar(0);
+            builder->appendBuf(buf, cursor.data() - buf);
+            continue;
+        }
+
+        const int width = 64 - countLeadingZeros64(bits);
+        builder->appendUChar(static_cast<unsigned char>(width));
+        packBlock(block, width, builder);
+    }
+}
+
+Status decode(ConstDataRangeCursor* cursor, std::size_t count, std::uint64_t* values) {
+    std::size_t pos = 0;
+    while (pos < count) {
+        auto swWidth = cursor->readAndAdvance<std::uint8_t>();
+        if (!swWidth.isOK()) {
+            return swWidth.getStatus();
+        }
+
+        const int width = swWidth.getValue();
+        if (width == 0) {
+            auto swZeroBlocks = cursor->readAndAdvance<FTDCVarInt>();
+            if (!swZeroBlocks.isOK()) {
+                return swZeroBlocks.getStatus();
+            }
+
+            const std::uint64_t zeroBlocks = swZeroBlocks.getValue();
+            const std::size_t blocksLeft = (count - pos + kBlockSize - 1) / kBlockSize;
+            if (zeroBlocks >= blocksLeft) {
+                return {ErrorCodes::BadValue,
+                        "Run of zeros in a packed block extends past the end of the values."};
+            }
+
+            const std::size_t zeros = std::min((zeroBlocks + 1) * kBlockSize, count - pos);
+            std::fill(values + pos, values + pos + zeros, 0);
+            pos += zeros;
+            continue;
+        }
+
+        if (width > 64) {
+            return {ErrorCodes::BadValue,
+                    str::stream() << "Packed block has an invalid bit width of " << width};
+        }
+
+        const std::size_t byteLength = 2 * width;
+        if (cursor->length() < byteLength) {
+            return {ErrorCodes::BadValue, "Packed block is truncated."};
+        }
+
+        std::uint64_t block[kBlockSize];
+        unpackBlock(reinterpret_cast<const unsigned char*>(cursor->data()), width, block);
+        invariantOK(cursor->advance(byteLength));
+
+        const std::size_t length = std::min(kBlockSize, count - pos);
+        std::copy(block, block + length, values + pos);
+        pos += length;
+    }
+
+    return Status::OK();
+}
+
+}  // namespace FTDCBlockPacking
+}  // namespace mongo
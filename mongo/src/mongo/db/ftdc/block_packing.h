@@ -0,0 +1,85 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "mongo/base/data_range_cursor.h"
+#include "mongo/base/status.h"
+#include "mongo/bson/util/builder.h"
+
+namespace mongo {
+
+/**
+ * Methods to pack arrays of 64-bit integers, most of which are small, into blocks of bits.
+ *
+ * Values are stored in blocks of kBlockSize. Each block starts with a byte holding the number of
+ * bits needed by the largest value of the block, followed by every value of the block packed into
+ * that many bits. A block of values which are all zero is instead followed by a VarInt count of
+ * the all zero blocks immediately after it, so that long runs of zeros take two bytes.
+ *
+ * Unlike VarInt encoding, which needs at least a byte per value, values which fit into a few bits
+ * take a few bits. Blocks have a fixed size so that the loops over them can be unrolled and
+ * vectorized by the compiler.
+ */
+namespace FTDCBlockPacking {
+
+/**
+ * Number of values in a block. A block of values packed into N bits each takes 2 * N bytes.
+ */
+const std::size_t kBlockSize = 16;
+
+/**
+ * Appends 'count' values to 'builder'.
+ */
+void encode(const std::uint64_t* values, std::size_t count, BufBuilder* builder);
+
+/**
+ * Reads 'count' values from 'cursor' into 'values', and advances 'cursor' past them.
+ *
+ * Returns an error if the buffer is too short or corrupt.
+ */
+Status decode(ConstDataRangeCursor* cursor, std::size_t count, std::uint64_t* values);
+
+/**
+ * Maps signed integers to unsigned integers so that values of small magnitude, whether they are
+ * positive or negative, are small.
+ */
+inline std::uint64_t zigZagEncode(std::int64_t value) {
+    return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+}
+
+inline std::int64_t zigZagDecode(std::uint64_t value) {
+    return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+}
+
+}  // namespace FTDCBlockPacking
+}  // namespace mongo
@@ -0,0 +1,133 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include <limits>
+#include <vector>
+
+#include "mongo/db/ftdc/block_packing.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+
+void TestRoundTrip(const std::vector<std::uint64_t>& values) {
+    BufBuilder builder;
+    FTDCBlockPacking::encode(values.data(), values.size(), &builder);
+
+    std::vector<std::uint64_t> decoded(values.size(), 1);
+    ConstDataRangeCursor cursor(builder.buf(), builder.buf() + builder.len());
+    ASSERT_OK(FTDCBlockPacking::decode(&cursor, decoded.size(), decoded.data()));
+
+    ASSERT_EQUALS(cursor.length(), 0U);
+    ASSERT_TRUE(values == decoded);
+}
+
+// Test every bit width round trips, in full and partial blocks
+TEST(FTDCBlockPackingTest, TestWidths) {
+    for (int width = 1; width <= 64; width++) {
+        const std::uint64_t max = width == 64 ? std::numeric_limits<std::uint64_t>::max()
+                                              : (std::uint64_t(1) << width) - 1;
+        for (size_t count : {1, 7, 16, 17, 40}) {
+            std::vector<std::uint64_t> values;
+            for (size_t i = 0; i < count; i++) {
+                values.push_back(i % 3 == 0 ? max : (max / (i + 2)));
+            }
+            TestRoundTrip(values);
+        }
+    }
+}
+
+// Test runs of zeros, including runs which end part way through a block
+TEST(FTDCBlockPackingTest, TestZeros) {
+    TestRoundTrip({});
+    TestRoundTrip(std::vector<std::uint64_t>(5, 0));
+    TestRoundTrip(std::vector<std::uint64_t>(1000, 0));
+
+    std::vector<std::uint64_t> values(1000, 0);
+    values[3] = 1;
+    values[500] = 12345;
+    values[999] = 7;
+    TestRoundTrip(values);
+}
+
+// Test runs of zeros are stored in a couple of bytes and small values in a few bits
+TEST(FTDCBlockPackingTest, TestSize) {
+    BufBuilder zeros;
+    std::vector<std::uint64_t> values(FTDCBlockPacking::kBlockSize * 100, 0);
+    FTDCBlockPacking::encode(values.data(), values.size(), &zeros);
+    ASSERT_EQUALS(zeros.len(), 2);
+
+    BufBuilder small;
+    std::fill(values.begin(), values.end(), 3);
+    FTDCBlockPacking::encode(values.data(), values.size(), &small);
+    ASSERT_EQUALS(small.len(), 100 * (1 + 4));
+}
+
+// Test corrupt input is rejected
+TEST(FTDCBlockPackingTest, TestCorrupt) {
+    std::vector<std::uint64_t> values(20, 1000);
+    BufBuilder builder;
+    FTDCBlockPacking::encode(values.data(), values.size(), &builder);
+
+    std::vector<std::uint64_t> decoded(values.size());
+
+    // Truncated
+    ConstDataRangeCursor truncated(builder.buf(), builder.buf() + builder.len() - 1);
+    ASSERT_NOT_OK(FTDCBlockPacking::decode(&truncated, decoded.size(), decoded.data()));
+
+    // Invalid bit width
+    const char badWidth[] = {65, 0, 0};
+    ConstDataRangeCursor badWidthCursor(badWidth, badWidth + sizeof(badWidth));
+    ASSERT_NOT_OK(FTDCBlockPacking::decode(&badWidthCursor, decoded.size(), decoded.data()));
+
+    // Run of zeros longer than the values
+    const char longRun[] = {0, 5};
+    ConstDataRangeCursor longRunCursor(longRun, longRun + sizeof(longRun));
+    ASSERT_NOT_OK(FTDCBlockPacking::decode(&longRunCursor, decoded.size(), decoded.data()));
+}
+
+// Test ZigZag encoding keeps values of small magnitude small
+TEST(FTDCBlockPackingTest, TestZigZag) {
+    ASSERT_EQUALS(FTDCBlockPacking::zigZagEncode(0), 0U);
+    ASSERT_EQUALS(FTDCBlockPacking::zigZagEncode(-1), 1U);
+    ASSERT_EQUALS(FTDCBlockPacking::zigZagEncode(1), 2U);
+    ASSERT_EQUALS(FTDCBlockPacking::zigZagEncode(-2), 3U);
+
+    for (std::int64_t value : {std::int64_t(0),
+                               std::int64_t(-1),
+                               std::int64_t(123456789),
+                               std::numeric_limits<std::int64_t>::min(),
+                               std::numeric_limits<std::int64_t>::max()}) {
+        ASSERT_EQUALS(FTDCBlockPacking::zigZagDecode(FTDCBlockPacking::zigZagEncode(value)),
+                      value);
+    }
+}
+
+}  // namespace mongo
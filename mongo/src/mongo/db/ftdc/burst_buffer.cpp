@@ -0,0 +1,140 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/ftdc/burst_buffer.h"
+
+#include <boost/filesystem.hpp>
+#include <fstream>
+
+#include "mongo/db/ftdc/util.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+
+FTDCBurstBuffer::FTDCBurstBuffer(const FTDCConfig* config, std::size_t maxSizeBytes)
+    : _maxSizeBytes(maxSizeBytes), _compressor(config) {}
+
+Status FTDCBurstBuffer::addSample(const BSONObj& sample, Date_t date) {
+    auto ret = _compressor.addSample(sample, date);
+
+    if (!ret.isOK()) {
+        return ret.getStatus();
+    }
+
+    ++_sampleCount;
+
+    if (!ret.getValue().is_initialized()) {
+        ++_pendingSampleCount;
+        return Status::OK();
+    }
+
+    auto& chunk = ret.getValue().get();
+
+    // A full compressor has compressed this sample along with the previous ones, but on a schema
+    // change this sample becomes the reference document of the next chunk instead.
+    if (std::get<1>(chunk) == FTDCCompressor::CompressorState::kCompressorFull) {
+        _appendChunk(std::get<0>(chunk), std::get<2>(chunk), _pendingSampleCount + 1);
+        _pendingSampleCount = 0;
+    } else {
+        _appendChunk(std::get<0>(chunk), std::get<2>(chunk), _pendingSampleCount);
+        _pendingSampleCount = 1;
+    }
+
+    return Status::OK();
+}
+
+void FTDCBurstBuffer::_appendChunk(ConstDataRange buf, Date_t date, std::size_t sampleCount) {
+    BSONObj o = FTDCBSONUtil::createBSONMetricChunkDocument(
+        buf, date, _compressor.getCompressedChunkType());
+
+    _size += o.objsize();
+    _chunks.emplace_back(std::move(o), sampleCount);
+
+    // Always keep the newest chunk, even if it alone is over the limit
+    while (_size > _maxSizeBytes && _chunks.size() > 1) {
+        _size -= _chunks.front().first.objsize();
+        _droppedSampleCount += _chunks.front().second;
+        _chunks.pop_front();
+    }
+}
+
+Status FTDCBurstBuffer::writeFile(const boost::filesystem::path& file,
+                                  const BSONObj& metadata,
+                                  Date_t date) {
+    if (_compressor.hasDataToFlush()) {
+        auto swBuf = _compressor.getCompressedSamples();
+        if (!swBuf.isOK()) {
+            return swBuf.getStatus();
+        }
+
+        _appendChunk(std::get<0>(swBuf.getValue()),
+                     std::get<1>(swBuf.getValue()),
+                     _pendingSampleCount);
+        _pendingSampleCount = 0;
+    }
+
+    auto tempFile = file;
+    tempFile += ".temp";
+
+    std::ofstream stream;
+    stream.open(tempFile.c_str(),
+                std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+
+    if (!stream.is_open()) {
+        return Status(ErrorCodes::FileNotOpen,
+                      "Failed to open burst file " + tempFile.generic_string());
+    }
+
+    BSONObj wrapped = FTDCBSONUtil::createBSONMetadataDocument(metadata, date);
+    stream.write(wrapped.objdata(), wrapped.objsize());
+
+    for (auto& chunk : _chunks) {
+        stream.write(chunk.first.objdata(), chunk.first.objsize());
+    }
+
+    stream.close();
+
+    if (stream.fail()) {
+        return {ErrorCodes::FileStreamFailed,
+                str::stream()
+                    << "Failed to write burst file for full-time diagnostic data capture: "
+                    << tempFile.generic_string()};
+    }
+
+    boost::system::error_code ec;
+    boost::filesystem::rename(tempFile, file, ec);
+    if (ec) {
+        return Status(ErrorCodes::FileRenameFailed, ec.message());
+    }
+
+    return Status::OK();
+}
+
+}  // namespace mongo
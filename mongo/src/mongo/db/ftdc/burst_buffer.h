@@ -0,0 +1,123 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#pragma once
+
+#include <boost/filesystem/path.hpp>
+#include <cstddef>
+#include <deque>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/status.h"
+#include "mongo/db/ftdc/compressor.h"
+#include "mongo/db/ftdc/config.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+/**
+ * Bounded in-memory ring of the samples collected during a burst of high-frequency sampling.
+ *
+ * Samples are compressed into metric chunks as they arrive so a burst of a few thousand samples
+ * only costs a few megabytes. Once the compressed chunks exceed the size limit, the oldest chunks
+ * are dropped so the buffer always holds the end of the burst.
+ *
+ * Nothing is written to disk until writeFile() is called.
+ *
+ * Not Thread-Safe.
+ */
+class FTDCBurstBuffer {
+    MONGO_DISALLOW_COPYING(FTDCBurstBuffer);
+
+public:
+    FTDCBurstBuffer(const FTDCConfig* config, std::size_t maxSizeBytes);
+
+    /**
+     * Add a sample to the buffer, dropping the oldest chunk of samples if the buffer is full.
+     */
+    Status addSample(const BSONObj& sample, Date_t date);
+
+    /**
+     * Compress any pending samples, and write the buffer to a new file as a metadata document
+     * followed by metric chunks, in the same format as an FTDC archive file.
+     *
+     * The file is written to a temporary file first and renamed into place so readers never see a
+     * partially written file.
+     */
+    Status writeFile(const boost::filesystem::path& file, const BSONObj& metadata, Date_t date);
+
+    /**
+     * Number of samples added to the buffer, including those that have since been dropped.
+     */
+    std::size_t getSampleCount() const {
+        return _sampleCount;
+    }
+
+    /**
+     * Number of samples dropped because the buffer was full.
+     */
+    std::size_t getDroppedSampleCount() const {
+        return _droppedSampleCount;
+    }
+
+    /**
+     * Size of the compressed chunks held in memory.
+     */
+    std::size_t getSize() const {
+        return _size;
+    }
+
+private:
+    /**
+     * Append a compressed chunk, and drop the oldest chunks if over the limit.
+     */
+    void _appendChunk(ConstDataRange buf, Date_t date, std::size_t sampleCount);
+
+private:
+    // Max size of _chunks in bytes
+    const std::size_t _maxSizeBytes;
+
+    // Compressor for the samples not yet in a chunk
+    FTDCCompressor _compressor;
+
+    // Compressed metric chunk documents and the number of samples in each, oldest first
+    std::deque<std::pair<BSONObj, std::size_t>> _chunks;
+
+    // Sum of the sizes of the documents in _chunks
+    std::size_t _size{0};
+
+    // Number of samples held by _compressor
+    std::size_t _pendingSampleCount{0};
+
+    std::size_t _sampleCount{0};
+
+    std::size_t _droppedSampleCount{0};
+};
+
+}  // namespace mongo
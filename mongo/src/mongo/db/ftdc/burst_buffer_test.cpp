@@ -0,0 +1,139 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <boost/filesystem.hpp>
+
+#include "mongo/bson/bsonmisc.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/ftdc/burst_buffer.h"
+#include "mongo/db/ftdc/config.h"
+#include "mongo/db/ftdc/ftdc_test.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/unittest/temp_dir.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+
+namespace {
+
+BSONObj generateSample(int i) {
+    // Change the schema half way through to start a new chunk early
+    if (i >= 12) {
+        return BSON("name"
+                    << "joe"
+                    << "key1"
+                    << (i * 37)
+                    << "key2"
+                    << (i * 3)
+                    << "key3"
+                    << i);
+    }
+
+    return BSON("name"
+                << "joe"
+                << "key1"
+                << (i * 37)
+                << "key2"
+                << (i * 3));
+}
+
+}  // namespace
+
+// Test all the samples are written to the file after the metadata document
+TEST(FTDCBurstBufferTest, TestWriteFile) {
+    unittest::TempDir tempdir("metrics_testpath");
+    boost::filesystem::path dir(tempdir.path());
+
+    createDirectoryClean(dir);
+
+    FTDCConfig config;
+    config.maxSamplesPerArchiveMetricChunk = 5;
+
+    FTDCBurstBuffer buffer(&config, FTDCConfig::kBurstMaxBufferBytes);
+
+    BSONObj metadata = BSON("burst" << BSON("reason"
+                                            << "test"));
+    std::vector<BSONObj> docs{metadata};
+
+    for (int i = 0; i < 25; i++) {
+        BSONObj sample = generateSample(i);
+        ASSERT_OK(buffer.addSample(sample, Date_t()));
+        docs.emplace_back(sample);
+    }
+
+    ASSERT_EQUALS(buffer.getSampleCount(), 25UL);
+    ASSERT_EQUALS(buffer.getDroppedSampleCount(), 0UL);
+
+    auto file = dir / "metrics.burst";
+    ASSERT_OK(buffer.writeFile(file, metadata, Date_t()));
+
+    ValidateDocumentList(file, docs);
+
+    // Only the final file is left behind
+    ASSERT_EQUALS(scanDirectory(dir).size(), 1UL);
+}
+
+// Test the oldest samples are dropped when the buffer is full
+TEST(FTDCBurstBufferTest, TestDropOldest) {
+    unittest::TempDir tempdir("metrics_testpath");
+    boost::filesystem::path dir(tempdir.path());
+
+    createDirectoryClean(dir);
+
+    FTDCConfig config;
+    config.maxSamplesPerArchiveMetricChunk = 5;
+
+    // Only room for a single chunk
+    FTDCBurstBuffer buffer(&config, 1);
+
+    BSONObj metadata = BSON("burst" << BSON("reason"
+                                            << "test"));
+    std::vector<BSONObj> docs{metadata};
+
+    for (int i = 0; i < 8; i++) {
+        BSONObj sample = generateSample(i);
+        ASSERT_OK(buffer.addSample(sample, Date_t()));
+
+        // The first 5 samples fill the first chunk, which is dropped for the last chunk
+        if (i >= 5) {
+            docs.emplace_back(sample);
+        }
+    }
+
+    auto file = dir / "metrics.burst";
+    ASSERT_OK(buffer.writeFile(file, metadata, Date_t()));
+
+    ASSERT_EQUALS(buffer.getSampleCount(), 8UL);
+    ASSERT_EQUALS(buffer.getDroppedSampleCount(), 5UL);
+
+    ValidateDocumentList(file, docs);
+}
+
+}  // namespace mongo
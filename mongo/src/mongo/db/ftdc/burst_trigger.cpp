@@ -0,0 +1,83 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/ftdc/burst_trigger.h"
+
+#include "mongo/db/service_context.h"
+#include "mongo/util/clock_source.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+
+namespace {
+
+const auto getFTDCBurstTrigger = ServiceContext::declareDecoration<FTDCBurstTrigger>();
+
+}  // namespace
+
+const Seconds FTDCBurstTrigger::kCooldown{300};
+
+FTDCBurstTrigger* FTDCBurstTrigger::get(ServiceContext* serviceContext) {
+    return &getFTDCBurstTrigger(serviceContext);
+}
+
+void FTDCBurstTrigger::setBurstFunction(BurstFunction burstFunction) {
+    _burstFunction = std::move(burstFunction);
+}
+
+void FTDCBurstTrigger::setLatencyThreshold(Milliseconds threshold) {
+    _thresholdMicros.store(durationCount<Microseconds>(threshold));
+}
+
+bool FTDCBurstTrigger::_fire(ClockSource* clockSource, Microseconds latency) {
+    const long long now = clockSource->now().toMillisSinceEpoch();
+    const long long last = _lastFiredMillis.load();
+
+    if (last != kNeverFired && now - last < durationCount<Milliseconds>(kCooldown)) {
+        return false;
+    }
+
+    // Only the operation which wins the race fires the trigger
+    if (_lastFiredMillis.compareAndSwap(last, now) != last) {
+        return false;
+    }
+
+    if (_burstFunction) {
+        _burstFunction(str::stream() << "operation latency of "
+                                     << durationCount<Milliseconds>(latency)
+                                     << "ms exceeded the threshold of "
+                                     << _thresholdMicros.load() / 1000
+                                     << "ms");
+    }
+
+    return true;
+}
+
+}  // namespace mongo
@@ -0,0 +1,109 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#pragma once
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/platform/compiler.h"
+#include "mongo/stdx/functional.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+class ClockSource;
+class ServiceContext;
+
+/**
+ * Starts a burst of high-frequency diagnostic data capture when an operation takes longer than a
+ * latency threshold.
+ *
+ * Checking an operation against the threshold is a single atomic load so it can be done at the
+ * end of every operation. Once the trigger fires it does not fire again until kCooldown has
+ * passed, so a long stall which slows down many operations requests a single burst.
+ */
+class FTDCBurstTrigger {
+    MONGO_DISALLOW_COPYING(FTDCBurstTrigger);
+
+public:
+    /**
+     * Called with a description of why the trigger fired.
+     */
+    using BurstFunction = stdx::function<void(StringData reason)>;
+
+    static const Seconds kCooldown;
+
+    FTDCBurstTrigger() = default;
+
+    /**
+     * Get the FTDCBurstTrigger from ServiceContext.
+     */
+    static FTDCBurstTrigger* get(ServiceContext* serviceContext);
+
+    /**
+     * Set the function to call when the trigger fires.
+     *
+     * Not thread-safe, must be called before any operations are run.
+     */
+    void setBurstFunction(BurstFunction burstFunction);
+
+    /**
+     * Set the operation latency which fires the trigger. Zero disables the trigger.
+     */
+    void setLatencyThreshold(Milliseconds threshold);
+
+    /**
+     * Note the latency of a completed operation. Returns true if this fired the trigger.
+     */
+    bool noteOperationLatency(ClockSource* clockSource, Microseconds latency) {
+        const long long threshold = _thresholdMicros.load();
+        if (MONGO_likely(threshold == 0 || durationCount<Microseconds>(latency) < threshold)) {
+            return false;
+        }
+
+        return _fire(clockSource, latency);
+    }
+
+private:
+    bool _fire(ClockSource* clockSource, Microseconds latency);
+
+private:
+    // Value of _lastFiredMillis before the trigger has ever fired
+    static const long long kNeverFired = -1;
+
+    // Latency threshold in microseconds, zero if disabled
+    AtomicInt64 _thresholdMicros{0};
+
+    // Time the trigger last fired in milliseconds since the epoch
+    AtomicInt64 _lastFiredMillis{kNeverFired};
+
+    BurstFunction _burstFunction;
+};
+
+}  // namespace mongo
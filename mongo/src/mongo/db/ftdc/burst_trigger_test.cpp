@@ -0,0 +1,82 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <string>
+#include <vector>
+
+#include "mongo/db/ftdc/burst_trigger.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/clock_source_mock.h"
+
+namespace mongo {
+
+// Test the trigger does nothing until a threshold is set
+TEST(FTDCBurstTriggerTest, TestDisabled) {
+    ClockSourceMock clockSource;
+    FTDCBurstTrigger trigger;
+
+    int bursts = 0;
+    trigger.setBurstFunction([&](StringData reason) { ++bursts; });
+
+    ASSERT_FALSE(trigger.noteOperationLatency(&clockSource, Hours(1)));
+
+    trigger.setLatencyThreshold(Milliseconds(100));
+    trigger.setLatencyThreshold(Milliseconds(0));
+
+    ASSERT_FALSE(trigger.noteOperationLatency(&clockSource, Hours(1)));
+    ASSERT_EQUALS(bursts, 0);
+}
+
+// Test the trigger fires on slow operations, and then waits for the cooldown
+TEST(FTDCBurstTriggerTest, TestThresholdAndCooldown) {
+    ClockSourceMock clockSource;
+    FTDCBurstTrigger trigger;
+
+    std::vector<std::string> reasons;
+    trigger.setBurstFunction([&](StringData reason) { reasons.push_back(reason.toString()); });
+    trigger.setLatencyThreshold(Milliseconds(100));
+
+    ASSERT_FALSE(trigger.noteOperationLatency(&clockSource, Microseconds(99999)));
+    ASSERT_TRUE(trigger.noteOperationLatency(&clockSource, Milliseconds(100)));
+    ASSERT_EQUALS(reasons.size(), 1UL);
+    ASSERT_EQUALS(reasons[0], "operation latency of 100ms exceeded the threshold of 100ms");
+
+    // Still cooling down
+    ASSERT_FALSE(trigger.noteOperationLatency(&clockSource, Seconds(10)));
+    clockSource.advance(FTDCBurstTrigger::kCooldown - Milliseconds(1));
+    ASSERT_FALSE(trigger.noteOperationLatency(&clockSource, Seconds(10)));
+    ASSERT_EQUALS(reasons.size(), 1UL);
+
+    clockSource.advance(Milliseconds(1));
+    ASSERT_TRUE(trigger.noteOperationLatency(&clockSource, Seconds(10)));
+    ASSERT_EQUALS(reasons.size(), 2UL);
+}
+
+}  // namespace mongo
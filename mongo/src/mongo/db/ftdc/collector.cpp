@@ -38,10 +38,32 @@
 #include "mongo/db/ftdc/util.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/util/time_support.h"
 
 namespace mongo {
 
+namespace {
+
+stdx::mutex burstCollectorFactoriesMutex;
+std::vector<FTDCCollectorFactory> burstCollectorFactories;
+
+}  // namespace
+
+void registerFTDCBurstCollectorFactory(FTDCCollectorFactory factory) {
+    stdx::lock_guard<stdx::mutex> lk(burstCollectorFactoriesMutex);
+    burstCollectorFactories.push_back(std::move(factory));
+}
+
+std::vector<std::unique_ptr<FTDCCollectorInterface>> makeRegisteredFTDCBurstCollectors() {
+    stdx::lock_guard<stdx::mutex> lk(burstCollectorFactoriesMutex);
+    std::vector<std::unique_ptr<FTDCCollectorInterface>> collectors;
+    for (auto&& factory : burstCollectorFactories) {
+        collectors.push_back(factory());
+    }
+    return collectors;
+}
+
 void FTDCCollectorCollection::add(std::unique_ptr<FTDCCollectorInterface> collector) {
     // TODO: ensure the collectors all have unique names.
     _collectors.emplace_back(std::move(collector));
@@ -33,6 +33,7 @@
 #include <vector>
 
 #include "mongo/base/disallow_copying.h"
+#include "mongo/stdx/functional.h"
 
 namespace mongo {
 
@@ -72,6 +73,27 @@ protected:
     FTDCCollectorInterface() = default;
 };
 
+/**
+ * Builds a collector for a component which the FTDC server code can't reach directly, such as the
+ * storage engine.
+ */
+using FTDCCollectorFactory = stdx::function<std::unique_ptr<FTDCCollectorInterface>()>;
+
+/**
+ * Registers 'factory' to build an additional burst collector each time FTDC starts. Must be called
+ * before FTDC starts, e.g. when the storage engine is created.
+ *
+ * Thread-Safe.
+ */
+void registerFTDCBurstCollectorFactory(FTDCCollectorFactory factory);
+
+/**
+ * Returns the collectors built by the registered burst collector factories.
+ *
+ * Thread-Safe.
+ */
+std::vector<std::unique_ptr<FTDCCollectorInterface>> makeRegisteredFTDCBurstCollectors();
+
 /**
  * Manages the set of BSON collectors
  *
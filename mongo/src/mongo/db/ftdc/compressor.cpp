@@ -31,6 +31,7 @@
 #include "mongo/db/ftdc/compressor.h"
 
 #include "mongo/base/data_builder.h"
+#include "mongo/db/ftdc/block_packing.h"
 #include "mongo/db/ftdc/config.h"
 #include "mongo/db/ftdc/util.h"
 #include "mongo/db/ftdc/varint.h"
@@ -45,25 +46,36 @@ using std::swap;
 StatusWith<boost::optional<std::tuple<ConstDataRange, FTDCCompressor::CompressorState, Date_t>>>
 FTDCCompressor::addSample(const BSONObj& sample, Date_t date) {
     if (_referenceDoc.isEmpty()) {
-        FTDCBSONUtil::extractMetricsFromDocument(sample, sample, &_metrics)
-            .status_with_transitional_ignore();
+        if (!_schemaCache.extractMetrics(sample, &_metrics)) {
+            FTDCBSONUtil::extractMetricsFromDocument(sample, sample, &_metrics)
+                .status_with_transitional_ignore();
+        }
         _reset(sample, date);
         return {boost::none};
     }
 
     _metrics.resize(0);
 
-    auto swMatches = FTDCBSONUtil::extractMetricsFromDocument(_referenceDoc, sample, &_metrics);
+    // A sample laid out like the last one which matched the reference document matches it too.
+    bool matches = _schemaCache.extractMetrics(sample, &_metrics);
+    if (!matches) {
+        auto swMatches = FTDCBSONUtil::extractMetricsFromDocument(_referenceDoc, sample, &_metrics);
+
+        if (!swMatches.isOK()) {
+            return swMatches.getStatus();
+        }
 
-    if (!swMatches.isOK()) {
-        return swMatches.getStatus();
+        matches = swMatches.getValue();
+        if (matches) {
+            _schemaCache.learn(sample);
+        }
     }
 
-    dassert((swMatches.getValue() == false || _metricsCount == _metrics.size()) &&
+    dassert((matches == false || _metricsCount == _metrics.size()) &&
             _metrics.size() < std::numeric_limits<std::uint32_t>::max());
 
     // We need to flush the current set of samples since the BSON schema has changed.
-    if (!swMatches.getValue()) {
+    if (!matches) {
         auto swCompressedSamples = getCompressedSamples();
 
         if (!swCompressedSamples.isOK()) {
@@ -124,58 +136,71 @@ StatusWith<std::tuple<ConstDataRange, Date_t>> FTDCCompressor::getCompressedSamp
     _uncompressedChunkBuffer.appendNum(static_cast<std::uint32_t>(_deltaCount));
 
     if (_metricsCount != 0 && _deltaCount != 0) {
-        // On average, we do not need all 10 bytes for every sample, worst case, we grow the buffer
-        DataBuilder db(_metricsCount * _deltaCount * FTDCVarInt::kMaxSizeBytes64 / 2);
-
-        std::uint32_t zeroesCount = 0;
-
-        // For each set of samples for a particular metric,
-        // we think of it is simple array of 64-bit integers we try to compress into a byte array.
-        // This is done in three steps for each metric
-        // 1. Delta Compression
-        //   - i.e., we store the difference between pairs of samples, not their absolute values
-        //   - this is done in addSamples
-        // 2. Run Length Encoding of zeros
-        //   - We find consecutive sets of zeros and represent them as a tuple of (0, count - 1).
-        //   - Each memeber is stored as VarInt packed integer
-        // 3. Finally, for non-zero members, we store these as VarInt packed
-        //
-        // These byte arrays are added to a buffer which is then concatenated with other chunks and
-        // compressed with ZLIB.
-        for (std::uint32_t i = 0; i < _metricsCount; i++) {
-            for (std::uint32_t j = 0; j < _deltaCount; j++) {
-                std::uint64_t delta = _deltas[getArrayOffset(_maxDeltas, j, i)];
-
-                if (delta == 0) {
-                    ++zeroesCount;
-                    continue;
-                }
+        if (_compact) {
+            _appendCompactDeltas();
+        } else {
+            Status status = _appendDeltas();
+            if (!status.isOK()) {
+                return status;
+            }
+        }
+    }
+
+    const ConstDataRange uncompressed(_uncompressedChunkBuffer.buf(),
+                                      _uncompressedChunkBuffer.len());
+    auto swDest = _compact ? _compressor.compressSnappy(uncompressed)
+                           : _compressor.compress(uncompressed);
+
+    // The only way for compression to fail is if the buffer size calculations are wrong
+    if (!swDest.isOK()) {
+        return swDest.getStatus();
+    }
 
-                // If we have a non-zero sample, then write out all the accumulated zero samples.
-                if (zeroesCount > 0) {
-                    auto s1 = db.writeAndAdvance(FTDCVarInt(0));
-                    if (!s1.isOK()) {
-                        return s1;
-                    }
+    _compressedChunkBuffer.setlen(0);
 
-                    auto s2 = db.writeAndAdvance(FTDCVarInt(zeroesCount - 1));
-                    if (!s2.isOK()) {
-                        return s2;
-                    }
+    _compressedChunkBuffer.appendNum(static_cast<std::uint32_t>(_uncompressedChunkBuffer.len()));
 
-                    zeroesCount = 0;
-                }
+    _compressedChunkBuffer.appendBuf(swDest.getValue().data(), swDest.getValue().length());
 
-                auto s3 = db.writeAndAdvance(FTDCVarInt(delta));
-                if (!s3.isOK()) {
-                    return s3;
-                }
+    _compressedChunkType = _compact ? FTDCBSONUtil::FTDCType::kCompactMetricChunk
+                                    : FTDCBSONUtil::FTDCType::kMetricChunk;
+
+    return std::tuple<ConstDataRange, Date_t>(
+        ConstDataRange(_compressedChunkBuffer.buf(),
+                       static_cast<size_t>(_compressedChunkBuffer.len())),
+        _referenceDocDate);
+}
+
+Status FTDCCompressor::_appendDeltas() {
+    // On average, we do not need all 10 bytes for every sample, worst case, we grow the buffer
+    DataBuilder db(_metricsCount * _deltaCount * FTDCVarInt::kMaxSizeBytes64 / 2);
+
+    std::uint32_t zeroesCount = 0;
+
+    // For each set of samples for a particular metric,
+    // we think of it is simple array of 64-bit integers we try to compress into a byte array.
+    // This is done in three steps for each metric
+    // 1. Delta Compression
+    //   - i.e., we store the difference between pairs of samples, not their absolute values
+    //   - this is done in addSamples
+    // 2. Run Length Encoding of zeros
+    //   - We find consecutive sets of zeros and represent them as a tuple of (0, count - 1).
+    //   - Each memeber is stored as VarInt packed integer
+    // 3. Finally, for non-zero members, we store these as VarInt packed
+    //
+    // These byte arrays are added to a buffer which is then concatenated with other chunks and
+    // compressed with ZLIB.
+    for (std::uint32_t i = 0; i < _metricsCount; i++) {
+        for (std::uint32_t j = 0; j < _deltaCount; j++) {
+            std::uint64_t delta = _deltas[getArrayOffset(_maxDeltas, j, i)];
+
+            if (delta == 0) {
+                ++zeroesCount;
+                continue;
             }
 
-            // If we are on the last metric, and the previous loop ended in a zero, write out the
-            // RLE
-            // pair of zero information.
-            if ((i == (_metricsCount - 1)) && zeroesCount) {
+            // If we have a non-zero sample, then write out all the accumulated zero samples.
+            if (zeroesCount > 0) {
                 auto s1 = db.writeAndAdvance(FTDCVarInt(0));
                 if (!s1.isOK()) {
                     return s1;
@@ -185,32 +210,56 @@ StatusWith<std::tuple<ConstDataRange, Date_t>> FTDCCompressor::getCompressedSamp
                 if (!s2.isOK()) {
                     return s2;
                 }
+
+                zeroesCount = 0;
             }
-        }
 
-        // Append the entire compacted metric chunk into the uncompressed buffer
-        ConstDataRange cdr = db.getCursor();
-        _uncompressedChunkBuffer.appendBuf(cdr.data(), cdr.length());
-    }
+            auto s3 = db.writeAndAdvance(FTDCVarInt(delta));
+            if (!s3.isOK()) {
+                return s3;
+            }
+        }
 
-    auto swDest = _compressor.compress(
-        ConstDataRange(_uncompressedChunkBuffer.buf(), _uncompressedChunkBuffer.len()));
+        // If we are on the last metric, and the previous loop ended in a zero, write out the
+        // RLE
+        // pair of zero information.
+        if ((i == (_metricsCount - 1)) && zeroesCount) {
+            auto s1 = db.writeAndAdvance(FTDCVarInt(0));
+            if (!s1.isOK()) {
+                return s1;
+            }
 
-    // The only way for compression to fail is if the buffer size calculations are wrong
-    if (!swDest.isOK()) {
-        return swDest.getStatus();
+            auto s2 = db.writeAndAdvance(FTDCVarInt(zeroesCount - 1));
+            if (!s2.isOK()) {
+                return s2;
+            }
+        }
     }
 
-    _compressedChunkBuffer.setlen(0);
+    // Append the entire compacted metric chunk into the uncompressed buffer
+    ConstDataRange cdr = db.getCursor();
+    _uncompressedChunkBuffer.appendBuf(cdr.data(), cdr.length());
 
-    _compressedChunkBuffer.appendNum(static_cast<std::uint32_t>(_uncompressedChunkBuffer.len()));
+    return Status::OK();
+}
 
-    _compressedChunkBuffer.appendBuf(swDest.getValue().data(), swDest.getValue().length());
+void FTDCCompressor::_appendCompactDeltas() {
+    // Lay out the delta-of-deltas of each metric contiguously, without the unused space left for
+    // the samples the chunk did not get to.
+    _packingBuffer.resize(_metricsCount * _deltaCount);
+
+    for (std::uint32_t i = 0; i < _metricsCount; i++) {
+        std::uint64_t prevDelta = 0;
+        for (std::uint32_t j = 0; j < _deltaCount; j++) {
+            const std::uint64_t delta = _deltas[getArrayOffset(_maxDeltas, j, i)];
+            _packingBuffer[getArrayOffset(_deltaCount, j, i)] =
+                FTDCBlockPacking::zigZagEncode(static_cast<std::int64_t>(delta - prevDelta));
+            prevDelta = delta;
+        }
+    }
 
-    return std::tuple<ConstDataRange, Date_t>(
-        ConstDataRange(_compressedChunkBuffer.buf(),
-                       static_cast<size_t>(_compressedChunkBuffer.len())),
-        _referenceDocDate);
+    FTDCBlockPacking::encode(
+        _packingBuffer.data(), _packingBuffer.size(), &_uncompressedChunkBuffer);
 }
 
 void FTDCCompressor::reset() {
@@ -221,6 +270,8 @@ void FTDCCompressor::reset() {
 void FTDCCompressor::_reset(const BSONObj& referenceDoc, Date_t date) {
     _referenceDoc = referenceDoc;
     _referenceDocDate = date;
+    _schemaCache.learn(referenceDoc);
+    _compact = _config->compactMetricChunks;
 
     _metricsCount = _metrics.size();
     _deltaCount = 0;
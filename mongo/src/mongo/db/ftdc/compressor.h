@@ -39,6 +39,7 @@
 #include "mongo/bson/util/builder.h"
 #include "mongo/db/ftdc/block_compressor.h"
 #include "mongo/db/ftdc/config.h"
+#include "mongo/db/ftdc/util.h"
 #include "mongo/db/jsobj.h"
 
 namespace mongo {
@@ -56,6 +57,17 @@ namespace mongo {
  * 4. Encodes zeros in Run Length Encoded pairs of <Count, Zero>
  * 5. ZLIB compresses the final processed array
  *
+ * Compact Compression Method, used for chunks started while FTDCConfig::compactMetricChunks is set
+ * 1. Computes deltas as above
+ * 2. Takes the difference between consecutive deltas of each metric, i.e. the delta-of-delta,
+ *    which is close to zero for counters that grow at a steady rate, and ZigZag encodes it
+ * 3. Packs the resulting array into blocks of bits, with runs of zeros run length encoded. See
+ *    block_packing.h.
+ * 4. Snappy compresses the final processed array, which is much cheaper than ZLIB
+ *
+ * Samples whose BSON layout is the same as the previous sample's are read through a
+ * FTDCBSONUtil::MetricSchemaCache rather than compared with the reference document.
+ *
  * NOTE: This compression ignores non-number data, and assumes the non-number data is constant
  * across all documents in the series of documents.
  */
@@ -127,6 +139,14 @@ public:
      */
     StatusWith<std::tuple<ConstDataRange, Date_t>> getCompressedSamples();
 
+    /**
+     * Returns the document type to store the buffer last returned by addSample() or
+     * getCompressedSamples() with, kMetricChunk or kCompactMetricChunk.
+     */
+    FTDCBSONUtil::FTDCType getCompressedChunkType() const {
+        return _compressedChunkType;
+    }
+
     /**
      * Reset the state of the compressor.
      *
@@ -149,6 +169,12 @@ private:
      */
     void _reset(const BSONObj& referenceDoc, Date_t date);
 
+    /**
+     * Appends the deltas of the current chunk to _uncompressedChunkBuffer in either format.
+     */
+    Status _appendDeltas();
+    void _appendCompactDeltas();
+
 private:
     // Block Compressor
     BlockCompressor _compressor;
@@ -159,6 +185,15 @@ private:
     // Reference schema document
     BSONObj _referenceDoc;
 
+    // Layout of the last sample known to match the reference document
+    FTDCBSONUtil::MetricSchemaCache _schemaCache;
+
+    // Whether the current chunk uses the compact format, fixed when the chunk is started
+    bool _compact{false};
+
+    // Type of the last chunk returned
+    FTDCBSONUtil::FTDCType _compressedChunkType{FTDCBSONUtil::FTDCType::kMetricChunk};
+
     // Time at which reference schema document was collected.
     // Passed in via addSample and returned with each chunk.
     Date_t _referenceDocDate;
@@ -185,6 +220,9 @@ private:
     // Buffer to hold metrics
     std::vector<std::uint64_t> _metrics;
     std::vector<std::uint64_t> _prevmetrics;
+
+    // Delta-of-deltas of the current chunk, for the compact format
+    std::vector<std::uint64_t> _packingBuffer;
 };
 
 }  // namespace mongo
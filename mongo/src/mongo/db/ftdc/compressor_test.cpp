@@ -125,7 +125,9 @@ TEST(FTDCCompressor, TestStrings) {
  */
 class TestTie {
 public:
-    TestTie() : _compressor(&_config) {}
+    explicit TestTie(bool compact = false) : _compressor(&_config) {
+        _config.compactMetricChunks = compact;
+    }
 
     ~TestTie() {
         validate(boost::none);
@@ -157,13 +159,13 @@ public:
     void validate(boost::optional<ConstDataRange> cdr) {
         std::vector<BSONObj> list;
         if (cdr.is_initialized()) {
-            auto sw = _decompressor.uncompress(cdr.get());
+            auto sw = uncompress(cdr.get());
             ASSERT_TRUE(sw.isOK());
             list = sw.getValue();
         } else {
             auto swBuf = _compressor.getCompressedSamples();
             ASSERT_TRUE(swBuf.isOK());
-            auto sw = _decompressor.uncompress(std::get<0>(swBuf.getValue()));
+            auto sw = uncompress(std::get<0>(swBuf.getValue()));
             ASSERT_TRUE(sw.isOK());
 
             list = sw.getValue();
@@ -172,6 +174,18 @@ public:
         ValidateDocumentList(list, _docs);
     }
 
+    void setCompact(bool compact) {
+        _config.compactMetricChunks = compact;
+    }
+
+private:
+    StatusWith<std::vector<BSONObj>> uncompress(ConstDataRange cdr) {
+        if (_compressor.getCompressedChunkType() == FTDCBSONUtil::FTDCType::kCompactMetricChunk) {
+            return _decompressor.uncompressCompact(cdr);
+        }
+        return _decompressor.uncompress(cdr);
+    }
+
 private:
     std::vector<BSONObj> _docs;
     FTDCConfig _config;
@@ -457,8 +471,8 @@ TEST(FTDCCompressor, Types) {
 // Test a full buffer
 TEST(FTDCCompressor, TestFull) {
     // Test a large numbers of zeros, and incremental numbers in a full buffer
-    for (int j = 0; j < 2; j++) {
-        TestTie c;
+    for (int j = 0; j < 4; j++) {
+        TestTie c(j >= 2);
 
         auto st = c.addSample(BSON("name"
                                    << "joe"
@@ -472,7 +486,7 @@ TEST(FTDCCompressor, TestFull) {
             st = c.addSample(BSON("name"
                                   << "joe"
                                   << "key1"
-                                  << static_cast<long long int>(i * j)
+                                  << static_cast<long long int>(i * (j % 2))
                                   << "key2"
                                   << 45));
             ASSERT_HAS_SPACE(st);
@@ -517,8 +531,8 @@ TEST(ZFTDCCompressor, TestManyMetrics) {
     const size_t metrics = 1000;
 
     // Test a large numbers of zeros, and incremental numbers in a full buffer
-    for (int j = 0; j < 2; j++) {
-        TestTie c;
+    for (int j = 0; j < 4; j++) {
+        TestTie c(j >= 2);
 
         auto st = c.addSample(generateSample(rd, genValues, metrics));
         ASSERT_HAS_SPACE(st);
@@ -537,4 +551,96 @@ TEST(ZFTDCCompressor, TestManyMetrics) {
     }
 }
 
+// Test the compact format with counters, gauges and values which go down as well as up
+TEST(FTDCCompressor, TestCompactDeltaOfDeltas) {
+    TestTie c(true);
+
+    for (long long i = 0; i != FTDCConfig::kMaxSamplesPerArchiveMetricChunkDefault + 10; i++) {
+        auto st = c.addSample(BSON("name"
+                                   << "joe"
+                                   << "counter"
+                                   << 1000 + i * 17
+                                   << "gauge"
+                                   << (i % 7) * 100 - 300
+                                   << "constant"
+                                   << 5
+                                   << "max"
+                                   << std::numeric_limits<long long>::max() - (i % 2)
+                                   << "nested"
+                                   << BSON("ts" << Timestamp(1000 + i, i % 3) << "flag"
+                                                << (i % 5 == 0))));
+        ASSERT_TRUE(st.isOK());
+    }
+}
+
+// Test switching between formats, which only takes effect when a new chunk is started
+TEST(FTDCCompressor, TestCompactSwitch) {
+    TestTie c;
+
+    auto sample = [](int i) {
+        return BSON("name"
+                    << "joe"
+                    << "key1"
+                    << i
+                    << "key2"
+                    << i * i);
+    };
+
+    auto st = c.addSample(sample(0));
+    ASSERT_HAS_SPACE(st);
+    c.setCompact(true);
+    st = c.addSample(sample(1));
+    ASSERT_HAS_SPACE(st);
+
+    // The schema change starts a new, compact, chunk.
+    st = c.addSample(BSON("name"
+                          << "joe"
+                          << "key3"
+                          << 3));
+    ASSERT_SCHEMA_CHANGED(st);
+    st = c.addSample(BSON("name"
+                          << "joe"
+                          << "key3"
+                          << 4));
+    ASSERT_HAS_SPACE(st);
+
+    c.setCompact(false);
+    st = c.addSample(sample(2));
+    ASSERT_SCHEMA_CHANGED(st);
+    st = c.addSample(sample(3));
+    ASSERT_HAS_SPACE(st);
+}
+
+// Test that samples whose non-metric content changes are still compared with the reference
+// document rather than read through the schema cache
+TEST(FTDCCompressor, TestSchemaCacheMisses) {
+    FTDCConfig config;
+    FTDCCompressor c(&config);
+
+    auto st = c.addSample(BSON("name"
+                               << "joe"
+                               << "key1"
+                               << 1),
+                          Date_t());
+    ASSERT_HAS_SPACE(st);
+    st = c.addSample(BSON("name"
+                          << "jim"
+                          << "key1"
+                          << 2),
+                     Date_t());
+    ASSERT_HAS_SPACE(st);
+    st = c.addSample(BSON("name"
+                          << "jim"
+                          << "key1"
+                          << 3.0),
+                     Date_t());
+    ASSERT_HAS_SPACE(st);
+    st = c.addSample(BSON("name"
+                          << "jim"
+                          << "key2"
+                          << 4.0),
+                     Date_t());
+    ASSERT_SCHEMA_CHANGED(st);
+}
+
 }  // namespace mongo
@@ -46,7 +46,8 @@ struct FTDCConfig {
           maxFileSizeBytes(kMaxFileSizeBytesDefault),
           period(kPeriodMillisDefault),
           maxSamplesPerArchiveMetricChunk(kMaxSamplesPerArchiveMetricChunkDefault),
-          maxSamplesPerInterimMetricChunk(kMaxSamplesPerInterimMetricChunkDefault) {}
+          maxSamplesPerInterimMetricChunk(kMaxSamplesPerInterimMetricChunkDefault),
+          compactMetricChunks(kCompactMetricChunksDefault) {}
 
     /**
      * True if FTDC is collecting data. False otherwise
@@ -83,6 +84,12 @@ struct FTDCConfig {
      */
     std::uint32_t maxSamplesPerInterimMetricChunk;
 
+    /**
+     * True if metric chunks are compressed in the compact format, which is cheaper to produce but
+     * is not understood by tools that only know the original format. See FTDCCompressor.
+     */
+    bool compactMetricChunks;
+
     static const bool kEnabledDefault = true;
 
     static const std::int64_t kPeriodMillisDefault;
@@ -93,6 +100,24 @@ struct FTDCConfig {
 
     static const std::uint32_t kMaxSamplesPerArchiveMetricChunkDefault = 300;
     static const std::uint32_t kMaxSamplesPerInterimMetricChunkDefault = 10;
+
+    static const bool kCompactMetricChunksDefault = false;
+
+    /**
+     * Bounds on a burst of high-frequency sampling. See FTDCController::startBurst.
+     */
+    static const std::int64_t kBurstMinPeriodMillis;
+    static const std::int64_t kBurstMaxPeriodMillis;
+    static const std::int64_t kBurstMaxDurationSecs;
+
+    static const std::int64_t kBurstPeriodMillisDefault;
+    static const std::int64_t kBurstDurationSecsDefault;
+
+    /**
+     * Max size of the compressed samples a burst keeps in memory. The oldest samples are dropped
+     * once a burst produces more than this.
+     */
+    static const std::uint64_t kBurstMaxBufferBytes = 16 * 1024 * 1024;
 };
 
 }  // namespace mongo
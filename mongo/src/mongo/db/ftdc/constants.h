@@ -34,6 +34,7 @@ namespace mongo {
 
 extern const char kFTDCInterimFile[];
 extern const char kFTDCArchiveFile[];
+extern const char kFTDCBurstFileSuffix[];
 
 extern const char kFTDCIdField[];
 extern const char kFTDCTypeField[];
@@ -32,8 +32,12 @@
 
 #include "mongo/db/ftdc/controller.h"
 
+#include <boost/filesystem.hpp>
+
 #include "mongo/db/client.h"
+#include "mongo/db/ftdc/burst_buffer.h"
 #include "mongo/db/ftdc/collector.h"
+#include "mongo/db/ftdc/constants.h"
 #include "mongo/db/ftdc/util.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/stdx/condition_variable.h"
@@ -43,6 +47,7 @@
 #include "mongo/util/concurrency/idle_thread_block.h"
 #include "mongo/util/exit.h"
 #include "mongo/util/log.h"
+#include "mongo/util/scopeguard.h"
 #include "mongo/util/time_support.h"
 
 namespace mongo {
@@ -92,6 +97,12 @@ void FTDCController::setMaxSamplesPerInterimMetricChunk(size_t size) {
     _condvar.notify_one();
 }
 
+void FTDCController::setCompactMetricChunks(bool compact) {
+    stdx::lock_guard<stdx::mutex> lock(_mutex);
+    _configTemp.compactMetricChunks = compact;
+    _condvar.notify_one();
+}
+
 Status FTDCController::setDirectory(const boost::filesystem::path& path) {
     stdx::lock_guard<stdx::mutex> lock(_mutex);
 
@@ -127,6 +138,53 @@ void FTDCController::addOnRotateCollector(std::unique_ptr<FTDCCollectorInterface
     }
 }
 
+void FTDCController::addBurstCollector(std::unique_ptr<FTDCCollectorInterface> collector) {
+    {
+        stdx::lock_guard<stdx::mutex> lock(_mutex);
+        invariant(_state == State::kNotStarted);
+
+        _burstCollectors.add(std::move(collector));
+    }
+}
+
+Status FTDCController::startBurst(Milliseconds period, Milliseconds duration, StringData reason) {
+    if (period < Milliseconds(FTDCConfig::kBurstMinPeriodMillis) ||
+        period > Milliseconds(FTDCConfig::kBurstMaxPeriodMillis)) {
+        return Status(ErrorCodes::BadValue,
+                      str::stream() << "Burst period must be between "
+                                    << FTDCConfig::kBurstMinPeriodMillis
+                                    << "ms and "
+                                    << FTDCConfig::kBurstMaxPeriodMillis
+                                    << "ms");
+    }
+
+    if (duration < period || duration > Seconds(FTDCConfig::kBurstMaxDurationSecs)) {
+        return Status(ErrorCodes::BadValue,
+                      str::stream() << "Burst duration must be between the burst period and "
+                                    << FTDCConfig::kBurstMaxDurationSecs
+                                    << " seconds");
+    }
+
+    stdx::lock_guard<stdx::mutex> lock(_mutex);
+
+    if (_state != State::kStarted || !_configTemp.enabled) {
+        return Status(ErrorCodes::IllegalOperation,
+                      "A burst cannot be started when full-time diagnostic data capture is not "
+                      "running");
+    }
+
+    if (_burstInProgress) {
+        return Status(ErrorCodes::ConflictingOperationInProgress,
+                      "A burst of full-time diagnostic data capture is already in progress");
+    }
+
+    _burstInProgress = true;
+    _burstRequest = BurstRequest{period, duration, reason.toString()};
+    _burstCondvar.notify_one();
+
+    return Status::OK();
+}
+
 BSONObj FTDCController::getMostRecentPeriodicDocument() {
     {
         stdx::lock_guard<stdx::mutex> lock(_mutex);
@@ -138,8 +196,9 @@ void FTDCController::start() {
     log() << "Initializing full-time diagnostic data capture with directory '"
           << _path.generic_string() << "'";
 
-    // Start the thread
+    // Start the threads
     _thread = stdx::thread(stdx::bind(&FTDCController::doLoop, this));
+    _burstThread = stdx::thread(stdx::bind(&FTDCController::doBurstLoop, this));
 
     {
         stdx::lock_guard<stdx::mutex> lock(_mutex);
@@ -167,11 +226,13 @@ void FTDCController::stop() {
         _configTemp.enabled = false;
         _state = State::kStopRequested;
 
-        // Wake up the thread if sleeping so that it will check if we are done
+        // Wake up the threads if sleeping so that they will check if we are done
         _condvar.notify_one();
+        _burstCondvar.notify_one();
     }
 
     _thread.join();
+    _burstThread.join();
 
     _state = State::kDone;
 
@@ -262,4 +323,136 @@ void FTDCController::doLoop() {
     }
 }
 
+void FTDCController::doBurstLoop() {
+    try {
+        Client::initThread("ftdcBurst");
+        Client* client = &cc();
+
+        while (true) {
+            BurstRequest request;
+            FTDCConfig config;
+
+            // Wait for a burst request or signal to shutdown
+            {
+                stdx::unique_lock<stdx::mutex> lock(_mutex);
+                MONGO_IDLE_THREAD_BLOCK;
+
+                _burstCondvar.wait(lock, [this] {
+                    return _state == State::kStopRequested || _burstRequest.is_initialized();
+                });
+
+                if (_state == State::kStopRequested) {
+                    break;
+                }
+
+                request = std::move(_burstRequest.get());
+                _burstRequest = boost::none;
+                config = _configTemp;
+            }
+
+            // Allow the next burst even if a burst collector throws
+            ON_BLOCK_EXIT([this] {
+                stdx::lock_guard<stdx::mutex> lock(_mutex);
+                _burstInProgress = false;
+            });
+
+            try {
+                runBurst(client, request, config);
+            } catch (const DBException& e) {
+                warning() << "Failed to run burst of full-time diagnostic data capture: "
+                          << e.toStatus();
+            }
+        }
+    } catch (...) {
+        warning() << "Uncaught exception in '" << exceptionToStatus()
+                  << "' in full-time diagnostic data capture burst subsystem. Shutting down the "
+                     "full-time diagnostic data capture burst subsystem.";
+    }
+}
+
+void FTDCController::runBurst(Client* client,
+                              const BurstRequest& request,
+                              const FTDCConfig& config) {
+    log() << "Starting a " << request.duration << " burst of full-time diagnostic data capture "
+          << "every " << request.period << " because " << request.reason;
+
+    auto clockSource = client->getServiceContext()->getPreciseClockSource();
+
+    FTDCBurstBuffer buffer(&config, FTDCConfig::kBurstMaxBufferBytes);
+
+    const Date_t start = clockSource->now();
+    const Date_t deadline = start + request.duration;
+
+    Status status = Status::OK();
+
+    while (status.isOK()) {
+        auto now = clockSource->now();
+        if (now >= deadline) {
+            break;
+        }
+
+        // Sample at the start of each period, skipping periods if a sample took too long
+        auto next_time = FTDCUtil::roundTime(now, request.period);
+
+        {
+            stdx::unique_lock<stdx::mutex> lock(_mutex);
+
+            // Stop early if the controller is stopped, but still write what we have collected
+            if (_burstCondvar.wait_until(lock, next_time.toSystemTimePoint(), [this] {
+                    return _state == State::kStopRequested;
+                })) {
+                break;
+            }
+        }
+
+        auto collectSample = _burstCollectors.collect(client);
+
+        status = buffer.addSample(std::get<0>(collectSample), std::get<1>(collectSample));
+    }
+
+    if (!status.isOK()) {
+        warning() << "Failed to collect burst of full-time diagnostic data capture: " << status;
+    }
+
+    if (buffer.getSampleCount() == 0) {
+        return;
+    }
+
+    const Date_t end = clockSource->now();
+
+    BSONObjBuilder builder;
+    {
+        BSONObjBuilder burst(builder.subobjStart("burst"));
+        burst.append("reason", request.reason);
+        burst.append("periodMillis", durationCount<Milliseconds>(request.period));
+        burst.appendDate(kFTDCCollectStartField, start);
+        burst.appendDate(kFTDCCollectEndField, end);
+        burst.append("samples", static_cast<long long>(buffer.getSampleCount()));
+        burst.append("droppedSamples", static_cast<long long>(buffer.getDroppedSampleCount()));
+    }
+
+    // Name the file like an archive file so it sorts with, and is trimmed with the archive files
+    auto file = _path;
+    file /= std::string(kFTDCArchiveFile);
+    file += std::string(".") + terseUTCCurrentTime() + kFTDCBurstFileSuffix;
+
+    boost::system::error_code ec;
+    boost::filesystem::create_directories(_path, ec);
+    if (ec) {
+        warning() << "Failed to create full-time diagnostic data capture directory '"
+                  << _path.generic_string() << "' for burst: " << ec.message();
+        return;
+    }
+
+    status = buffer.writeFile(file, builder.obj(), start);
+    if (!status.isOK()) {
+        warning() << "Failed to write burst of full-time diagnostic data capture: " << status;
+        return;
+    }
+
+    log() << "Wrote " << buffer.getSampleCount() - buffer.getDroppedSampleCount()
+          << " samples from a burst of full-time diagnostic data capture to '"
+          << file.generic_string() << "'";
+}
+
 }  // namespace mongo
@@ -29,8 +29,10 @@
 #pragma once
 
 #include <boost/filesystem/path.hpp>
+#include <boost/optional.hpp>
 #include <cstdint>
 #include <memory>
+#include <string>
 
 #include "mongo/base/disallow_copying.h"
 #include "mongo/db/ftdc/collector.h"
@@ -98,6 +100,11 @@ public:
      */
     void setMaxSamplesPerInterimMetricChunk(size_t size);
 
+    /**
+     * Set whether metric chunks started from now on are compressed in the compact format.
+     */
+    void setCompactMetricChunks(bool compact);
+
     /*
      * Set the path to store FTDC files if not already set.
      *
@@ -117,6 +124,23 @@ public:
      */
     void addOnRotateCollector(std::unique_ptr<FTDCCollectorInterface> collector);
 
+    /**
+     * Add a collector to collect at a high frequency during a burst. i.e., the global lock queue
+     *
+     * These collectors must be cheap since they may run every few milliseconds.
+     */
+    void addBurstCollector(std::unique_ptr<FTDCCollectorInterface> collector);
+
+    /**
+     * Start a burst of sampling the burst collectors every period for the given duration.
+     *
+     * Samples are buffered in memory, and written to their own file in the FTDC directory when
+     * the burst ends, or the controller is stopped. The periodic collectors are not affected.
+     *
+     * Returns ErrorCodes::ConflictingOperationInProgress if a burst is already in progress.
+     */
+    Status startBurst(Milliseconds period, Milliseconds duration, StringData reason);
+
     /**
      * Start the controller.
      *
@@ -147,6 +171,25 @@ private:
      */
     void doLoop();
 
+    /**
+     * Run requested bursts of high-frequency collection on the burst thread.
+     */
+    void doBurstLoop();
+
+    /**
+     * A burst requested by startBurst.
+     */
+    struct BurstRequest {
+        Milliseconds period;
+        Milliseconds duration;
+        std::string reason;
+    };
+
+    /**
+     * Collect a single burst, and write it to disk.
+     */
+    void runBurst(Client* client, const BurstRequest& request, const FTDCConfig& config);
+
 private:
     /**
     * Private enum to track state.
@@ -185,10 +228,14 @@ private:
     // Directory to store files
     boost::filesystem::path _path;
 
-    // Mutex to protect the condvar, configuration changes, and most recent periodic document.
+    // Mutex to protect the condvars, configuration changes, most recent periodic document, and
+    // burst state.
     stdx::mutex _mutex;
     stdx::condition_variable _condvar;
 
+    // Signals the burst thread about burst requests, and stop requests
+    stdx::condition_variable _burstCondvar;
+
     // Config settings that are used by controller, file manager, and all other classes.
     // Copied from _configTemp periodically to get a consistent snapshot.
     FTDCConfig _config;
@@ -209,8 +256,20 @@ private:
     // File manager that manages file rotation, and logging
     std::unique_ptr<FTDCFileManager> _mgr;
 
+    // Set of burst collectors
+    FTDCCollectorCollection _burstCollectors;
+
+    // Burst waiting to be started by the burst thread
+    boost::optional<BurstRequest> _burstRequest;
+
+    // True from when a burst is requested until its file has been written
+    bool _burstInProgress{false};
+
     // Background collection and writing thread
     stdx::thread _thread;
+
+    // Background burst collection thread
+    stdx::thread _burstThread;
 };
 
 }  // namespace mongo
@@ -41,12 +41,14 @@
 #include "mongo/db/ftdc/config.h"
 #include "mongo/db/ftdc/constants.h"
 #include "mongo/db/ftdc/controller.h"
+#include "mongo/db/ftdc/file_reader.h"
 #include "mongo/db/ftdc/ftdc_test.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/service_context.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 
@@ -153,6 +155,39 @@ public:
     }
 };
 
+// Collector that fails its first collection
+class FTDCMetricsCollectorMockThrowOnce : public FTDCCollectorInterface {
+public:
+    void collect(OperationContext* opCtx, BSONObjBuilder& builder) final {
+        {
+            stdx::lock_guard<stdx::mutex> lck(_mutex);
+            ++_counter;
+            _condvar.notify_all();
+        }
+
+        uassert(ErrorCodes::InternalError, "mock collector failure", _counter > 1);
+
+        builder.append("key1", static_cast<int>(_counter));
+    }
+
+    std::string name() const final {
+        return "mockThrowOnce";
+    }
+
+    void wait(std::uint32_t count) {
+        stdx::unique_lock<stdx::mutex> lck(_mutex);
+        while (_counter < count) {
+            _condvar.wait(lck);
+        }
+    }
+
+private:
+    std::uint32_t _counter{0};
+
+    stdx::mutex _mutex;
+    stdx::condition_variable _condvar;
+};
+
 // Test a run of the controller and the data it logs to log file
 TEST(FTDCControllerTest, TestFull) {
     unittest::TempDir tempdir("metrics_testpath");
@@ -277,4 +312,124 @@ TEST(FTDCControllerTest, TestStartAsDisabled) {
     ValidateDocumentList(alog, allDocs);
 }
 
+// Test a burst collects its own samples, and writes them to a separate file when stopped
+TEST(FTDCControllerTest, TestBurst) {
+    unittest::TempDir tempdir("metrics_testpath");
+    boost::filesystem::path dir(tempdir.path());
+
+    createDirectoryClean(dir);
+
+    FTDCConfig config;
+    config.enabled = true;
+    config.period = Milliseconds(1);
+    config.maxFileSizeBytes = FTDCConfig::kMaxFileSizeBytesDefault;
+    config.maxDirectorySizeBytes = FTDCConfig::kMaxDirectorySizeBytesDefault;
+
+    FTDCController c(dir, config);
+
+    auto c1 = stdx::make_unique<FTDCMetricsCollectorMock2>();
+    auto c2 = stdx::make_unique<FTDCMetricsCollectorMock2>();
+
+    auto c2Ptr = c2.get();
+
+    c2Ptr->setSignalOnCount(50);
+
+    c.addPeriodicCollector(std::move(c1));
+
+    c.addBurstCollector(std::move(c2));
+
+    // Bursts can only be started while running
+    ASSERT_EQUALS(c.startBurst(Milliseconds(10), Seconds(1), "test").code(),
+                  ErrorCodes::IllegalOperation);
+
+    c.start();
+
+    ASSERT_EQUALS(c.startBurst(Milliseconds(1), Seconds(1), "test").code(), ErrorCodes::BadValue);
+    ASSERT_EQUALS(c.startBurst(Milliseconds(10), Seconds(61), "test").code(),
+                  ErrorCodes::BadValue);
+
+    // The clock source is a mock so the burst never ends on its own
+    ASSERT_OK(c.startBurst(Milliseconds(10), Seconds(60), "test"));
+    ASSERT_EQUALS(c.startBurst(Milliseconds(10), Seconds(60), "test").code(),
+                  ErrorCodes::ConflictingOperationInProgress);
+
+    // Wait for 50 samples to have occured
+    c2Ptr->wait();
+
+    c.stop();
+
+    auto docsBurst = c2Ptr->getDocs();
+    ASSERT_GREATER_THAN_OR_EQUALS(docsBurst.size(), 50UL);
+
+    std::vector<boost::filesystem::path> burstFiles;
+    for (auto& file : scanDirectory(dir)) {
+        if (StringData(file.filename().generic_string()).endsWith(kFTDCBurstFileSuffix)) {
+            burstFiles.push_back(file);
+        }
+    }
+
+    ASSERT_EQUALS(burstFiles.size(), 1UL);
+
+    FTDCFileReader reader;
+    ASSERT_OK(reader.open(burstFiles[0]));
+
+    ASSERT_TRUE(uassertStatusOK(reader.hasNext()));
+    auto metadata = reader.next();
+    ASSERT_TRUE(std::get<0>(metadata) == FTDCBSONUtil::FTDCType::kMetadata);
+    ASSERT_EQUALS(std::get<1>(metadata)["burst"]["reason"].String(), "test");
+    ASSERT_EQUALS(std::get<1>(metadata)["burst"]["samples"].numberLong(),
+                  static_cast<long long>(docsBurst.size()));
+
+    std::vector<BSONObj> samples;
+    while (uassertStatusOK(reader.hasNext())) {
+        samples.emplace_back(std::get<1>(reader.next()).getOwned());
+    }
+
+    ValidateDocumentList(samples, docsBurst);
+}
+
+// Test that a burst collector throwing does not prevent further bursts
+TEST(FTDCControllerTest, TestBurstAfterCollectorThrows) {
+    unittest::TempDir tempdir("metrics_testpath");
+    boost::filesystem::path dir(tempdir.path());
+
+    createDirectoryClean(dir);
+
+    FTDCConfig config;
+    config.enabled = true;
+    config.period = Milliseconds(1);
+    config.maxFileSizeBytes = FTDCConfig::kMaxFileSizeBytesDefault;
+    config.maxDirectorySizeBytes = FTDCConfig::kMaxDirectorySizeBytesDefault;
+
+    FTDCController c(dir, config);
+
+    auto c1 = stdx::make_unique<FTDCMetricsCollectorMock2>();
+    auto c2 = stdx::make_unique<FTDCMetricsCollectorMockThrowOnce>();
+
+    auto c2Ptr = c2.get();
+
+    c.addPeriodicCollector(std::move(c1));
+
+    c.addBurstCollector(std::move(c2));
+
+    c.start();
+
+    ASSERT_OK(c.startBurst(Milliseconds(10), Seconds(60), "test"));
+
+    // Wait for the first collection, which throws and ends the burst
+    c2Ptr->wait(1);
+
+    Status status = Status::OK();
+    while ((status = c.startBurst(Milliseconds(10), Seconds(60), "test")).code() ==
+           ErrorCodes::ConflictingOperationInProgress) {
+        sleepmillis(1);
+    }
+    ASSERT_OK(status);
+
+    // The burst thread is still running the new burst
+    c2Ptr->wait(2);
+
+    c.stop();
+}
+
 }  // namespace mongo
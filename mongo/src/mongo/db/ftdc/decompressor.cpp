@@ -32,6 +32,7 @@
 
 #include "mongo/base/data_range_cursor.h"
 #include "mongo/base/data_type_validated.h"
+#include "mongo/db/ftdc/block_packing.h"
 #include "mongo/db/ftdc/compressor.h"
 #include "mongo/db/ftdc/util.h"
 #include "mongo/db/ftdc/varint.h"
@@ -42,6 +43,14 @@
 namespace mongo {
 
 StatusWith<std::vector<BSONObj>> FTDCDecompressor::uncompress(ConstDataRange buf) {
+    return _uncompress(buf, false);
+}
+
+StatusWith<std::vector<BSONObj>> FTDCDecompressor::uncompressCompact(ConstDataRange buf) {
+    return _uncompress(buf, true);
+}
+
+StatusWith<std::vector<BSONObj>> FTDCDecompressor::_uncompress(ConstDataRange buf, bool compact) {
     ConstDataRangeCursor compressedDataRange(buf);
 
     // Read the length of the uncompressed buffer
@@ -58,7 +67,9 @@ StatusWith<std::vector<BSONObj>> FTDCDecompressor::uncompress(ConstDataRange buf
         return Status(ErrorCodes::InvalidLength, "Metrics chunk has exceeded the allowable size.");
     }
 
-    auto statusUncompress = _compressor.uncompress(compressedDataRange, uncompressedLength);
+    auto statusUncompress = compact
+        ? _compressor.uncompressSnappy(compressedDataRange, uncompressedLength)
+        : _compressor.uncompress(compressedDataRange, uncompressedLength);
 
     if (!statusUncompress.isOK()) {
         return {statusUncompress.getStatus()};
@@ -124,36 +135,53 @@ StatusWith<std::vector<BSONObj>> FTDCDecompressor::uncompress(ConstDataRange buf
     // Read the samples
     std::vector<std::uint64_t> deltas(metricsCount * sampleCount);
 
-    // decompress the deltas
-    std::uint64_t zeroesCount = 0;
-
     auto cdrc = ConstDataRangeCursor(cdc);
 
-    for (std::uint32_t i = 0; i < metricsCount; i++) {
-        for (std::uint32_t j = 0; j < sampleCount; j++) {
-            if (zeroesCount) {
-                deltas[FTDCCompressor::getArrayOffset(sampleCount, j, i)] = 0;
-                zeroesCount--;
-                continue;
-            }
-
-            auto swDelta = cdrc.readAndAdvance<FTDCVarInt>();
+    if (compact) {
+        // The chunk holds the zig-zag encoded differences between consecutive deltas.
+        auto status = FTDCBlockPacking::decode(&cdrc, deltas.size(), deltas.data());
+        if (!status.isOK()) {
+            return status;
+        }
 
-            if (!swDelta.isOK()) {
-                return swDelta.getStatus();
+        for (std::uint32_t i = 0; i < metricsCount; i++) {
+            std::uint64_t delta = 0;
+            for (std::uint32_t j = 0; j < sampleCount; j++) {
+                auto& value = deltas[FTDCCompressor::getArrayOffset(sampleCount, j, i)];
+                delta += FTDCBlockPacking::zigZagDecode(value);
+                value = delta;
             }
+        }
+    } else {
+        // decompress the deltas
+        std::uint64_t zeroesCount = 0;
+
+        for (std::uint32_t i = 0; i < metricsCount; i++) {
+            for (std::uint32_t j = 0; j < sampleCount; j++) {
+                if (zeroesCount) {
+                    deltas[FTDCCompressor::getArrayOffset(sampleCount, j, i)] = 0;
+                    zeroesCount--;
+                    continue;
+                }
 
-            if (swDelta.getValue() == 0) {
-                auto swZero = cdrc.readAndAdvance<FTDCVarInt>();
+                auto swDelta = cdrc.readAndAdvance<FTDCVarInt>();
 
-                if (!swZero.isOK()) {
+                if (!swDelta.isOK()) {
                     return swDelta.getStatus();
                 }
 
-                zeroesCount = swZero.getValue();
-            }
+                if (swDelta.getValue() == 0) {
+                    auto swZero = cdrc.readAndAdvance<FTDCVarInt>();
 
-            deltas[FTDCCompressor::getArrayOffset(sampleCount, j, i)] = swDelta.getValue();
+                    if (!swZero.isOK()) {
+                        return swDelta.getStatus();
+                    }
+
+                    zeroesCount = swZero.getValue();
+                }
+
+                deltas[FTDCCompressor::getArrayOffset(sampleCount, j, i)] = swDelta.getValue();
+            }
         }
     }
 
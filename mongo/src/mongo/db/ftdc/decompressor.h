@@ -56,7 +56,14 @@ public:
      */
     StatusWith<std::vector<BSONObj>> uncompress(ConstDataRange buf);
 
+    /**
+     * Inflates a chunk of metrics compressed in the compact format. See uncompress().
+     */
+    StatusWith<std::vector<BSONObj>> uncompressCompact(ConstDataRange buf);
+
 private:
+    StatusWith<std::vector<BSONObj>> _uncompress(ConstDataRange buf, bool compact);
+
     BlockCompressor _compressor;
 };
 
@@ -170,8 +170,10 @@ Status FTDCFileWriter::writeSample(const BSONObj& sample, Date_t date) {
             return swBuf.getStatus();
         }
 
-        BSONObj o = FTDCBSONUtil::createBSONMetricChunkDocument(std::get<0>(swBuf.getValue()),
-                                                                std::get<1>(swBuf.getValue()));
+        BSONObj o = FTDCBSONUtil::createBSONMetricChunkDocument(
+            std::get<0>(swBuf.getValue()),
+            std::get<1>(swBuf.getValue()),
+            _compressor.getCompressedChunkType());
         return writeInterimFileBuffer({o.objdata(), static_cast<size_t>(o.objsize())});
     }
 
@@ -187,8 +189,10 @@ Status FTDCFileWriter::flush(const boost::optional<ConstDataRange>& range, Date_
                 return swBuf.getStatus();
             }
 
-            BSONObj o = FTDCBSONUtil::createBSONMetricChunkDocument(std::get<0>(swBuf.getValue()),
-                                                                    std::get<1>(swBuf.getValue()));
+            BSONObj o = FTDCBSONUtil::createBSONMetricChunkDocument(
+                std::get<0>(swBuf.getValue()),
+                std::get<1>(swBuf.getValue()),
+                _compressor.getCompressedChunkType());
             Status s = writeArchiveFileBuffer({o.objdata(), static_cast<size_t>(o.objsize())});
 
             if (!s.isOK()) {
@@ -196,7 +200,8 @@ Status FTDCFileWriter::flush(const boost::optional<ConstDataRange>& range, Date_
             }
         }
     } else {
-        BSONObj o = FTDCBSONUtil::createBSONMetricChunkDocument(range.get(), date);
+        BSONObj o = FTDCBSONUtil::createBSONMetricChunkDocument(
+            range.get(), date, _compressor.getCompressedChunkType());
         Status s = writeArchiveFileBuffer({o.objdata(), static_cast<size_t>(o.objsize())});
 
         if (!s.isOK()) {
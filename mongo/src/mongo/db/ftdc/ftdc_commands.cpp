@@ -31,8 +31,10 @@
 #include "mongo/base/init.h"
 #include "mongo/db/auth/action_type.h"
 #include "mongo/db/auth/authorization_session.h"
+#include "mongo/bson/util/bson_extract.h"
 #include "mongo/db/client.h"
 #include "mongo/db/commands.h"
+#include "mongo/db/ftdc/config.h"
 #include "mongo/db/ftdc/controller.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/operation_context.h"
@@ -101,10 +103,78 @@ public:
     }
 };
 
+/**
+ * Start a burst of high-frequency diagnostic data collection.
+ *
+ * {
+ *     startDiagnosticDataBurst: 1,
+ *     periodMillis: <int>,   // Defaults to 20
+ *     durationSecs: <int>,   // Defaults to 10
+ * }
+ */
+class StartDiagnosticDataBurstCommand final : public BasicCommand {
+public:
+    StartDiagnosticDataBurstCommand() : BasicCommand("startDiagnosticDataBurst") {}
+
+    bool adminOnly() const override {
+        return true;
+    }
+
+    void help(std::stringstream& help) const override {
+        help << "start a short burst of high-frequency diagnostic data collection";
+    }
+
+    bool slaveOk() const override {
+        return true;
+    }
+
+    bool supportsWriteConcern(const BSONObj& cmd) const override {
+        return false;
+    }
+
+    Status checkAuthForCommand(Client* client,
+                               const std::string& dbname,
+                               const BSONObj& cmdObj) override {
+        if (!AuthorizationSession::get(client)->isAuthorizedForActionsOnResource(
+                ResourcePattern::forClusterResource(), ActionType::serverStatus)) {
+            return Status(ErrorCodes::Unauthorized, "Unauthorized");
+        }
+
+        if (!AuthorizationSession::get(client)->isAuthorizedForActionsOnResource(
+                ResourcePattern::forClusterResource(), ActionType::setParameter)) {
+            return Status(ErrorCodes::Unauthorized, "Unauthorized");
+        }
+
+        return Status::OK();
+    }
+
+    bool run(OperationContext* opCtx,
+             const std::string& db,
+             const BSONObj& cmdObj,
+             BSONObjBuilder& result) override {
+        long long periodMillis;
+        uassertStatusOK(bsonExtractIntegerFieldWithDefault(
+            cmdObj, "periodMillis", FTDCConfig::kBurstPeriodMillisDefault, &periodMillis));
+
+        long long durationSecs;
+        uassertStatusOK(bsonExtractIntegerFieldWithDefault(
+            cmdObj, "durationSecs", FTDCConfig::kBurstDurationSecsDefault, &durationSecs));
+
+        uassertStatusOK(FTDCController::get(opCtx->getServiceContext())
+                            ->startBurst(Milliseconds(periodMillis),
+                                         Seconds(durationSecs),
+                                         "requested by the startDiagnosticDataBurst command"));
+
+        return true;
+    }
+};
+
 Command* ftdcCommand;
+Command* ftdcBurstCommand;
 
 MONGO_INITIALIZER(CreateDiagnosticDataCommand)(InitializerContext* context) {
     ftdcCommand = new GetDiagnosticDataCommand();
+    ftdcBurstCommand = new StartDiagnosticDataBurstCommand();
 
     return Status::OK();
 }
@@ -26,6 +26,8 @@
  * then also delete it in the license file.
  */
 
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kFTDC
+
 #include "mongo/platform/basic.h"
 
 #include "mongo/db/ftdc/ftdc_server.h"
@@ -37,6 +39,7 @@
 #include "mongo/base/status.h"
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/commands.h"
+#include "mongo/db/ftdc/burst_trigger.h"
 #include "mongo/db/ftdc/collector.h"
 #include "mongo/db/ftdc/config.h"
 #include "mongo/db/ftdc/controller.h"
@@ -45,6 +48,7 @@
 #include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/util/log.h"
 
 namespace mongo {
 
@@ -241,6 +245,108 @@ public:
     }
 
 } exportedFTDCInterimChunkSizeParameter;
+
+AtomicBool localCompactMetricChunks(FTDCConfig::kCompactMetricChunksDefault);
+
+class ExportedFTDCCompactChunksParameter
+    : public ExportedServerParameter<bool, ServerParameterType::kStartupAndRuntime> {
+public:
+    ExportedFTDCCompactChunksParameter()
+        : ExportedServerParameter<bool, ServerParameterType::kStartupAndRuntime>(
+              ServerParameterSet::getGlobal(),
+              "diagnosticDataCollectionCompactChunks",
+              &localCompactMetricChunks) {}
+
+    virtual Status validate(const bool& potentialNewValue) {
+        auto controller = getGlobalFTDCController();
+        if (controller) {
+            controller->setCompactMetricChunks(potentialNewValue);
+        }
+
+        return Status::OK();
+    }
+
+} exportedFTDCCompactChunksParameter;
+
+AtomicInt32 localBurstPeriodMillis(FTDCConfig::kBurstPeriodMillisDefault);
+
+class ExportedFTDCBurstPeriodParameter
+    : public ExportedServerParameter<std::int32_t, ServerParameterType::kStartupAndRuntime> {
+public:
+    ExportedFTDCBurstPeriodParameter()
+        : ExportedServerParameter<std::int32_t, ServerParameterType::kStartupAndRuntime>(
+              ServerParameterSet::getGlobal(),
+              "diagnosticDataCollectionBurstPeriodMillis",
+              &localBurstPeriodMillis) {}
+
+    virtual Status validate(const std::int32_t& potentialNewValue) {
+        if (potentialNewValue < FTDCConfig::kBurstMinPeriodMillis ||
+            potentialNewValue > FTDCConfig::kBurstMaxPeriodMillis) {
+            return Status(ErrorCodes::BadValue,
+                          str::stream() << "diagnosticDataCollectionBurstPeriodMillis must be "
+                                           "between "
+                                        << FTDCConfig::kBurstMinPeriodMillis
+                                        << " and "
+                                        << FTDCConfig::kBurstMaxPeriodMillis);
+        }
+
+        return Status::OK();
+    }
+
+} exportedFTDCBurstPeriodParameter;
+
+AtomicInt32 localBurstDurationSecs(FTDCConfig::kBurstDurationSecsDefault);
+
+class ExportedFTDCBurstDurationParameter
+    : public ExportedServerParameter<std::int32_t, ServerParameterType::kStartupAndRuntime> {
+public:
+    ExportedFTDCBurstDurationParameter()
+        : ExportedServerParameter<std::int32_t, ServerParameterType::kStartupAndRuntime>(
+              ServerParameterSet::getGlobal(),
+              "diagnosticDataCollectionBurstDurationSecs",
+              &localBurstDurationSecs) {}
+
+    virtual Status validate(const std::int32_t& potentialNewValue) {
+        if (potentialNewValue < 1 || potentialNewValue > FTDCConfig::kBurstMaxDurationSecs) {
+            return Status(ErrorCodes::BadValue,
+                          str::stream() << "diagnosticDataCollectionBurstDurationSecs must be "
+                                           "between 1 and "
+                                        << FTDCConfig::kBurstMaxDurationSecs);
+        }
+
+        return Status::OK();
+    }
+
+} exportedFTDCBurstDurationParameter;
+
+// Zero disables starting bursts on slow operations
+AtomicInt32 localBurstTriggerLatencyMillis(0);
+
+class ExportedFTDCBurstTriggerLatencyParameter
+    : public ExportedServerParameter<std::int32_t, ServerParameterType::kStartupAndRuntime> {
+public:
+    ExportedFTDCBurstTriggerLatencyParameter()
+        : ExportedServerParameter<std::int32_t, ServerParameterType::kStartupAndRuntime>(
+              ServerParameterSet::getGlobal(),
+              "diagnosticDataCollectionBurstTriggerLatencyMillis",
+              &localBurstTriggerLatencyMillis) {}
+
+    virtual Status validate(const std::int32_t& potentialNewValue) {
+        if (potentialNewValue < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "diagnosticDataCollectionBurstTriggerLatencyMillis must be greater than "
+                          "or equal to 0");
+        }
+
+        if (hasGlobalServiceContext()) {
+            FTDCBurstTrigger::get(getGlobalServiceContext())
+                ->setLatencyThreshold(Milliseconds(potentialNewValue));
+        }
+
+        return Status::OK();
+    }
+
+} exportedFTDCBurstTriggerLatencyParameter;
 }  // namespace
 
 FTDCSimpleInternalCommandCollector::FTDCSimpleInternalCommandCollector(StringData command,
@@ -278,6 +384,7 @@ void startFTDC(boost::filesystem::path& path,
     config.maxDirectorySizeBytes = localMaxDirectorySizeMB.load() * 1024 * 1024;
     config.maxSamplesPerArchiveMetricChunk = localMaxSamplesPerArchiveMetricChunk.load();
     config.maxSamplesPerInterimMetricChunk = localMaxSamplesPerInterimMetricChunk.load();
+    config.compactMetricChunks = localCompactMetricChunks.load();
 
     auto controller = stdx::make_unique<FTDCController>(path, config);
 
@@ -303,6 +410,26 @@ void startFTDC(boost::filesystem::path& path,
     // Install System Metric Collector as a periodic collector
     installSystemMetricsCollector(controller.get());
 
+    // Install burst collectors
+    // These are collected every few milliseconds during a burst so they are limited to the
+    // serverStatus sections which show short stalls and take neither locks nor tickets: the global
+    // lock queue, network, and operation latencies. The storage engine registers its own burst
+    // collector for its tickets and cache, since its serverStatus section takes the global lock and
+    // walks every statistic.
+    controller->addBurstCollector(stdx::make_unique<FTDCSimpleInternalCommandCollector>(
+        "serverStatus",
+        "serverStatus",
+        "",
+        BSON("serverStatus" << 1 << "defaultSections" << false << "globalLock" << true
+                            << "network"
+                            << true
+                            << "opLatencies"
+                            << true)));
+
+    for (auto&& collector : makeRegisteredFTDCBurstCollectors()) {
+        controller->addBurstCollector(std::move(collector));
+    }
+
     // Install file rotation collectors
     // These are collected on each file rotation.
 
@@ -324,6 +451,24 @@ void startFTDC(boost::filesystem::path& path,
     staticFTDC = std::move(controller);
 
     staticFTDC->start();
+
+    // Start a burst of the default period and duration when an operation is slower than the
+    // trigger latency
+    auto trigger = FTDCBurstTrigger::get(getGlobalServiceContext());
+    trigger->setLatencyThreshold(Milliseconds(localBurstTriggerLatencyMillis.load()));
+    trigger->setBurstFunction([](StringData reason) {
+        auto controller = getGlobalFTDCController();
+        if (!controller) {
+            return;
+        }
+
+        auto status = controller->startBurst(Milliseconds(localBurstPeriodMillis.load()),
+                                             Seconds(localBurstDurationSecs.load()),
+                                             reason);
+        if (!status.isOK()) {
+            LOG(1) << "Failed to start a burst of full-time diagnostic data capture: " << status;
+        }
+    });
 }
 
 void stopFTDC() {
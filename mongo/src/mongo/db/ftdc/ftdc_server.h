@@ -63,7 +63,7 @@ enum class FTDCStartMode {
 
 /**
  * Start Full Time Data Capture
- * Starts 1 thread.
+ * Starts 2 threads, one for periodic collection, and one for bursts of high-frequency collection.
  *
  * See MongoD and MongoS specific functions.
  */
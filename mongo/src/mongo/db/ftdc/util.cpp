@@ -33,6 +33,7 @@
 #include "mongo/db/ftdc/util.h"
 
 #include <boost/filesystem.hpp>
+#include <cstring>
 
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/bson/util/bson_extract.h"
@@ -51,6 +52,7 @@ namespace mongo {
 const char kFTDCInterimFile[] = "metrics.interim";
 const char kFTDCInterimTempFile[] = "metrics.interim.temp";
 const char kFTDCArchiveFile[] = "metrics";
+const char kFTDCBurstFileSuffix[] = "-burst";
 
 const char kFTDCIdField[] = "_id";
 const char kFTDCTypeField[] = "type";
@@ -65,6 +67,12 @@ const char kFTDCCollectEndField[] = "end";
 
 const std::int64_t FTDCConfig::kPeriodMillisDefault = 1000;
 
+const std::int64_t FTDCConfig::kBurstMinPeriodMillis = 10;
+const std::int64_t FTDCConfig::kBurstMaxPeriodMillis = 1000;
+const std::int64_t FTDCConfig::kBurstMaxDurationSecs = 60;
+const std::int64_t FTDCConfig::kBurstPeriodMillisDefault = 20;
+const std::int64_t FTDCConfig::kBurstDurationSecsDefault = 10;
+
 const std::size_t kMaxRecursion = 10;
 
 namespace FTDCUtil {
@@ -123,6 +131,55 @@ namespace FTDCBSONUtil {
 
 namespace {
 
+/**
+ * Appends the metrics of a non-document element, if it has any.
+ */
+void extractMetricsFromElement(const BSONElement& element, std::vector<std::uint64_t>* metrics) {
+    switch (element.type()) {
+        // all numeric types are extracted as long (int64)
+        // this supports the loose schema matching of extractMetricsFromDocument,
+        // but does create a range issue for doubles, and requires doubles to be integer
+        case NumberDouble:
+        case NumberInt:
+        case NumberLong:
+        case NumberDecimal:
+            metrics->emplace_back(element.numberLong());
+            break;
+
+        case Bool:
+            metrics->emplace_back(element.Bool());
+            break;
+
+        case Date:
+            metrics->emplace_back(element.Date().toMillisSinceEpoch());
+            break;
+
+        case bsonTimestamp:
+            // very slightly more space efficient to treat these as two separate metrics
+            metrics->emplace_back(element.timestamp().getSecs());
+            metrics->emplace_back(element.timestamp().getInc());
+            break;
+
+        default:
+            break;
+    }
+}
+
+bool isMetricType(BSONType type) {
+    switch (type) {
+        case NumberDouble:
+        case NumberInt:
+        case NumberLong:
+        case NumberDecimal:
+        case Bool:
+        case Date:
+        case bsonTimestamp:
+            return true;
+        default:
+            return false;
+    }
+}
+
 StatusWith<bool> extractMetricsFromDocument(const BSONObj& referenceDoc,
                                             const BSONObj& currentDoc,
                                             std::vector<std::uint64_t>* metrics,
@@ -174,30 +231,6 @@ StatusWith<bool> extractMetricsFromDocument(const BSONObj& referenceDoc,
         }
 
         switch (currentElement.type()) {
-            // all numeric types are extracted as long (int64)
-            // this supports the loose schema matching mentioned above,
-            // but does create a range issue for doubles, and requires doubles to be integer
-            case NumberDouble:
-            case NumberInt:
-            case NumberLong:
-            case NumberDecimal:
-                metrics->emplace_back(currentElement.numberLong());
-                break;
-
-            case Bool:
-                metrics->emplace_back(currentElement.Bool());
-                break;
-
-            case Date:
-                metrics->emplace_back(currentElement.Date().toMillisSinceEpoch());
-                break;
-
-            case bsonTimestamp:
-                // very slightly more space efficient to treat these as two separate metrics
-                metrics->emplace_back(currentElement.timestamp().getSecs());
-                metrics->emplace_back(currentElement.timestamp().getInc());
-                break;
-
             case Object:
             case Array: {
                 // Maximum recursion is controlled by the documents we collect. Maximum is 5 in the
@@ -214,6 +247,7 @@ StatusWith<bool> extractMetricsFromDocument(const BSONObj& referenceDoc,
             } break;
 
             default:
+                extractMetricsFromElement(currentElement, metrics);
                 break;
         }
     }
@@ -236,6 +270,68 @@ StatusWith<bool> extractMetricsFromDocument(const BSONObj& referenceDoc,
     return extractMetricsFromDocument(referenceDoc, currentDoc, metrics, true, 0);
 }
 
+bool MetricSchemaCache::extractMetrics(const BSONObj& doc,
+                                       std::vector<std::uint64_t>* metrics) const {
+    if (_doc.isEmpty() || doc.objsize() != _doc.objsize()) {
+        return false;
+    }
+
+    const char* cached = _doc.objdata();
+    const char* current = doc.objdata();
+
+    std::uint32_t pos = 0;
+    for (const auto& slot : _slots) {
+        if (std::memcmp(cached + pos, current + pos, slot.valueOffset - pos) != 0) {
+            return false;
+        }
+        pos = slot.valueEnd;
+    }
+    if (std::memcmp(cached + pos, current + pos, doc.objsize() - pos) != 0) {
+        return false;
+    }
+
+    for (const auto& slot : _slots) {
+        // The field name, including its terminating null, lies between the type and the value.
+        const int fieldNameSize = slot.valueOffset - slot.elementOffset - 1;
+        const BSONElement element(
+            current + slot.elementOffset, fieldNameSize, BSONElement::FieldNameSizeTag());
+        extractMetricsFromElement(element, metrics);
+    }
+
+    return true;
+}
+
+void MetricSchemaCache::learn(const BSONObj& doc) {
+    _doc = doc.getOwned();
+    _slots.clear();
+
+    if (!_learn(_doc, 0)) {
+        _doc = BSONObj();
+        _slots.clear();
+    }
+}
+
+bool MetricSchemaCache::_learn(const BSONObj& obj, std::size_t recursion) {
+    if (recursion > kMaxRecursion) {
+        return false;
+    }
+
+    for (const auto& element : obj) {
+        if (element.type() == Object || element.type() == Array) {
+            if (!_learn(element.Obj(), recursion + 1)) {
+                return false;
+            }
+        } else if (isMetricType(element.type())) {
+            const std::uint32_t valueOffset = element.value() - _doc.objdata();
+            _slots.push_back({static_cast<std::uint32_t>(element.rawdata() - _doc.objdata()),
+                              valueOffset,
+                              valueOffset + element.valuesize()});
+        }
+    }
+
+    return true;
+}
+
 namespace {
 Status constructDocumentFromMetrics(const BSONObj& referenceDocument,
                                     BSONObjBuilder& builder,
@@ -352,11 +448,13 @@ BSONObj createBSONMetadataDocument(const BSONObj& metadata, Date_t date) {
     return builder.obj();
 }
 
-BSONObj createBSONMetricChunkDocument(ConstDataRange buf, Date_t date) {
+BSONObj createBSONMetricChunkDocument(ConstDataRange buf, Date_t date, FTDCType type) {
+    dassert(type == FTDCType::kMetricChunk || type == FTDCType::kCompactMetricChunk);
+
     BSONObjBuilder builder;
 
     builder.appendDate(kFTDCIdField, date);
-    builder.appendNumber(kFTDCTypeField, static_cast<int>(FTDCType::kMetricChunk));
+    builder.appendNumber(kFTDCTypeField, static_cast<int>(type));
     builder.appendBinData(kFTDCDataField, buf.length(), BinDataType::BinDataGeneral, buf.data());
 
     return builder.obj();
@@ -382,6 +480,7 @@ StatusWith<FTDCType> getBSONDocumentType(const BSONObj& obj) {
     }
 
     if (static_cast<FTDCType>(value) != FTDCType::kMetricChunk &&
+        static_cast<FTDCType>(value) != FTDCType::kCompactMetricChunk &&
         static_cast<FTDCType>(value) != FTDCType::kMetadata) {
         return {ErrorCodes::BadValue,
                 str::stream() << "Field '" << std::string(kFTDCTypeField)
@@ -411,10 +510,12 @@ StatusWith<BSONObj> getBSONDocumentFromMetadataDoc(const BSONObj& obj) {
 
 StatusWith<std::vector<BSONObj>> getMetricsFromMetricDoc(const BSONObj& obj,
                                                          FTDCDecompressor* decompressor) {
-    if (kDebugBuild) {
-        auto swType = getBSONDocumentType(obj);
-        dassert(swType.isOK() && swType.getValue() == FTDCType::kMetricChunk);
+    auto swType = getBSONDocumentType(obj);
+    if (!swType.isOK()) {
+        return {swType.getStatus()};
     }
+    dassert(swType.getValue() == FTDCType::kMetricChunk ||
+            swType.getValue() == FTDCType::kCompactMetricChunk);
 
     BSONElement element;
 
@@ -430,6 +531,10 @@ StatusWith<std::vector<BSONObj>> getMetricsFromMetricDoc(const BSONObj& obj,
                 str::stream() << "Field " << std::string(kFTDCTypeField) << " is not a BinData."};
     }
 
+    if (swType.getValue() == FTDCType::kCompactMetricChunk) {
+        return decompressor->uncompressCompact({buffer, static_cast<std::size_t>(length)});
+    }
+
     return decompressor->uncompress({buffer, static_cast<std::size_t>(length)});
 }
 
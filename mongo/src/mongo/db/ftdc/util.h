@@ -62,6 +62,16 @@ enum class FTDCType : std::int32_t {
     * See createBSONMetricChunkDocument
     */
     kMetricChunk = 1,
+
+    /**
+    * A metrics chunk whose samples are compressed in the compact format, see FTDCCompressor.
+    *
+    * Numbered well away from the upstream types, which continue from 2 (periodic metadata), so
+    * that files written by either server are never misread by the other's tools.
+    *
+    * See createBSONMetricChunkDocument
+    */
+    kCompactMetricChunk = 100,
 };
 
 
@@ -97,6 +107,44 @@ StatusWith<bool> extractMetricsFromDocument(const BSONObj& referenceDoc,
                                             const BSONObj& doc,
                                             std::vector<std::uint64_t>* metrics);
 
+/**
+ * Remembers where the metrics of a document lie in its BSON, so that the metrics of a later
+ * document with the same layout can be read directly instead of walking and comparing it against
+ * the reference document element by element.
+ *
+ * Documents have the same layout if they are the same size and every byte outside of their
+ * metric values is the same, which is checked with a memcmp per metric over the field names and
+ * types in between. Consecutive serverStatus samples usually qualify, as their non-metric content
+ * rarely changes. Callers fall back to extractMetricsFromDocument for documents which do not.
+ */
+class MetricSchemaCache {
+public:
+    /**
+     * Appends the metrics of doc to metrics and returns true if doc has the layout of the last
+     * document learnt. Otherwise returns false and leaves metrics untouched.
+     */
+    bool extractMetrics(const BSONObj& doc, std::vector<std::uint64_t>* metrics) const;
+
+    /**
+     * Remembers the layout of doc, which replaces any layout remembered so far.
+     */
+    void learn(const BSONObj& doc);
+
+private:
+    // A metric value: BSONElement starting at elementOffset and whose value is in
+    // [valueOffset, valueEnd).
+    struct Slot {
+        std::uint32_t elementOffset;
+        std::uint32_t valueOffset;
+        std::uint32_t valueEnd;
+    };
+
+    bool _learn(const BSONObj& obj, std::size_t recursion);
+
+    BSONObj _doc;
+    std::vector<Slot> _slots;
+};
+
 /**
  * Construct a document from a reference document and array of metrics.
  *
@@ -138,6 +186,7 @@ BSONObj createBSONMetadataDocument(const BSONObj& metadata, Date_t date);
  * Create a BSON metric chunk document for storage. The passed in document is embedded as the
  * data field in the example above. For the _id field, the date is specified by the caller
  * since the metric chunk usually composed of multiple samples gathered over a period of time.
+ * The type is kMetricChunk or kCompactMetricChunk, depending on how the data was compressed.
  *
  * Example:
  * {
@@ -146,7 +195,9 @@ BSONObj createBSONMetadataDocument(const BSONObj& metadata, Date_t date);
  *  "data" : BinData(...)
  * }
  */
-BSONObj createBSONMetricChunkDocument(ConstDataRange buf, Date_t now);
+BSONObj createBSONMetricChunkDocument(ConstDataRange buf,
+                                      Date_t now,
+                                      FTDCType type = FTDCType::kMetricChunk);
 
 /**
  * Get the _id field of a BSON document
@@ -29,6 +29,7 @@
 #include "mongo/platform/basic.h"
 
 #include "mongo/db/ftdc/util.h"
+#include "mongo/db/jsobj.h"
 #include "mongo/unittest/unittest.h"
 
 namespace mongo {
@@ -69,4 +70,51 @@ TEST(FTDCUtilTest, TestMongoSPath) {
     }
 }
 
+// Validate the schema cache extracts the same metrics as a full walk, and only for documents with
+// the layout it learnt
+TEST(FTDCUtilTest, TestMetricSchemaCache) {
+    auto makeDoc = [](int i, StringData name) {
+        return BSON("name" << name << "a" << i << "b"
+                           << BSON("c" << (i * 2LL) << "d" << (i % 2 == 0))
+                           << "ts"
+                           << Timestamp(100 + i, i)
+                           << "date"
+                           << Date_t::fromMillisSinceEpoch(1000 * i)
+                           << "e"
+                           << BSON_ARRAY(1.5 * i << 7));
+    };
+
+    FTDCBSONUtil::MetricSchemaCache cache;
+    std::vector<std::uint64_t> cached;
+    ASSERT_FALSE(cache.extractMetrics(makeDoc(1, "x"), &cached));
+
+    cache.learn(makeDoc(1, "x"));
+    for (int i = 0; i < 10; i++) {
+        BSONObj doc = makeDoc(i, "x");
+
+        std::vector<std::uint64_t> walked;
+        ASSERT_TRUE(FTDCBSONUtil::extractMetricsFromDocument(doc, doc, &walked).getValue());
+
+        cached.clear();
+        ASSERT_TRUE(cache.extractMetrics(doc, &cached));
+        ASSERT_TRUE(walked == cached);
+    }
+
+    // Different non-metric content
+    cached.clear();
+    ASSERT_FALSE(cache.extractMetrics(makeDoc(1, "y"), &cached));
+    ASSERT_TRUE(cached.empty());
+
+    // Different numeric type
+    ASSERT_FALSE(cache.extractMetrics(BSON("name"
+                                           << "x"
+                                           << "a"
+                                           << 1LL),
+                                      &cached));
+
+    // Learning an empty document forgets the layout
+    cache.learn(BSONObj());
+    ASSERT_FALSE(cache.extractMetrics(makeDoc(1, "x"), &cached));
+}
+
 }  // namespace mongo
@@ -0,0 +1,114 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/json.h"
+#include "mongo/db/matcher/expression.h"
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/pipeline/expression_context_for_test.h"
+#include "mongo/unittest/benchmark.h"
+
+namespace mongo {
+namespace {
+
+using unittest::BenchmarkState;
+
+struct Filter {
+    const char* name;
+    const char* json;
+};
+
+const Filter kFilters[] = {
+    {"eq", "{a: 5}"},
+    {"range", "{a: {$gt: 2, $lt: 8}}"},
+    {"in", "{b: {$in: ['v0', 'v1', 'v2', 'v3', 'v4', 'v5', 'v6', 'v7', 'value5']}}"},
+    {"and", "{a: {$gte: 0}, b: 'value5', 'c.d': {$exists: true}}"},
+    {"or", "{$or: [{a: 100}, {b: 'none'}, {'c.d': 3}]}"},
+    {"dottedArray", "{'items.qty': 19}"},
+    {"elemMatch", "{arr: {$elemMatch: {$gt: 15, $lt: 17}}}"},
+    {"regex", "{b: /^val.*5$/}"},
+    {"expr", "{$expr: {$gt: ['$a', '$c.d']}}"},
+};
+
+BSONObj makeDocument() {
+    return fromjson(
+        "{_id: 1, a: 5, b: 'value5', c: {d: 3, e: 'nested'}, pad1: 'padding', pad2: 12.5,"
+        " arr: [1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20],"
+        " items: [{qty: 1}, {qty: 7}, {qty: 13}, {qty: 19}]}");
+}
+
+const Filter& filter(BenchmarkState& state) {
+    const auto& filter = kFilters[state.range()];
+    state.setLabel(filter.name);
+    return filter;
+}
+
+std::unique_ptr<MatchExpression> parseFilter(const BSONObj& query) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    auto swExpr = MatchExpressionParser::parse(query, expCtx);
+    uassertStatusOK(swExpr.getStatus());
+    return MatchExpression::optimize(std::move(swExpr.getValue()));
+}
+
+void BM_MatchExpressionParse(BenchmarkState& state) {
+    const auto query = fromjson(filter(state).json);
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    while (state.keepRunning()) {
+        auto swExpr = MatchExpressionParser::parse(query, expCtx);
+        auto expr = MatchExpression::optimize(std::move(swExpr.getValue()));
+        unittest::doNotOptimize(expr);
+    }
+    state.setItemsProcessed(state.iterations());
+}
+
+void BM_MatchExpressionMatches(BenchmarkState& state) {
+    const auto query = fromjson(filter(state).json);
+    const auto expr = parseFilter(query);
+    const auto document = makeDocument();
+    invariant(expr->matchesBSON(document));
+    while (state.keepRunning()) {
+        auto result = expr->matchesBSON(document);
+        unittest::doNotOptimize(result);
+    }
+    state.setItemsProcessed(state.iterations());
+    state.setBytesProcessed(static_cast<long long>(state.iterations()) * document.objsize());
+}
+
+void allFilters(unittest::Benchmark* benchmark) {
+    for (std::size_t i = 0; i < sizeof(kFilters) / sizeof(kFilters[0]); ++i) {
+        benchmark->arg(i);
+    }
+}
+
+MONGO_BENCHMARK(BM_MatchExpressionParse)->apply(allFilters);
+MONGO_BENCHMARK(BM_MatchExpressionMatches)->apply(allFilters);
+
+}  // namespace
+}  // namespace mongo
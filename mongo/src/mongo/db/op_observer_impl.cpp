@@ -43,6 +43,7 @@
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/pipeline/column_cache.h"
 #include "mongo/db/repl/oplog.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/s/collection_sharding_state.h"
@@ -336,6 +337,11 @@ void OpObserverImpl::onInserts(OperationContext* opCtx,
         }
     }
 
+    auto columnCaches = ColumnCacheCatalog::get(opCtx);
+    for (auto it = begin; it != end; it++) {
+        columnCaches->onInsert(opCtx, nss, it->doc);
+    }
+
     const auto lastOpTime = opTimeList.empty() ? repl::OpTime() : opTimeList.back();
     if (nss.coll() == "system.js") {
         Scope::storedFuncMod(opCtx);
@@ -398,6 +404,8 @@ void OpObserverImpl::onUpdate(OperationContext* opCtx, const OplogUpdateEntryArg
         }
     }
 
+    ColumnCacheCatalog::get(opCtx)->onUpdate(opCtx, args.nss, args.updatedDoc);
+
     if (args.nss.coll() == "system.js") {
         Scope::storedFuncMod(opCtx);
     } else if (args.nss.coll() == DurableViewCatalog::viewsCollectionName()) {
@@ -450,6 +458,8 @@ void OpObserverImpl::onDelete(OperationContext* opCtx,
         }
     }
 
+    ColumnCacheCatalog::get(opCtx)->onDelete(opCtx, nss, deleteState.documentKey);
+
     if (nss.coll() == "system.js") {
         Scope::storedFuncMod(opCtx);
     } else if (nss.coll() == DurableViewCatalog::viewsCollectionName()) {
@@ -625,6 +635,7 @@ void OpObserverImpl::onDropDatabase(OperationContext* opCtx, const std::string&
     }
 
     NamespaceUUIDCache::get(opCtx).evictNamespacesInDatabase(dbName);
+    ColumnCacheCatalog::get(opCtx)->removeDatabase(dbName);
 
     AuthorizationManager::get(opCtx->getServiceContext())
         ->logOp(opCtx, "c", cmdNss, cmdObj, nullptr);
@@ -669,6 +680,7 @@ repl::OpTime OpObserverImpl::onDropCollection(OperationContext* opCtx,
 
     // Evict namespace entry from the namespace/uuid cache if it exists.
     NamespaceUUIDCache::get(opCtx).evictNamespace(collectionName);
+    ColumnCacheCatalog::get(opCtx)->remove(collectionName);
 
     // Remove collection from the uuid catalog.
     if (uuid) {
@@ -753,6 +765,10 @@ repl::OpTime OpObserverImpl::onRenameCollection(OperationContext* opCtx,
     opCtx->recoveryUnit()->onRollback(
         [&cache, toCollection]() { cache.evictNamespace(toCollection); });
 
+    // A column cache does not follow its collection to the new name.
+    ColumnCacheCatalog::get(opCtx)->remove(fromCollection);
+    ColumnCacheCatalog::get(opCtx)->remove(toCollection);
+
     // Finally update the UUID Catalog.
     if (uuid) {
         auto getNewCollection = [opCtx, toCollection] {
@@ -0,0 +1,249 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/operation_trace.h"
+
+#include <algorithm>
+#include <deque>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/client.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+namespace {
+
+// The fraction of operations of each type which are traced.
+MONGO_EXPORT_SERVER_PARAMETER(operationTraceSampleRateQuery, double, 0.0);
+MONGO_EXPORT_SERVER_PARAMETER(operationTraceSampleRateGetMore, double, 0.0);
+MONGO_EXPORT_SERVER_PARAMETER(operationTraceSampleRateInsert, double, 0.0);
+MONGO_EXPORT_SERVER_PARAMETER(operationTraceSampleRateUpdate, double, 0.0);
+MONGO_EXPORT_SERVER_PARAMETER(operationTraceSampleRateDelete, double, 0.0);
+MONGO_EXPORT_SERVER_PARAMETER(operationTraceSampleRateCommand, double, 0.0);
+
+// The number of completed traces kept for getOperationTraces.
+MONGO_EXPORT_SERVER_PARAMETER(operationTraceBufferSize, int, 100);
+
+double sampleRateFor(LogicalOp logicalOp) {
+    switch (logicalOp) {
+        case LogicalOp::opQuery:
+            return operationTraceSampleRateQuery.load();
+        case LogicalOp::opGetMore:
+            return operationTraceSampleRateGetMore.load();
+        case LogicalOp::opInsert:
+            return operationTraceSampleRateInsert.load();
+        case LogicalOp::opUpdate:
+            return operationTraceSampleRateUpdate.load();
+        case LogicalOp::opDelete:
+            return operationTraceSampleRateDelete.load();
+        default:
+            return operationTraceSampleRateCommand.load();
+    }
+}
+
+struct ClientTraceState {
+    // When the ServiceStateMachine started processing the current message, or 0 between messages.
+    long long messageStartMicros = 0;
+    long long sinkStartMicros = 0;
+    std::unique_ptr<OperationTrace> trace;
+};
+
+const auto getClientTraceState = Client::declareDecoration<ClientTraceState>();
+
+stdx::mutex recentTracesMutex;
+std::deque<BSONObj> recentTraces;
+
+void addRecentTrace(BSONObj trace) {
+    const size_t capacity = std::max(operationTraceBufferSize.load(), 0);
+
+    stdx::lock_guard<stdx::mutex> lk(recentTracesMutex);
+    recentTraces.push_back(std::move(trace));
+    while (recentTraces.size() > capacity) {
+        recentTraces.pop_front();
+    }
+}
+
+}  // namespace
+
+StringData OperationTrace::phaseName(Phase phase) {
+    switch (phase) {
+        case Phase::kTicketWait:
+            return "ticketWait"_sd;
+        case Phase::kLockWait:
+            return "lockWait"_sd;
+        case Phase::kPlanSelection:
+            return "planSelection"_sd;
+        case Phase::kYield:
+            return "yield"_sd;
+        case Phase::kStorageBegin:
+            return "storageBegin"_sd;
+        case Phase::kStorageCommit:
+            return "storageCommit"_sd;
+        case Phase::kNetworkWrite:
+            return "networkWrite"_sd;
+        case Phase::kNumPhases:
+            break;
+    }
+    MONGO_UNREACHABLE;
+}
+
+OperationTrace::OperationTrace(StringData opName, LogicalOp logicalOp, long long startMicros)
+    : _opName(opName.toString()), _logicalOp(logicalOp), _startMicros(startMicros) {}
+
+void OperationTrace::addSpan(Phase phase, long long startMicros, long long endMicros) {
+    const long long durationMicros = std::max(endMicros - startMicros, 0LL);
+
+    PhaseTotal& total = _totals[static_cast<size_t>(phase)];
+    total.count++;
+    total.micros += durationMicros;
+
+    if (_spans.size() < kMaxSpans) {
+        _spans.push_back({phase, startMicros - _startMicros, durationMicros});
+    } else {
+        _droppedSpans++;
+    }
+}
+
+BSONObj OperationTrace::toBSON() const {
+    const long long endMicros = _endMicros ? _endMicros : static_cast<long long>(curTimeMicros64());
+
+    BSONObjBuilder builder;
+    builder.append("op", _opName);
+    builder.append("type", logicalOpToString(_logicalOp));
+    builder.append("start", Date_t::fromMillisSinceEpoch(_startMicros / 1000));
+    builder.append("durationMicros", endMicros - _startMicros);
+    {
+        BSONObjBuilder phasesBuilder(builder.subobjStart("phases"));
+        for (size_t i = 0; i < _totals.size(); i++) {
+            if (_totals[i].count) {
+                BSONObjBuilder phaseBuilder(
+                    phasesBuilder.subobjStart(phaseName(static_cast<Phase>(i))));
+                phaseBuilder.append("count", _totals[i].count);
+                phaseBuilder.append("micros", _totals[i].micros);
+            }
+        }
+    }
+    {
+        BSONArrayBuilder spansBuilder(builder.subarrayStart("spans"));
+        for (auto&& span : _spans) {
+            BSONObjBuilder spanBuilder(spansBuilder.subobjStart());
+            spanBuilder.append("phase", phaseName(span.phase));
+            spanBuilder.append("offsetMicros", span.startMicros);
+            spanBuilder.append("micros", span.durationMicros);
+        }
+    }
+    if (_droppedSpans) {
+        builder.append("droppedSpans", _droppedSpans);
+    }
+    return builder.obj();
+}
+
+const OperationTrace* OperationTrace::get(Client* client) {
+    return getClientTraceState(client).trace.get();
+}
+
+void OperationTrace::maybeSample(OperationContext* opCtx,
+                                 StringData opName,
+                                 LogicalOp logicalOp) {
+    Client* client = opCtx->getClient();
+    auto& state = getClientTraceState(client);
+    if (state.trace || !state.messageStartMicros || client->isInDirectClient()) {
+        return;
+    }
+
+    const double sampleRate = sampleRateFor(logicalOp);
+    if (sampleRate <= 0 ||
+        (sampleRate < 1 && client->getPrng().nextCanonicalDouble() >= sampleRate)) {
+        return;
+    }
+
+    state.trace = stdx::make_unique<OperationTrace>(opName, logicalOp, state.messageStartMicros);
+}
+
+void OperationTrace::onMessageStart(Client* client) {
+    auto& state = getClientTraceState(client);
+    state.messageStartMicros = curTimeMicros64();
+    state.trace.reset();
+}
+
+void OperationTrace::onSinkStart(Client* client) {
+    auto& state = getClientTraceState(client);
+    if (state.trace) {
+        state.sinkStartMicros = curTimeMicros64();
+    }
+}
+
+void OperationTrace::onMessageDone(Client* client) {
+    auto& state = getClientTraceState(client);
+    state.messageStartMicros = 0;
+    if (!state.trace) {
+        return;
+    }
+
+    const long long now = curTimeMicros64();
+    if (state.sinkStartMicros) {
+        state.trace->addSpan(Phase::kNetworkWrite, state.sinkStartMicros, now);
+        state.sinkStartMicros = 0;
+    }
+    state.trace->_endMicros = now;
+
+    addRecentTrace(state.trace->toBSON());
+    state.trace.reset();
+}
+
+std::vector<BSONObj> OperationTrace::getRecentTraces() {
+    stdx::lock_guard<stdx::mutex> lk(recentTracesMutex);
+    return std::vector<BSONObj>(recentTraces.begin(), recentTraces.end());
+}
+
+OperationTrace::Span::Span(Phase phase) : _trace(nullptr), _phase(phase) {
+    Client* client = Client::getCurrent();
+    if (!client) {
+        return;
+    }
+    _trace = getClientTraceState(client).trace.get();
+    if (_trace) {
+        _startMicros = curTimeMicros64();
+    }
+}
+
+OperationTrace::Span::~Span() {
+    if (_trace) {
+        _trace->addSpan(_phase, _startMicros, curTimeMicros64());
+    }
+}
+
+}  // namespace mongo
@@ -0,0 +1,158 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+
+#pragma once
+
+#include <array>
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/util/net/message.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+class Client;
+class OperationContext;
+
+/**
+ * A timeline of where a single sampled operation spent its time. Spans are recorded at the phase
+ * boundaries which most often explain latency outliers: waiting for a storage engine ticket or a
+ * lock, selecting a plan, yielding, beginning and committing storage engine transactions and
+ * writing the reply to the network.
+ *
+ * Operations are sampled when their type is known, at the rate configured for that type by the
+ * operationTraceSampleRate* server parameters, which all default to 0. Only operations received
+ * through the ServiceStateMachine are traced. The trace of an operation is appended to its slow
+ * query log line, and once its reply has been written the trace is kept in a ring buffer of the
+ * most recent traces, which is read by the getOperationTraces command.
+ *
+ * The trace belongs to the Client running the operation and is only accessed by the thread which
+ * currently owns that Client.
+ */
+class OperationTrace {
+    MONGO_DISALLOW_COPYING(OperationTrace);
+
+public:
+    enum class Phase {
+        kTicketWait,
+        kLockWait,
+        kPlanSelection,
+        kYield,
+        kStorageBegin,
+        kStorageCommit,
+        kNetworkWrite,
+
+        kNumPhases
+    };
+
+    // Spans after the first kMaxSpans are only added to the per-phase totals.
+    static const size_t kMaxSpans = 64;
+
+    static StringData phaseName(Phase phase);
+
+    OperationTrace(StringData opName, LogicalOp logicalOp, long long startMicros);
+
+    /**
+     * Records that the operation spent [startMicros, endMicros) in 'phase'.
+     */
+    void addSpan(Phase phase, long long startMicros, long long endMicros);
+
+    BSONObj toBSON() const;
+
+    /**
+     * Returns the trace of the operation 'client' is running, or nullptr if it is not sampled.
+     */
+    static const OperationTrace* get(Client* client);
+
+    /**
+     * Decides whether to trace the operation running on 'opCtx', which has just been identified as
+     * 'opName' of type 'logicalOp'. Does nothing for operations which are already traced, run
+     * through DBDirectClient or were not received through the ServiceStateMachine.
+     */
+    static void maybeSample(OperationContext* opCtx, StringData opName, LogicalOp logicalOp);
+
+    /**
+     * Hooks through which the ServiceStateMachine marks the start of processing a message, the
+     * start of writing its reply and the end of the message's handling. The trace, if any, is
+     * moved into the ring buffer by onMessageDone().
+     */
+    static void onMessageStart(Client* client);
+    static void onSinkStart(Client* client);
+    static void onMessageDone(Client* client);
+
+    /**
+     * Returns copies of the most recently completed traces, oldest first.
+     */
+    static std::vector<BSONObj> getRecentTraces();
+
+    /**
+     * Records the time between its construction and destruction as a span of 'phase' in the trace
+     * of the operation running on the current thread, if it is sampled. Costs a thread local
+     * lookup when it is not.
+     */
+    class Span {
+        MONGO_DISALLOW_COPYING(Span);
+
+    public:
+        explicit Span(Phase phase);
+        ~Span();
+
+    private:
+        OperationTrace* _trace;
+        Phase _phase;
+        long long _startMicros = 0;
+    };
+
+private:
+    struct SpanEntry {
+        Phase phase;
+        long long startMicros;
+        long long durationMicros;
+    };
+
+    struct PhaseTotal {
+        long long count = 0;
+        long long micros = 0;
+    };
+
+    const std::string _opName;
+    const LogicalOp _logicalOp;
+    const long long _startMicros;
+    long long _endMicros = 0;
+
+    std::vector<SpanEntry> _spans;
+    long long _droppedSpans = 0;
+    std::array<PhaseTotal, static_cast<size_t>(Phase::kNumPhases)> _totals;
+};
+
+}  // namespace mongo
@@ -0,0 +1,144 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/operation_trace.h"
+
+#include "mongo/db/client.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/service_context_noop.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace {
+
+void setParameter(StringData name, StringData value) {
+    auto& params = ServerParameterSet::getGlobal()->getMap();
+    auto it = params.find(name.toString());
+    invariant(it != params.end());
+    ASSERT_OK(it->second->setFromString(value.toString()));
+}
+
+TEST(OperationTraceTest, SpansAreTotalledPerPhase) {
+    OperationTrace trace("find", LogicalOp::opQuery, 1000);
+    trace.addSpan(OperationTrace::Phase::kLockWait, 1010, 1030);
+    trace.addSpan(OperationTrace::Phase::kPlanSelection, 1030, 1100);
+    trace.addSpan(OperationTrace::Phase::kLockWait, 1100, 1105);
+
+    BSONObj obj = trace.toBSON();
+    ASSERT_EQ(obj["op"].String(), "find");
+    ASSERT_EQ(obj["type"].String(), "query");
+    ASSERT_BSONOBJ_EQ(obj["phases"].Obj(),
+                      BSON("lockWait" << BSON("count" << 2LL << "micros" << 25LL)
+                                      << "planSelection"
+                                      << BSON("count" << 1LL << "micros" << 70LL)));
+
+    std::vector<BSONElement> spans = obj["spans"].Array();
+    ASSERT_EQ(spans.size(), 3U);
+    ASSERT_BSONOBJ_EQ(spans[0].Obj(),
+                      BSON("phase"
+                           << "lockWait"
+                           << "offsetMicros"
+                           << 10LL
+                           << "micros"
+                           << 20LL));
+    ASSERT_FALSE(obj.hasField("droppedSpans"));
+}
+
+TEST(OperationTraceTest, SpansBeyondTheLimitAreOnlyTotalled) {
+    OperationTrace trace("insert", LogicalOp::opInsert, 0);
+    const size_t numSpans = OperationTrace::kMaxSpans + 10;
+    for (size_t i = 0; i < numSpans; i++) {
+        trace.addSpan(OperationTrace::Phase::kStorageCommit, i, i + 1);
+    }
+
+    BSONObj obj = trace.toBSON();
+    ASSERT_EQ(obj["spans"].Array().size(), OperationTrace::kMaxSpans);
+    ASSERT_EQ(obj["droppedSpans"].numberLong(), 10LL);
+    ASSERT_EQ(obj["phases"]["storageCommit"]["count"].numberLong(),
+              static_cast<long long>(numSpans));
+}
+
+TEST(OperationTraceTest, SampledOperationIsKeptOnceItsMessageIsDone) {
+    setParameter("operationTraceSampleRateInsert", "1");
+    ON_BLOCK_EXIT([] { setParameter("operationTraceSampleRateInsert", "0"); });
+
+    ServiceContextNoop serviceContext;
+    Client::setCurrent(serviceContext.makeClient("OperationTraceTest"));
+    ON_BLOCK_EXIT([] { Client::releaseCurrent(); });
+    Client* client = Client::getCurrent();
+
+    const size_t numTracesBefore = OperationTrace::getRecentTraces().size();
+
+    OperationTrace::onMessageStart(client);
+    {
+        auto opCtx = client->makeOperationContext();
+        OperationTrace::maybeSample(opCtx.get(), "insert", LogicalOp::opInsert);
+        ASSERT(OperationTrace::get(client));
+        { OperationTrace::Span span(OperationTrace::Phase::kStorageCommit); }
+    }
+    OperationTrace::onSinkStart(client);
+    OperationTrace::onMessageDone(client);
+    ASSERT_FALSE(OperationTrace::get(client));
+
+    std::vector<BSONObj> traces = OperationTrace::getRecentTraces();
+    ASSERT_EQ(traces.size(), numTracesBefore + 1);
+    BSONObj phases = traces.back()["phases"].Obj();
+    ASSERT_EQ(phases["storageCommit"]["count"].numberLong(), 1LL);
+    ASSERT_EQ(phases["networkWrite"]["count"].numberLong(), 1LL);
+}
+
+TEST(OperationTraceTest, UnsampledOperationTypesAreNotTraced) {
+    ServiceContextNoop serviceContext;
+    auto client = serviceContext.makeClient("OperationTraceTest");
+
+    OperationTrace::onMessageStart(client.get());
+    auto opCtx = client->makeOperationContext();
+    OperationTrace::maybeSample(opCtx.get(), "update", LogicalOp::opUpdate);
+    ASSERT_FALSE(OperationTrace::get(client.get()));
+    OperationTrace::onMessageDone(client.get());
+}
+
+TEST(OperationTraceTest, OperationsOutsideAMessageAreNotTraced) {
+    setParameter("operationTraceSampleRateCommand", "1");
+    ON_BLOCK_EXIT([] { setParameter("operationTraceSampleRateCommand", "0"); });
+
+    ServiceContextNoop serviceContext;
+    auto client = serviceContext.makeClient("OperationTraceTest");
+    auto opCtx = client->makeOperationContext();
+    OperationTrace::maybeSample(opCtx.get(), "ping", LogicalOp::opCommand);
+    ASSERT_FALSE(OperationTrace::get(client.get()));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -169,7 +169,10 @@ StatusWith<BSONObj> fixDocumentForInsert(ServiceContext* service, const BSONObj&
 
     BSONObjIterator i(doc);
 
-    BSONObjBuilder b(doc.objsize() + 16);
+    // Size the builder for exactly the new document, so that it is copied only once. Generating an
+    // _id adds its type byte, its name and an ObjectId.
+    const int generatedIdSize = hadId ? 0 : 1 + sizeof("_id") + OID::kOIDSize;
+    BSONObjBuilder b(doc.objsize() + generatedIdSize);
     if (firstElementIsId) { //ͻдһelemʹ_ID
         b.append(doc.firstElement()); //ֱappendµBSONObjBuilder
         i.next();
@@ -39,6 +39,7 @@
 #include "mongo/db/catalog/database_holder.h"
 #include "mongo/db/catalog/document_validation.h"
 #include "mongo/db/commands.h"
+#include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/curop_metrics.h"
 #include "mongo/db/db_raii.h"
@@ -82,6 +83,19 @@ MONGO_FP_DECLARE(failAllInserts);
 MONGO_FP_DECLARE(failAllUpdates);
 MONGO_FP_DECLARE(failAllRemoves);
 
+// Inserted documents are normally passed to the storage engine and the oplog straight out of the
+// request message. These count how often a document had to be rebuilt first instead, because an
+// _id had to be generated or timestamps filled in.
+Counter64 insertDocsFromRequest;
+Counter64 insertDocsCopied;
+Counter64 insertBytesCopied;
+ServerStatusMetricField<Counter64> displayInsertDocsFromRequest("insert.documentsFromRequest",
+                                                                &insertDocsFromRequest);
+ServerStatusMetricField<Counter64> displayInsertDocsCopied("insert.documentsCopied",
+                                                           &insertDocsCopied);
+ServerStatusMetricField<Counter64> displayInsertBytesCopied("insert.bytesCopied",
+                                                            &insertBytesCopied);
+
 //performUpdates   performDeletes
 void finishCurOp(OperationContext* opCtx, CurOp* curOp) {
     try {
@@ -584,6 +598,12 @@ WriteResult performInserts(OperationContext* opCtx, const write_ops::Insert& who
             }
 
             BSONObj toInsert = fixedDoc.getValue().isEmpty() ? doc : std::move(fixedDoc.getValue());
+            if (toInsert.objdata() == doc.objdata()) {
+                insertDocsFromRequest.increment();
+            } else {
+                insertDocsCopied.increment();
+                insertBytesCopied.increment(toInsert.objsize());
+            }
 			// db.collname.insert({"name":"coutamg1", "age":22})
 			//ddd test performInserts... doc:{ _id: ObjectId('5badf00412ee982ae019e0c1'), name: "coutamg1", age: 22.0 }
 			//log() << "ddd test performInserts... doc:" << redact(toInsert);
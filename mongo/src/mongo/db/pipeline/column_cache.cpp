@@ -0,0 +1,524 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/column_cache.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/service_context.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+namespace {
+
+const auto getColumnCacheCatalog = ServiceContext::declareDecoration<ColumnCacheCatalog>();
+
+}  // namespace
+
+void ColumnCache::Column::resize(size_t rows) {
+    _types.resize(rows, static_cast<signed char>(EOO));
+    _payloads.resize(rows, 0);
+}
+
+void ColumnCache::Column::clear(size_t row) {
+    const BSONType type = static_cast<BSONType>(_types[row]);
+    switch (type) {
+        case EOO:
+        case NumberInt:
+        case NumberLong:
+        case NumberDouble:
+        case Bool:
+        case Date:
+            break;
+        case String: {
+            // Forget strings which no row holds any more, so that churn on a string field doesn't
+            // grow the dictionary until the cache outgrows its memory limit.
+            const auto index = static_cast<uint32_t>(_payloads[row]);
+            if (--_stringRefs[index] == 0) {
+                _stringBytes -= 2 * _strings[index].getApproximateSize();
+                _stringIds.erase(_strings[index].getString());
+                _strings[index] = Value();
+                _freeStrings.push_back(index);
+            }
+            break;
+        }
+        default: {
+            const auto index = static_cast<uint32_t>(_payloads[row]);
+            _valueBytes -= _values[index].getApproximateSize();
+            _values[index] = Value();
+            _freeValues.push_back(index);
+            break;
+        }
+    }
+    _types[row] = static_cast<signed char>(EOO);
+    _payloads[row] = 0;
+}
+
+void ColumnCache::Column::set(size_t row, const BSONElement& elem) {
+    clear(row);
+
+    int64_t payload = 0;
+    switch (elem.type()) {
+        case EOO:
+            return;
+        case NumberInt:
+            payload = elem._numberInt();
+            break;
+        case NumberLong:
+            payload = elem._numberLong();
+            break;
+        case NumberDouble: {
+            const double d = elem._numberDouble();
+            std::memcpy(&payload, &d, sizeof(d));
+            break;
+        }
+        case Bool:
+            payload = elem.boolean();
+            break;
+        case Date:
+            payload = elem.date().toMillisSinceEpoch();
+            break;
+        case String: {
+            const StringData str = elem.valueStringData();
+            auto it = _stringIds.find(str);
+            if (it == _stringIds.end()) {
+                Value value(str);
+                // Once for the Value and once for the key in '_stringIds'.
+                _stringBytes += 2 * value.getApproximateSize();
+                uint32_t index;
+                if (_freeStrings.empty()) {
+                    index = _strings.size();
+                    _strings.push_back(std::move(value));
+                    _stringRefs.push_back(0);
+                } else {
+                    index = _freeStrings.back();
+                    _freeStrings.pop_back();
+                    _strings[index] = std::move(value);
+                }
+                it = _stringIds.try_emplace(str, index).first;
+            }
+            payload = it->second;
+            ++_stringRefs[payload];
+            break;
+        }
+        default: {
+            Value value(elem);
+            _valueBytes += value.getApproximateSize();
+            if (_freeValues.empty()) {
+                payload = _values.size();
+                _values.push_back(std::move(value));
+            } else {
+                payload = _freeValues.back();
+                _freeValues.pop_back();
+                _values[payload] = std::move(value);
+            }
+            break;
+        }
+    }
+
+    _types[row] = static_cast<signed char>(elem.type());
+    _payloads[row] = payload;
+}
+
+Value ColumnCache::Column::get(size_t row) const {
+    const int64_t payload = _payloads[row];
+    switch (static_cast<BSONType>(_types[row])) {
+        case EOO:
+            return Value();
+        case NumberInt:
+            return Value(static_cast<int>(payload));
+        case NumberLong:
+            return Value(static_cast<long long>(payload));
+        case NumberDouble: {
+            double d;
+            std::memcpy(&d, &payload, sizeof(d));
+            return Value(d);
+        }
+        case Bool:
+            return Value(payload != 0);
+        case Date:
+            return Value(Date_t::fromMillisSinceEpoch(payload));
+        case String:
+            return _strings[payload];
+        default:
+            return _values[payload];
+    }
+}
+
+size_t ColumnCache::Column::approximateBytes() const {
+    size_t bytes = _types.capacity() * sizeof(_types[0]) +
+        _payloads.capacity() * sizeof(_payloads[0]) + _values.capacity() * sizeof(Value) +
+        _freeValues.capacity() * sizeof(_freeValues[0]) + _valueBytes +
+        _strings.capacity() * sizeof(Value) + _stringRefs.capacity() * sizeof(uint32_t) +
+        _freeStrings.capacity() * sizeof(uint32_t) + _stringBytes;
+    return bytes;
+}
+
+ColumnCache::ColumnCache(NamespaceString nss,
+                         std::vector<std::string> fieldNames,
+                         size_t maxBytes)
+    : _nss(std::move(nss)),
+      _fieldNames(std::move(fieldNames)),
+      _maxBytes(maxBytes),
+      _columns(_fieldNames.size()) {}
+
+bool ColumnCache::covers(const std::set<std::string>& fieldPaths) const {
+    for (auto&& path : fieldPaths) {
+        const StringData topLevel = StringData(path).substr(0, path.find('.'));
+        if (topLevel == "_id"_sd) {
+            continue;
+        }
+        if (std::find(_fieldNames.begin(), _fieldNames.end(), topLevel) == _fieldNames.end()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void ColumnCache::setRow(size_t row, const Value& id, const BSONObj& doc) {
+    _ids[row] = id;
+    for (size_t i = 0; i < _columns.size(); ++i) {
+        _columns[i].set(row, doc[_fieldNames[i]]);
+    }
+}
+
+void ColumnCache::clearRow(size_t row) {
+    _ids[row] = Value();
+    for (auto&& column : _columns) {
+        column.set(row, BSONElement());
+    }
+    _freeRows.push_back(row);
+}
+
+void ColumnCache::replace(const BSONElement& id, const boost::optional<BSONObj>& doc) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (!_valid.load()) {
+        return;
+    }
+    _replace_inlock(Value(id), doc, 0);
+}
+
+BSONObj ColumnCache::cachedFields(const BSONObj& doc) const {
+    BSONObjBuilder bob;
+    bob.append(doc["_id"]);
+    for (auto&& fieldName : _fieldNames) {
+        const BSONElement elem = doc[fieldName];
+        if (!elem.eoo()) {
+            bob.append(elem);
+        }
+    }
+    return bob.obj();
+}
+
+long long ColumnCache::beginWrite() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    const long long version = _nextVersion++;
+    _pendingVersions.insert(version);
+    return version;
+}
+
+void ColumnCache::commitWrite(const BSONElement& id,
+                              const boost::optional<BSONObj>& doc,
+                              long long version) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _pendingVersions.erase(version);
+    if (!_valid.load()) {
+        return;
+    }
+
+    const Value idValue(id);
+    auto row = _rowById.find(idValue);
+    if (row != _rowById.end()) {
+        if (_versions[row->second] > version) {
+            return;
+        }
+    } else {
+        auto tombstone = _tombstoneById.find(idValue);
+        if (tombstone != _tombstoneById.end() && tombstone->second > version) {
+            return;
+        }
+    }
+
+    _replace_inlock(idValue, doc, version);
+    _pruneTombstones_inlock();
+}
+
+void ColumnCache::abortWrite(long long version) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _pendingVersions.erase(version);
+    if (_valid.load()) {
+        _pruneTombstones_inlock();
+    }
+}
+
+void ColumnCache::_replace_inlock(const Value& id,
+                                  const boost::optional<BSONObj>& doc,
+                                  long long version) {
+    auto tombstone = _tombstoneById.find(id);
+    if (tombstone != _tombstoneById.end()) {
+        _tombstoneByVersion.erase(tombstone->second);
+        _tombstoneById.erase(tombstone);
+    }
+
+    auto it = _rowById.find(id);
+    if (it != _rowById.end()) {
+        if (doc) {
+            setRow(it->second, id, *doc);
+            _versions[it->second] = version;
+        } else {
+            clearRow(it->second);
+            _rowById.erase(it);
+        }
+    } else if (doc) {
+        size_t row;
+        if (_freeRows.empty()) {
+            row = _ids.size();
+            _ids.resize(row + 1);
+            _versions.resize(row + 1);
+            for (auto&& column : _columns) {
+                column.resize(row + 1);
+            }
+        } else {
+            row = _freeRows.back();
+            _freeRows.pop_back();
+        }
+        setRow(row, id, *doc);
+        _versions[row] = version;
+        _rowById.emplace(id, row);
+    }
+
+    if (!doc && version) {
+        _tombstoneById[id] = version;
+        _tombstoneByVersion.emplace(version, id);
+    }
+
+    if (_approximateBytes_inlock() > _maxBytes) {
+        _clear_inlock();
+    }
+}
+
+void ColumnCache::_pruneTombstones_inlock() {
+    const long long oldestPending =
+        _pendingVersions.empty() ? _nextVersion : *_pendingVersions.begin();
+    while (!_tombstoneByVersion.empty() && _tombstoneByVersion.begin()->first < oldestPending) {
+        _tombstoneById.erase(_tombstoneByVersion.begin()->second);
+        _tombstoneByVersion.erase(_tombstoneByVersion.begin());
+    }
+}
+
+bool ColumnCache::fetch(size_t* position,
+                        size_t maxRows,
+                        bool includeId,
+                        const std::vector<size_t>& fieldIndexes,
+                        std::deque<Document>* out) const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    uassert(ErrorCodes::QueryPlanKilled,
+            str::stream() << "column cache for " << _nss.ns() << " was dropped",
+            _valid.load());
+
+    size_t added = 0;
+    size_t row = *position;
+    for (; row < _ids.size() && added < maxRows; ++row) {
+        if (_ids[row].missing()) {
+            continue;
+        }
+
+        MutableDocument doc(fieldIndexes.size() + (includeId ? 1 : 0));
+        if (includeId) {
+            doc.addField("_id", _ids[row]);
+        }
+        for (size_t index : fieldIndexes) {
+            Value value = _columns[index].get(row);
+            if (!value.missing()) {
+                doc.addField(_fieldNames[index], std::move(value));
+            }
+        }
+        out->push_back(doc.freeze());
+        ++added;
+    }
+
+    *position = row;
+    return added > 0;
+}
+
+void ColumnCache::invalidate() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _clear_inlock();
+}
+
+void ColumnCache::_clear_inlock() {
+    _valid.store(false);
+    _columns.clear();
+    _ids.clear();
+    _versions.clear();
+    _rowById.clear();
+    _freeRows.clear();
+    _tombstoneById.clear();
+    _tombstoneByVersion.clear();
+}
+
+size_t ColumnCache::numRows() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _rowById.size();
+}
+
+size_t ColumnCache::approximateBytes() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _approximateBytes_inlock();
+}
+
+size_t ColumnCache::_approximateBytes_inlock() const {
+    size_t bytes = _ids.capacity() * sizeof(Value) + _versions.capacity() * sizeof(long long) +
+        _rowById.size() * 2 * sizeof(Value) +
+        _tombstoneById.size() * 2 * (sizeof(Value) + sizeof(long long));
+    for (auto&& column : _columns) {
+        bytes += column.approximateBytes();
+    }
+    return bytes;
+}
+
+ColumnCacheCatalog* ColumnCacheCatalog::get(ServiceContext* service) {
+    return &getColumnCacheCatalog(service);
+}
+
+ColumnCacheCatalog* ColumnCacheCatalog::get(OperationContext* opCtx) {
+    return get(opCtx->getServiceContext());
+}
+
+std::shared_ptr<ColumnCache> ColumnCacheCatalog::lookup(const NamespaceString& nss) const {
+    if (_numCaches.load() == 0) {
+        return nullptr;
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    auto it = _caches.find(nss);
+    if (it == _caches.end() || !it->second->isValid()) {
+        return nullptr;
+    }
+    return it->second;
+}
+
+void ColumnCacheCatalog::install(std::shared_ptr<ColumnCache> cache) {
+    invariant(cache);
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    auto& slot = _caches[cache->ns()];
+    if (slot) {
+        slot->invalidate();
+    }
+    slot = std::move(cache);
+    _numCaches.store(_caches.size());
+}
+
+void ColumnCacheCatalog::remove(const NamespaceString& nss) {
+    if (_numCaches.load() == 0) {
+        return;
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    auto it = _caches.find(nss);
+    if (it != _caches.end()) {
+        it->second->invalidate();
+        _caches.erase(it);
+    }
+    _numCaches.store(_caches.size());
+}
+
+void ColumnCacheCatalog::removeDatabase(StringData dbName) {
+    if (_numCaches.load() == 0) {
+        return;
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    for (auto it = _caches.begin(); it != _caches.end();) {
+        if (it->first.db() == dbName) {
+            it->second->invalidate();
+            it = _caches.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    _numCaches.store(_caches.size());
+}
+
+void ColumnCacheCatalog::onInsert(OperationContext* opCtx,
+                                  const NamespaceString& nss,
+                                  const BSONObj& doc) {
+    _replace(opCtx, nss, doc["_id"], doc);
+}
+
+void ColumnCacheCatalog::onUpdate(OperationContext* opCtx,
+                                  const NamespaceString& nss,
+                                  const BSONObj& updatedDoc) {
+    _replace(opCtx, nss, updatedDoc["_id"], updatedDoc);
+}
+
+void ColumnCacheCatalog::onDelete(OperationContext* opCtx,
+                                  const NamespaceString& nss,
+                                  const BSONObj& documentKey) {
+    _replace(opCtx, nss, documentKey["_id"], boost::none);
+}
+
+void ColumnCacheCatalog::_replace(OperationContext* opCtx,
+                                  const NamespaceString& nss,
+                                  const BSONElement& id,
+                                  const boost::optional<BSONObj>& doc) {
+    auto cache = lookup(nss);
+    if (!cache) {
+        return;
+    }
+
+    if (id.eoo()) {
+        // Without an _id the row cannot be found again, so the cache can no longer be kept in
+        // sync.
+        remove(nss);
+        return;
+    }
+
+    // Scans read the cache outside of any storage snapshot, so the write is only applied once it
+    // commits. The documents handed to the OpObserver don't outlive the write, so keep a copy of
+    // the cached fields.
+    const BSONObj idObj = id.wrap();
+    boost::optional<BSONObj> fields;
+    if (doc) {
+        fields = cache->cachedFields(*doc);
+    }
+    const long long version = cache->beginWrite();
+    opCtx->recoveryUnit()->onCommit([cache, idObj, fields, version] {
+        cache->commitWrite(idObj.firstElement(), fields, version);
+    });
+    opCtx->recoveryUnit()->onRollback([cache, version] { cache->abortWrite(version); });
+}
+
+}  // namespace mongo
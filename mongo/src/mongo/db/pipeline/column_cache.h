@@ -0,0 +1,277 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/value.h"
+#include "mongo/db/pipeline/value_comparator.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/string_map.h"
+
+namespace mongo {
+
+class OperationContext;
+class ServiceContext;
+
+/**
+ * An in-memory, column oriented copy of a few top-level fields of every document in a collection.
+ *
+ * Each cached field is stored as a column of type tags and fixed-width payloads, with strings
+ * dictionary encoded, so that an aggregation which only needs those fields can be answered without
+ * reading or parsing the documents themselves. Rows are keyed by _id; the slots of removed rows are
+ * reused by later inserts.
+ *
+ * The cache is kept up to date by the OpObserver (see ColumnCacheCatalog), which applies each
+ * write only once it commits, and is dropped rather than allowed to go stale: once invalidate() has
+ * been called or it has grown past its memory limit, it stops accepting changes and any scan still
+ * reading it fails.
+ *
+ * Writes commit in a different order than their commit handlers run, so each write is given a
+ * version when it is made, and a row only takes a committed write with a higher version than the
+ * one it holds. Deleted rows leave their version behind until no earlier write can still commit.
+ */
+class ColumnCache {
+    MONGO_DISALLOW_COPYING(ColumnCache);
+
+public:
+    ColumnCache(NamespaceString nss, std::vector<std::string> fieldNames, size_t maxBytes);
+
+    const NamespaceString& ns() const {
+        return _nss;
+    }
+
+    const std::vector<std::string>& fieldNames() const {
+        return _fieldNames;
+    }
+
+    /**
+     * Returns true if every path in 'fieldPaths' can be answered from the cache, that is if each
+     * path is "_id" or a cached field, or lies within one of them.
+     */
+    bool covers(const std::set<std::string>& fieldPaths) const;
+
+    /**
+     * Makes the row for the document with _id 'id' hold the cached fields of 'doc', or removes the
+     * row if 'doc' is boost::none.
+     */
+    void replace(const BSONElement& id, const boost::optional<BSONObj>& doc);
+
+    /**
+     * Returns the _id and the cached fields of 'doc', in a buffer of their own.
+     */
+    BSONObj cachedFields(const BSONObj& doc) const;
+
+    /**
+     * Reserves the version of a write which is about to be made. Every reserved version must be
+     * passed to either commitWrite() or abortWrite().
+     */
+    long long beginWrite();
+
+    /**
+     * Applies the committed write of 'version', like replace(), unless the row already holds a
+     * write with a higher version.
+     */
+    void commitWrite(const BSONElement& id,
+                     const boost::optional<BSONObj>& doc,
+                     long long version);
+
+    /**
+     * Forgets the write of 'version', which rolled back.
+     */
+    void abortWrite(long long version);
+
+    /**
+     * Appends to 'out' a document holding the requested fields for each row from '*position'
+     * onwards, stopping after 'maxRows' documents, and advances '*position' past the rows read.
+     * Only "_id" and the cached fields can be requested; 'fieldIndexes' holds indexes into
+     * fieldNames(), and '_id' is included if 'includeId' is true. Returns false once there are no
+     * rows left.
+     *
+     * Throws QueryPlanKilled if the cache has been invalidated.
+     */
+    bool fetch(size_t* position,
+               size_t maxRows,
+               bool includeId,
+               const std::vector<size_t>& fieldIndexes,
+               std::deque<Document>* out) const;
+
+    /**
+     * Marks the cache as no longer in sync with the collection.
+     */
+    void invalidate();
+
+    bool isValid() const {
+        return _valid.load();
+    }
+
+    size_t numRows() const;
+    size_t approximateBytes() const;
+
+private:
+    /**
+     * The values of one field across all rows.
+     */
+    class Column {
+    public:
+        void resize(size_t rows);
+
+        /**
+         * Sets the value in 'row', or marks it missing if 'elem' is EOO.
+         */
+        void set(size_t row, const BSONElement& elem);
+        Value get(size_t row) const;
+
+        size_t approximateBytes() const;
+
+    private:
+        void clear(size_t row);
+
+        // BSONType of each row, EOO if the field is missing.
+        std::vector<signed char> _types;
+
+        // The value for numbers, booleans and dates, the index into '_strings' for strings and the
+        // index into '_values' for any other type.
+        std::vector<int64_t> _payloads;
+
+        // The distinct strings held by some row, with the number of rows holding each. Unused
+        // entries are recycled.
+        std::vector<Value> _strings;
+        std::vector<uint32_t> _stringRefs;
+        std::vector<uint32_t> _freeStrings;
+        StringMap<uint32_t> _stringIds;
+        size_t _stringBytes = 0;
+
+        std::vector<Value> _values;
+        std::vector<uint32_t> _freeValues;
+        size_t _valueBytes = 0;
+    };
+
+    void setRow(size_t row, const Value& id, const BSONObj& doc);
+    void clearRow(size_t row);
+
+    void _replace_inlock(const Value& id, const boost::optional<BSONObj>& doc, long long version);
+
+    /**
+     * Forgets the versions of deleted rows which no write still in progress can be older than.
+     */
+    void _pruneTombstones_inlock();
+
+    void _clear_inlock();
+    size_t _approximateBytes_inlock() const;
+
+    const NamespaceString _nss;
+    const std::vector<std::string> _fieldNames;
+    const size_t _maxBytes;
+
+    AtomicWord<bool> _valid{true};
+
+    mutable stdx::mutex _mutex;
+
+    std::vector<Column> _columns;
+
+    // _id of each row, missing for unused rows, and the version of the write it holds.
+    std::vector<Value> _ids;
+    std::vector<long long> _versions;
+    ValueUnorderedMap<size_t> _rowById =
+        ValueComparator::kInstance.makeUnorderedValueMap<size_t>();
+    std::vector<size_t> _freeRows;
+
+    // Versions of the writes made but not committed or rolled back yet.
+    long long _nextVersion = 1;
+    std::set<long long> _pendingVersions;
+
+    // The version of each deleted row, by _id and by version.
+    ValueUnorderedMap<long long> _tombstoneById =
+        ValueComparator::kInstance.makeUnorderedValueMap<long long>();
+    std::map<long long, Value> _tombstoneByVersion;
+};
+
+/**
+ * The column caches enabled on this node, by namespace. The OpObserver forwards every document
+ * write here, and the catalog applies it to the namespace's cache, if any, once the write unit of
+ * work commits, so that scans never see uncommitted writes.
+ */
+class ColumnCacheCatalog {
+    MONGO_DISALLOW_COPYING(ColumnCacheCatalog);
+
+public:
+    ColumnCacheCatalog() = default;
+
+    static ColumnCacheCatalog* get(ServiceContext* service);
+    static ColumnCacheCatalog* get(OperationContext* opCtx);
+
+    /**
+     * Returns the cache for 'nss', or nullptr if there is none or it is no longer valid.
+     */
+    std::shared_ptr<ColumnCache> lookup(const NamespaceString& nss) const;
+
+    /**
+     * Installs 'cache' for its namespace, replacing any previous one.
+     */
+    void install(std::shared_ptr<ColumnCache> cache);
+
+    /**
+     * Invalidates and forgets the cache for 'nss', or every cache in database 'dbName'.
+     */
+    void remove(const NamespaceString& nss);
+    void removeDatabase(StringData dbName);
+
+    void onInsert(OperationContext* opCtx, const NamespaceString& nss, const BSONObj& doc);
+    void onUpdate(OperationContext* opCtx, const NamespaceString& nss, const BSONObj& updatedDoc);
+    void onDelete(OperationContext* opCtx, const NamespaceString& nss, const BSONObj& documentKey);
+
+private:
+    void _replace(OperationContext* opCtx,
+                  const NamespaceString& nss,
+                  const BSONElement& id,
+                  const boost::optional<BSONObj>& doc);
+
+    // Lets writes skip the mutex in the common case that no collection is cached.
+    AtomicWord<long long> _numCaches{0};
+
+    mutable stdx::mutex _mutex;
+    std::map<NamespaceString, std::shared_ptr<ColumnCache>> _caches;
+};
+
+}  // namespace mongo
@@ -0,0 +1,256 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/column_cache.h"
+
+#include "mongo/db/json.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/pipeline/document_source_column_scan.h"
+#include "mongo/db/pipeline/document_value_test_util.h"
+#include "mongo/db/pipeline/expression_context_for_test.h"
+#include "mongo/db/query/query_test_service_context.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const NamespaceString kNss("test", "coll");
+
+std::shared_ptr<ColumnCache> makeCache(size_t maxBytes = 1024 * 1024) {
+    return std::make_shared<ColumnCache>(
+        kNss, std::vector<std::string>{"a", "b", "c"}, maxBytes);
+}
+
+std::deque<Document> fetchAll(const ColumnCache& cache,
+                              bool includeId,
+                              const std::vector<size_t>& fieldIndexes) {
+    std::deque<Document> out;
+    size_t position = 0;
+    while (cache.fetch(&position, 2, includeId, fieldIndexes, &out)) {
+    }
+    return out;
+}
+
+void replace(ColumnCache* cache, const BSONObj& doc) {
+    cache->replace(doc["_id"], doc);
+}
+
+TEST(ColumnCacheTest, ReturnsCachedFieldsOfEachType) {
+    auto cache = makeCache();
+    replace(cache.get(), fromjson("{_id: 1, a: 1, b: 'x', c: {d: 1}, e: 5}"));
+    replace(cache.get(), fromjson("{_id: 2, a: 2.5, b: true, c: [1, 2]}"));
+    replace(cache.get(), BSON("_id" << 3 << "a" << 3LL << "b" << Date_t::fromMillisSinceEpoch(7)));
+    replace(cache.get(), fromjson("{_id: 4, a: 'x', b: null}"));
+
+    auto docs = fetchAll(*cache, true, {0, 1, 2});
+    ASSERT_EQ(docs.size(), 4U);
+    ASSERT_DOCUMENT_EQ(docs[0], Document(fromjson("{_id: 1, a: 1, b: 'x', c: {d: 1}}")));
+    ASSERT_DOCUMENT_EQ(docs[1], Document(fromjson("{_id: 2, a: 2.5, b: true, c: [1, 2]}")));
+    ASSERT_DOCUMENT_EQ(
+        docs[2], Document(BSON("_id" << 3 << "a" << 3LL << "b" << Date_t::fromMillisSinceEpoch(7))));
+    ASSERT_DOCUMENT_EQ(docs[3], Document(fromjson("{_id: 4, a: 'x', b: null}")));
+    ASSERT_EQ(docs[2]["a"].getType(), NumberLong);
+    ASSERT_EQ(cache->numRows(), 4U);
+}
+
+TEST(ColumnCacheTest, FetchReturnsOnlyRequestedFields) {
+    auto cache = makeCache();
+    replace(cache.get(), fromjson("{_id: 1, a: 1, b: 2, c: 3}"));
+
+    auto docs = fetchAll(*cache, false, {1});
+    ASSERT_EQ(docs.size(), 1U);
+    ASSERT_DOCUMENT_EQ(docs[0], (Document{{"b", 2}}));
+
+    docs = fetchAll(*cache, false, {});
+    ASSERT_EQ(docs.size(), 1U);
+    ASSERT_DOCUMENT_EQ(docs[0], Document());
+}
+
+TEST(ColumnCacheTest, WritesAreAppliedInVersionOrderOnceCommitted) {
+    auto cache = makeCache();
+    const BSONObj id = BSON("_id" << 1);
+
+    // Nothing is visible before the write commits, or if it rolls back.
+    const long long aborted = cache->beginWrite();
+    cache->abortWrite(aborted);
+    ASSERT_EQ(cache->numRows(), 0U);
+
+    // A write made later wins even if its commit handler runs first.
+    const long long first = cache->beginWrite();
+    const long long second = cache->beginWrite();
+    ASSERT_LT(first, second);
+    cache->commitWrite(id.firstElement(), fromjson("{_id: 1, a: 2}"), second);
+    cache->commitWrite(id.firstElement(), fromjson("{_id: 1, a: 1}"), first);
+    auto docs = fetchAll(*cache, true, {0});
+    ASSERT_EQ(docs.size(), 1U);
+    ASSERT_DOCUMENT_EQ(docs[0], Document(fromjson("{_id: 1, a: 2}")));
+
+    // A delete isn't undone by an earlier write committing after it.
+    const long long update = cache->beginWrite();
+    const long long remove = cache->beginWrite();
+    cache->commitWrite(id.firstElement(), boost::none, remove);
+    cache->commitWrite(id.firstElement(), fromjson("{_id: 1, a: 3}"), update);
+    ASSERT_EQ(cache->numRows(), 0U);
+
+    // Once no earlier write is pending, a new insert of the same _id is applied.
+    const long long insert = cache->beginWrite();
+    cache->commitWrite(id.firstElement(), fromjson("{_id: 1, a: 4}"), insert);
+    docs = fetchAll(*cache, true, {0});
+    ASSERT_EQ(docs.size(), 1U);
+    ASSERT_DOCUMENT_EQ(docs[0], Document(fromjson("{_id: 1, a: 4}")));
+}
+
+TEST(ColumnCacheTest, CachedFieldsHoldOnlyIdAndCachedFields) {
+    auto cache = makeCache();
+    ASSERT_BSONOBJ_EQ(cache->cachedFields(fromjson("{z: 0, _id: 1, c: 3, a: 1}")),
+                      fromjson("{_id: 1, a: 1, c: 3}"));
+}
+
+TEST(ColumnCacheTest, ReusesRowsOfDeletedDocuments) {
+    auto cache = makeCache();
+    for (int i = 0; i < 10; ++i) {
+        replace(cache.get(), BSON("_id" << i << "a" << i));
+    }
+    for (int i = 0; i < 10; i += 2) {
+        cache->replace(BSON("_id" << i).firstElement(), boost::none);
+    }
+    const size_t bytes = cache->approximateBytes();
+    for (int i = 10; i < 15; ++i) {
+        replace(cache.get(), BSON("_id" << i << "a" << i));
+    }
+
+    ASSERT_EQ(cache->numRows(), 10U);
+    ASSERT_EQ(fetchAll(*cache, true, {0}).size(), 10U);
+    ASSERT_EQ(cache->approximateBytes(), bytes);
+}
+
+TEST(ColumnCacheTest, ForgetsStringsNoRowHolds) {
+    auto cache = makeCache();
+    replace(cache.get(), BSON("_id" << 0 << "b" << "shared"));
+    replace(cache.get(), BSON("_id" << 1 << "b" << "shared"));
+    replace(cache.get(), BSON("_id" << 2 << "b" << "x0"));
+    const size_t bytes = cache->approximateBytes();
+
+    // Each update drops the only reference to the previous string, so the dictionary doesn't grow.
+    for (int i = 1; i < 100; ++i) {
+        replace(cache.get(), BSON("_id" << 2 << "b" << "x" + std::to_string(i % 10)));
+    }
+    ASSERT_EQ(cache->approximateBytes(), bytes);
+
+    replace(cache.get(), BSON("_id" << 0 << "b" << 1));
+    auto docs = fetchAll(*cache, true, {1});
+    ASSERT_EQ(docs.size(), 3U);
+    ASSERT_DOCUMENT_EQ(docs[1], Document(BSON("_id" << 1 << "b" << "shared")));
+    ASSERT_DOCUMENT_EQ(docs[2], Document(BSON("_id" << 2 << "b" << "x9")));
+}
+
+TEST(ColumnCacheTest, CoversOnlyIdAndCachedFields) {
+    auto cache = makeCache();
+    ASSERT_TRUE(cache->covers({}));
+    ASSERT_TRUE(cache->covers({"_id", "a", "b.x", "c"}));
+    ASSERT_FALSE(cache->covers({"a", "d"}));
+    ASSERT_FALSE(cache->covers({"ab"}));
+}
+
+TEST(ColumnCacheTest, InvalidatesWhenOverMemoryLimit) {
+    auto cache = makeCache(4 * 1024);
+    for (int i = 0; i < 1000 && cache->isValid(); ++i) {
+        replace(cache.get(), BSON("_id" << i << "b" << std::string(100, 'x') + std::to_string(i)));
+    }
+    ASSERT_FALSE(cache->isValid());
+
+    std::deque<Document> out;
+    size_t position = 0;
+    ASSERT_THROWS_CODE(
+        cache->fetch(&position, 10, true, {0}, &out), AssertionException, ErrorCodes::QueryPlanKilled);
+}
+
+TEST(ColumnCacheCatalogTest, AppliesWritesAndUndoesThemOnRollback) {
+    QueryTestServiceContext serviceContext;
+    auto opCtx = serviceContext.makeOperationContext();
+    auto catalog = ColumnCacheCatalog::get(opCtx.get());
+
+    auto cache = makeCache();
+    catalog->install(cache);
+    ASSERT(catalog->lookup(kNss) == cache);
+    ASSERT(catalog->lookup(NamespaceString("test", "other")) == nullptr);
+
+    {
+        WriteUnitOfWork wuow(opCtx.get());
+        catalog->onInsert(opCtx.get(), kNss, fromjson("{_id: 1, a: 1}"));
+        catalog->onInsert(opCtx.get(), kNss, fromjson("{_id: 2, a: 2}"));
+        wuow.commit();
+    }
+
+    {
+        WriteUnitOfWork wuow(opCtx.get());
+        catalog->onUpdate(opCtx.get(), kNss, fromjson("{_id: 1, a: 10}"));
+        catalog->onUpdate(opCtx.get(), kNss, fromjson("{_id: 1, a: 11}"));
+        catalog->onDelete(opCtx.get(), kNss, fromjson("{_id: 2}"));
+        catalog->onInsert(opCtx.get(), kNss, fromjson("{_id: 3, a: 3}"));
+        ASSERT_EQ(cache->numRows(), 2U);
+        // Not committed.
+    }
+
+    auto docs = fetchAll(*cache, true, {0});
+    ASSERT_EQ(docs.size(), 2U);
+    ASSERT_DOCUMENT_EQ(docs[0], Document(fromjson("{_id: 1, a: 1}")));
+    ASSERT_DOCUMENT_EQ(docs[1], Document(fromjson("{_id: 2, a: 2}")));
+
+    catalog->removeDatabase("test");
+    ASSERT_FALSE(cache->isValid());
+    ASSERT(catalog->lookup(kNss) == nullptr);
+}
+
+TEST(DocumentSourceColumnScanTest, ReturnsTopLevelDependencies) {
+    auto cache = makeCache();
+    for (int i = 0; i < 3000; ++i) {
+        replace(cache.get(), BSON("_id" << i << "a" << i << "b" << i % 3 << "c" << "x"));
+    }
+
+    QueryTestServiceContext serviceContext;
+    auto opCtx = serviceContext.makeOperationContext();
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    expCtx->opCtx = opCtx.get();
+
+    auto scan = DocumentSourceColumnScan::create(cache, {"b.x", "a"}, expCtx);
+    for (int i = 0; i < 3000; ++i) {
+        auto next = scan->getNext();
+        ASSERT(next.isAdvanced());
+        ASSERT_DOCUMENT_EQ(next.releaseDocument(), (Document{{"a", i}, {"b", i % 3}}));
+    }
+    ASSERT(scan->getNext().isEOF());
+    ASSERT(scan->getNext().isEOF());
+    ASSERT_EQ(scan->getDocsReturned(), 3000);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -30,11 +30,16 @@
 
 #include "mongo/db/pipeline/document.h"
 
+#include <algorithm>
+#include <array>
 #include <boost/functional/hash.hpp>
 
+#include "mongo/base/counter.h"
 #include "mongo/bson/bson_depth.h"
+#include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/pipeline/field_path.h"
+#include "mongo/platform/bits.h"
 #include "mongo/util/mongoutils/str.h"
 
 namespace mongo {
@@ -43,12 +48,173 @@ using boost::intrusive_ptr;
 using std::string;
 using std::vector;
 
+namespace {
+
+/**
+ * DocumentStorage buffers are power-of-two sized. Pipelines create and destroy huge numbers of
+ * small documents, so released buffers up to kMaxCachedBufferSize are kept in a cache owned by the
+ * releasing thread and handed out again to the next document which needs a buffer of that size,
+ * rather than going back to the allocator every time.
+ *
+ * The cache only holds memory no document refers to anymore, so documents remain free to move
+ * between threads and to outlive the operation which created them. Each thread holds at most
+ * kMaxCachedBytesPerThread bytes and all threads together at most kMaxCachedBytes, so that
+ * thousands of connection threads cannot pin hundreds of megabytes between them.
+ */
+const size_t kMinBufferSize = 128;
+const size_t kMaxCachedBufferSize = 4096;
+const size_t kNumCachedBufferSizes = 6;  // 128, 256, ..., 4096
+const size_t kMaxCachedBytesPerThread = 256 * 1024;
+const long long kMaxCachedBytes = 32 * 1024 * 1024;
+
+// Bytes held by the caches of all threads
+Counter64 totalCachedBytes;
+
+ServerStatusMetricField<Counter64> displayTotalCachedBytes("documentBufferCache.cachedBytes",
+                                                           &totalCachedBytes);
+
+class DocumentBufferCache {
+    MONGO_DISALLOW_COPYING(DocumentBufferCache);
+
+public:
+    DocumentBufferCache();
+    ~DocumentBufferCache();
+
+    char* allocate(size_t capacity);
+    void release(char* buffer, size_t capacity);
+
+private:
+    /**
+     * Returns the index of the free list for buffers of 'capacity' bytes, or -1 if buffers of this
+     * size are not cached.
+     */
+    static int sizeClass(size_t capacity) {
+        if (capacity < kMinBufferSize || capacity > kMaxCachedBufferSize ||
+            (capacity & (capacity - 1))) {
+            return -1;
+        }
+        return countTrailingZeros64(capacity) - countTrailingZeros64(kMinBufferSize);
+    }
+
+    std::array<std::vector<char*>, kNumCachedBufferSizes> _freeBuffers;
+    size_t _cachedBytes{0};
+};
+
+thread_local DocumentBufferCache bufferCache;
+thread_local DocumentStorage::BufferStats bufferStats;
+
+// Documents destroyed during thread exit may outlive the cache, so it must not be touched then
+thread_local bool bufferCacheDestroyed = false;
+
+DocumentBufferCache::DocumentBufferCache() = default;
+
+DocumentBufferCache::~DocumentBufferCache() {
+    bufferCacheDestroyed = true;
+    totalCachedBytes.decrement(_cachedBytes);
+    for (auto&& freeList : _freeBuffers) {
+        for (char* buffer : freeList) {
+            delete[] buffer;
+        }
+    }
+}
+
+char* DocumentBufferCache::allocate(size_t capacity) {
+    const int index = sizeClass(capacity);
+    if (index >= 0 && !_freeBuffers[index].empty()) {
+        char* buffer = _freeBuffers[index].back();
+        _freeBuffers[index].pop_back();
+        _cachedBytes -= capacity;
+        totalCachedBytes.decrement(capacity);
+        bufferStats.reused++;
+        return buffer;
+    }
+    return new char[capacity];
+}
+
+void DocumentBufferCache::release(char* buffer, size_t capacity) {
+    const int index = sizeClass(capacity);
+    if (index < 0 || _cachedBytes + capacity > kMaxCachedBytesPerThread) {
+        delete[] buffer;
+        return;
+    }
+    totalCachedBytes.increment(capacity);
+    if (totalCachedBytes.get() > kMaxCachedBytes) {
+        totalCachedBytes.decrement(capacity);
+        delete[] buffer;
+        return;
+    }
+    _freeBuffers[index].push_back(buffer);
+    _cachedBytes += capacity;
+}
+
+char* allocateBuffer(size_t capacity) {
+    bufferStats.allocations++;
+    return bufferCacheDestroyed ? new char[capacity] : bufferCache.allocate(capacity);
+}
+
+void releaseBuffer(char* buffer, size_t capacity) {
+    if (!buffer) {
+        return;
+    }
+    if (bufferCacheDestroyed) {
+        delete[] buffer;
+    } else {
+        bufferCache.release(buffer, capacity);
+    }
+}
+
+/**
+ * Once more than this many fields of a BSON-backed document have been modified, it stops keeping
+ * track of them and is serialized like any other document.
+ */
+const size_t kMaxModifiedBsonFields = 16;
+
+/**
+ * Returns true if 'obj' and the objects and arrays nested in it fit in 'levels' levels of nesting.
+ */
+bool fitsWithinDepth(const BSONObj& obj, size_t levels) {
+    if (levels == 0)
+        return false;
+
+    BSONForEach(elem, obj) {
+        if (elem.isABSONObj() && !fitsWithinDepth(elem.embeddedObject(), levels - 1))
+            return false;
+    }
+    return true;
+}
+
+}  // namespace
+
 const DocumentStorage DocumentStorage::kEmptyDoc;
 
+DocumentStorage::BufferStats DocumentStorage::getThreadBufferStats() {
+    return bufferStats;
+}
+
+long long DocumentStorage::getCachedBufferBytes() {
+    return totalCachedBytes.get();
+}
+
 const std::vector<StringData> Document::allMetadataFieldNames = {
     Document::metaFieldTextScore, Document::metaFieldRandVal, Document::metaFieldSortKey};
 
 Position DocumentStorage::findField(StringData requested) const {
+    LazyLoadGuard guard(*this);
+    Position pos = findLoadedField(requested);
+    if (pos.found())
+        return pos;
+
+    // Fields of _bson are loaded in order, so keep going until the requested one turns up
+    while (_bsonNextElement) {
+        pos = loadNextBsonField();
+        if (getField(pos).nameSD() == requested)
+            return pos;
+    }
+
+    return Position();
+}
+
+Position DocumentStorage::findLoadedField(StringData requested) const {
     int reqSize = requested.size();  // get size calculation out of the way if needed
 
     if (_numFields >= HASH_TAB_MIN) {  // hash lookup
@@ -65,7 +231,7 @@ Position DocumentStorage::findField(StringData requested) const {
             pos = elem.nextCollision;
         }
     } else {  // linear scan
-        for (DocumentStorageIterator it = iteratorAll(); !it.atEnd(); it.advance()) {
+        for (DocumentStorageIterator it = loadedIterator(); !it.atEnd(); it.advance()) {
             if (it->nameLen == reqSize && memcmp(requested.rawData(), it->_name, reqSize) == 0) {
                 return it.position();
             }
@@ -76,7 +242,128 @@ Position DocumentStorage::findField(StringData requested) const {
     return Position();
 }
 
+void DocumentStorage::initFromBson(BSONObj bson) {
+    invariant(!_buffer);
+    invariant(bson.isOwned());
+
+    // Don't keep the rest of a shared buffer, such as the parent of an embedded object, alive
+    if (bson.objdata() != bson.sharedBuffer().get())
+        bson = bson.copy();
+
+    // Size the buffer for exactly the fields of bson, so loading them never moves it
+    size_t elementBytes = 0;
+    size_t numFields = 0;
+    BSONForEach(elem, bson) {
+        elementBytes += ValueElement::align(sizeof(ValueElement) + elem.fieldNameSize() - 1);
+        numFields++;
+    }
+    if (!numFields)
+        return;
+
+    reserve(elementBytes, numFields);
+    _bsonNextElement = bson.firstElement().rawdata() - bson.objdata();
+    _bson = std::move(bson);
+    _bsonPending.store(true);
+}
+
+Position DocumentStorage::loadNextBsonField() const {
+    DocumentStorage* const self = const_cast<DocumentStorage*>(this);
+    const BSONElement elem(_bson.objdata() + _bsonNextElement);
+
+    Value val;
+    if (elem.type() == Object) {
+        // Embedded documents are loaded lazily as well, from a copy of their own so that their size
+        // accounts for everything they keep alive
+        val = Value(Document(elem.embeddedObject().copy()));
+    } else {
+        val = Value(elem);
+    }
+
+    const Position pos = getNextPosition();
+    self->appendFieldImpl(elem.fieldNameStringData()) = std::move(val);
+    self->_bsonLoadedBytes = _usedBytes;
+
+    const unsigned next = _bsonNextElement + elem.size();
+    self->_bsonNextElement = (_bson.objdata()[next] == EOO) ? 0 : next;
+    if (!_bsonNextElement)
+        self->_bsonPending.store(false);
+    return pos;
+}
+
+void DocumentStorage::markModified(Position pos) {
+    if (pos.index >= _bsonLoadedBytes)
+        return;  // not a field of _bson
+
+    if (std::find(_modifiedBsonFields.begin(), _modifiedBsonFields.end(), pos) !=
+        _modifiedBsonFields.end())
+        return;
+
+    if (_modifiedBsonFields.size() >= kMaxModifiedBsonFields) {
+        detachFromBson();
+        return;
+    }
+
+    _modifiedBsonFields.push_back(pos);
+}
+
+void DocumentStorage::detachFromBson() {
+    loadAllBsonFields();
+    _bson = BSONObj();
+    _bsonLoadedBytes = 0;
+    _modifiedBsonFields.clear();
+}
+
+bool DocumentStorage::appendSplicedBson(BSONObjBuilder* builder, size_t recursionLevel) const {
+    if (_bson.isEmpty())
+        return false;
+
+    LazyLoadGuard guard(*this);
+
+    // The loaded fields of _bson come first in the buffer and in the same order, followed by any
+    // fields added since.
+    DocumentStorageIterator loaded = loadedIterator();
+    BSONForEach(elem, _bson) {
+        const ValueElement* field = nullptr;
+        bool modified = false;
+        if (!loaded.atEnd() && loaded.position().index < _bsonLoadedBytes) {
+            field = &loaded.get();
+            modified = std::find(_modifiedBsonFields.begin(),
+                                 _modifiedBsonFields.end(),
+                                 loaded.position()) != _modifiedBsonFields.end();
+            loaded.advance();
+        }
+
+        // Embedded objects and arrays which would exceed the depth limit at this level go through
+        // the usual conversion, so that it can report the error.
+        const bool tooDeep = elem.isABSONObj() &&
+            !fitsWithinDepth(elem.embeddedObject(),
+                             BSONDepth::getMaxAllowableDepth() - recursionLevel);
+
+        if (field && (modified || tooDeep)) {
+            if (!field->val.missing())
+                field->val.addToBsonObj(builder, field->nameSD(), recursionLevel);
+        } else if (tooDeep) {
+            Value(elem).addToBsonObj(builder, elem.fieldNameStringData(), recursionLevel);
+        } else {
+            builder->append(elem);
+        }
+    }
+
+    for (; !loaded.atEnd(); loaded.advance()) {
+        if (!loaded->val.missing())
+            loaded->val.addToBsonObj(builder, loaded->nameSD(), recursionLevel);
+    }
+
+    return true;
+}
+
 Value& DocumentStorage::appendField(StringData name) {
+    // New fields go after all of the fields of _bson
+    loadAllBsonFields();
+    return appendFieldImpl(name);
+}
+
+Value& DocumentStorage::appendFieldImpl(StringData name) {
     Position pos = getNextPosition();
     const int nameSize = name.size();
 
@@ -103,7 +390,7 @@ Value& DocumentStorage::appendField(StringData name) {
 #undef append
 
     // Make sure next field starts where we expect it
-    fassert(16486, getField(pos).next()->ptr() == _buffer + _usedBytes);
+    fassert(16486, element(pos).next()->ptr() == _buffer + _usedBytes);
 
     _numFields++;
 
@@ -114,12 +401,12 @@ Value& DocumentStorage::appendField(StringData name) {
         rehash();
     }
 
-    return getField(pos).val;
+    return element(pos).val;
 }
 
 // Call after adding field to _fields and increasing _numFields
 void DocumentStorage::addFieldToHashTable(Position pos) {
-    ValueElement& elem = getField(pos);
+    ValueElement& elem = element(pos);
     elem.nextCollision = Position();
 
     const unsigned bucket = bucketForKey(elem.nameSD());
@@ -127,7 +414,7 @@ void DocumentStorage::addFieldToHashTable(Position pos) {
     Position* posPtr = &_hashTab[bucket];
     while (posPtr->found()) {
         // collision: walk links and add new to end
-        posPtr = &getField(*posPtr).nextCollision;
+        posPtr = &element(*posPtr).nextCollision;
     }
     *posPtr = Position(pos.index);
 }
@@ -136,25 +423,26 @@ void DocumentStorage::alloc(unsigned newSize) {
     const bool firstAlloc = !_buffer;
     const bool doingRehash = needRehash();
     const size_t oldCapacity = _bufferEnd - _buffer;
+    const size_t oldAllocatedBytes = allocatedBytes();
 
     // make new bucket count big enough
     while (needRehash() || hashTabBuckets() < HASH_TAB_INIT_SIZE)
         _hashTabMask = hashTabBuckets() * 2 - 1;
 
     // only allocate power-of-two sized space > 128 bytes
-    size_t capacity = 128;
+    size_t capacity = kMinBufferSize;
     while (capacity < newSize + hashTabBytes())
         capacity *= 2;
 
     uassert(16490, "Tried to make oversized document", capacity <= size_t(BufferMaxSize));
 
-    std::unique_ptr<char[]> oldBuf(_buffer);
-    _buffer = new char[capacity];
+    char* const oldBuf = _buffer;
+    _buffer = allocateBuffer(capacity);
     _bufferEnd = _buffer + capacity - hashTabBytes();
 
     if (!firstAlloc) {
         // This just copies the elements
-        memcpy(_buffer, oldBuf.get(), _usedBytes);
+        memcpy(_buffer, oldBuf, _usedBytes);
 
         if (_numFields >= HASH_TAB_MIN) {
             // if we were hashing, deal with the hash table
@@ -162,38 +450,48 @@ void DocumentStorage::alloc(unsigned newSize) {
                 rehash();
             } else {
                 // no rehash needed so just slide table down to new position
-                memcpy(_hashTab, oldBuf.get() + oldCapacity, hashTabBytes());
+                memcpy(_hashTab, oldBuf + oldCapacity, hashTabBytes());
             }
         }
+
+        releaseBuffer(oldBuf, oldAllocatedBytes);
     }
 }
 
 void DocumentStorage::reserveFields(size_t expectedFields) {
     fassert(16487, !_buffer);
 
+    // Using expectedFields+1 to allow space for long field names
+    reserve((expectedFields + 1) * ValueElement::align(sizeof(ValueElement)), expectedFields);
+}
+
+void DocumentStorage::reserve(size_t elementBytes, size_t numFields) {
     unsigned buckets = HASH_TAB_INIT_SIZE;
-    while (buckets < expectedFields)
+    while (buckets < numFields)
         buckets *= 2;
     _hashTabMask = buckets - 1;
 
-    // Using expectedFields+1 to allow space for long field names
-    const size_t newSize = (expectedFields + 1) * ValueElement::align(sizeof(ValueElement));
+    // Round up to the same power-of-two sizes alloc() uses, so the buffer can be recycled
+    size_t capacity = kMinBufferSize;
+    while (capacity < elementBytes + hashTabBytes())
+        capacity *= 2;
 
-    uassert(16491, "Tried to make oversized document", newSize <= size_t(BufferMaxSize));
+    uassert(16491, "Tried to make oversized document", capacity <= size_t(BufferMaxSize));
 
-    _buffer = new char[newSize + hashTabBytes()];
-    _bufferEnd = _buffer + newSize;
+    _buffer = allocateBuffer(capacity);
+    _bufferEnd = _buffer + capacity - hashTabBytes();
 }
 
 intrusive_ptr<DocumentStorage> DocumentStorage::clone() const {
+    LazyLoadGuard guard(*this);
     intrusive_ptr<DocumentStorage> out(new DocumentStorage());
 
     // Make a copy of the buffer.
     // It is very important that the positions of each field are the same after cloning.
     const size_t bufferBytes = allocatedBytes();
-    out->_buffer = new char[bufferBytes];
-    out->_bufferEnd = out->_buffer + (_bufferEnd - _buffer);
     if (bufferBytes > 0) {
+        out->_buffer = allocateBuffer(bufferBytes);
+        out->_bufferEnd = out->_buffer + (_bufferEnd - _buffer);
         memcpy(out->_buffer, _buffer, bufferBytes);
     }
 
@@ -205,9 +503,14 @@ intrusive_ptr<DocumentStorage> DocumentStorage::clone() const {
     out->_textScore = _textScore;
     out->_randVal = _randVal;
     out->_sortKey = _sortKey.getOwned();
+    out->_bson = _bson;
+    out->_bsonNextElement = _bsonNextElement;
+    out->_bsonLoadedBytes = _bsonLoadedBytes;
+    out->_bsonPending.store(_bsonNextElement != 0);
+    out->_modifiedBsonFields = _modifiedBsonFields;
 
     // Tell values that they have been memcpyed (updates ref counts)
-    for (DocumentStorageIterator it = out->iteratorAll(); !it.atEnd(); it.advance()) {
+    for (DocumentStorageIterator it = out->loadedIterator(); !it.atEnd(); it.advance()) {
         it->val.memcpyed();
     }
 
@@ -215,14 +518,22 @@ intrusive_ptr<DocumentStorage> DocumentStorage::clone() const {
 }
 
 DocumentStorage::~DocumentStorage() {
-    std::unique_ptr<char[]> deleteBufferAtScopeEnd(_buffer);
-
-    for (DocumentStorageIterator it = iteratorAll(); !it.atEnd(); it.advance()) {
+    for (DocumentStorageIterator it = loadedIterator(); !it.atEnd(); it.advance()) {
         it->val.~Value();  // explicit destructor call
     }
+
+    releaseBuffer(_buffer, allocatedBytes());
 }
 
 Document::Document(const BSONObj& bson) {
+    if (bson.isOwned() && !bson.isEmpty()) {
+        // The buffer stays alive as long as we do, so fields can be converted as they are needed
+        intrusive_ptr<DocumentStorage> storage(new DocumentStorage());
+        storage->initFromBson(bson);
+        _storage = std::move(storage);
+        return;
+    }
+
     MutableDocument md(bson.nFields());
 
     BSONObjIterator it(bson);
@@ -258,12 +569,20 @@ void Document::toBson(BSONObjBuilder* builder, size_t recursionLevel) const {
                           << " levels of nesting",
             recursionLevel <= BSONDepth::getMaxAllowableDepth());
 
+    if (storage().appendSplicedBson(builder, recursionLevel))
+        return;
+
     for (DocumentStorageIterator it = storage().iterator(); !it.atEnd(); it.advance()) {
         it->val.addToBsonObj(builder, it->nameSD(), recursionLevel);
     }
 }
 
 BSONObj Document::toBson() const {
+    // A document which is still exactly the BSON it was created from serializes to that BSON
+    BSONObj unmodified = storage().unmodifiedBson();
+    if (!unmodified.isEmpty())
+        return unmodified;
+
     BSONObjBuilder bb;
     toBson(&bb);
     return bb.obj();
@@ -286,6 +605,19 @@ BSONObj Document::toBsonWithMetaData(bool includeSortKey) const {
 }
 
 Document Document::fromBsonWithMetaData(const BSONObj& bson) {
+    bool hasMetaData = false;
+    BSONForEach(elem, bson) {
+        if (elem.fieldName()[0] == '$' &&
+            std::find(allMetadataFieldNames.begin(),
+                      allMetadataFieldNames.end(),
+                      elem.fieldNameStringData()) != allMetadataFieldNames.end()) {
+            hasMetaData = true;
+            break;
+        }
+    }
+    if (!hasMetaData)
+        return Document(bson.getOwned());
+
     MutableDocument md;
 
     BSONObjIterator it(bson);
@@ -380,10 +712,14 @@ size_t Document::getApproximateSize() const {
     if (!_storage)
         return 0;  // we've allocated no memory
 
+    DocumentStorage::LazyLoadGuard guard(storage());
     size_t size = sizeof(DocumentStorage);
     size += storage().allocatedBytes();
 
-    for (DocumentStorageIterator it = storage().iterator(); !it.atEnd(); it.advance()) {
+    // Fields which have not been loaded yet are accounted for by the BSON they will come from
+    size += storage().ownedBsonBytes();
+
+    for (DocumentStorageIterator it = storage().loadedIterator(); !it.atEnd(); it.advance()) {
         size += it->val.getApproximateSize();
         size -= sizeof(Value);  // already accounted for above
     }
@@ -99,7 +99,14 @@ public:
     /// Empty Document (does no allocation)
     Document() {}
 
-    /// Create a new Document deep-converted from the given BSONObj.
+    /**
+     * Create a new Document from the given BSONObj. If the BSONObj is owned, the Document keeps a
+     * reference to it and converts fields as they are accessed; otherwise it is deep-converted.
+     *
+     * Reading a Document created this way may convert more of its fields, but those conversions
+     * are serialized internally, so it can be read by several threads at once like any other
+     * Document. As usual, it must not be modified while other threads read it.
+     */
     explicit Document(const BSONObj& bson);
 
     /**
@@ -32,9 +32,14 @@
 
 #include <bitset>
 #include <boost/intrusive_ptr.hpp>
+#include <vector>
 
+#include "mongo/base/disallow_copying.h"
 #include "mongo/base/static_assert.h"
+#include "mongo/bson/bsonobj.h"
 #include "mongo/db/pipeline/value.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/util/concurrency/spin_lock.h"
 #include "mongo/util/intrusive_counter.h"
 
 namespace mongo {
@@ -189,7 +194,9 @@ public:
           _hashTabMask(0),
           _metaFields(),
           _textScore(0),
-          _randVal(0) {}
+          _randVal(0),
+          _bsonNextElement(0),
+          _bsonLoadedBytes(0) {}
 
     ~DocumentStorage();
 
@@ -205,6 +212,38 @@ public:
         return kEmptyDoc;
     }
 
+    /**
+     * Const access loads fields of the BSON this storage was created from, and a frozen Document
+     * may be read from several threads, so readers of the loaded fields hold this guard. It only
+     * locks while fields remain to be loaded; after that, const access no longer changes anything.
+     */
+    class LazyLoadGuard {
+        MONGO_DISALLOW_COPYING(LazyLoadGuard);
+
+    public:
+        explicit LazyLoadGuard(const DocumentStorage& storage)
+            : _lock(storage._bsonPending.load() ? &storage._bsonLoadLock : nullptr) {
+            if (_lock)
+                _lock->lock();
+        }
+
+        ~LazyLoadGuard() {
+            if (_lock)
+                _lock->unlock();
+        }
+
+    private:
+        SpinLock* _lock;
+    };
+
+    /**
+     * Makes this empty storage hold the fields of 'bson', which must be owned. Fields are only
+     * converted to Values when they are looked up, in order, and fields which were never modified
+     * are serialized by copying them straight from 'bson'. If 'bson' shares a larger buffer, it is
+     * copied first so that this storage never keeps more than its own bytes alive.
+     */
+    void initFromBson(BSONObj bson);
+
     size_t size() const {
         // can't use _numFields because it includes removed Fields
         size_t count = 0;
@@ -236,7 +275,8 @@ public:
     // MutableDocument uses these
     ValueElement& getField(Position pos) {
         verify(pos.found());
-        return *(_firstElement->plusBytes(pos.index));
+        markModified(pos);
+        return element(pos);
     }
     Value& getField(StringData name) {
         Position pos = findField(name);
@@ -255,14 +295,44 @@ public:
 
     /// This skips missing values
     DocumentStorageIterator iterator() const {
+        loadAllBsonFields();
         return DocumentStorageIterator(_firstElement, end(), false);
     }
 
     /// This includes missing values
     DocumentStorageIterator iteratorAll() const {
+        loadAllBsonFields();
         return DocumentStorageIterator(_firstElement, end(), true);
     }
 
+    /// Iterates over the fields loaded so far, including missing values, without loading more
+    DocumentStorageIterator loadedIterator() const {
+        return DocumentStorageIterator(_firstElement, end(), true);
+    }
+
+    /**
+     * If this storage was created from BSON, appends its fields to 'builder' and returns true.
+     * Fields which have not been modified, or not even loaded, are copied from the original BSON
+     * rather than converted back from Values. Returns false if there is no original BSON.
+     */
+    bool appendSplicedBson(BSONObjBuilder* builder, size_t recursionLevel) const;
+
+    /**
+     * Returns the BSON this storage was created from if no field has been modified, added or
+     * removed since, or an empty object otherwise.
+     */
+    BSONObj unmodifiedBson() const {
+        LazyLoadGuard guard(*this);
+        return (_modifiedBsonFields.empty() && _usedBytes == _bsonLoadedBytes) ? _bson : BSONObj();
+    }
+
+    /**
+     * Size of the BSON this storage was created from, which it owns a buffer of its own for.
+     */
+    size_t ownedBsonBytes() const {
+        return _bson.isEmpty() ? 0 : _bson.objsize();
+    }
+
     /// Shallow copy of this. Caller owns memory.
     boost::intrusive_ptr<DocumentStorage> clone() const;
 
@@ -270,6 +340,22 @@ public:
         return !_buffer ? 0 : (_bufferEnd - _buffer + hashTabBytes());
     }
 
+    /**
+     * Counts of the buffers DocumentStorage has allocated on the calling thread, and of how many
+     * of those were recycled from buffers released earlier on the same thread.
+     */
+    struct BufferStats {
+        long long allocations{0};
+        long long reused{0};
+    };
+    static BufferStats getThreadBufferStats();
+
+    /**
+     * Returns the bytes of released buffers held for reuse by all threads together, which is also
+     * reported as metrics.documentBufferCache.cachedBytes in serverStatus.
+     */
+    static long long getCachedBufferBytes();
+
     /**
      * Copies all metadata from source if it has any.
      * Note: does not clear metadata from this.
@@ -325,6 +411,36 @@ private:
         return _firstElement ? _firstElement->plusBytes(_usedBytes) : nullptr;
     }
 
+    ValueElement& element(Position pos) {
+        return *(_firstElement->plusBytes(pos.index));
+    }
+
+    Position findLoadedField(StringData name) const;
+
+    /**
+     * Converts the next field of _bson to a Value and returns its position. This is logically
+     * const since it does not change the contents of the document. Callers hold a LazyLoadGuard.
+     */
+    Position loadNextBsonField() const;
+
+    void loadAllBsonFields() const {
+        LazyLoadGuard guard(*this);
+        while (_bsonNextElement)
+            loadNextBsonField();
+    }
+
+    /// Called when a reference to the field at pos is handed out for modification
+    void markModified(Position pos);
+
+    /// Loads all remaining fields and drops _bson, leaving an ordinary document
+    void detachFromBson();
+
+    /// Adds a new field without loading the remaining fields of _bson first
+    Value& appendFieldImpl(StringData name);
+
+    /// Allocates a buffer for elementBytes worth of fields and a hash table sized for numFields
+    void reserve(size_t elementBytes, size_t numFields);
+
     /// Allocates space in _buffer. Copies existing data if there is any.
     void alloc(unsigned newSize);
 
@@ -363,7 +479,7 @@ private:
     /// Adds all fields to the hash table
     void rehash() {
         hashTabInit();
-        for (DocumentStorageIterator it = iteratorAll(); !it.atEnd(); it.advance())
+        for (DocumentStorageIterator it = loadedIterator(); !it.atEnd(); it.advance())
             addFieldToHashTable(it.position());
     }
 
@@ -401,6 +517,20 @@ private:
     double _textScore;
     double _randVal;
     BSONObj _sortKey;
+
+    // The BSON this document was created from, if any. Its leading fields have been loaded into the
+    // first _bsonLoadedBytes of _buffer, in order, and _bsonNextElement is the offset in _bson of
+    // the first field not loaded yet, or 0 once all of them are.
+    BSONObj _bson;
+    unsigned _bsonNextElement;
+    unsigned _bsonLoadedBytes;
+    // True while fields of _bson remain to be loaded, during which _bsonLoadLock guards loading
+    // them and reading the fields loaded so far.
+    AtomicWord<bool> _bsonPending;
+    mutable SpinLock _bsonLoadLock;
+    // Loaded fields of _bson which may have been changed through a non-const reference
+    std::vector<Position> _modifiedBsonFields;
+
     // When adding a field, make sure to update clone() method
 
     // Defined in document.cpp
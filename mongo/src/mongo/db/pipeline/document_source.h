@@ -776,6 +776,13 @@ public:
         virtual Status appendRecordCount(const NamespaceString& nss,
                                          BSONObjBuilder* builder) const = 0;
 
+        /**
+         * Appends to "builder" how much of collection "nss" and of its indexes is held in the
+         * storage engine's cache.
+         */
+        virtual Status appendCacheResidency(const NamespaceString& nss,
+                                            BSONObjBuilder* builder) const = 0;
+
         /**
          * Gets the collection options for the collection given by 'nss'.
          */
@@ -828,6 +835,19 @@ public:
                                                    CurrentOpUserMode userMode,
                                                    CurrentOpTruncateMode) const = 0;
 
+        /**
+         * Returns a vector of owned BSONObjs, each of which contains the statistics accumulated for
+         * a query shape, with latency histograms if 'includeHistograms' is true.
+         */
+        virtual std::vector<BSONObj> getQueryStats(bool includeHistograms) const = 0;
+
+        /**
+         * Returns a vector of owned BSONObjs, one per collection on this node, each of which
+         * contains how much of the collection and of its indexes is held in the storage engine's
+         * cache.
+         */
+        virtual std::vector<BSONObj> getCacheResidency() const = 0;
+
         /**
          * Returns the name of the local shard if sharding is enabled, or an empty string.
          */
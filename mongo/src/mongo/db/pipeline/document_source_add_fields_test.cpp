@@ -28,6 +28,7 @@
 
 #include "mongo/platform/basic.h"
 
+#include <deque>
 #include <vector>
 
 #include "mongo/bson/bson_depth.h"
@@ -154,6 +155,94 @@ TEST_F(AddFieldsTest, ShouldPropagatePauses) {
     ASSERT_TRUE(addFields->getNext().isEOF());
 }
 
+TEST_F(AddFieldsTest, ShouldReturnBatchedDocumentsInOrderAroundPauses) {
+    auto addFields = DocumentSourceAddFields::create(
+        fromjson("{b: {$multiply: ['$a', 2]}, c: {$cond: [{$gt: ['$a', 500]}, 'big', 'small']}}"),
+        getExpCtx());
+    std::deque<DocumentSource::GetNextResult> inputs;
+    for (int i = 0; i < 1000; ++i) {
+        inputs.push_back(Document{{"a", i}});
+        if (i == 100) {
+            inputs.push_back(DocumentSource::GetNextResult::makePauseExecution());
+        }
+    }
+    auto mock = DocumentSourceMock::create(inputs);
+    addFields->setSource(mock.get());
+
+    for (int i = 0; i < 1000; ++i) {
+        auto next = addFields->getNext();
+        ASSERT_TRUE(next.isAdvanced());
+        auto expectedSize = i > 500 ? "big"_sd : "small"_sd;
+        ASSERT_DOCUMENT_EQ(next.releaseDocument(),
+                           (Document{{"a", i}, {"b", i * 2}, {"c", expectedSize}}));
+        if (i == 100) {
+            ASSERT_TRUE(addFields->getNext().isPaused());
+        }
+    }
+    ASSERT_TRUE(addFields->getNext().isEOF());
+}
+
+TEST_F(AddFieldsTest, ShouldMatchUnbatchedResultsWhenBatchEvaluationFails) {
+    // Evaluated one document at a time, $add stops at the null and never divides by zero. The
+    // batched evaluation of the $add does divide by zero, and must fall back to the unbatched
+    // result.
+    auto addFields = DocumentSourceAddFields::create(
+        fromjson("{x: {$add: ['$a', {$divide: [1, '$d']}]}}"), getExpCtx());
+    auto mock = DocumentSourceMock::create(
+        {Document{{"a", BSONNULL}, {"d", 0}}, Document{{"a", 1}, {"d", 2}}});
+    addFields->setSource(mock.get());
+
+    auto next = addFields->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(),
+                       (Document{{"a", BSONNULL}, {"d", 0}, {"x", BSONNULL}}));
+    next = addFields->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(), (Document{{"a", 1}, {"d", 2}, {"x", 1.5}}));
+    ASSERT_TRUE(addFields->getNext().isEOF());
+}
+
+TEST_F(AddFieldsTest, ShouldReturnEarlierDocumentsOfABatchBeforeAnError) {
+    auto addFields =
+        DocumentSourceAddFields::create(fromjson("{x: {$divide: [1, '$d']}}"), getExpCtx());
+    std::deque<DocumentSource::GetNextResult> inputs;
+    for (int i = 0; i < 5; ++i) {
+        inputs.push_back(Document{{"d", 1}});
+    }
+    inputs.push_back(Document{{"d", 0}});
+    inputs.push_back(Document{{"d", 1}});
+    auto mock = DocumentSourceMock::create(inputs);
+    addFields->setSource(mock.get());
+
+    for (int i = 0; i < 5; ++i) {
+        auto next = addFields->getNext();
+        ASSERT_TRUE(next.isAdvanced());
+        ASSERT_DOCUMENT_EQ(next.releaseDocument(), (Document{{"d", 1}, {"x", 1.0}}));
+    }
+    ASSERT_THROWS_CODE(addFields->getNext(), AssertionException, 16608);
+}
+
+TEST_F(AddFieldsTest, ShouldReturnAllOfALargeBatch) {
+    // Each of these documents is about 1MB, so batches are cut short by their size rather than by
+    // their number of documents.
+    auto addFields = DocumentSourceAddFields::create(fromjson("{b: '$a'}"), getExpCtx());
+    const std::string bigString(1024 * 1024, 'x');
+    std::deque<DocumentSource::GetNextResult> inputs;
+    for (int i = 0; i < 20; ++i) {
+        inputs.push_back(Document{{"_id", i}, {"a", bigString}});
+    }
+    auto mock = DocumentSourceMock::create(inputs);
+    addFields->setSource(mock.get());
+
+    for (int i = 0; i < 20; ++i) {
+        auto next = addFields->getNext();
+        ASSERT_TRUE(next.isAdvanced());
+        ASSERT_DOCUMENT_EQ(next.releaseDocument(),
+                           (Document{{"_id", i}, {"a", bigString}, {"b", bigString}}));
+    }
+    ASSERT_TRUE(addFields->getNext().isEOF());
+}
+
 TEST_F(AddFieldsTest, AddFieldsWithRemoveSystemVariableDoesNotAddField) {
     auto addFields = DocumentSourceAddFields::create(BSON("fieldToAdd"
                                                           << "$$REMOVE"),
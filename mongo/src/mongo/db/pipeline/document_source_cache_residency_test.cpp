@@ -0,0 +1,124 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/aggregation_context_fixture.h"
+#include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/document_source_cache_residency.h"
+#include "mongo/db/pipeline/document_value_test_util.h"
+#include "mongo/db/pipeline/stub_mongo_process_interface.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+
+namespace {
+
+/**
+ * Sets the ExpressionContext's namespace to 'admin' with {aggregate: 1} by default.
+ */
+class DocumentSourceCacheResidencyTest : public AggregationContextFixture {
+public:
+    DocumentSourceCacheResidencyTest()
+        : AggregationContextFixture(NamespaceString::makeCollectionlessAggregateNSS("admin")) {}
+};
+
+/**
+ * A MongoProcessInterface used for testing which returns artificial cache residency statistics.
+ */
+class MockMongoProcessInterfaceImplementation final : public StubMongoProcessInterface {
+public:
+    explicit MockMongoProcessInterfaceImplementation(std::vector<BSONObj> stats)
+        : _stats(std::move(stats)) {}
+
+    std::vector<BSONObj> getCacheResidency() const {
+        return _stats;
+    }
+
+    std::string getShardName(OperationContext* opCtx) const {
+        return "testshard";
+    }
+
+private:
+    std::vector<BSONObj> _stats;
+};
+
+TEST_F(DocumentSourceCacheResidencyTest, ShouldFailToParseIfSpecIsNotEmptyObject) {
+    for (auto spec : {"{$cacheResidency:1}", "{$cacheResidency:{foo:true}}"}) {
+        const auto specObj = fromjson(spec);
+        ASSERT_THROWS_CODE(
+            DocumentSourceCacheResidency::createFromBson(specObj.firstElement(), getExpCtx()),
+            AssertionException,
+            ErrorCodes::FailedToParse);
+    }
+}
+
+TEST_F(DocumentSourceCacheResidencyTest, ShouldFailToParseIfNotRunWithAggregateOneOnAdmin) {
+    const auto specObj = fromjson("{$cacheResidency:{}}");
+    getExpCtx()->ns = NamespaceString("admin.foo");
+    ASSERT_THROWS_CODE(
+        DocumentSourceCacheResidency::createFromBson(specObj.firstElement(), getExpCtx()),
+        AssertionException,
+        ErrorCodes::InvalidNamespace);
+}
+
+TEST_F(DocumentSourceCacheResidencyTest, ShouldReturnOneDocumentPerCollection) {
+    std::vector<BSONObj> stats{
+        fromjson("{ns: 'test.a', collection: {bytesInCache: 10}, indexes: {_id_: {}}}"),
+        fromjson("{ns: 'test.b', collection: {bytesInCache: 20}, indexes: {}}")};
+    const auto cacheResidency = DocumentSourceCacheResidency::create(getExpCtx());
+    cacheResidency->injectMongoProcessInterface(
+        std::make_shared<MockMongoProcessInterfaceImplementation>(stats));
+
+    for (auto&& expected : stats) {
+        auto next = cacheResidency->getNext();
+        ASSERT(next.isAdvanced());
+        ASSERT_DOCUMENT_EQ(next.releaseDocument(), Document(expected));
+    }
+    ASSERT(cacheResidency->getNext().isEOF());
+}
+
+TEST_F(DocumentSourceCacheResidencyTest, ShouldAddShardNameInShardedContext) {
+    getExpCtx()->fromMongos = true;
+
+    std::vector<BSONObj> stats{fromjson("{ns: 'test.a', collection: {bytesInCache: 10}}")};
+    const auto cacheResidency = DocumentSourceCacheResidency::create(getExpCtx());
+    cacheResidency->injectMongoProcessInterface(
+        std::make_shared<MockMongoProcessInterfaceImplementation>(stats));
+
+    auto next = cacheResidency->getNext();
+    ASSERT(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(),
+                       (Document{{"shard", "testshard"_sd},
+                                 {"ns", "test.a"_sd},
+                                 {"collection", Document{{"bytesInCache", 10}}}}));
+    ASSERT(cacheResidency->getNext().isEOF());
+}
+
+}  // namespace
+}  // namespace mongo
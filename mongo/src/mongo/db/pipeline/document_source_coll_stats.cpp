@@ -84,6 +84,12 @@ intrusive_ptr<DocumentSource> DocumentSourceCollStats::createFromBson(
                                   << " of type "
                                   << typeName(elem.type()),
                     elem.type() == BSONType::Object);
+        } else if ("cacheResidency" == fieldName) {
+            uassert(40682,
+                    str::stream() << "cacheResidency argument must be an object, but got " << elem
+                                  << " of type "
+                                  << typeName(elem.type()),
+                    elem.type() == BSONType::Object);
         } else {
             uasserted(40168, str::stream() << "unrecognized option to $collStats: " << fieldName);
         }
@@ -146,6 +152,18 @@ DocumentSource::GetNextResult DocumentSourceCollStats::getNext() {
         }
     }
 
+    if (_collStatsSpec.hasField("cacheResidency")) {
+        BSONObjBuilder cacheBuilder(builder.subobjStart("cacheResidency"));
+        Status status =
+            _mongoProcessInterface->appendCacheResidency(pExpCtx->ns, &cacheBuilder);
+        cacheBuilder.doneFast();
+        if (!status.isOK()) {
+            uasserted(40683,
+                      str::stream() << "Unable to retrieve cacheResidency in $collStats stage: "
+                                    << status.reason());
+        }
+    }
+
     return {Document(builder.obj())};
 }
 
@@ -0,0 +1,127 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/document_source_column_scan.h"
+
+#include <algorithm>
+
+#include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/expression_context.h"
+#include "mongo/db/pipeline/value.h"
+
+namespace mongo {
+
+using boost::intrusive_ptr;
+
+constexpr StringData DocumentSourceColumnScan::kStageName;
+constexpr size_t DocumentSourceColumnScan::kBatchSize;
+
+intrusive_ptr<DocumentSourceColumnScan> DocumentSourceColumnScan::create(
+    std::shared_ptr<const ColumnCache> cache,
+    const std::set<std::string>& fieldPaths,
+    const intrusive_ptr<ExpressionContext>& expCtx) {
+    invariant(cache->covers(fieldPaths));
+
+    // Whole top-level fields are returned, so "a.b" and "a.c" both just need "a".
+    bool includeId = false;
+    std::set<size_t> indexes;
+    for (auto&& path : fieldPaths) {
+        const StringData topLevel = StringData(path).substr(0, path.find('.'));
+        if (topLevel == "_id"_sd) {
+            includeId = true;
+            continue;
+        }
+        const auto& names = cache->fieldNames();
+        indexes.insert(std::find(names.begin(), names.end(), topLevel) - names.begin());
+    }
+
+    return new DocumentSourceColumnScan(std::move(cache),
+                                        includeId,
+                                        std::vector<size_t>(indexes.begin(), indexes.end()),
+                                        expCtx);
+}
+
+DocumentSourceColumnScan::DocumentSourceColumnScan(std::shared_ptr<const ColumnCache> cache,
+                                                   bool includeId,
+                                                   std::vector<size_t> fieldIndexes,
+                                                   const intrusive_ptr<ExpressionContext>& expCtx)
+    : DocumentSource(expCtx),
+      _cache(std::move(cache)),
+      _includeId(includeId),
+      _fieldIndexes(std::move(fieldIndexes)) {}
+
+DocumentSource::GetNextResult DocumentSourceColumnScan::getNext() {
+    pExpCtx->checkForInterrupt();
+
+    if (_batch.empty() && !_exhausted) {
+        _exhausted = !_cache->fetch(&_position, kBatchSize, _includeId, _fieldIndexes, &_batch);
+    }
+
+    if (_batch.empty()) {
+        return GetNextResult::makeEOF();
+    }
+
+    Document next = std::move(_batch.front());
+    _batch.pop_front();
+    ++_docsReturned;
+    return std::move(next);
+}
+
+Value DocumentSourceColumnScan::serialize(
+    boost::optional<ExplainOptions::Verbosity> explain) const {
+    // Only ever created by PipelineD, so there is nothing to serialize unless explaining.
+    if (!explain) {
+        return Value();
+    }
+
+    std::vector<Value> fields;
+    if (_includeId) {
+        fields.push_back(Value("_id"_sd));
+    }
+    for (size_t index : _fieldIndexes) {
+        fields.push_back(Value(_cache->fieldNames()[index]));
+    }
+
+    MutableDocument out;
+    out["fields"] = Value(std::move(fields));
+    if (*explain >= ExplainOptions::Verbosity::kExecStats) {
+        out["nReturned"] = Value(_docsReturned);
+    }
+    return Value(DOC(getSourceName() << out.freeze()));
+}
+
+void DocumentSourceColumnScan::doDispose() {
+    _exhausted = true;
+    _batch.clear();
+    _cache.reset();
+}
+
+}  // namespace mongo
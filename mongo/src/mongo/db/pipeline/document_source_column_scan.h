@@ -0,0 +1,103 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "mongo/db/pipeline/column_cache.h"
+#include "mongo/db/pipeline/document_source.h"
+
+namespace mongo {
+
+/**
+ * Produces the documents of a collection from its ColumnCache rather than from the storage engine.
+ * Each output document holds only the requested top-level fields, which must all be cached (and
+ * '_id' if asked for). Used in place of a DocumentSourceCursor when a pipeline's dependencies are
+ * covered by the cache, so it is only ever created by PipelineD and cannot be parsed.
+ */
+class DocumentSourceColumnScan final : public DocumentSource {
+public:
+    static constexpr StringData kStageName = "$columnScan"_sd;
+
+    // Number of documents read from the cache at a time.
+    static constexpr size_t kBatchSize = 1024;
+
+    static boost::intrusive_ptr<DocumentSourceColumnScan> create(
+        std::shared_ptr<const ColumnCache> cache,
+        const std::set<std::string>& fieldPaths,
+        const boost::intrusive_ptr<ExpressionContext>& expCtx);
+
+    GetNextResult getNext() final;
+
+    const char* getSourceName() const final {
+        return kStageName.rawData();
+    }
+
+    Value serialize(boost::optional<ExplainOptions::Verbosity> explain = boost::none) const final;
+
+    StageConstraints constraints(Pipeline::SplitState pipeState) const final {
+        StageConstraints constraints(StreamType::kStreaming,
+                                     PositionRequirement::kFirst,
+                                     HostTypeRequirement::kAnyShard,
+                                     DiskUseRequirement::kNoDiskUse,
+                                     FacetRequirement::kNotAllowed);
+
+        constraints.requiresInputDocSource = false;
+        return constraints;
+    }
+
+    long long getDocsReturned() const {
+        return _docsReturned;
+    }
+
+protected:
+    void doDispose() final;
+
+private:
+    DocumentSourceColumnScan(std::shared_ptr<const ColumnCache> cache,
+                             bool includeId,
+                             std::vector<size_t> fieldIndexes,
+                             const boost::intrusive_ptr<ExpressionContext>& expCtx);
+
+    std::shared_ptr<const ColumnCache> _cache;
+    const bool _includeId;
+    const std::vector<size_t> _fieldIndexes;
+
+    size_t _position = 0;
+    bool _exhausted = false;
+    std::deque<Document> _batch;
+    long long _docsReturned = 0;
+};
+
+}  // namespace mongo
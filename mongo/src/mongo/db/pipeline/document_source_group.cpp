@@ -66,10 +66,6 @@ DocumentSource::GetNextResult DocumentSourceGroup::getNext() {
         invariant(initializationResult.isEOF());
     }
 
-    for (auto&& accum : _currentAccumulators) {
-        accum->reset();  // Prep accumulators for a new group.
-    }
-
     if (_spilled) {
         return getNextSpilled();
     } else if (_streaming) {
@@ -84,6 +80,10 @@ DocumentSource::GetNextResult DocumentSourceGroup::getNextSpilled() {
     if (!_sorterIterator)
         return GetNextResult::makeEOF();
 
+    for (auto&& accum : _currentAccumulators) {
+        accum->reset();  // Prep accumulators for a new group.
+    }
+
     _currentId = _firstPartOfNextGroup.first;
     const size_t numAccumulators = _accumulatedFields.size();
     while (pExpCtx->getValueComparator().evaluate(_currentId == _firstPartOfNextGroup.first)) {
@@ -127,41 +127,44 @@ DocumentSource::GetNextResult DocumentSourceGroup::getNextStandard() {
 }
 
 DocumentSource::GetNextResult DocumentSourceGroup::getNextStreaming() {
-    // Streaming optimization is active.
-    if (!_firstDocOfNextGroup) {
-        auto nextInput = pSource->getNext();
-        if (!nextInput.isAdvanced()) {
-            return nextInput;
+    // Streaming optimization is active. '_firstDocOfNextGroup' is an input document which has not
+    // been added to a group yet, and '_currentAccumulators' hold the group with _id '_currentId'
+    // while '_currentGroupStarted' is set. Both survive a pause of the input.
+    while (true) {
+        if (!_firstDocOfNextGroup) {
+            auto nextInput = pSource->getNext();
+            if (nextInput.isEOF() && _currentGroupStarted) {
+                // The input is exhausted, so the current group is the last one.
+                _currentGroupStarted = false;
+                return makeDocument(_currentId, _currentAccumulators, pExpCtx->needsMerge);
+            }
+            if (!nextInput.isAdvanced()) {
+                return nextInput;
+            }
+            _firstDocOfNextGroup = nextInput.releaseDocument();
         }
-        _firstDocOfNextGroup = nextInput.releaseDocument();
-    }
 
-    Value id;
-    do {
-        // Add to the current accumulator(s).
-        for (size_t i = 0; i < _currentAccumulators.size(); i++) {
-            _currentAccumulators[i]->process(
-                _accumulatedFields[i].expression->evaluate(*_firstDocOfNextGroup), _doingMerge);
+        Value id = computeId(*_firstDocOfNextGroup);
+        if (_currentGroupStarted && !pExpCtx->getValueComparator().evaluate(_currentId == id)) {
+            // The current group is complete. '_firstDocOfNextGroup' is kept for the next call.
+            _currentGroupStarted = false;
+            return makeDocument(_currentId, _currentAccumulators, pExpCtx->needsMerge);
         }
 
-        // Retrieve the next document.
-        auto nextInput = pSource->getNext();
-        if (!nextInput.isAdvanced()) {
-            return nextInput;
+        if (!_currentGroupStarted) {
+            for (auto&& accum : _currentAccumulators) {
+                accum->reset();  // Prep accumulators for a new group.
+            }
+            _currentId = std::move(id);
+            _currentGroupStarted = true;
         }
 
-        _firstDocOfNextGroup = nextInput.releaseDocument();
-
-
-        // Compute the id. If it does not match _currentId, we will exit the loop, leaving
-        // _firstDocOfNextGroup set for the next time getNext() is called.
-        id = computeId(*_firstDocOfNextGroup);
-    } while (pExpCtx->getValueComparator().evaluate(_currentId == id));
-
-    Document out = makeDocument(_currentId, _currentAccumulators, pExpCtx->needsMerge);
-    _currentId = std::move(id);
-
-    return std::move(out);
+        for (size_t i = 0; i < _currentAccumulators.size(); i++) {
+            _currentAccumulators[i]->process(
+                _accumulatedFields[i].expression->evaluate(*_firstDocOfNextGroup), _doingMerge);
+        }
+        _firstDocOfNextGroup = boost::none;
+    }
 }
 
 void DocumentSourceGroup::doDispose() {
@@ -173,6 +176,7 @@ void DocumentSourceGroup::doDispose() {
     groupsIterator = _groups->end();
 
     _firstDocOfNextGroup = boost::none;
+    _currentGroupStarted = false;
 }
 
 intrusive_ptr<DocumentSource> DocumentSourceGroup::optimize() {
@@ -221,7 +225,7 @@ Value DocumentSourceGroup::serialize(boost::optional<ExplainOptions::Verbosity>
         insides["$doingMerge"] = Value(true);
     }
 
-    if (explain && findRelevantInputSort()) {
+    if (explain && (_streaming || findRelevantInputSort())) {
         return Value(DOC("$streamingGroup" << insides.freeze()));
     }
     return Value(DOC(getSourceName() << insides.freeze()));
@@ -451,28 +455,22 @@ void getFieldPathListForSpilled(ExpressionObject* expressionObj,
 DocumentSource::GetNextResult DocumentSourceGroup::initialize() {
     const size_t numAccumulators = _accumulatedFields.size();
 
-    boost::optional<BSONObj> inputSort = findRelevantInputSort();
-    if (inputSort) {
-        // We can convert to streaming.
-        _streaming = true;
-        _inputSort = *inputSort;
+    if (!_streaming) {
+        boost::optional<BSONObj> inputSort = findRelevantInputSort();
+        if (inputSort) {
+            // We can convert to streaming.
+            _streaming = true;
+            _inputSort = *inputSort;
+        }
+    }
 
-        // Set up accumulators.
+    if (_streaming) {
+        // Set up accumulators. The input is read one group at a time by getNextStreaming().
         _currentAccumulators.reserve(numAccumulators);
         for (auto&& accumulatedField : _accumulatedFields) {
             _currentAccumulators.push_back(accumulatedField.makeAccumulator(pExpCtx));
         }
 
-        // We only need to load the first document.
-        auto firstInput = pSource->getNext();
-        if (!firstInput.isAdvanced()) {
-            // Leave '_firstDocOfNextGroup' uninitialized and return.
-            return firstInput;
-        }
-        _firstDocOfNextGroup = firstInput.releaseDocument();
-
-        // Compute the _id value.
-        _currentId = computeId(*_firstDocOfNextGroup);
         _initialized = true;
         return DocumentSource::GetNextResult::makeEOF();
     }
@@ -688,6 +686,54 @@ boost::optional<BSONObj> DocumentSourceGroup::findRelevantInputSort() const {
     return boost::none;
 }
 
+boost::optional<std::string> DocumentSourceGroup::getStreamableGroupField() const {
+    if (_doingMerge || pExpCtx->getCollator() || !_idFieldNames.empty() ||
+        _idExpressions.size() != 1) {
+        return boost::none;
+    }
+
+    auto idPath = dynamic_cast<ExpressionFieldPath*>(_idExpressions[0].get());
+    if (!idPath || !idPath->isRootFieldPath() || idPath->getFieldPath().getPathLength() < 2) {
+        return boost::none;
+    }
+
+    // A covered index scan reports a missing field as null. These accumulators ignore both, and
+    // computeId() turns a missing _id into null anyway, so the results are the same.
+    static const std::set<StringData> kNullishInsensitiveAccumulators = {
+        "$sum"_sd, "$avg"_sd, "$min"_sd, "$max"_sd, "$stdDevPop"_sd, "$stdDevSamp"_sd};
+    for (auto&& accumulatedField : _accumulatedFields) {
+        if (!dynamic_cast<ExpressionConstant*>(accumulatedField.expression.get()) &&
+            !dynamic_cast<ExpressionFieldPath*>(accumulatedField.expression.get())) {
+            return boost::none;
+        }
+        auto accumulator = accumulatedField.makeAccumulator(pExpCtx);
+        if (!kNullishInsensitiveAccumulators.count(accumulator->getOpName())) {
+            return boost::none;
+        }
+    }
+
+    // Strip the leading "CURRENT".
+    return idPath->getFieldPath().tail().fullPath();
+}
+
+bool DocumentSourceGroup::setStreamingInputSorts(const BSONObjSet& inputSorts) {
+    invariant(!_initialized);
+
+    const auto groupField = getStreamableGroupField();
+    if (!groupField) {
+        return false;
+    }
+
+    for (auto&& sort : inputSorts) {
+        if (sort.firstElement().fieldNameStringData() == *groupField) {
+            _streaming = true;
+            _inputSort = sort.firstElement().wrap();
+            return true;
+        }
+    }
+    return false;
+}
+
 BSONObjSet DocumentSourceGroup::getOutputSorts() {
     if (!_initialized) {
         initialize();  // Note this might not finish initializing, but that's OK. We just want to
@@ -98,6 +98,21 @@ public:
         return _streaming;
     }
 
+    /**
+     * Returns the field this $group groups by if it could stream over the output of a covered
+     * index scan: the _id must be a single field path, and every accumulator must treat a missing
+     * value like null, since that is how a covered scan reports a field the document lacks.
+     * Returns boost::none otherwise.
+     */
+    boost::optional<std::string> getStreamableGroupField() const;
+
+    /**
+     * Makes this $group stream if one of 'inputSorts', the orders its input is known to be sorted
+     * in, starts with the field returned by getStreamableGroupField(), so that equal _ids arrive
+     * consecutively. Returns whether it will stream. Must be called before the first getNext().
+     */
+    bool setStreamingInputSorts(const BSONObjSet& inputSorts);
+
     // Virtuals for SplittableDocumentSource.
     boost::intrusive_ptr<DocumentSource> getShardSource() final;
     std::list<boost::intrusive_ptr<DocumentSource>> getMergeSources() final;
@@ -111,8 +126,7 @@ private:
 
     /**
      * getNext() dispatches to one of these three depending on what type of $group it is. All three
-     * of these methods expect '_currentAccumulators' to have been reset before being called, and
-     * also expect initialize() to have been called already.
+     * of these methods expect initialize() to have been called already.
      */
     GetNextResult getNextStreaming();
     GetNextResult getNextSpilled();
@@ -170,6 +184,8 @@ private:
 
     Value _currentId;
     Accumulators _currentAccumulators;
+    // Only used when '_streaming' is true: whether '_currentAccumulators' hold a partial group.
+    bool _currentGroupStarted = false;
 
     // We use boost::optional to defer initialization until the ExpressionContext containing the
     // correct comparator is injected, since the groups must be built using the comparator's
@@ -189,6 +189,96 @@ TEST_F(DocumentSourceGroupTest, ShouldCorrectlyTrackMemoryUsageBetweenPauses) {
     ASSERT_THROWS_CODE(group->getNext(), AssertionException, 16945);
 }
 
+intrusive_ptr<DocumentSourceGroup> parseGroup(const intrusive_ptr<ExpressionContext>& expCtx,
+                                              const BSONObj& spec) {
+    auto group = DocumentSourceGroup::createFromBson(BSON("$group" << spec).firstElement(), expCtx);
+    return dynamic_cast<DocumentSourceGroup*>(group.get());
+}
+
+BSONObjSet makeSorts(std::initializer_list<BSONObj> sorts) {
+    BSONObjSet out = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+    out.insert(sorts.begin(), sorts.end());
+    return out;
+}
+
+TEST_F(DocumentSourceGroupTest, StreamableGroupFieldRequiresNullInsensitiveAccumulators) {
+    auto expCtx = getExpCtx();
+    ASSERT_EQ(*parseGroup(expCtx, fromjson("{_id: '$a', n: {$sum: 1}}"))->getStreamableGroupField(),
+              "a");
+    ASSERT_EQ(*parseGroup(expCtx, fromjson("{_id: '$a.b', m: {$max: '$c'}, s: {$avg: '$c'}}"))
+                   ->getStreamableGroupField(),
+              "a.b");
+
+    // A missing value and null would give different results.
+    ASSERT_FALSE(parseGroup(expCtx, fromjson("{_id: '$a', p: {$push: '$b'}}"))
+                     ->getStreamableGroupField());
+    ASSERT_FALSE(parseGroup(expCtx, fromjson("{_id: {x: '$a'}, n: {$sum: 1}}"))
+                     ->getStreamableGroupField());
+    ASSERT_FALSE(parseGroup(expCtx, fromjson("{_id: '$a', n: {$sum: {$ifNull: ['$b', 1]}}}"))
+                     ->getStreamableGroupField());
+
+    // Not a single field.
+    ASSERT_FALSE(parseGroup(expCtx, fromjson("{_id: null, n: {$sum: 1}}"))
+                     ->getStreamableGroupField());
+    ASSERT_FALSE(parseGroup(expCtx, fromjson("{_id: {$toLower: '$a'}, n: {$sum: 1}}"))
+                     ->getStreamableGroupField());
+}
+
+TEST_F(DocumentSourceGroupTest, StreamsOnlyWhenInputIsSortedByGroupField) {
+    auto expCtx = getExpCtx();
+    const BSONObj spec = fromjson("{_id: '$a', n: {$sum: 1}}");
+
+    ASSERT_FALSE(parseGroup(expCtx, spec)->setStreamingInputSorts(makeSorts({BSON("b" << 1)})));
+    ASSERT_FALSE(
+        parseGroup(expCtx, spec)->setStreamingInputSorts(makeSorts({BSON("b" << 1 << "a" << 1)})));
+
+    auto group = parseGroup(expCtx, spec);
+    ASSERT_TRUE(group->setStreamingInputSorts(
+        makeSorts({BSON("b" << 1), BSON("a" << -1 << "b" << 1)})));
+    ASSERT_TRUE(group->isStreaming());
+    ASSERT_BSONOBJ_EQ(*group->getOutputSorts().begin(), BSON("_id" << -1));
+}
+
+TEST_F(DocumentSourceGroupTest, StreamingGroupReturnsEveryGroupInInputOrder) {
+    auto expCtx = getExpCtx();
+    auto group = parseGroup(expCtx, fromjson("{_id: '$a', n: {$sum: 1}, t: {$sum: '$b'}}"));
+    ASSERT_TRUE(group->setStreamingInputSorts(makeSorts({BSON("a" << 1)})));
+
+    // A covered index scan turns a missing 'a' into null; both are grouped under null.
+    auto mock = DocumentSourceMock::create({Document{{"a", BSONNULL}, {"b", 1}},
+                                            Document{{"b", 2}},
+                                            Document{{"a", 1}, {"b", 1}},
+                                            DocumentSource::GetNextResult::makePauseExecution(),
+                                            Document{{"a", 1.0}, {"b", 3}},
+                                            Document{{"a", 2}, {"b", 5}},
+                                            DocumentSource::GetNextResult::makePauseExecution(),
+                                            Document{{"a", "x"_sd}}});
+    group->setSource(mock.get());
+
+    auto next = group->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(),
+                       (Document{{"_id", BSONNULL}, {"n", 2}, {"t", 3}}));
+
+    // The pause comes in the middle of the group for 1.
+    ASSERT_TRUE(group->getNext().isPaused());
+    next = group->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(), (Document{{"_id", 1}, {"n", 2}, {"t", 4}}));
+
+    // The group for 2 is not known to be complete until the document after the pause.
+    ASSERT_TRUE(group->getNext().isPaused());
+    next = group->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(), (Document{{"_id", 2}, {"n", 1}, {"t", 5}}));
+
+    // The last group is returned once the input is exhausted.
+    next = group->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(), (Document{{"_id", "x"_sd}, {"n", 1}, {"t", 0}}));
+    ASSERT_TRUE(group->getNext().isEOF());
+}
+
 BSONObj toBson(const intrusive_ptr<DocumentSource>& source) {
     vector<Value> arr;
     source->serializeToArray(arr);
@@ -0,0 +1,134 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/document_source_query_stats.h"
+
+#include "mongo/db/pipeline/lite_parsed_document_source.h"
+
+namespace mongo {
+
+namespace {
+const StringData kHistogramsFieldName = "histograms"_sd;
+const StringData kShardFieldName = "shard"_sd;
+}  // namespace
+
+using boost::intrusive_ptr;
+
+REGISTER_DOCUMENT_SOURCE(queryStats,
+                         DocumentSourceQueryStats::LiteParsed::parse,
+                         DocumentSourceQueryStats::createFromBson);
+
+const char* DocumentSourceQueryStats::getSourceName() const {
+    return "$queryStats";
+}
+
+DocumentSource::GetNextResult DocumentSourceQueryStats::getNext() {
+    pExpCtx->checkForInterrupt();
+
+    if (!_fetched) {
+        _stats = _mongoProcessInterface->getQueryStats(_includeHistograms);
+        _statsIter = _stats.begin();
+        _fetched = true;
+
+        if (pExpCtx->fromMongos) {
+            _shardName = _mongoProcessInterface->getShardName(pExpCtx->opCtx);
+
+            uassert(40679,
+                    "Aggregation request specified 'fromMongos' but unable to retrieve shard name "
+                    "for $queryStats pipeline stage.",
+                    !_shardName.empty());
+        }
+    }
+
+    if (_statsIter == _stats.end()) {
+        return GetNextResult::makeEOF();
+    }
+
+    if (_shardName.empty()) {
+        return Document(*_statsIter++);
+    }
+
+    // Identify which shard each query shape was seen on when running in a sharded cluster.
+    MutableDocument doc;
+    doc.addField(kShardFieldName, Value(_shardName));
+    for (auto&& elem : *_statsIter++) {
+        doc.addField(elem.fieldNameStringData(), Value(elem));
+    }
+    return doc.freeze();
+}
+
+intrusive_ptr<DocumentSource> DocumentSourceQueryStats::createFromBson(
+    BSONElement spec, const intrusive_ptr<ExpressionContext>& pExpCtx) {
+    uassert(ErrorCodes::FailedToParse,
+            str::stream() << "$queryStats options must be specified in an object, but found: "
+                          << typeName(spec.type()),
+            spec.type() == BSONType::Object);
+
+    const NamespaceString& nss = pExpCtx->ns;
+
+    uassert(ErrorCodes::InvalidNamespace,
+            "$queryStats must be run against the 'admin' database with {aggregate: 1}",
+            nss.db() == NamespaceString::kAdminDb && nss.isCollectionlessAggregateNS());
+
+    bool includeHistograms = false;
+
+    for (auto&& elem : spec.embeddedObject()) {
+        const auto fieldName = elem.fieldNameStringData();
+
+        if (fieldName == kHistogramsFieldName) {
+            uassert(ErrorCodes::FailedToParse,
+                    str::stream() << "The 'histograms' parameter of the $queryStats stage must be "
+                                     "a boolean value, but found: "
+                                  << typeName(elem.type()),
+                    elem.type() == BSONType::Bool);
+            includeHistograms = elem.Bool();
+        } else {
+            uasserted(ErrorCodes::FailedToParse,
+                      str::stream() << "Unrecognized option '" << fieldName
+                                    << "' in $queryStats stage.");
+        }
+    }
+
+    return create(pExpCtx, includeHistograms);
+}
+
+intrusive_ptr<DocumentSourceQueryStats> DocumentSourceQueryStats::create(
+    const intrusive_ptr<ExpressionContext>& pExpCtx, bool includeHistograms) {
+    return intrusive_ptr<DocumentSourceQueryStats>(
+        new DocumentSourceQueryStats(pExpCtx, includeHistograms));
+}
+
+Value DocumentSourceQueryStats::serialize(
+    boost::optional<ExplainOptions::Verbosity> explain) const {
+    return Value(
+        Document{{getSourceName(), Document{{kHistogramsFieldName, _includeHistograms}}}});
+}
+}  // namespace mongo
@@ -0,0 +1,142 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/aggregation_context_fixture.h"
+#include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/document_source_query_stats.h"
+#include "mongo/db/pipeline/document_value_test_util.h"
+#include "mongo/db/pipeline/stub_mongo_process_interface.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+
+namespace {
+
+/**
+ * Sets the ExpressionContext's namespace to 'admin' with {aggregate: 1} by default.
+ */
+class DocumentSourceQueryStatsTest : public AggregationContextFixture {
+public:
+    DocumentSourceQueryStatsTest()
+        : AggregationContextFixture(NamespaceString::makeCollectionlessAggregateNSS("admin")) {}
+};
+
+/**
+ * A MongoProcessInterface used for testing which returns artificial query stats.
+ */
+class MockMongoProcessInterfaceImplementation final : public StubMongoProcessInterface {
+public:
+    explicit MockMongoProcessInterfaceImplementation(std::vector<BSONObj> stats)
+        : _stats(std::move(stats)) {}
+
+    std::vector<BSONObj> getQueryStats(bool includeHistograms) const {
+        return _stats;
+    }
+
+    std::string getShardName(OperationContext* opCtx) const {
+        return "testshard";
+    }
+
+private:
+    std::vector<BSONObj> _stats;
+};
+
+TEST_F(DocumentSourceQueryStatsTest, ShouldFailToParseIfSpecIsNotObject) {
+    const auto specObj = fromjson("{$queryStats:1}");
+    ASSERT_THROWS_CODE(
+        DocumentSourceQueryStats::createFromBson(specObj.firstElement(), getExpCtx()),
+        AssertionException,
+        ErrorCodes::FailedToParse);
+}
+
+TEST_F(DocumentSourceQueryStatsTest, ShouldFailToParseIfNotRunWithAggregateOneOnAdmin) {
+    const auto specObj = fromjson("{$queryStats:{}}");
+    getExpCtx()->ns = NamespaceString("admin.foo");
+    ASSERT_THROWS_CODE(
+        DocumentSourceQueryStats::createFromBson(specObj.firstElement(), getExpCtx()),
+        AssertionException,
+        ErrorCodes::InvalidNamespace);
+}
+
+TEST_F(DocumentSourceQueryStatsTest, ShouldFailToParseUnrecognisedOrNonBooleanParameters) {
+    for (auto spec : {"{$queryStats:{histograms:1}}", "{$queryStats:{foo:true}}"}) {
+        const auto specObj = fromjson(spec);
+        ASSERT_THROWS_CODE(
+            DocumentSourceQueryStats::createFromBson(specObj.firstElement(), getExpCtx()),
+            AssertionException,
+            ErrorCodes::FailedToParse);
+    }
+}
+
+TEST_F(DocumentSourceQueryStatsTest, ShouldParseAndSerializeHistogramsArgument) {
+    const auto specObj = fromjson("{$queryStats:{histograms:true}}");
+    const auto parsed =
+        DocumentSourceQueryStats::createFromBson(specObj.firstElement(), getExpCtx());
+    const auto queryStats = static_cast<DocumentSourceQueryStats*>(parsed.get());
+
+    ASSERT_DOCUMENT_EQ(queryStats->serialize().getDocument(),
+                       (Document{{"$queryStats", Document{{"histograms", true}}}}));
+}
+
+TEST_F(DocumentSourceQueryStatsTest, ShouldReturnOneDocumentPerQueryShape) {
+    std::vector<BSONObj> stats{fromjson("{ns: 'test.a', queryShape: 'eqa', execCount: 2}"),
+                               fromjson("{ns: 'test.b', queryShape: 'eqb', execCount: 1}")};
+    const auto queryStats = DocumentSourceQueryStats::create(getExpCtx());
+    queryStats->injectMongoProcessInterface(
+        std::make_shared<MockMongoProcessInterfaceImplementation>(stats));
+
+    for (auto&& expected : stats) {
+        auto next = queryStats->getNext();
+        ASSERT(next.isAdvanced());
+        ASSERT_DOCUMENT_EQ(next.releaseDocument(), Document(expected));
+    }
+    ASSERT(queryStats->getNext().isEOF());
+}
+
+TEST_F(DocumentSourceQueryStatsTest, ShouldAddShardNameInShardedContext) {
+    getExpCtx()->fromMongos = true;
+
+    std::vector<BSONObj> stats{fromjson("{ns: 'test.a', queryShape: 'eqa', execCount: 2}")};
+    const auto queryStats = DocumentSourceQueryStats::create(getExpCtx());
+    queryStats->injectMongoProcessInterface(
+        std::make_shared<MockMongoProcessInterfaceImplementation>(stats));
+
+    auto next = queryStats->getNext();
+    ASSERT(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(
+        next.releaseDocument(),
+        (Document{{"shard", "testshard"_sd}, {"ns", "test.a"_sd}, {"queryShape", "eqa"_sd},
+                  {"execCount", 2}}));
+    ASSERT(queryStats->getNext().isEOF());
+}
+
+}  // namespace
+}  // namespace mongo
@@ -30,6 +30,7 @@
 
 #include "mongo/db/pipeline/document_source_single_document_transformation.h"
 
+#include <algorithm>
 #include <boost/smart_ptr/intrusive_ptr.hpp>
 
 #include "mongo/db/pipeline/document.h"
@@ -54,17 +55,82 @@ const char* DocumentSourceSingleDocumentTransformation::getSourceName() const {
     return _name.c_str();
 }
 
+constexpr size_t DocumentSourceSingleDocumentTransformation::kInitialBatchSize;
+constexpr size_t DocumentSourceSingleDocumentTransformation::kMaxBatchSize;
+constexpr size_t DocumentSourceSingleDocumentTransformation::kMaxBatchBytes;
+
 DocumentSource::GetNextResult DocumentSourceSingleDocumentTransformation::getNext() {
     pExpCtx->checkForInterrupt();
 
-    // Get the next input document.
-    auto input = pSource->getNext();
-    if (!input.isAdvanced()) {
-        return input;
+    // Return anything left over from the last batch first.
+    if (_transformedBatchPosition < _transformedBatch.size()) {
+        return std::move(_transformedBatch[_transformedBatchPosition++]);
+    }
+    if (!_errorAfterBatch.isOK()) {
+        auto status = std::move(_errorAfterBatch);
+        _errorAfterBatch = Status::OK();
+        _resultAfterBatch = boost::none;
+        uassertStatusOK(status);
+    }
+    if (_resultAfterBatch) {
+        auto result = std::move(*_resultAfterBatch);
+        _resultAfterBatch = boost::none;
+        return result;
+    }
+
+    if (!_parsedTransform->canTransformBatches()) {
+        // Get the next input document.
+        auto input = pSource->getNext();
+        if (!input.isAdvanced()) {
+            return input;
+        }
+
+        // Apply and return the document with added fields.
+        return _parsedTransform->applyTransformation(input.releaseDocument());
     }
 
-    // Apply and return the document with added fields.
-    return _parsedTransform->applyTransformation(input.releaseDocument());
+    // Gather a batch of input documents, stopping early at the first pause or EOF so that it is
+    // still returned right after the documents which preceded it.
+    _transformedBatch.clear();
+    _transformedBatchPosition = 0;
+    size_t batchBytes = 0;
+    while (_transformedBatch.size() < _nextBatchSize && batchBytes < kMaxBatchBytes) {
+        auto input = pSource->getNext();
+        if (!input.isAdvanced()) {
+            if (_transformedBatch.empty()) {
+                return input;
+            }
+            _resultAfterBatch = std::move(input);
+            break;
+        }
+        _transformedBatch.push_back(input.releaseDocument());
+        batchBytes += _transformedBatch.back().getApproximateSize();
+    }
+    _nextBatchSize = std::min(_nextBatchSize * 2, kMaxBatchSize);
+
+    try {
+        _parsedTransform->applyTransformationToBatch(&_transformedBatch);
+    } catch (const DBException&) {
+        // Evaluating a batch may evaluate operands in a different order than evaluating each
+        // document would, or operands that it would have skipped.
+        _transformBatchOneAtATime();
+    }
+    return std::move(_transformedBatch[_transformedBatchPosition++]);
+}
+
+void DocumentSourceSingleDocumentTransformation::_transformBatchOneAtATime() {
+    for (size_t i = 0; i < _transformedBatch.size(); ++i) {
+        try {
+            _transformedBatch[i] = _parsedTransform->applyTransformation(_transformedBatch[i]);
+        } catch (const DBException& ex) {
+            if (i == 0) {
+                throw;
+            }
+            _transformedBatch.resize(i);
+            _errorAfterBatch = ex.toStatus();
+            return;
+        }
+    }
 }
 
 intrusive_ptr<DocumentSource> DocumentSourceSingleDocumentTransformation::optimize() {
@@ -74,6 +140,10 @@ intrusive_ptr<DocumentSource> DocumentSourceSingleDocumentTransformation::optimi
 
 void DocumentSourceSingleDocumentTransformation::doDispose() {
     _parsedTransform.reset();
+    _transformedBatch.clear();
+    _transformedBatchPosition = 0;
+    _errorAfterBatch = Status::OK();
+    _resultAfterBatch = boost::none;
 }
 
 Value DocumentSourceSingleDocumentTransformation::serialize(
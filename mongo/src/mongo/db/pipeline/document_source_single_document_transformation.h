@@ -88,6 +88,32 @@ public:
             return false;
         }
 
+        /**
+         * Returns true if this transformer benefits from being handed several documents at once
+         * via applyTransformationToBatch(), for example because it evaluates expressions which
+         * can be evaluated over a whole batch.
+         */
+        virtual bool canTransformBatches() const {
+            return false;
+        }
+
+        /**
+         * Replaces each document in 'docs' with the result of applyTransformation(). The default
+         * implementation transforms the documents one at a time.
+         *
+         * If this throws, 'docs' must be left unchanged. The caller then transforms the documents
+         * one at a time with applyTransformation(), which reports the error, if any, of the first
+         * document that fails.
+         */
+        virtual void applyTransformationToBatch(std::vector<Document>* docs) {
+            std::vector<Document> outputs;
+            outputs.reserve(docs->size());
+            for (auto&& doc : *docs) {
+                outputs.push_back(applyTransformation(doc));
+            }
+            docs->swap(outputs);
+        }
+
     protected:
         MongoProcessInterface* _mongoProcess{nullptr};
 
@@ -155,6 +181,31 @@ private:
 
     // Specific name of the transformation.
     std::string _name;
+
+    /**
+     * Transforms '_transformedBatch' one document at a time after transforming it as a batch
+     * failed. If a document fails, the batch is cut short before it and its error is kept in
+     * '_errorAfterBatch', so that the documents which precede it are still returned first.
+     */
+    void _transformBatchOneAtATime();
+
+    // When the transformer can transform batches, documents are pulled from 'pSource' and
+    // transformed '_nextBatchSize' at a time. The transformed documents are returned from
+    // '_transformedBatch' in order, followed by the error of the document that cut the batch short,
+    // or else the non-advanced result (if any) that did.
+    std::vector<Document> _transformedBatch;
+    size_t _transformedBatchPosition = 0;
+    Status _errorAfterBatch = Status::OK();
+    boost::optional<GetNextResult> _resultAfterBatch;
+    size_t _nextBatchSize = kInitialBatchSize;
+
+    // Batches start small so that a consumer which only wants a few documents, such as a $limit,
+    // doesn't cause many documents to be transformed needlessly, and grow from there. A batch also
+    // ends once its input documents reach kMaxBatchBytes, so that large documents are not buffered
+    // by the hundred.
+    static constexpr size_t kInitialBatchSize = 8;
+    static constexpr size_t kMaxBatchSize = 256;
+    static constexpr size_t kMaxBatchBytes = 4 * 1024 * 1024;
 };
 
 }  // namespace mongo
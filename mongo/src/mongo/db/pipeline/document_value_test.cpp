@@ -40,6 +40,7 @@
 #include "mongo/db/pipeline/value.h"
 #include "mongo/db/pipeline/value_comparator.h"
 #include "mongo/dbtests/dbtests.h"
+#include "mongo/stdx/thread.h"
 
 namespace DocumentTests {
 
@@ -113,6 +114,140 @@ TEST(DocumentConstruction, FromEmptyDocumentClone) {
     ASSERT_DOCUMENT_EQ(document, documentClone);
 }
 
+TEST(DocumentConstruction, ReleasedBuffersAreReused) {
+    const BSONObj bson = BSON("a" << 1 << "b"
+                                  << "str"
+                                  << "c"
+                                  << BSON("d" << 2));
+
+    // Make sure a buffer of this size has been released on this thread at least once
+    { Document warmup(bson); }
+
+    const auto before = mongo::DocumentStorage::getThreadBufferStats();
+    for (int i = 0; i < 10; i++) {
+        Document document(bson);
+        ASSERT_BSONOBJ_EQ(bson, document.toBson());
+    }
+    const auto after = mongo::DocumentStorage::getThreadBufferStats();
+
+    ASSERT_GTE(after.allocations - before.allocations, 10);
+    ASSERT_EQUALS(after.allocations - before.allocations, after.reused - before.reused);
+}
+
+TEST(DocumentConstruction, CachedBytesAreCountedProcessWide) {
+    // Leave a released buffer in this thread's cache
+    { Document warmup{{"a", 1}}; }
+    const long long cached = mongo::DocumentStorage::getCachedBufferBytes();
+    ASSERT_GT(cached, 0);
+
+    // Taking it back out of the cache is accounted for too
+    Document document{{"a", 1}};
+    ASSERT_LT(mongo::DocumentStorage::getCachedBufferBytes(), cached);
+}
+
+TEST(DocumentConstruction, CloneOfGrownDocument) {
+    // Grow the document through several buffer sizes so that its hash table moves each time
+    mongo::MutableDocument md;
+    for (int i = 0; i < 200; i++) {
+        md.addField(std::to_string(i), mongo::Value(i));
+    }
+    Document document = md.freeze();
+    Document documentClone = document.clone();
+    ASSERT_DOCUMENT_EQ(document, documentClone);
+    ASSERT_VALUE_EQ(mongo::Value(150), documentClone["150"]);
+}
+
+TEST(DocumentFromBson, UnmodifiedDocumentSerializesToOriginalBson) {
+    const BSONObj bson = BSON("a" << 1 << "b" << BSON("c" << 2) << "d" << BSON_ARRAY(3 << 4));
+    Document document(bson);
+    ASSERT_VALUE_EQ(mongo::Value(1), document["a"]);
+    ASSERT_EQUALS(bson.objdata(), document.toBson().objdata());
+    ASSERT_EQUALS(3U, document.size());
+    ASSERT_EQUALS(bson.objdata(), document.toBson().objdata());
+}
+
+TEST(DocumentFromBson, FieldsAreFoundInAnyOrder) {
+    Document document(BSON("a" << 1 << "b" << 2 << "c" << 3 << "d" << 4 << "e" << 5));
+    ASSERT_VALUE_EQ(mongo::Value(4), document["d"]);
+    ASSERT_VALUE_EQ(mongo::Value(2), document["b"]);
+    ASSERT(document["f"].missing());
+    ASSERT_VALUE_EQ(mongo::Value(5), document["e"]);
+    ASSERT_EQUALS("b", getNthField(document, 1).first.toString());
+}
+
+TEST(DocumentFromBson, ModifiedFieldsAreSerializedInPlace) {
+    const BSONObj bson = BSON("a" << 1 << "b" << 2 << "c" << 3);
+    mongo::MutableDocument md{Document(bson)};
+    md["b"] = mongo::Value("x"_sd);
+    md.remove("c");
+    md.addField("e", mongo::Value(5));
+    ASSERT_BSONOBJ_EQ(BSON("a" << 1 << "b"
+                               << "x"
+                               << "e"
+                               << 5),
+                      md.freeze().toBson());
+}
+
+TEST(DocumentFromBson, ModifyingCopyLeavesOriginalUntouched) {
+    const BSONObj bson = BSON("a" << 1 << "b" << BSON("c" << 2 << "d" << 3));
+    Document document(bson);
+    ASSERT_VALUE_EQ(mongo::Value(2), document.getNestedField(mongo::FieldPath("b.c")));
+
+    mongo::MutableDocument md(document);
+    md.setNestedField(mongo::FieldPath("b.c"), mongo::Value(20));
+    ASSERT_BSONOBJ_EQ(BSON("a" << 1 << "b" << BSON("c" << 20 << "d" << 3)), md.freeze().toBson());
+    ASSERT_BSONOBJ_EQ(bson, document.toBson());
+}
+
+TEST(DocumentFromBson, EmbeddedDocumentSizeCountsTheBytesItKeepsAlive) {
+    const std::string padding(1024 * 1024, 'x');
+    const BSONObj bson = BSON("a" << padding << "b" << BSON("c" << padding));
+    Document document(bson);
+
+    // The embedded document doesn't keep its parent's buffer alive, so it only counts its own
+    const Document embedded = document["b"].getDocument();
+    ASSERT_GTE(embedded.getApproximateSize(), padding.size());
+    ASSERT_LT(embedded.getApproximateSize(), 2 * padding.size());
+    ASSERT_NE(bson.sharedBuffer().get(), embedded.toBson().sharedBuffer().get());
+    ASSERT_GTE(document.getApproximateSize(), 2 * padding.size());
+}
+
+TEST(DocumentFromBson, FrozenDocumentCanBeReadFromSeveralThreads) {
+    BSONObjBuilder builder;
+    for (int i = 0; i < 100; i++) {
+        builder.append(std::to_string(i), i);
+    }
+    const Document document(builder.obj());
+
+    std::vector<mongo::stdx::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&document, t] {
+            for (int i = 99 - t; i >= 0; i -= 4) {
+                ASSERT_VALUE_EQ(mongo::Value(i), document[std::to_string(i)]);
+            }
+        });
+    }
+    for (auto&& thread : threads) {
+        thread.join();
+    }
+    ASSERT_EQUALS(100U, document.size());
+}
+
+TEST(DocumentFromBson, ManyModifiedFields) {
+    BSONObjBuilder original;
+    BSONObjBuilder expected;
+    for (int i = 0; i < 40; i++) {
+        original.append(std::to_string(i), i);
+        expected.append(std::to_string(i), i % 2 ? -i : i);
+    }
+
+    mongo::MutableDocument md{Document(original.obj())};
+    for (int i = 1; i < 40; i += 2) {
+        md[std::to_string(i)] = mongo::Value(-i);
+    }
+    ASSERT_BSONOBJ_EQ(expected.obj(), md.freeze().toBson());
+}
+
 /**
  * Appends to 'builder' an object nested 'depth' levels deep.
  */
@@ -147,6 +282,17 @@ TEST(DocumentSerialization, CannotSerializeDocumentThatExceedsDepthLimit) {
     throwaway.abandon();
 }
 
+TEST(DocumentFromBson, NestedSerializationRespectsDepthLimit) {
+    BSONObjBuilder builder;
+    appendNestedObject(BSONDepth::getMaxAllowableDepth(), &builder);
+
+    mongo::MutableDocument md;
+    md.addField("outer", mongo::Value(Document(builder.obj())));
+    BSONObjBuilder throwaway;
+    ASSERT_THROWS_CODE(md.freeze().toBson(&throwaway), AssertionException, ErrorCodes::Overflow);
+    throwaway.abandon();
+}
+
 /** Add Document fields. */
 class AddField {
 public:
@@ -43,6 +43,7 @@
 #include "mongo/db/query/datetime/date_time_support.h"
 #include "mongo/platform/bits.h"
 #include "mongo/platform/decimal128.h"
+#include "mongo/platform/overflow_arithmetic.h"
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/string_map.h"
 #include "mongo/util/summation.h"
@@ -87,6 +88,14 @@ string Expression::removeFieldPrefix(const string& prefixedField) {
     return string(pPrefixedField + 1);
 }
 
+void Expression::evaluateBatch(const vector<Document>& roots, vector<Value>* results) const {
+    results->clear();
+    results->reserve(roots.size());
+    for (auto&& root : roots) {
+        results->push_back(evaluate(root));
+    }
+}
+
 intrusive_ptr<Expression> Expression::parseObject(
     const boost::intrusive_ptr<ExpressionContext>& expCtx,
     BSONObj obj,
@@ -239,7 +248,14 @@ const char* ExpressionAbs::getOpName() const {
 
 /* ------------------------- ExpressionAdd ----------------------------- */
 
-Value ExpressionAdd::evaluate(const Document& root) const {
+namespace {
+/**
+ * Computes the result of an $add over 'n' operands, where 'getOperand(i)' returns the value of the
+ * i-th operand. Operands are requested in order, and no further operands are requested once the
+ * result is known to be null.
+ */
+template <typename GetOperand>
+Value addOperands(size_t n, GetOperand getOperand) {
     // We'll try to return the narrowest possible result value while avoiding overflow, loss
     // of precision due to intermediate rounding or implicit use of decimal types. To do that,
     // compute a compensated sum for non-decimal values and a separate decimal sum for decimal
@@ -249,9 +265,8 @@ Value ExpressionAdd::evaluate(const Document& root) const {
     BSONType totalType = NumberInt;
     bool haveDate = false;
 
-    const size_t n = vpOperand.size();
     for (size_t i = 0; i < n; ++i) {
-        Value val = vpOperand[i]->evaluate(root);
+        Value val = getOperand(i);
 
         switch (val.getType()) {
             case NumberDecimal:
@@ -313,6 +328,50 @@ Value ExpressionAdd::evaluate(const Document& root) const {
             massert(16417, "$add resulted in a non-numeric type", false);
     }
 }
+}  // namespace
+
+Value ExpressionAdd::evaluate(const Document& root) const {
+    return addOperands(vpOperand.size(), [&](size_t i) { return vpOperand[i]->evaluate(root); });
+}
+
+void ExpressionAdd::evaluateBatch(const vector<Document>& roots, vector<Value>* results) const {
+    const size_t n = vpOperand.size();
+    vector<vector<Value>> operands(n);
+    for (size_t i = 0; i < n; ++i) {
+        vpOperand[i]->evaluateBatch(roots, &operands[i]);
+    }
+
+    results->clear();
+    results->reserve(roots.size());
+    for (size_t row = 0; row < roots.size(); ++row) {
+        // Sums of ints and longs are exact, so as long as the total doesn't overflow they don't
+        // need the compensated summation used by addOperands().
+        long long longTotal = 0;
+        bool haveLong = false;
+        bool integral = true;
+        for (size_t i = 0; i < n && integral; ++i) {
+            const Value& val = operands[i][row];
+            switch (val.getType()) {
+                case NumberInt:
+                    integral = !mongoSignedAddOverflow64(
+                        longTotal, static_cast<long long>(val.getInt()), &longTotal);
+                    break;
+                case NumberLong:
+                    haveLong = true;
+                    integral = !mongoSignedAddOverflow64(longTotal, val.getLong(), &longTotal);
+                    break;
+                default:
+                    integral = false;
+            }
+        }
+
+        if (integral) {
+            results->push_back(haveLong ? Value(longTotal) : Value::createIntOrLong(longTotal));
+        } else {
+            results->push_back(addOperands(n, [&](size_t i) { return operands[i][row]; }));
+        }
+    }
+}
 
 REGISTER_EXPRESSION(add, ExpressionAdd::parse);
 const char* ExpressionAdd::getOpName() const {
@@ -878,6 +937,42 @@ Value ExpressionCond::evaluate(const Document& root) const {
     return vpOperand[idx]->evaluate(root);
 }
 
+void ExpressionCond::evaluateBatch(const vector<Document>& roots, vector<Value>* results) const {
+    vector<Value> conditions;
+    vpOperand[0]->evaluateBatch(roots, &conditions);
+
+    // Partition the rows by the branch they take, so that each branch is only evaluated against
+    // the documents which select it, just as evaluate() would.
+    vector<size_t> branchRows[2];
+    for (size_t row = 0; row < roots.size(); ++row) {
+        branchRows[conditions[row].coerceToBool() ? 0 : 1].push_back(row);
+    }
+
+    for (int branch = 0; branch < 2; ++branch) {
+        if (branchRows[branch].size() == roots.size()) {
+            // Every document took this branch, so there is nothing to scatter.
+            vpOperand[branch + 1]->evaluateBatch(roots, results);
+            return;
+        }
+    }
+
+    results->clear();
+    results->resize(roots.size());
+    vector<Document> branchRoots;
+    vector<Value> branchResults;
+    for (int branch = 0; branch < 2; ++branch) {
+        branchRoots.clear();
+        for (size_t row : branchRows[branch]) {
+            branchRoots.push_back(roots[row]);
+        }
+
+        vpOperand[branch + 1]->evaluateBatch(branchRoots, &branchResults);
+        for (size_t i = 0; i < branchRows[branch].size(); ++i) {
+            (*results)[branchRows[branch][i]] = std::move(branchResults[i]);
+        }
+    }
+}
+
 intrusive_ptr<Expression> ExpressionCond::parse(
     const boost::intrusive_ptr<ExpressionContext>& expCtx,
     BSONElement expr,
@@ -950,6 +1045,11 @@ Value ExpressionConstant::evaluate(const Document& root) const {
     return _value;
 }
 
+void ExpressionConstant::evaluateBatch(const vector<Document>& roots,
+                                       vector<Value>* results) const {
+    results->assign(roots.size(), _value);
+}
+
 Value ExpressionConstant::serialize(bool explain) const {
     return serializeConstant(_value);
 }
@@ -1635,6 +1735,35 @@ Value ExpressionDateToString::evaluate(const Document& root) const {
     return Value(timeZone->formatDate(_format, date.coerceToDate()));
 }
 
+void ExpressionDateToString::evaluateBatch(const vector<Document>& roots,
+                                           vector<Value>* results) const {
+    if (!ExpressionConstant::isNullOrConstant(_timeZone)) {
+        Expression::evaluateBatch(roots, results);
+        return;
+    }
+
+    vector<Value> dates;
+    _date->evaluateBatch(roots, &dates);
+
+    results->clear();
+    if (roots.empty()) {
+        return;
+    }
+
+    // The timezone doesn't depend on the document, so it only needs to be looked up once.
+    const auto timeZone =
+        makeTimeZone(getExpressionContext()->timeZoneDatabase, roots.front(), _timeZone.get());
+
+    results->reserve(roots.size());
+    for (auto&& date : dates) {
+        if (!timeZone || date.nullish()) {
+            results->push_back(Value(BSONNULL));
+        } else {
+            results->push_back(Value(timeZone->formatDate(_format, date.coerceToDate())));
+        }
+    }
+}
+
 void ExpressionDateToString::_doAddDependencies(DepsTracker* deps) const {
     _date->addDependencies(deps);
     if (_timeZone) {
@@ -1902,6 +2031,20 @@ Value ExpressionFieldPath::evaluate(const Document& root) const {
     }
 }
 
+void ExpressionFieldPath::evaluateBatch(const vector<Document>& roots,
+                                        vector<Value>* results) const {
+    if (_variable != Variables::kRootId || _fieldPath.getPathLength() == 1) {
+        Expression::evaluateBatch(roots, results);
+        return;
+    }
+
+    results->clear();
+    results->reserve(roots.size());
+    for (auto&& root : roots) {
+        results->push_back(evaluatePath(1, root));
+    }
+}
+
 Value ExpressionFieldPath::serialize(bool explain) const {
     if (_fieldPath.getFieldName(0) == "CURRENT" && _fieldPath.getPathLength() > 1) {
         // use short form for "$$CURRENT.foo" but not just "$$CURRENT"
@@ -2407,7 +2550,14 @@ const char* ExpressionMod::getOpName() const {
 
 /* ------------------------- ExpressionMultiply ----------------------------- */
 
-Value ExpressionMultiply::evaluate(const Document& root) const {
+namespace {
+/**
+ * Computes the result of a $multiply over 'n' operands, where 'getOperand(i)' returns the value
+ * of the i-th operand. Operands are requested in order, and no further operands are requested once
+ * the result is known to be null.
+ */
+template <typename GetOperand>
+Value multiplyOperands(size_t n, GetOperand getOperand) {
     /*
       We'll try to return the narrowest possible result value.  To do that
       without creating intermediate Values, do the arithmetic for double
@@ -2420,9 +2570,8 @@ Value ExpressionMultiply::evaluate(const Document& root) const {
 
     BSONType productType = NumberInt;
 
-    const size_t n = vpOperand.size();
     for (size_t i = 0; i < n; ++i) {
-        Value val = vpOperand[i]->evaluate(root);
+        Value val = getOperand(i);
 
         if (val.numeric()) {
             BSONType oldProductType = productType;
@@ -2462,6 +2611,72 @@ Value ExpressionMultiply::evaluate(const Document& root) const {
     else
         massert(16418, "$multiply resulted in a non-numeric type", false);
 }
+}  // namespace
+
+Value ExpressionMultiply::evaluate(const Document& root) const {
+    return multiplyOperands(vpOperand.size(),
+                            [&](size_t i) { return vpOperand[i]->evaluate(root); });
+}
+
+void ExpressionMultiply::evaluateBatch(const vector<Document>& roots,
+                                       vector<Value>* results) const {
+    const size_t n = vpOperand.size();
+    vector<vector<Value>> operands(n);
+    for (size_t i = 0; i < n; ++i) {
+        vpOperand[i]->evaluateBatch(roots, &operands[i]);
+    }
+
+    results->clear();
+    results->reserve(roots.size());
+    for (size_t row = 0; row < roots.size(); ++row) {
+        // Handle rows made up only of ints, longs and doubles without going through the generic
+        // widening logic. This tracks the same double and long products as multiplyOperands(),
+        // so the result is identical.
+        double doubleProduct = 1;
+        long long longProduct = 1;
+        BSONType productType = NumberInt;
+        bool simple = true;
+        for (size_t i = 0; i < n && simple; ++i) {
+            const Value& val = operands[i][row];
+            switch (val.getType()) {
+                case NumberInt:
+                    doubleProduct *= val.getInt();
+                    if (productType != NumberDouble &&
+                        mongoSignedMultiplyOverflow64(
+                            longProduct, static_cast<long long>(val.getInt()), &longProduct)) {
+                        productType = NumberDouble;
+                    }
+                    break;
+                case NumberLong:
+                    doubleProduct *= val.getLong();
+                    if (productType == NumberInt) {
+                        productType = NumberLong;
+                    }
+                    if (productType != NumberDouble &&
+                        mongoSignedMultiplyOverflow64(longProduct, val.getLong(), &longProduct)) {
+                        productType = NumberDouble;
+                    }
+                    break;
+                case NumberDouble:
+                    doubleProduct *= val.getDouble();
+                    productType = NumberDouble;
+                    break;
+                default:
+                    simple = false;
+            }
+        }
+
+        if (!simple) {
+            results->push_back(multiplyOperands(n, [&](size_t i) { return operands[i][row]; }));
+        } else if (productType == NumberDouble) {
+            results->push_back(Value(doubleProduct));
+        } else if (productType == NumberLong) {
+            results->push_back(Value(longProduct));
+        } else {
+            results->push_back(Value::createIntOrLong(longProduct));
+        }
+    }
+}
 
 REGISTER_EXPRESSION(multiply, ExpressionMultiply::parse);
 const char* ExpressionMultiply::getOpName() const {
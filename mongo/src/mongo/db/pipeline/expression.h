@@ -128,6 +128,23 @@ public:
      */
     virtual Value evaluate(const Document& root) const = 0;
 
+    /**
+     * Evaluate expression with respect to each Document in 'roots', replacing the contents of
+     * 'results' so that (*results)[i] is the result of evaluate(roots[i]).
+     *
+     * The default implementation calls evaluate() once per document. Expressions which can do
+     * better when they see a whole column of inputs at once, such as field paths and the common
+     * arithmetic operators, override this to evaluate their operands as batches and combine them
+     * in a single loop.
+     *
+     * Unlike evaluate(), an override may evaluate operands that evaluate() would have skipped, and
+     * may evaluate operands across all documents in a different order. If this throws, the caller
+     * must fall back to calling evaluate() on each document in turn to get the correct result or
+     * error.
+     */
+    virtual void evaluateBatch(const std::vector<Document>& roots,
+                               std::vector<Value>* results) const;
+
     /**
      * Returns information about the paths computed by this expression. This only needs to be
      * overridden by expressions that have renaming semantics, where optimization code could take
@@ -437,6 +454,8 @@ class ExpressionConstant final : public Expression {
 public:
     boost::intrusive_ptr<Expression> optimize() final;
     Value evaluate(const Document& root) const final;
+    void evaluateBatch(const std::vector<Document>& roots,
+                       std::vector<Value>* results) const final;
     Value serialize(bool explain) const final;
 
     const char* getOpName() const;
@@ -649,6 +668,8 @@ public:
         : ExpressionVariadic<ExpressionAdd>(expCtx) {}
 
     Value evaluate(const Document& root) const final;
+    void evaluateBatch(const std::vector<Document>& roots,
+                       std::vector<Value>* results) const final;
     const char* getOpName() const final;
 
     bool isAssociative() const final {
@@ -845,6 +866,8 @@ public:
     explicit ExpressionCond(const boost::intrusive_ptr<ExpressionContext>& expCtx) : Base(expCtx) {}
 
     Value evaluate(const Document& root) const final;
+    void evaluateBatch(const std::vector<Document>& roots,
+                       std::vector<Value>* results) const final;
     const char* getOpName() const final;
 
     static boost::intrusive_ptr<Expression> parse(
@@ -967,6 +990,8 @@ public:
     boost::intrusive_ptr<Expression> optimize() final;
     Value serialize(bool explain) const final;
     Value evaluate(const Document& root) const final;
+    void evaluateBatch(const std::vector<Document>& roots,
+                       std::vector<Value>* results) const final;
 
     static boost::intrusive_ptr<Expression> parse(
         const boost::intrusive_ptr<ExpressionContext>& expCtx,
@@ -1048,6 +1073,8 @@ public:
 
     boost::intrusive_ptr<Expression> optimize() final;
     Value evaluate(const Document& root) const final;
+    void evaluateBatch(const std::vector<Document>& roots,
+                       std::vector<Value>* results) const final;
     Value serialize(bool explain) const final;
 
     /*
@@ -1370,6 +1397,8 @@ public:
         : ExpressionVariadic<ExpressionMultiply>(expCtx) {}
 
     Value evaluate(const Document& root) const final;
+    void evaluateBatch(const std::vector<Document>& roots,
+                       std::vector<Value>* results) const final;
     const char* getOpName() const final;
 
     bool isAssociative() const final {
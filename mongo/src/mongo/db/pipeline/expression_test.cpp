@@ -5158,6 +5158,101 @@ TEST_F(ExpressionDateToStringTest, OptimizesToConstantIfAllInputsAreConstant) {
 }
 }  // namespace ExpressionDateToStringTest
 
+namespace ExpressionBatchTest {
+
+using ExpressionBatchTest = AggregationContextFixture;
+
+/**
+ * Asserts that evaluating 'expression' over 'roots' as a batch gives exactly the same values,
+ * including numeric types, as evaluating it against each document in turn.
+ */
+void assertBatchMatchesEvaluate(const intrusive_ptr<Expression>& expression,
+                                const vector<Document>& roots) {
+    vector<Value> results;
+    expression->evaluateBatch(roots, &results);
+    ASSERT_EQ(results.size(), roots.size());
+    for (size_t i = 0; i < roots.size(); ++i) {
+        Value expected = expression->evaluate(roots[i]);
+        ASSERT_VALUE_EQ(results[i], expected);
+        ASSERT_EQ(results[i].getType(), expected.getType());
+    }
+}
+
+void assertBatchMatchesEvaluate(const intrusive_ptr<ExpressionContext>& expCtx,
+                                const BSONObj& spec,
+                                const vector<Document>& roots) {
+    assertBatchMatchesEvaluate(
+        Expression::parseExpression(expCtx, spec, expCtx->variablesParseState), roots);
+}
+
+vector<Document> numericRoots() {
+    return {Document{{"a", 3}, {"b", 4}},
+            Document{{"a", 3}, {"b", 4LL}},
+            Document{{"a", 3}, {"b", 4.5}},
+            Document{{"a", 3LL}, {"b", Decimal128("4.5")}},
+            Document{{"a", numeric_limits<int>::max()}, {"b", numeric_limits<int>::max()}},
+            Document{{"a", numeric_limits<long long>::max()}, {"b", 2LL}},
+            Document{{"a", 3}, {"b", BSONNULL}},
+            Document{{"a", 3}},
+            Document{{"a", Date_t::fromMillisSinceEpoch(1000)}, {"b", 4}}};
+}
+
+TEST_F(ExpressionBatchTest, AddMatchesEvaluate) {
+    assertBatchMatchesEvaluate(getExpCtx(), BSON("$add" << BSON_ARRAY("$a"
+                                                                       << "$b"
+                                                                       << 1)),
+                               numericRoots());
+}
+
+TEST_F(ExpressionBatchTest, MultiplyMatchesEvaluate) {
+    auto roots = numericRoots();
+    // $multiply doesn't accept dates.
+    roots.pop_back();
+    assertBatchMatchesEvaluate(getExpCtx(), BSON("$multiply" << BSON_ARRAY("$a"
+                                                                           << "$b"
+                                                                           << 2)),
+                               roots);
+    assertBatchMatchesEvaluate(getExpCtx(), BSON("$multiply" << BSON_ARRAY("$a" << 0.5)), roots);
+}
+
+TEST_F(ExpressionBatchTest, CondOnlyEvaluatesTheSelectedBranch) {
+    // The 'else' branch would fail with a division by zero if it were evaluated against the first
+    // document.
+    auto spec = fromjson("{$cond: [{$eq: ['$a', 0]}, 'zero', {$divide: [1, '$a']}]}");
+    assertBatchMatchesEvaluate(
+        getExpCtx(), spec, {Document{{"a", 0}}, Document{{"a", 2}}, Document{{"a", 0}}});
+    assertBatchMatchesEvaluate(getExpCtx(), spec, {Document{{"a", 0}}, Document{{"a", 0}}});
+    assertBatchMatchesEvaluate(getExpCtx(), spec, {});
+}
+
+TEST_F(ExpressionBatchTest, DateToStringMatchesEvaluate) {
+    vector<Document> roots = {Document{{"d", Date_t::fromMillisSinceEpoch(0)}},
+                              Document{{"d", Date_t::fromMillisSinceEpoch(1500000000000LL)}},
+                              Document{{"d", BSONNULL}},
+                              Document{}};
+    assertBatchMatchesEvaluate(getExpCtx(),
+                               fromjson("{$dateToString: {format: '%Y-%m-%d %H:%M', date: '$d'}}"),
+                               roots);
+    assertBatchMatchesEvaluate(
+        getExpCtx(),
+        fromjson("{$dateToString: {format: '%H:%M', date: '$d', timezone: 'America/New_York'}}"),
+        roots);
+}
+
+TEST_F(ExpressionBatchTest, FieldPathsMatchEvaluate) {
+    vector<Document> roots = {Document{{"a", Document{{"b", 1}}}},
+                              Document{{"a", vector<Value>{Value(Document{{"b", 2}}), Value(3)}}},
+                              Document{{"a", 4}},
+                              Document{}};
+    auto expCtx = getExpCtx();
+    for (auto&& path : {"$a.b", "$a", "$$ROOT", "$$CURRENT.a.b"}) {
+        assertBatchMatchesEvaluate(
+            ExpressionFieldPath::parse(expCtx, path, expCtx->variablesParseState), roots);
+    }
+}
+
+}  // namespace ExpressionBatchTest
+
 namespace ExpressionDateFromStringTest {
 
 // This provides access to an ExpressionContext that has a valid ServiceContext with a
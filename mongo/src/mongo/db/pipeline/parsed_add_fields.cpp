@@ -90,6 +90,13 @@ Document ParsedAddFields::applyProjection(const Document& inputDoc) const {
     return output.freeze();
 }
 
+void ParsedAddFields::applyProjectionToBatch(const std::vector<Document>& inputs,
+                                             std::vector<Document>* outputs) const {
+    // The metadata travels along with the input documents.
+    outputs->insert(outputs->end(), inputs.begin(), inputs.end());
+    _root->addComputedFields(outputs, inputs);
+}
+
 bool ParsedAddFields::parseObjectAsExpression(StringData pathToObject,
                                               const BSONObj& objSpec,
                                               const VariablesParseState& variablesParseState) {
@@ -112,6 +112,17 @@ public:
      */
     Document applyProjection(const Document& inputDoc) const final;
 
+    /**
+     * Batches only help when there are expressions to evaluate.
+     */
+    bool canTransformBatches() const final {
+        return _root->subtreeContainsComputedFields();
+    }
+
+protected:
+    void applyProjectionToBatch(const std::vector<Document>& inputs,
+                                std::vector<Document>* outputs) const final;
+
 private:
     /**
      * Attempts to parse 'objSpec' as an expression like {$add: [...]}. Adds a computed field to
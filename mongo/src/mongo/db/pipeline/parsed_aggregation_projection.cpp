@@ -304,5 +304,19 @@ std::unique_ptr<ParsedAggregationProjection> ParsedAggregationProjection::create
     return parsedProject;
 }
 
+void ParsedAggregationProjection::applyTransformationToBatch(std::vector<Document>* docs) {
+    std::vector<Document> outputs;
+    outputs.reserve(docs->size());
+    applyProjectionToBatch(*docs, &outputs);
+    docs->swap(outputs);
+}
+
+void ParsedAggregationProjection::applyProjectionToBatch(const std::vector<Document>& inputs,
+                                                         std::vector<Document>* outputs) const {
+    for (auto&& input : inputs) {
+        outputs->push_back(applyProjection(input));
+    }
+}
+
 }  // namespace parsed_aggregation_projection
 }  // namespace mongo
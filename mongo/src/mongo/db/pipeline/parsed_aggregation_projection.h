@@ -32,6 +32,7 @@
 
 #include <boost/intrusive_ptr.hpp>
 #include <memory>
+#include <vector>
 
 #include "mongo/bson/bsonelement.h"
 #include "mongo/db/pipeline/document_source_single_document_transformation.h"
@@ -177,6 +178,12 @@ public:
         return applyProjection(input);
     }
 
+    /**
+     * Apply the projection transformation to each document in 'docs', in place. If applying the
+     * projection to the batch as a whole fails, 'docs' is left unchanged.
+     */
+    void applyTransformationToBatch(std::vector<Document>* docs) final;
+
 protected:
     ParsedAggregationProjection(const boost::intrusive_ptr<ExpressionContext>& expCtx)
         : _expCtx(expCtx){};
@@ -186,6 +193,13 @@ protected:
      */
     virtual Document applyProjection(const Document& input) const = 0;
 
+    /**
+     * Apply the projection to each document in 'inputs', appending the results to 'outputs'. The
+     * default implementation calls applyProjection() on each document.
+     */
+    virtual void applyProjectionToBatch(const std::vector<Document>& inputs,
+                                        std::vector<Document>* outputs) const;
+
     boost::intrusive_ptr<ExpressionContext> _expCtx;
 };
 }  // namespace parsed_aggregation_projection
@@ -155,6 +155,31 @@ void InclusionNode::addComputedFields(MutableDocument* outputDoc, const Document
     }
 }
 
+void InclusionNode::addComputedFields(std::vector<Document>* outputDocs,
+                                      const std::vector<Document>& roots) const {
+    invariant(outputDocs->size() == roots.size());
+    std::vector<Value> computed;
+    for (auto&& field : _orderToProcessAdditionsAndChildren) {
+        auto childIt = _children.find(field);
+        if (childIt == _children.end()) {
+            auto expressionIt = _expressions.find(field);
+            invariant(expressionIt != _expressions.end());
+            expressionIt->second->evaluateBatch(roots, &computed);
+        }
+
+        for (size_t i = 0; i < roots.size(); ++i) {
+            MutableDocument outputDoc(std::move((*outputDocs)[i]));
+            if (childIt != _children.end()) {
+                outputDoc.setField(
+                    field, childIt->second->addComputedFields(outputDoc.peek()[field], roots[i]));
+            } else {
+                outputDoc.setField(field, std::move(computed[i]));
+            }
+            (*outputDocs)[i] = outputDoc.freeze();
+        }
+    }
+}
+
 Value InclusionNode::addComputedFields(Value inputValue, const Document& root) const {
     if (inputValue.getType() == BSONType::Object) {
         MutableDocument outputDoc(inputValue.getDocument());
@@ -349,6 +374,17 @@ Document ParsedInclusionProjection::applyProjection(const Document& inputDoc) co
     return output.freeze();
 }
 
+void ParsedInclusionProjection::applyProjectionToBatch(const std::vector<Document>& inputs,
+                                                       std::vector<Document>* outputs) const {
+    for (auto&& inputDoc : inputs) {
+        MutableDocument output;
+        _root->applyInclusions(inputDoc, &output);
+        output.copyMetaDataFrom(inputDoc);
+        outputs->push_back(output.freeze());
+    }
+    _root->addComputedFields(outputs, inputs);
+}
+
 bool ParsedInclusionProjection::parseObjectAsExpression(
     StringData pathToObject,
     const BSONObj& objSpec,
@@ -90,6 +90,14 @@ public:
      */
     void addComputedFields(MutableDocument* outputDoc, const Document& root) const;
 
+    /**
+     * Add computed fields to each document in 'outputDocs', where (*outputDocs)[i] was derived from
+     * roots[i]. Computed fields at this level are evaluated as a batch across all of 'roots', while
+     * fields nested in child nodes are added to each document in turn.
+     */
+    void addComputedFields(std::vector<Document>* outputDocs,
+                           const std::vector<Document>& roots) const;
+
     /**
      * Creates the child if it doesn't already exist. 'field' is not allowed to be dotted.
      */
@@ -135,6 +143,11 @@ public:
     void addComputedPaths(std::set<std::string>* computedPaths,
                           StringMap<std::string>* renamedPaths) const;
 
+    /**
+     * Returns true if this node or any child of this node contains a computed field.
+     */
+    bool subtreeContainsComputedFields() const;
+
 private:
     // Helpers for the Document versions above. These will apply the transformation recursively to
     // each element of any arrays, and ensure non-documents are handled appropriately.
@@ -151,11 +164,6 @@ private:
      */
     InclusionNode* addChild(std::string field);
 
-    /**
-     * Returns true if this node or any child of this node contains a computed field.
-     */
-    bool subtreeContainsComputedFields() const;
-
     std::string _pathToNode;
 
     // Our projection semantics are such that all field additions need to be processed in the order
@@ -251,6 +259,17 @@ public:
      */
     bool isSubsetOfProjection(const BSONObj& proj) const final;
 
+    /**
+     * Batches only help when there are expressions to evaluate.
+     */
+    bool canTransformBatches() const final {
+        return _root->subtreeContainsComputedFields();
+    }
+
+protected:
+    void applyProjectionToBatch(const std::vector<Document>& inputs,
+                                std::vector<Document>* outputs) const final;
+
 private:
     /**
      * Attempts to parse 'objSpec' as an expression like {$add: [...]}. Adds a computed field to
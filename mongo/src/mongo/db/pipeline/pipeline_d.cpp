@@ -52,9 +52,12 @@
 #include "mongo/db/index/index_access_method.h"
 #include "mongo/db/matcher/extensions_callback_real.h"
 #include "mongo/db/namespace_string.h"
+#include "mongo/db/pipeline/column_cache.h"
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/document_source_change_stream.h"
+#include "mongo/db/pipeline/document_source_column_scan.h"
 #include "mongo/db/pipeline/document_source_cursor.h"
+#include "mongo/db/pipeline/document_source_group.h"
 #include "mongo/db/pipeline/document_source_match.h"
 #include "mongo/db/pipeline/document_source_merge_cursors.h"
 #include "mongo/db/pipeline/document_source_sample.h"
@@ -66,13 +69,16 @@
 #include "mongo/db/query/get_executor.h"
 #include "mongo/db/query/plan_summary_stats.h"
 #include "mongo/db/query/query_planner.h"
+#include "mongo/db/repl/read_concern_args.h"
 #include "mongo/db/s/collection_metadata.h"
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/s/metadata_manager.h"
 #include "mongo/db/s/sharding_state.h"
 #include "mongo/db/service_context.h"
+#include "mongo/db/stats/cache_residency.h"
 #include "mongo/db/stats/fill_locker_info.h"
 #include "mongo/db/stats/storage_stats.h"
+#include "mongo/db/stats/query_stats_store.h"
 #include "mongo/db/stats/top.h"
 #include "mongo/db/storage/record_store.h"
 #include "mongo/db/storage/sorted_data_interface.h"
@@ -160,6 +166,11 @@ public:
         return appendCollectionRecordCount(_ctx->opCtx, nss, builder);
     }
 
+    Status appendCacheResidency(const NamespaceString& nss,
+                                BSONObjBuilder* builder) const final {
+        return appendCollectionCacheResidency(_ctx->opCtx, nss, builder);
+    }
+
     BSONObj getCollectionOptions(const NamespaceString& nss) final {
         const auto infos =
             _client.getCollectionInfos(nss.db().toString(), BSON("name" << nss.coll()));
@@ -347,6 +358,14 @@ public:
         return ops;
     }
 
+    std::vector<BSONObj> getQueryStats(bool includeHistograms) const final {
+        return QueryStatsStore::get(_ctx->opCtx->getServiceContext()).getStats(includeHistograms);
+    }
+
+    std::vector<BSONObj> getCacheResidency() const final {
+        return getCacheResidencyStats(_ctx->opCtx);
+    }
+
     std::string getShardName(OperationContext* opCtx) const {
         if (ShardingState::get(opCtx)->enabled()) {
             return ShardingState::get(opCtx)->getShardName();
@@ -577,6 +596,33 @@ BSONObj removeSortKeyMetaProjection(BSONObj projectionObj) {
     }
     return projectionObj.removeField(Document::metaFieldSortKey);
 }
+
+/**
+ * Returns a $columnScan stage reading the column cache of 'collection' if the cache holds every
+ * field in 'deps', or nullptr if the documents have to be read from the collection itself.
+ */
+intrusive_ptr<DocumentSource> getColumnScanSource(OperationContext* opCtx,
+                                                  Collection* collection,
+                                                  const intrusive_ptr<ExpressionContext>& expCtx,
+                                                  const DepsTracker& deps) {
+    if (!collection || deps.needWholeDocument || deps.getNeedTextScore() ||
+        deps.getNeedSortKey()) {
+        return nullptr;
+    }
+
+    // The cache always reflects the latest writes, and knows nothing about chunk ownership.
+    if (repl::ReadConcernArgs::get(opCtx).getLevel() !=
+            repl::ReadConcernLevel::kLocalReadConcern ||
+        ShardingState::get(opCtx)->needCollectionMetadata(opCtx, collection->ns().ns())) {
+        return nullptr;
+    }
+
+    auto cache = ColumnCacheCatalog::get(opCtx)->lookup(collection->ns());
+    if (!cache || !cache->covers(deps.fields)) {
+        return nullptr;
+    }
+    return DocumentSourceColumnScan::create(std::move(cache), deps.fields, expCtx);
+}
 }  // namespace
 
 void PipelineD::injectMongodInterface(Pipeline* pipeline) {
@@ -674,6 +720,15 @@ void PipelineD::prepareCursorSource(Collection* collection,
         }
     }
 
+    // With no filter or sort to push down, a pipeline that only reads cached fields can be fed
+    // from the collection's column cache instead of a collection scan.
+    if (queryObj.isEmpty() && !sortStage) {
+        if (auto columnScan = getColumnScanSource(expCtx->opCtx, collection, expCtx, deps)) {
+            pipeline->addInitialSource(columnScan);
+            return;
+        }
+    }
+
     // Create the PlanExecutor.
     auto exec = uassertStatusOK(prepareExecutor(expCtx->opCtx,
                                                 collection,
@@ -699,6 +754,14 @@ void PipelineD::prepareCursorSource(Collection* collection,
         }
     }
 
+    if (!projForQuery.isEmpty() && !sources.empty()) {
+        // A covered plan returns documents in index order, which may let a $group on the leading
+        // field of the index return each group as soon as it is complete.
+        if (auto groupStage = dynamic_cast<DocumentSourceGroup*>(sources.front().get())) {
+            groupStage->setStreamingInputSorts(exec->getOutputSorts());
+        }
+    }
+
     addCursorSource(
         collection, pipeline, expCtx, std::move(exec), deps, queryObj, sortObj, projForQuery);
 }
@@ -754,6 +817,17 @@ StatusWith<std::unique_ptr<PlanExecutor, PlanExecutor::Deleter>> PipelineD::prep
         plannerOpts |= QueryPlannerParams::TRACK_LATEST_OPLOG_TS;
     }
 
+    // Without a filter or sort the query system only considers a collection scan, unless asked to
+    // also try covering the projection with a whole index scan. That is worth it for a $group
+    // which can stream over a covered scan of an index on its key: it reads only the index, and
+    // holds one group in memory instead of all of them.
+    if (queryObj.isEmpty() && !sortStage && !pipeline->_sources.empty()) {
+        auto groupStage = dynamic_cast<DocumentSourceGroup*>(pipeline->_sources.front().get());
+        if (groupStage && groupStage->getStreamableGroupField()) {
+            plannerOpts |= QueryPlannerParams::GENERATE_COVERED_IXSCANS;
+        }
+    }
+
     const BSONObj emptyProjection;
     const BSONObj metaSortProjection = BSON("$meta"
                                             << "sortKey");
@@ -918,6 +992,10 @@ std::string PipelineD::getPlanSummaryStr(const Pipeline* pPipeline) {
         return docSourceCursor->getPlanSummaryStr();
     }
 
+    if (dynamic_cast<DocumentSourceColumnScan*>(pPipeline->_sources.front().get())) {
+        return "COLUMN_SCAN";
+    }
+
     return "";
 }
 
@@ -80,6 +80,11 @@ public:
         MONGO_UNREACHABLE;
     }
 
+    Status appendCacheResidency(const NamespaceString& nss,
+                                BSONObjBuilder* builder) const override {
+        MONGO_UNREACHABLE;
+    }
+
     BSONObj getCollectionOptions(const NamespaceString& nss) override {
         MONGO_UNREACHABLE;
     }
@@ -110,6 +115,14 @@ public:
         MONGO_UNREACHABLE;
     }
 
+    std::vector<BSONObj> getQueryStats(bool includeHistograms) const override {
+        MONGO_UNREACHABLE;
+    }
+
+    std::vector<BSONObj> getCacheResidency() const override {
+        MONGO_UNREACHABLE;
+    }
+
     std::string getShardName(OperationContext* opCtx) const override {
         MONGO_UNREACHABLE;
     }
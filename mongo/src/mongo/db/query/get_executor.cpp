@@ -40,6 +40,7 @@
 #include "mongo/base/parse_number.h"
 #include "mongo/client/dbclientinterface.h"
 #include "mongo/db/catalog/index_catalog.h"
+#include "mongo/db/curop.h"
 #include "mongo/db/exec/cached_plan.h"
 #include "mongo/db/exec/count.h"
 #include "mongo/db/exec/delete.h"
@@ -80,6 +81,7 @@
 #include "mongo/db/server_options.h"
 #include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
+#include "mongo/db/stats/query_stats_store.h"
 #include "mongo/db/storage/oplog_hack.h"
 #include "mongo/db/storage/storage_options.h"
 #include "mongo/scripting/engine.h"
@@ -178,6 +180,14 @@ void fillOutPlannerParams(OperationContext* opCtx,
         PlanCacheKey planCacheKey =
             collection->infoCache()->getPlanCache()->computeKey(*canonicalQuery);
 
+        // The key is also the shape of the operation's first query, under which QueryStatsStore
+        // records it.
+        OpDebug& opDebug = CurOp::get(opCtx)->debug();
+        if (opDebug.queryShape.empty() && QueryStatsStore::isEnabled()) {
+            opDebug.queryShapeNs = canonicalQuery->ns();
+            opDebug.queryShape = planCacheKey;
+        }
+
         // Filter index catalog if index filters are specified for query.
         // Also, signal to planner that application hint should be ignored.
         if (boost::optional<AllowedIndicesFilter> allowedIndicesFilter =
@@ -342,6 +352,14 @@ StatusWith<PrepareExecutionResult> prepareExecution(OperationContext* opCtx,
 	//ȡcollection϶ӦϢ洢indicesУͬʱԲʼֵ
     fillOutPlannerParams(opCtx, collection, canonicalQuery.get(), &plannerParams);
 
+    // fillOutPlannerParams() remembers the shape of the operation's first query, except for those
+    // which may use the id-hack, as it doesn't compute their plan cache key.
+    OpDebug& opDebug = CurOp::get(opCtx)->debug();
+    if (opDebug.queryShape.empty() && QueryStatsStore::isEnabled()) {
+        opDebug.queryShapeNs = canonicalQuery->ns();
+        opDebug.queryShape = collection->infoCache()->getPlanCache()->computeKey(*canonicalQuery);
+    }
+
     // If the canonical query does not have a user-specified collation, set it from the collection
     // default. 
 
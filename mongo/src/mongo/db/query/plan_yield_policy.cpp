@@ -33,6 +33,7 @@
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/curop.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/operation_trace.h"
 #include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_yield.h"
 #include "mongo/db/service_context.h"
@@ -119,6 +120,7 @@ Status PlanYieldPolicy::yield(stdx::function<void()> beforeYieldingFn,
     // again right away. We delay the resetTimer() call so that the clock doesn't start ticking
     // until after we return from the yield.
     ON_BLOCK_EXIT([this]() { resetTimer(); });
+    OperationTrace::Span traceSpan(OperationTrace::Phase::kYield);
 
     _forceYield = false;
 
@@ -37,11 +37,13 @@
 
 #include "mongo/base/status_with.h"
 #include "mongo/bson/bsonobj_comparator_interface.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/s/catalog/sharding_catalog_client.h"
 #include "mongo/s/catalog/type_chunk.h"
 #include "mongo/s/catalog/type_collection.h"
 #include "mongo/s/catalog/type_tags.h"
 #include "mongo/s/catalog_cache.h"
+#include "mongo/s/client/shard_registry.h"
 #include "mongo/s/grid.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
@@ -58,6 +60,13 @@ using std::vector;
 
 namespace {
 
+// When enabled, collections whose chunk counts are already balanced are additionally balanced by
+// the sampled write load each shard reports for its chunks
+MONGO_EXPORT_SERVER_PARAMETER(balancerLoadAwareMigrations, bool, false);
+
+// How far above the mean write load, in percent, a shard must be before load-based migrations start
+MONGO_EXPORT_SERVER_PARAMETER(balancerLoadImbalancePercent, int, 25);
+
 /**
  * Does a linear pass over the information cached in the specified chunk manager and extracts chunk
  * distribution and chunk placement information which is needed by the balancer policy.
@@ -114,6 +123,73 @@ StatusWith<DistributionStatus> createCollectionDistributionStatus(
     return {std::move(distribution)};
 }
 
+/**
+ * Runs _getChunkLoadStatistics for the specified collection against a single shard.
+ */
+StatusWith<BSONObj> runGetChunkLoadStatistics(OperationContext* opCtx,
+                                              const ShardId& shardId,
+                                              const NamespaceString& nss,
+                                              bool reset) {
+    auto shardStatus = Grid::get(opCtx)->shardRegistry()->getShard(opCtx, shardId);
+    if (!shardStatus.isOK()) {
+        return shardStatus.getStatus();
+    }
+
+    auto cmdStatus = shardStatus.getValue()->runCommandWithFixedRetryAttempts(
+        opCtx,
+        ReadPreferenceSetting{ReadPreference::PrimaryOnly},
+        "admin",
+        BSON("_getChunkLoadStatistics" << nss.ns() << "reset" << reset),
+        reset ? Shard::RetryPolicy::kNotIdempotent : Shard::RetryPolicy::kIdempotent);
+    if (!cmdStatus.isOK()) {
+        return cmdStatus.getStatus();
+    }
+    if (!cmdStatus.getValue().commandStatus.isOK()) {
+        return cmdStatus.getValue().commandStatus;
+    }
+
+    return std::move(cmdStatus.getValue().response);
+}
+
+/**
+ * Collects the per-chunk write load of the specified collection from every shard and resets the
+ * shards' counters, so that each balancer round looks at the load since the previous one.
+ *
+ * The counters are only reset once every shard has reported. Otherwise a failure on one shard
+ * would discard the window already collected from the shards before it, and the next round would
+ * compare a fresh window on those shards against a full one on the rest.
+ */
+StatusWith<ChunkLoadMap> retrieveChunkLoads(OperationContext* opCtx,
+                                            const NamespaceString& nss,
+                                            const ShardStatisticsVector& shardStats) {
+    auto chunkLoads = SimpleBSONObjComparator::kInstance.makeBSONObjIndexedMap<ChunkLoad>();
+
+    for (const auto& stat : shardStats) {
+        auto swResponse = runGetChunkLoadStatistics(opCtx, stat.shardId, nss, false);
+        if (!swResponse.isOK()) {
+            return swResponse.getStatus();
+        }
+
+        for (const auto& elem : swResponse.getValue()["chunks"].Array()) {
+            const BSONObj entry = elem.Obj();
+            ChunkLoad& load = chunkLoads[entry["min"].Obj().getOwned()];
+            load.ops += entry["ops"].safeNumberLong();
+            load.bytes += entry["bytes"].safeNumberLong();
+        }
+    }
+
+    // The writes sampled between the two passes are dropped, which only shortens the next window
+    for (const auto& stat : shardStats) {
+        auto swResponse = runGetChunkLoadStatistics(opCtx, stat.shardId, nss, true);
+        if (!swResponse.isOK()) {
+            warning() << "Unable to reset chunk load statistics for collection " << nss.ns()
+                      << " on shard " << stat.shardId << causedBy(swResponse.getStatus());
+        }
+    }
+
+    return {std::move(chunkLoads)};
+}
+
 /**
  * Helper class used to accumulate the split points for the same chunk together so they can be
  * submitted to the shard as a single call versus multiple. This is necessary in order to avoid
@@ -502,7 +578,28 @@ StatusWith<MigrateInfoVector> BalancerChunkSelectionPolicyImpl::_getMigrateCandi
         }
     }
 
-    return BalancerPolicy::balance(shardStats, distribution, aggressiveBalanceHint);
+    auto migrations = BalancerPolicy::balance(shardStats, distribution, aggressiveBalanceHint);
+    if (!migrations.empty() || !balancerLoadAwareMigrations.load()) {
+        return {std::move(migrations)};
+    }
+
+    auto chunkLoadsStatus = retrieveChunkLoads(opCtx, nss, shardStats);
+    if (!chunkLoadsStatus.isOK()) {
+        warning() << "Unable to retrieve chunk load statistics for collection " << nss.ns()
+                  << causedBy(chunkLoadsStatus.getStatus());
+        return {std::move(migrations)};
+    }
+
+    auto loadMigration = BalancerPolicy::balanceByLoad(shardStats,
+                                                       distribution,
+                                                       chunkLoadsStatus.getValue(),
+                                                       balancerLoadImbalancePercent.load(),
+                                                       aggressiveBalanceHint);
+    if (loadMigration) {
+        migrations.push_back(std::move(*loadMigration));
+    }
+
+    return {std::move(migrations)};
 }
 
 }  // namespace mongo
@@ -53,6 +53,66 @@ namespace {
 const size_t kDefaultImbalanceThreshold = 2;
 const size_t kAggressiveImbalanceThreshold = 1;
 
+/**
+ * Returns the minimum deviation from the optimal number of chunks per shard which causes balance()
+ * to move chunks of the specified collection.
+ */
+size_t getImbalanceThreshold(const DistributionStatus& distribution,
+                             bool shouldAggressivelyBalance) {
+    return (shouldAggressivelyBalance || distribution.totalChunks() < 20)
+        ? kAggressiveImbalanceThreshold
+        : kDefaultImbalanceThreshold;
+}
+
+/**
+ * Returns whether, after moving one chunk of zone 'tag' from shard 'from' to shard 'to', the chunk
+ * counts of the zone would be uneven enough for balance() to move one of its chunks again. This
+ * uses the same optimal chunk count and threshold as balance(), but ignores which shards can
+ * receive chunks, so it errs on the side of reporting that a move would follow.
+ */
+bool wouldUnbalanceChunkCounts(const ShardStatisticsVector& shardStats,
+                               const DistributionStatus& distribution,
+                               const string& tag,
+                               const ShardId& from,
+                               const ShardId& to,
+                               size_t imbalanceThreshold) {
+    size_t totalNumberOfShardsWithTag = 0;
+    size_t max = 0;
+    size_t min = numeric_limits<size_t>::max();
+
+    for (const auto& stat : shardStats) {
+        if (!tag.empty() && !stat.shardTags.count(tag)) {
+            continue;
+        }
+
+        totalNumberOfShardsWithTag++;
+
+        size_t numChunks = distribution.numberOfChunksInShardWithTag(stat.shardId, tag);
+        if (stat.shardId == from) {
+            numChunks--;
+        } else if (stat.shardId == to) {
+            numChunks++;
+        }
+
+        max = std::max(max, numChunks);
+        min = std::min(min, numChunks);
+    }
+
+    if (totalNumberOfShardsWithTag == 0) {
+        return false;
+    }
+
+    const size_t totalNumberOfChunksWithTag =
+        (tag.empty() ? distribution.totalChunks() : distribution.totalChunksWithTag(tag));
+    const size_t idealNumberOfChunksPerShardForTag =
+        (totalNumberOfChunksWithTag / totalNumberOfShardsWithTag) +
+        (totalNumberOfChunksWithTag % totalNumberOfShardsWithTag ? 1 : 0);
+
+    return max > idealNumberOfChunksPerShardForTag &&
+        max - idealNumberOfChunksPerShardForTag >= imbalanceThreshold &&
+        min < idealNumberOfChunksPerShardForTag;
+}
+
 }  // namespace
 
 DistributionStatus::DistributionStatus(NamespaceString nss, ShardToChunksMap shardToChunksMap)
@@ -392,9 +452,8 @@ vector<MigrateInfo> BalancerPolicy::balance(const ShardStatisticsVector& shardSt
     }
 
     // 3) for each tag balance
-    const size_t imbalanceThreshold = (shouldAggressivelyBalance || distribution.totalChunks() < 20)
-        ? kAggressiveImbalanceThreshold
-        : kDefaultImbalanceThreshold;
+    const size_t imbalanceThreshold =
+        getImbalanceThreshold(distribution, shouldAggressivelyBalance);
 
     vector<string> tagsPlusEmpty(distribution.tags().begin(), distribution.tags().end());
     tagsPlusEmpty.push_back("");
@@ -456,6 +515,116 @@ boost::optional<MigrateInfo> BalancerPolicy::balanceSingleChunk(
     return MigrateInfo(newShardId, chunk);
 }
 
+boost::optional<MigrateInfo> BalancerPolicy::balanceByLoad(const ShardStatisticsVector& shardStats,
+                                                           const DistributionStatus& distribution,
+                                                           const ChunkLoadMap& chunkLoads,
+                                                           int imbalancePercent,
+                                                           bool shouldAggressivelyBalance) {
+    if (shardStats.size() < 2) {
+        return boost::none;
+    }
+
+    auto chunkLoad = [&chunkLoads](const ChunkType& chunk) -> long long {
+        auto it = chunkLoads.find(chunk.getMin());
+        return it == chunkLoads.end() ? 0 : it->second.ops;
+    };
+
+    map<ShardId, long long> shardLoads;
+    long long totalLoad = 0;
+    for (const auto& stat : shardStats) {
+        long long load = 0;
+        for (const auto& chunk : distribution.getChunks(stat.shardId)) {
+            load += chunkLoad(chunk);
+        }
+        shardLoads[stat.shardId] = load;
+        totalLoad += load;
+    }
+
+    if (totalLoad == 0) {
+        return boost::none;
+    }
+
+    const ClusterStatistics::ShardStatistics* from = nullptr;
+    const ClusterStatistics::ShardStatistics* to = nullptr;
+    for (const auto& stat : shardStats) {
+        const long long load = shardLoads[stat.shardId];
+        if (!from || load > shardLoads[from->shardId]) {
+            from = &stat;
+        }
+        if (isShardSuitableReceiver(stat, "").isOK() &&
+            (!to || load < shardLoads[to->shardId])) {
+            to = &stat;
+        }
+    }
+
+    if (!to || from->shardId == to->shardId) {
+        return boost::none;
+    }
+
+    const long long fromLoad = shardLoads[from->shardId];
+    const long long toLoad = shardLoads[to->shardId];
+    const long long meanLoad = totalLoad / static_cast<long long>(shardStats.size());
+
+    if (fromLoad * 100 <= meanLoad * (100 + imbalancePercent)) {
+        return boost::none;
+    }
+
+    const size_t imbalanceThreshold =
+        getImbalanceThreshold(distribution, shouldAggressivelyBalance);
+
+    // Whether moving a chunk of each zone would make balance() move a chunk back
+    map<string, bool> unbalancesZone;
+
+    // Prefer the chunk which brings the two shards closest to each other
+    const long long idealLoadToMove = (fromLoad - toLoad) / 2;
+    const ChunkType* bestChunk = nullptr;
+    long long bestDistance = numeric_limits<long long>::max();
+
+    for (const auto& chunk : distribution.getChunks(from->shardId)) {
+        if (chunk.getJumbo()) {
+            continue;
+        }
+
+        const long long load = chunkLoad(chunk);
+        if (load == 0 || toLoad + load >= fromLoad) {
+            continue;
+        }
+
+        const string tag = distribution.getTagForChunk(chunk);
+        if (!isShardSuitableReceiver(*to, tag).isOK()) {
+            continue;
+        }
+
+        auto it = unbalancesZone.find(tag);
+        if (it == unbalancesZone.end()) {
+            it = unbalancesZone
+                     .emplace(tag,
+                              wouldUnbalanceChunkCounts(shardStats,
+                                                        distribution,
+                                                        tag,
+                                                        from->shardId,
+                                                        to->shardId,
+                                                        imbalanceThreshold))
+                     .first;
+        }
+        if (it->second) {
+            continue;
+        }
+
+        const long long distance = std::abs(load - idealLoadToMove);
+        if (distance < bestDistance) {
+            bestChunk = &chunk;
+            bestDistance = distance;
+        }
+    }
+
+    if (!bestChunk) {
+        return boost::none;
+    }
+
+    return MigrateInfo(to->shardId, *bestChunk);
+}
+
 bool BalancerPolicy::_singleZoneBalance(const ShardStatisticsVector& shardStats,
                                         const DistributionStatus& distribution,
                                         const string& tag,
@@ -92,6 +92,17 @@ struct MigrateInfo {
 typedef std::vector<ClusterStatistics::ShardStatistics> ShardStatisticsVector;
 typedef std::map<ShardId, std::vector<ChunkType>> ShardToChunksMap;
 
+/**
+ * Sampled write load of a single chunk, as reported by its owning shard.
+ */
+struct ChunkLoad {
+    long long ops{0};
+    long long bytes{0};
+};
+
+// Map of chunk min key to the load of that chunk
+typedef BSONObjIndexedMap<ChunkLoad> ChunkLoadMap;
+
 /**
  * This class constitutes a cache of the chunk distribution across the entire cluster along with the
  * zone boundaries imposed on it. This information is stored in format, which makes it efficient to
@@ -220,6 +231,23 @@ public:
                                                            const ShardStatisticsVector& shardStats,
                                                            const DistributionStatus& distribution);
 
+    /**
+     * Returns a suggested migration which evens out the write load of a collection across its
+     * shards, given the sampled per-chunk load in 'chunkLoads'. Chunks missing from 'chunkLoads'
+     * are treated as idle.
+     *
+     * A migration is only suggested if the most loaded shard is more than 'imbalancePercent' above
+     * the mean load, and only for a chunk which leaves the receiving shard less loaded than the
+     * donor was. The latter prevents a single hot chunk from bouncing between shards. Neither is a
+     * chunk moved if the resulting chunk counts would make balance(), called with the same
+     * shouldAggressivelyBalance, move a chunk back.
+     */
+    static boost::optional<MigrateInfo> balanceByLoad(const ShardStatisticsVector& shardStats,
+                                                      const DistributionStatus& distribution,
+                                                      const ChunkLoadMap& chunkLoads,
+                                                      int imbalancePercent,
+                                                      bool shouldAggressivelyBalance);
+
 private:
     /**
      * Return the shard with the specified tag, which has the least number of chunks. If the tag is
@@ -704,5 +704,106 @@ TEST(DistributionStatus, ChunkTagsSelectorWithMinMaxKeys) {
     }
 }
 
+TEST(BalancerPolicy, BalanceByLoadMovesHotChunkToIdleShard) {
+    auto cluster = generateCluster(
+        {{ShardStatistics(kShardId0, kNoMaxSize, 10, false, emptyTagSet, emptyShardVersion), 10},
+         {ShardStatistics(kShardId1, kNoMaxSize, 10, false, emptyTagSet, emptyShardVersion), 10}});
+
+    auto chunkLoads = SimpleBSONObjComparator::kInstance.makeBSONObjIndexedMap<ChunkLoad>();
+    chunkLoads[cluster.second[kShardId0][0].getMin()].ops = 100;
+    chunkLoads[cluster.second[kShardId0][1].getMin()].ops = 300;
+    chunkLoads[cluster.second[kShardId0][2].getMin()].ops = 200;
+
+    const auto migration(BalancerPolicy::balanceByLoad(
+        cluster.first, DistributionStatus(kNamespace, cluster.second), chunkLoads, 25, false));
+    ASSERT(migration);
+    ASSERT_EQ(kShardId0, migration->from);
+    ASSERT_EQ(kShardId1, migration->to);
+    ASSERT_BSONOBJ_EQ(cluster.second[kShardId0][1].getMin(), migration->minKey);
+}
+
+TEST(BalancerPolicy, BalanceByLoadThresholdObeyed) {
+    auto cluster = generateCluster(
+        {{ShardStatistics(kShardId0, kNoMaxSize, 2, false, emptyTagSet, emptyShardVersion), 2},
+         {ShardStatistics(kShardId1, kNoMaxSize, 2, false, emptyTagSet, emptyShardVersion), 2}});
+
+    auto chunkLoads = SimpleBSONObjComparator::kInstance.makeBSONObjIndexedMap<ChunkLoad>();
+    chunkLoads[cluster.second[kShardId0][0].getMin()].ops = 110;
+    chunkLoads[cluster.second[kShardId1][0].getMin()].ops = 90;
+
+    ASSERT(!BalancerPolicy::balanceByLoad(
+        cluster.first, DistributionStatus(kNamespace, cluster.second), chunkLoads, 25, false));
+}
+
+TEST(BalancerPolicy, BalanceByLoadDoesNotBounceSingleHotChunk) {
+    auto cluster = generateCluster(
+        {{ShardStatistics(kShardId0, kNoMaxSize, 2, false, emptyTagSet, emptyShardVersion), 2},
+         {ShardStatistics(kShardId1, kNoMaxSize, 2, false, emptyTagSet, emptyShardVersion), 2}});
+
+    // Moving the only hot chunk would just make the other shard the hot one
+    auto chunkLoads = SimpleBSONObjComparator::kInstance.makeBSONObjIndexedMap<ChunkLoad>();
+    chunkLoads[cluster.second[kShardId0][0].getMin()].ops = 1000;
+
+    ASSERT(!BalancerPolicy::balanceByLoad(
+        cluster.first, DistributionStatus(kNamespace, cluster.second), chunkLoads, 25, false));
+}
+
+TEST(BalancerPolicy, BalanceByLoadSkipsJumboAndDrainingShards) {
+    auto cluster = generateCluster(
+        {{ShardStatistics(kShardId0, kNoMaxSize, 10, false, emptyTagSet, emptyShardVersion), 10},
+         {ShardStatistics(kShardId1, kNoMaxSize, 10, true, emptyTagSet, emptyShardVersion), 10},
+         {ShardStatistics(kShardId2, kNoMaxSize, 10, false, emptyTagSet, emptyShardVersion), 10}});
+
+    cluster.second[kShardId0][0].setJumbo(true);
+
+    auto chunkLoads = SimpleBSONObjComparator::kInstance.makeBSONObjIndexedMap<ChunkLoad>();
+    chunkLoads[cluster.second[kShardId0][0].getMin()].ops = 500;
+    chunkLoads[cluster.second[kShardId0][1].getMin()].ops = 300;
+    chunkLoads[cluster.second[kShardId2][0].getMin()].ops = 100;
+
+    const auto migration(BalancerPolicy::balanceByLoad(
+        cluster.first, DistributionStatus(kNamespace, cluster.second), chunkLoads, 25, false));
+    ASSERT(migration);
+    ASSERT_EQ(kShardId0, migration->from);
+    ASSERT_EQ(kShardId2, migration->to);
+    ASSERT_BSONOBJ_EQ(cluster.second[kShardId0][1].getMin(), migration->minKey);
+}
+
+TEST(BalancerPolicy, BalanceByLoadDoesNotUndoChunkCountBalance) {
+    auto cluster = generateCluster(
+        {{ShardStatistics(kShardId0, kNoMaxSize, 3, false, emptyTagSet, emptyShardVersion), 3},
+         {ShardStatistics(kShardId1, kNoMaxSize, 3, false, emptyTagSet, emptyShardVersion), 3}});
+
+    auto chunkLoads = SimpleBSONObjComparator::kInstance.makeBSONObjIndexedMap<ChunkLoad>();
+    chunkLoads[cluster.second[kShardId0][0].getMin()].ops = 100;
+    chunkLoads[cluster.second[kShardId0][1].getMin()].ops = 300;
+    chunkLoads[cluster.second[kShardId0][2].getMin()].ops = 200;
+
+    // With fewer than 20 chunks a difference of one chunk is enough for balance() to move a chunk
+    // back, possibly the hot one
+    ASSERT(!BalancerPolicy::balanceByLoad(
+        cluster.first, DistributionStatus(kNamespace, cluster.second), chunkLoads, 25, false));
+
+    // The same holds for any collection while balancing aggressively
+    auto largeCluster = generateCluster(
+        {{ShardStatistics(kShardId0, kNoMaxSize, 10, false, emptyTagSet, emptyShardVersion), 10},
+         {ShardStatistics(kShardId1, kNoMaxSize, 10, false, emptyTagSet, emptyShardVersion), 10}});
+
+    auto largeChunkLoads = SimpleBSONObjComparator::kInstance.makeBSONObjIndexedMap<ChunkLoad>();
+    largeChunkLoads[largeCluster.second[kShardId0][0].getMin()].ops = 100;
+    largeChunkLoads[largeCluster.second[kShardId0][1].getMin()].ops = 300;
+
+    ASSERT(BalancerPolicy::balanceByLoad(largeCluster.first,
+                                         DistributionStatus(kNamespace, largeCluster.second),
+                                         largeChunkLoads,
+                                         25,
+                                         false));
+    ASSERT(!BalancerPolicy::balanceByLoad(largeCluster.first,
+                                          DistributionStatus(kNamespace, largeCluster.second),
+                                          largeChunkLoads,
+                                          25,
+                                          true));
+}
+
 }  // namespace
 }  // namespace mongo
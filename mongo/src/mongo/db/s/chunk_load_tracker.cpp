@@ -0,0 +1,95 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/s/chunk_load_tracker.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/server_parameters.h"
+
+namespace mongo {
+namespace {
+
+// One in this many writes to a sharded collection is sampled into the per-chunk load counters. A
+// value <= 0 disables tracking.
+MONGO_EXPORT_SERVER_PARAMETER(chunkLoadSampleInterval, int, 16);
+
+}  // namespace
+
+ChunkLoadTracker::ChunkLoadTracker(int sampleInterval)
+    : _fixedSampleInterval(sampleInterval),
+      _chunks(SimpleBSONObjComparator::kInstance.makeBSONObjIndexedMap<Counters>()) {}
+
+int ChunkLoadTracker::_getSampleInterval() const {
+    return _fixedSampleInterval ? _fixedSampleInterval : chunkLoadSampleInterval.load();
+}
+
+void ChunkLoadTracker::recordWrite(const BSONObj& chunkMin, long long bytes) {
+    const int sampleInterval = _getSampleInterval();
+    if (sampleInterval <= 0) {
+        return;
+    }
+
+    if (_writes.fetchAndAdd(1) % sampleInterval != 0) {
+        return;
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    auto it = _chunks.find(chunkMin);
+    if (it == _chunks.end()) {
+        it = _chunks.emplace(chunkMin.getOwned(), Counters()).first;
+    }
+
+    it->second.ops += sampleInterval;
+    it->second.bytes += bytes * sampleInterval;
+}
+
+void ChunkLoadTracker::report(BSONArrayBuilder* chunksArr, bool reset) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    for (const auto& entry : _chunks) {
+        BSONObjBuilder chunkBuilder(chunksArr->subobjStart());
+        chunkBuilder.append("min", entry.first);
+        chunkBuilder.append("ops", entry.second.ops);
+        chunkBuilder.append("bytes", entry.second.bytes);
+        chunkBuilder.doneFast();
+    }
+
+    if (reset) {
+        _chunks.clear();
+    }
+}
+
+void ChunkLoadTracker::clear() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _chunks.clear();
+}
+
+}  // namespace mongo
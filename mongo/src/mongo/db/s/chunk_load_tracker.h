@@ -0,0 +1,94 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#pragma once
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/bson/simple_bsonobj_comparator.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/mutex.h"
+
+namespace mongo {
+
+class BSONArrayBuilder;
+
+/**
+ * Tracks the write load of each chunk of a sharded collection on this shard, so that the balancer
+ * can even out measured load rather than chunk counts.
+ *
+ * Writes are sampled: only one in every 'chunkLoadSampleInterval' calls to recordWrite takes the
+ * mutex, and it is counted with a weight equal to the interval. Chunks are identified by their min
+ * key, so the counters survive routing table refreshes.
+ */
+class ChunkLoadTracker {
+    MONGO_DISALLOW_COPYING(ChunkLoadTracker);
+
+public:
+    /**
+     * A sampleInterval of 0 means to use the 'chunkLoadSampleInterval' server parameter.
+     */
+    explicit ChunkLoadTracker(int sampleInterval = 0);
+
+    /**
+     * Records a write of 'bytes' bytes to the chunk starting at 'chunkMin'.
+     */
+    void recordWrite(const BSONObj& chunkMin, long long bytes);
+
+    /**
+     * Appends one {min, ops, bytes} entry per chunk written since the last reset. If 'reset' is
+     * true, clears the counters so that the next report covers a new window.
+     */
+    void report(BSONArrayBuilder* chunksArr, bool reset);
+
+    /**
+     * Clears all counters.
+     */
+    void clear();
+
+private:
+    struct Counters {
+        long long ops{0};
+        long long bytes{0};
+    };
+
+    int _getSampleInterval() const;
+
+    const int _fixedSampleInterval;
+
+    // Number of writes seen, used to pick the samples
+    AtomicUInt64 _writes;
+
+    // Protects _chunks
+    stdx::mutex _mutex;
+
+    // Sampled counters, keyed by chunk min
+    BSONObjIndexedMap<Counters> _chunks;
+};
+
+}  // namespace mongo
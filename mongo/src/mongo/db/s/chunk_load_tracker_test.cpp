@@ -0,0 +1,79 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/s/chunk_load_tracker.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+BSONObj reportOf(ChunkLoadTracker& tracker, bool reset) {
+    BSONArrayBuilder arr;
+    tracker.report(&arr, reset);
+    return arr.arr();
+}
+
+TEST(ChunkLoadTracker, EveryWriteCountedWithIntervalOne) {
+    ChunkLoadTracker tracker(1);
+    tracker.recordWrite(BSON("x" << 0), 10);
+    tracker.recordWrite(BSON("x" << 0), 20);
+    tracker.recordWrite(BSON("x" << 100), 5);
+
+    ASSERT_BSONOBJ_EQ(BSON_ARRAY(BSON("min" << BSON("x" << 0) << "ops" << 2LL << "bytes" << 30LL)
+                                 << BSON("min" << BSON("x" << 100) << "ops" << 1LL << "bytes"
+                                               << 5LL)),
+                      reportOf(tracker, false));
+}
+
+TEST(ChunkLoadTracker, SampledWritesAreWeightedByInterval) {
+    ChunkLoadTracker tracker(4);
+    for (int i = 0; i < 8; i++) {
+        tracker.recordWrite(BSON("x" << 0), 10);
+    }
+
+    ASSERT_BSONOBJ_EQ(BSON_ARRAY(BSON("min" << BSON("x" << 0) << "ops" << 8LL << "bytes" << 80LL)),
+                      reportOf(tracker, false));
+}
+
+TEST(ChunkLoadTracker, ResetStartsNewWindow) {
+    ChunkLoadTracker tracker(1);
+    tracker.recordWrite(BSON("x" << 0), 10);
+
+    ASSERT_EQ(1, reportOf(tracker, true).nFields());
+    ASSERT_EQ(0, reportOf(tracker, false).nFields());
+
+    tracker.recordWrite(BSON("x" << 0), 10);
+    tracker.clear();
+    ASSERT_EQ(0, reportOf(tracker, false).nFields());
+}
+
+}  // namespace
+}  // namespace mongo
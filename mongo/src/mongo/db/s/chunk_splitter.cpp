@@ -326,16 +326,28 @@ void ChunkSplitter::_runAutosplit(const NamespaceString& nss,
                << " maxChunkSizeBytes: " << maxChunkSizeBytes;
 
 		////splitVectorжǷҪsplit
-        auto splitPoints = uassertStatusOK(splitVector(opCtx.get(),
-                                                       nss,
-                                                       cm->getShardKeyPattern().toBSON(),
-                                                       chunk->getMin(),
-                                                       chunk->getMax(),
-                                                       false,
-                                                       boost::none,
-                                                       boost::none,
-                                                       boost::none,
-                                                       maxChunkSizeBytes));
+        // Estimate the split points from a random sample first and only fall back to scanning the
+        // chunk's index range when the sample cannot be trusted
+        auto sampledSplitPoints =
+            uassertStatusOK(sampleSplitPoints(opCtx.get(),
+                                              nss,
+                                              cm->getShardKeyPattern().toBSON(),
+                                              chunk->getMin(),
+                                              chunk->getMax(),
+                                              static_cast<long long>(maxChunkSizeBytes)));
+
+        auto splitPoints = sampledSplitPoints
+            ? std::move(*sampledSplitPoints)
+            : uassertStatusOK(splitVector(opCtx.get(),
+                                          nss,
+                                          cm->getShardKeyPattern().toBSON(),
+                                          chunk->getMin(),
+                                          chunk->getMax(),
+                                          false,
+                                          boost::none,
+                                          boost::none,
+                                          boost::none,
+                                          maxChunkSizeBytes));
 
 		/*ûзָζû㹻ݿɹָ;һָζһĿСĿСԻûбҪָ*/
         if (splitPoints.size() <= 1) {
@@ -53,6 +53,7 @@
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/s/metadata_manager.h"
 #include "mongo/db/s/sharding_state.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/write_concern.h"
 #include "mongo/executor/task_executor.h"
@@ -70,6 +71,20 @@ const WriteConcernOptions kMajorityWriteConcern(WriteConcernOptions::kMajority,
                                                 WriteConcernOptions::SyncMode::UNSET,
                                                 Seconds(60));
 
+// Maximum number of documents removed by one pass of the range deleter. A value <= 0 means to use
+// internalQueryExecYieldIterations, which was the historical batch size.
+MONGO_EXPORT_SERVER_PARAMETER(rangeDeleterBatchSize, int, 0);
+
+// Limits on the size of a single pass, which runs in one storage transaction. The byte limit lets
+// a pass of large documents end early.
+const int kMaxBatchSize = 10000;
+const long long kMaxBatchBytes = 16 * 1024 * 1024;
+
+// Upper bound on the rate at which orphaned documents are removed, in bytes of BSON per second.
+// Rather than sleeping a fixed amount between batches, the next pass is scheduled as soon as the
+// bytes removed by the previous pass fit in the budget. A value <= 0 disables throttling.
+MONGO_EXPORT_SERVER_PARAMETER(rangeDeleterMaxBytesPerSecond, long long, 0);
+
 boost::optional<DeleteNotification> checkOverlap(std::list<Deletion> const& deletions,
                                                  ChunkRange const& range) {
     // Start search with newest entries by using reverse iterators
@@ -83,8 +98,29 @@ boost::optional<DeleteNotification> checkOverlap(std::list<Deletion> const& dele
     return boost::none;
 }
 
+/**
+ * Returns the time at which the next pass of the range deleter may begin, given that the last pass
+ * removed 'bytesDeleted' bytes of documents.
+ */
+Date_t nextPassTime(long long bytesDeleted) {
+    const long long maxBytesPerSecond = rangeDeleterMaxBytesPerSecond.load();
+    if (maxBytesPerSecond <= 0 || bytesDeleted <= 0) {
+        return Date_t{};
+    }
+
+    return Date_t::now() + Milliseconds(bytesDeleted * 1000 / maxBytesPerSecond);
+}
+
 }  // namespace
 
+int CollectionRangeDeleter::getBatchSize() {
+    const int batchSize = rangeDeleterBatchSize.load();
+    if (batchSize > 0) {
+        return std::min(batchSize, kMaxBatchSize);
+    }
+    return std::max(int(internalQueryExecYieldIterations.load()), 1);
+}
+
 CollectionRangeDeleter::CollectionRangeDeleter() = default;
 
 CollectionRangeDeleter::~CollectionRangeDeleter() {
@@ -100,6 +136,7 @@ boost::optional<Date_t> CollectionRangeDeleter::cleanUpNextRange(
     CollectionRangeDeleter* forTestOnly) {
 
     StatusWith<int> wrote = 0;
+    long long bytesDeleted = 0;
 
     auto range = boost::optional<ChunkRange>(boost::none);
     auto notification = DeleteNotification();
@@ -201,7 +238,8 @@ boost::optional<Date_t> CollectionRangeDeleter::cleanUpNextRange(
 
         try {
             const auto keyPattern = scopedCollectionMetadata->getKeyPattern();
-            wrote = self->_doDeletion(opCtx, collection, keyPattern, *range, maxToDelete);
+            wrote = self->_doDeletion(
+                opCtx, collection, keyPattern, *range, maxToDelete, &bytesDeleted);
         } catch (const DBException& e) {
             wrote = e.toStatus();
             warning() << e.what();
@@ -261,19 +299,20 @@ boost::optional<Date_t> CollectionRangeDeleter::cleanUpNextRange(
             self->_pop(status);
         }
     } else {
-        LOG(1) << "Deleted " << wrote.getValue() << " documents in " << nss.ns() << " range "
-               << redact(range->toString());
+        LOG(1) << "Deleted " << wrote.getValue() << " documents (" << bytesDeleted << " bytes) in "
+               << nss.ns() << " range " << redact(range->toString());
     }
 
     notification.abandon();
-    return Date_t{};
+    return nextPassTime(bytesDeleted);
 }
 
 StatusWith<int> CollectionRangeDeleter::_doDeletion(OperationContext* opCtx,
                                                     Collection* collection,
                                                     BSONObj const& keyPattern,
                                                     ChunkRange const& range,
-                                                    int maxToDelete) {
+                                                    int maxToDelete,
+                                                    long long* bytesDeleted) {
     invariant(collection != nullptr);
     invariant(!isEmpty());
 
@@ -315,40 +354,66 @@ StatusWith<int> CollectionRangeDeleter::_doDeletion(OperationContext* opCtx,
         saver.emplace("moveChunk", nss.ns(), "cleaning");
     }
 
+    // Find a whole batch with a single index scan and remove it in a single storage transaction,
+    // instead of re-planning the scan and committing once per document. The scan runs inside the
+    // transaction, so a write conflict repeats it rather than deleting records which the
+    // conflicting write may have removed. The batch is complete before the first delete, so that
+    // the deletes do not move the index cursor.
     int numDeleted = 0;
-    do {
-        auto halfOpen = BoundInclusion::kIncludeStartKeyOnly;
-        auto manual = PlanExecutor::YIELD_MANUAL;
-        auto forward = InternalPlanner::FORWARD;
-        auto fetch = InternalPlanner::IXSCAN_FETCH;
-
-        auto exec = InternalPlanner::indexScan(
-            opCtx, collection, descriptor, min, max, halfOpen, manual, forward, fetch);
-
-        RecordId rloc;
-        BSONObj obj;
-        PlanExecutor::ExecState state = exec->getNext(&obj, &rloc);
-        if (state == PlanExecutor::IS_EOF) {
-            break;
-        }
-        if (state == PlanExecutor::FAILURE || state == PlanExecutor::DEAD) {
-            warning() << PlanExecutor::statestr(state) << " - cursor error while trying to delete "
-                      << redact(min) << " to " << redact(max) << " in " << nss << ": "
-                      << WorkingSetCommon::toStatusString(obj)
-                      << ", stats: " << Explain::getWinningPlanStats(exec.get());
-            break;
-        }
-        invariant(PlanExecutor::ADVANCED == state);
+    long long batchBytes = 0;
+    writeConflictRetry(opCtx, "delete range", nss.ns(), [&] {
+        WriteUnitOfWork wuow(opCtx);
 
-        writeConflictRetry(opCtx, "delete range", nss.ns(), [&] {
-            WriteUnitOfWork wuow(opCtx);
-            if (saver) {
-                uassertStatusOK(saver->goingToDelete(obj));
+        std::vector<RecordId> batch;
+        batchBytes = 0;
+        {
+            auto exec = InternalPlanner::indexScan(opCtx,
+                                                   collection,
+                                                   descriptor,
+                                                   min,
+                                                   max,
+                                                   BoundInclusion::kIncludeStartKeyOnly,
+                                                   PlanExecutor::YIELD_MANUAL,
+                                                   InternalPlanner::FORWARD,
+                                                   InternalPlanner::IXSCAN_FETCH);
+
+            while (batch.size() < static_cast<size_t>(std::max(maxToDelete, 1)) &&
+                   batchBytes < kMaxBatchBytes) {
+                RecordId rloc;
+                BSONObj obj;
+                PlanExecutor::ExecState state = exec->getNext(&obj, &rloc);
+                if (state == PlanExecutor::IS_EOF) {
+                    break;
+                }
+                if (state == PlanExecutor::FAILURE || state == PlanExecutor::DEAD) {
+                    warning() << PlanExecutor::statestr(state)
+                              << " - cursor error while trying to delete " << redact(min) << " to "
+                              << redact(max) << " in " << nss << ": "
+                              << WorkingSetCommon::toStatusString(obj)
+                              << ", stats: " << Explain::getWinningPlanStats(exec.get());
+                    break;
+                }
+                invariant(PlanExecutor::ADVANCED == state);
+
+                if (saver) {
+                    uassertStatusOK(saver->goingToDelete(obj));
+                }
+                batch.push_back(rloc);
+                batchBytes += obj.objsize();
             }
+        }
+
+        for (const auto& rloc : batch) {
             collection->deleteDocument(opCtx, kUninitializedStmtId, rloc, nullptr, true);
-            wuow.commit();
-        });
-    } while (++numDeleted < maxToDelete);
+        }
+        wuow.commit();
+
+        numDeleted = static_cast<int>(batch.size());
+    });
+
+    if (bytesDeleted) {
+        *bytesDeleted = batchBytes;
+    }
 
     return numDeleted;
 }
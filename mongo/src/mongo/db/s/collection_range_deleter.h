@@ -158,7 +158,9 @@ public:
      * it must be called without locks.
      *
      * If it should be scheduled to run again because there might be more documents to delete,
-     * returns the time to begin, or boost::none otherwise.
+     * returns the time to begin, or boost::none otherwise. When the server parameter
+     * rangeDeleterMaxBytesPerSecond is set, the returned time is pushed out far enough that the
+     * bytes removed by this pass stay within that budget.
      *
      * Argument 'forTestOnly' is used in unit tests that exercise the CollectionRangeDeleter class,
      * so that they do not need to set up CollectionShardingState and MetadataManager objects.
@@ -169,10 +171,18 @@ public:
                                                     int maxToDelete,
                                                     CollectionRangeDeleter* forTestOnly = nullptr);
 
+    /**
+     * Returns the number of documents to remove per call to cleanUpNextRange, as configured by the
+     * server parameter rangeDeleterBatchSize, and at most 10000.
+     */
+    static int getBatchSize();
+
 private:
     /**
      * Performs the deletion of up to maxToDelete entries within the range in progress. Must be
-     * called under the collection lock.
+     * called under the collection lock. The entries are found with a single index scan and removed
+     * in a single WriteUnitOfWork, which ends the batch early once the documents found reach 16MB.
+     * If bytesDeleted is not null, it is set to the total size of the documents removed.
      *
      * Returns the number of documents deleted, 0 if done with the range, or bad status if deleting
      * the range failed.
@@ -181,7 +191,8 @@ private:
                                 Collection* collection,
                                 const BSONObj& keyPattern,
                                 ChunkRange const& range,
-                                int maxToDelete);
+                                int maxToDelete,
+                                long long* bytesDeleted = nullptr);
 
     /**
      * Removes the latest-scheduled range from the ranges to be cleaned up, and notifies any
@@ -42,12 +42,14 @@
 #include "mongo/db/s/collection_range_deleter.h"
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/s/sharding_state.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context_d_test_fixture.h"
 #include "mongo/s/balancer_configuration.h"
 #include "mongo/s/chunk_version.h"
 #include "mongo/s/client/shard_registry.h"
 #include "mongo/s/sharding_mongod_test_fixture.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -400,5 +402,49 @@ TEST_F(CollectionRangeDeleterTest, MultipleDocumentsInMultipleRangesToClean) {
     ASSERT_FALSE(next(rangeDeleter, 1));
 }
 
+// Tests that with a byte budget configured, the next pass is deferred in proportion to the bytes
+// removed by the previous one, and that an empty pass is not deferred.
+TEST_F(CollectionRangeDeleterTest, ByteBudgetDefersNextPass) {
+    auto* maxBytesPerSecond =
+        ServerParameterSet::getGlobal()->getMap().find("rangeDeleterMaxBytesPerSecond")->second;
+    ASSERT_OK(maxBytesPerSecond->setFromString("1"));
+    ON_BLOCK_EXIT([&] { maxBytesPerSecond->setFromString("0").transitional_ignore(); });
+
+    CollectionRangeDeleter rangeDeleter;
+    DBDirectClient dbclient(operationContext());
+    dbclient.insert(kNss.toString(), BSON(kPattern << 1));
+    dbclient.insert(kNss.toString(), BSON(kPattern << 2));
+
+    std::list<Deletion> ranges;
+    ranges.emplace_back(Deletion{ChunkRange(BSON(kPattern << 0), BSON(kPattern << 10)), Date_t{}});
+    auto when = rangeDeleter.add(std::move(ranges));
+    ASSERT(when && *when == Date_t{});
+
+    const auto before = Date_t::now();
+    auto deferred = next(rangeDeleter, 100);
+    ASSERT_TRUE(deferred);
+    ASSERT_GT(*deferred, before);
+    ASSERT_EQUALS(0ULL, dbclient.count(kNss.toString(), BSON(kPattern << LT << 10)));
+
+    // Nothing left to remove, so the range is popped without delay.
+    auto popped = next(rangeDeleter, 100);
+    ASSERT_TRUE(popped);
+    ASSERT_EQUALS(*popped, Date_t{});
+    ASSERT_TRUE(rangeDeleter.isEmpty());
+}
+
+// Tests that a configured batch size is capped, since each pass runs in a single transaction.
+TEST_F(CollectionRangeDeleterTest, BatchSizeIsCapped) {
+    auto* batchSize =
+        ServerParameterSet::getGlobal()->getMap().find("rangeDeleterBatchSize")->second;
+    ON_BLOCK_EXIT([&] { batchSize->setFromString("0").transitional_ignore(); });
+
+    ASSERT_OK(batchSize->setFromString("500"));
+    ASSERT_EQUALS(500, CollectionRangeDeleter::getBatchSize());
+
+    ASSERT_OK(batchSize->setFromString("100000000"));
+    ASSERT_EQUALS(10000, CollectionRangeDeleter::getBatchSize());
+}
+
 }  // namespace
 }  // namespace mongo
@@ -643,6 +643,8 @@ uint64_t CollectionShardingState::_incrementChunkOnInsertOrUpdate(OperationConte
     invariant(chunk);
     chunk->addBytesWritten(dataWritten);
 
+    _chunkLoadTracker.recordWrite(chunk->getMin(), dataWritten);
+
     // If the chunk becomes too large, then we call the ChunkSplitter to schedule a split. Then, we
     // reset the tracking for that chunk to 0.
     if (_shouldSplitChunk(opCtx, shardKeyPattern, *chunk)) {
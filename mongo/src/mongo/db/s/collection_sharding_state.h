@@ -34,6 +34,7 @@
 #include "mongo/base/disallow_copying.h"
 #include "mongo/base/string_data.h"
 #include "mongo/db/namespace_string.h"
+#include "mongo/db/s/chunk_load_tracker.h"
 #include "mongo/db/s/collection_range_deleter.h"
 #include "mongo/db/s/metadata_manager.h"
 #include "mongo/util/concurrency/notification.h"
@@ -102,6 +103,13 @@ public:
      */
     ScopedCollectionMetadata getMetadata(); 
 
+    /**
+     * Returns the sampled per-chunk write load of this collection on this shard.
+     */
+    ChunkLoadTracker& getChunkLoadTracker() {
+        return _chunkLoadTracker;
+    }
+
     /**
      * BSON output of the pending metadata into a BSONArray
      */
@@ -333,6 +341,9 @@ private:
     //CollectionShardingState::setMigrationSourceManagerиֵ
     MigrationSourceManager* _sourceMgr{nullptr};
 
+    // Sampled write load per chunk, reported to the balancer
+    ChunkLoadTracker _chunkLoadTracker;
+
     // for access to _metadataManager
     friend auto CollectionRangeDeleter::cleanUpNextRange(OperationContext*,
                                                          NamespaceString const&,
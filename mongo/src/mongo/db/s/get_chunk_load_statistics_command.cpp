@@ -0,0 +1,110 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kSharding
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/auth/action_set.h"
+#include "mongo/db/auth/action_type.h"
+#include "mongo/db/auth/authorization_session.h"
+#include "mongo/db/auth/privilege.h"
+#include "mongo/db/commands.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/s/collection_sharding_state.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * Internal command run by the balancer against each shard to collect the sampled per-chunk write
+ * load of a collection.
+ *
+ * {
+ *   _getChunkLoadStatistics: <fully qualified namespace>,
+ *   reset: <bool, whether to start a new sampling window>
+ * }
+ *
+ * Returns {chunks: [{min: <chunk min>, ops: <sampled writes>, bytes: <sampled bytes>}, ...]}.
+ */
+class GetChunkLoadStatisticsCommand : public BasicCommand {
+public:
+    GetChunkLoadStatisticsCommand() : BasicCommand("_getChunkLoadStatistics") {}
+
+    void help(std::stringstream& help) const override {
+        help << "should not be calling this directly";
+    }
+
+    bool supportsWriteConcern(const BSONObj& cmd) const override {
+        return false;
+    }
+
+    bool slaveOk() const override {
+        return false;
+    }
+
+    bool adminOnly() const override {
+        return true;
+    }
+
+    Status checkAuthForCommand(Client* client,
+                               const std::string& dbname,
+                               const BSONObj& cmdObj) override {
+        if (!AuthorizationSession::get(client)->isAuthorizedForActionsOnResource(
+                ResourcePattern::forClusterResource(), ActionType::internal)) {
+            return Status(ErrorCodes::Unauthorized, "Unauthorized");
+        }
+        return Status::OK();
+    }
+
+    std::string parseNs(const std::string& dbname, const BSONObj& cmdObj) const override {
+        return parseNsFullyQualified(dbname, cmdObj);
+    }
+
+    bool run(OperationContext* opCtx,
+             const std::string& dbname,
+             const BSONObj& cmdObj,
+             BSONObjBuilder& result) override {
+        const NamespaceString nss(parseNs(dbname, cmdObj));
+        const bool reset = cmdObj["reset"].trueValue();
+
+        AutoGetCollection autoColl(opCtx, nss, MODE_IS);
+        CollectionShardingState* const css = CollectionShardingState::get(opCtx, nss);
+
+        BSONArrayBuilder chunksArr(result.subarrayStart("chunks"));
+        css->getChunkLoadTracker().report(&chunksArr, reset);
+        chunksArr.doneFast();
+
+        return true;
+    }
+
+} getChunkLoadStatisticsCmd;
+
+}  // namespace
+}  // namespace mongo
@@ -32,6 +32,8 @@
 
 #include "mongo/db/s/split_vector.h"
 
+#include <cmath>
+
 #include "mongo/base/status_with.h"
 #include "mongo/db/bson/dotted_path_support.h"
 #include "mongo/db/catalog/index_catalog.h"
@@ -43,6 +45,9 @@
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/query/internal_plans.h"
 #include "mongo/db/query/plan_executor.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/storage/record_store.h"
+#include "mongo/s/shard_key_pattern.h"
 #include "mongo/util/log.h"
 /*
 https://blog.csdn.net/weixin_33827731/article/details/90534750
@@ -54,6 +59,26 @@ namespace {
 
 const int kMaxObjectPerChunk{250000};
 
+// Minimum number of random documents drawn by sampleSplitPoints, which draws more from collections
+// much larger than the max chunk size. Zero disables sampling.
+MONGO_EXPORT_SERVER_PARAMETER(autoSplitSampleSize, int, 1000);
+
+// Random cursors are only unbiased when the sample is a small fraction of the collection, so
+// sampling is only used on collections at least this many times larger than the sample.
+const long long kMinRecordsPerSample{20};
+
+// Minimum number of sampled keys which must fall in each resulting chunk for the estimated split
+// points to be used.
+const long long kMinSampledKeysPerChunk{8};
+
+// Splitting yields at least three chunks, so fewer sampled keys than this in the chunk can neither
+// justify split points nor show that the chunk is small enough to be left alone.
+const long long kMinSampledKeysForEstimate{3 * kMinSampledKeysPerChunk};
+
+// Number of sampled keys expected to fall in a chunk of the max chunk size. The sample is drawn
+// from the whole collection, so it grows with the number of such chunks the collection holds.
+const long long kTargetSampledKeysPerChunk{2 * kMinSampledKeysForEstimate};
+
 BSONObj prettyKey(const BSONObj& keyPattern, const BSONObj& key) {
     return key.replaceFieldNames(keyPattern).clientReadable();
 }
@@ -314,4 +339,147 @@ StatusWith<std::vector<BSONObj>>
     return splitKeys;
 }
 
+StatusWith<boost::optional<std::vector<BSONObj>>> sampleSplitPoints(OperationContext* opCtx,
+                                                                    const NamespaceString& nss,
+                                                                    const BSONObj& keyPattern,
+                                                                    const BSONObj& min,
+                                                                    const BSONObj& max,
+                                                                    long long maxChunkSizeBytes) {
+    if (autoSplitSampleSize.load() <= 0) {
+        return {boost::none};
+    }
+
+    if (maxChunkSizeBytes <= 0) {
+        return {ErrorCodes::InvalidOptions, "need to specify the desired max chunk size"};
+    }
+
+    AutoGetCollection autoColl(opCtx, nss, MODE_IS);
+
+    Collection* const collection = autoColl.getCollection();
+    if (!collection) {
+        return {ErrorCodes::NamespaceNotFound, "ns not found"};
+    }
+
+    const long long recCount = collection->numRecords(opCtx);
+    const long long dataSize = collection->dataSize(opCtx);
+    const long long sampleSize = splitPointSampleSize(recCount, dataSize, maxChunkSizeBytes);
+    if (sampleSize == 0) {
+        LOG(1) << "not sampling split points for chunk " << nss.toString() << " " << redact(min)
+               << " -->> " << redact(max) << ": with " << recCount << " documents of "
+               << dataSize << " bytes, sampling is not cheaper than scanning the chunk";
+        return {boost::none};
+    }
+
+    auto cursor = collection->getRecordStore()->getRandomCursor(opCtx);
+    if (!cursor) {
+        return {boost::none};
+    }
+
+    const ShardKeyPattern shardKeyPattern(keyPattern);
+    const auto isInChunk = [&](const BSONObj& key) {
+        return key.woCompare(min) >= 0 && (max.isEmpty() || key.woCompare(max) < 0);
+    };
+
+    Timer timer;
+    std::vector<BSONObj> sampledKeys;
+    for (long long i = 0; i < sampleSize; i++) {
+        auto record = cursor->next();
+        if (!record) {
+            return {boost::none};
+        }
+
+        BSONObj key = shardKeyPattern.extractShardKeyFromDoc(record->data.toBson());
+        if (!key.isEmpty() && isInChunk(key)) {
+            sampledKeys.push_back(key.getOwned());
+        }
+    }
+
+    const long long numSampled = sampledKeys.size();
+    auto splitKeys = splitPointsFromSample(
+        std::move(sampledKeys), sampleSize, dataSize, min, maxChunkSizeBytes);
+    if (!splitKeys) {
+        LOG(1) << "too few sampled keys (" << numSampled << ") to estimate split points for chunk "
+               << nss.toString() << " " << redact(min) << " -->> " << redact(max);
+        return {boost::none};
+    }
+
+    LOG(1) << "estimated " << splitKeys->size() << " split points for chunk " << nss.toString()
+           << " " << redact(min) << " -->> " << redact(max) << " from " << numSampled << " of "
+           << sampleSize << " sampled documents in " << timer.millis() << "ms";
+
+    return {std::move(splitKeys)};
+}
+
+long long splitPointSampleSize(long long recCount, long long dataSize, long long maxChunkSizeBytes) {
+    invariant(maxChunkSizeBytes > 0);
+
+    const long long minSampleSize = autoSplitSampleSize.load();
+    if (minSampleSize <= 0 || recCount <= 0 || dataSize <= 0) {
+        return 0;
+    }
+
+    const double maxChunks = static_cast<double>(dataSize) / maxChunkSizeBytes;
+    const long long sampleSize = std::max(
+        minSampleSize, static_cast<long long>(std::ceil(maxChunks * kTargetSampledKeysPerChunk)));
+
+    if (recCount < sampleSize * kMinRecordsPerSample) {
+        return 0;
+    }
+
+    // Past the number of documents in a chunk of the max size, scanning the chunk's index range
+    // reads less than the sample would
+    if (static_cast<double>(sampleSize) > recCount / maxChunks) {
+        return 0;
+    }
+
+    return sampleSize;
+}
+
+boost::optional<std::vector<BSONObj>> splitPointsFromSample(std::vector<BSONObj> sampledKeys,
+                                                            long long sampleSize,
+                                                            long long dataSize,
+                                                            const BSONObj& min,
+                                                            long long maxChunkSizeBytes) {
+    invariant(sampleSize > 0);
+    invariant(maxChunkSizeBytes > 0);
+
+    // The share of the sample which falls in the chunk estimates the share of the data it holds,
+    // but a handful of keys says nothing about the chunk's size, not even that it is small
+    const long long numSampled = sampledKeys.size();
+    if (numSampled < kMinSampledKeysForEstimate) {
+        return boost::none;
+    }
+
+    const double estimatedChunkSize =
+        static_cast<double>(dataSize) * numSampled / static_cast<double>(sampleSize);
+
+    std::vector<BSONObj> splitKeys;
+    if (estimatedChunkSize < maxChunkSizeBytes) {
+        return splitKeys;
+    }
+
+    const long long numChunks =
+        static_cast<long long>(estimatedChunkSize / (maxChunkSizeBytes / 2)) + 1;
+    if (numSampled < numChunks * kMinSampledKeysPerChunk) {
+        return boost::none;
+    }
+
+    std::sort(
+        sampledKeys.begin(), sampledKeys.end(), SimpleBSONObjComparator::kInstance.makeLessThan());
+
+    // Take the keys at evenly spaced quantiles of the sample as the split points, skipping any
+    // which would produce an empty chunk
+    for (long long i = 1; i < numChunks; i++) {
+        const BSONObj& key = sampledKeys[i * numSampled / numChunks];
+        if (key.woCompare(min) == 0 ||
+            (!splitKeys.empty() && key.woCompare(splitKeys.back()) == 0)) {
+            continue;
+        }
+
+        splitKeys.push_back(key);
+    }
+
+    return splitKeys;
+}
+
 }  // namespace mongo
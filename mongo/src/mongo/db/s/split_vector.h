@@ -71,4 +71,49 @@ StatusWith<std::vector<BSONObj>> splitVector(OperationContext* opCtx,
                                              boost::optional<long long> maxChunkSize,
                                              boost::optional<long long> maxChunkSizeBytes);
 
+/**
+ * Estimates the split points of a chunk from a random sample of the collection's documents rather
+ * than by scanning the chunk's index range, so the cost is proportional to the sample size and not
+ * to the size of the chunk. The sample size is chosen by splitPointSampleSize. The split points
+ * follow the same rules as splitVector with 'force' unset: no split points if the chunk appears
+ * smaller than maxChunkSizeBytes, otherwise one split point every maxChunkSizeBytes / 2 worth of
+ * estimated data.
+ *
+ * Returns boost::none if splitPointSampleSize returns 0, the storage engine cannot provide a random
+ * cursor, or too few of the sampled documents fall in the chunk for the estimate to be trusted. The
+ * caller should fall back to splitVector then.
+ */
+StatusWith<boost::optional<std::vector<BSONObj>>> sampleSplitPoints(OperationContext* opCtx,
+                                                                    const NamespaceString& nss,
+                                                                    const BSONObj& keyPattern,
+                                                                    const BSONObj& min,
+                                                                    const BSONObj& max,
+                                                                    long long maxChunkSizeBytes);
+
+/**
+ * Returns the number of random documents sampleSplitPoints draws from a collection of 'recCount'
+ * documents and 'dataSize' bytes. It is at least the autoSplitSampleSize server parameter, and
+ * grows with dataSize / maxChunkSizeBytes so that a chunk of the max size can expect enough of the
+ * sampled documents for an estimate.
+ *
+ * Returns 0 if sampling is disabled, the collection is too small to sample without bias, or the
+ * sample would be larger than a chunk of the max size, which is cheaper to scan.
+ */
+long long splitPointSampleSize(long long recCount, long long dataSize, long long maxChunkSizeBytes);
+
+/**
+ * The estimate behind sampleSplitPoints, separated from the sampling so that it can be tested
+ * without a storage engine which provides random cursors. 'sampledKeys' holds the shard keys of
+ * those of 'sampleSize' random documents which fall in the chunk starting at 'min', and 'dataSize'
+ * is the size of the whole collection.
+ *
+ * Returns boost::none if too few of the sampled keys fall in the chunk for the estimate to be
+ * trusted, including to conclude that the chunk needs no split.
+ */
+boost::optional<std::vector<BSONObj>> splitPointsFromSample(std::vector<BSONObj> sampledKeys,
+                                                            long long sampleSize,
+                                                            long long dataSize,
+                                                            const BSONObj& min,
+                                                            long long maxChunkSizeBytes);
+
 }  // namespace mongo
@@ -300,5 +300,118 @@ TEST_F(SplitVectorTest, NoMaxChunkSize) {
     ASSERT_EQUALS(status.code(), ErrorCodes::InvalidOptions);
 }
 
+TEST_F(SplitVectorTest, SampleSplitPointsNoCollection) {
+    auto status = sampleSplitPoints(operationContext(),
+                                    NamespaceString("dummy", "collection"),
+                                    BSON(kPattern << 1),
+                                    BSON(kPattern << 0),
+                                    BSON(kPattern << 100),
+                                    getDocSizeBytes() * 10LL)
+                      .getStatus();
+    ASSERT_EQUALS(status.code(), ErrorCodes::NamespaceNotFound);
+}
+
+TEST_F(SplitVectorTest, SampleSplitPointsFallsBackOnSmallCollection) {
+    // The collection is too small for a random sample to be representative, so the caller is
+    // expected to use splitVector instead
+    auto splitKeys = unittest::assertGet(sampleSplitPoints(operationContext(),
+                                                           kNss,
+                                                           BSON(kPattern << 1),
+                                                           BSON(kPattern << 0),
+                                                           BSON(kPattern << 100),
+                                                           getDocSizeBytes() * 10LL));
+    ASSERT(!splitKeys);
+}
+
+TEST(SplitPointSampleSizeTest, SampleGrowsWithTheNumberOfChunks) {
+    const long long kChunkSize = 64 << 20;
+    const long long kDocSize = 1024;
+
+    // A collection of a few chunks gets the minimum sample
+    ASSERT_EQUALS(1000,
+                  splitPointSampleSize((4 * kChunkSize) / kDocSize, 4 * kChunkSize, kChunkSize));
+
+    // 10GB is 160 chunks, each of which must expect a few dozen sampled keys. That is still far
+    // fewer random reads than the 65536 documents of a full chunk.
+    const long long dataSize = 10LL << 30;
+    const long long sampleSize = splitPointSampleSize(dataSize / kDocSize, dataSize, kChunkSize);
+    ASSERT_GT(sampleSize, 1000);
+    ASSERT_LT(sampleSize, kChunkSize / kDocSize);
+    ASSERT_GTE(sampleSize * kChunkSize / dataSize, 48);
+}
+
+TEST(SplitPointSampleSizeTest, NoSampleWhenScanningIsCheaper) {
+    const long long kChunkSize = 64 << 20;
+
+    // Too few documents to sample without bias
+    ASSERT_EQUALS(0, splitPointSampleSize(10000, 10000LL * 1024, kChunkSize));
+
+    // 16KB documents put only 4096 of them in a chunk, fewer than the 48 * 6400 random reads a
+    // 100GB collection would need
+    const long long dataSize = 100LL << 30;
+    ASSERT_EQUALS(0, splitPointSampleSize(dataSize / (16 * 1024), dataSize, kChunkSize));
+}
+
+TEST(SplitPointsFromSampleTest, SplitPointsAreOrderedUniqueAndWithinTheChunk) {
+    // 1000 sampled documents, all in the chunk [{_id: 0}, {_id: 250}), with many repeated keys and
+    // a tenth of them on the chunk's lower bound, which must never be a split point.
+    std::vector<BSONObj> sampledKeys;
+    for (int i = 0; i < 1000; i++) {
+        sampledKeys.push_back(BSON(kPattern << (i % 10 == 0 ? 0 : (i * 7919) % 250)));
+    }
+    const BSONObj min = BSON(kPattern << 0);
+    const BSONObj max = BSON(kPattern << 250);
+
+    // A 10MB chunk with a 1MB limit is estimated to need 21 chunks
+    auto splitKeys = splitPointsFromSample(sampledKeys, 1000, 10 << 20, min, 1 << 20);
+    ASSERT(splitKeys);
+    ASSERT_GT(splitKeys->size(), 10U);
+    ASSERT_LTE(splitKeys->size(), 20U);
+    for (size_t i = 0; i < splitKeys->size(); i++) {
+        const BSONObj& key = (*splitKeys)[i];
+        ASSERT_GT(key.woCompare(min), 0);
+        ASSERT_LT(key.woCompare(max), 0);
+        if (i > 0) {
+            ASSERT_GT(key.woCompare((*splitKeys)[i - 1]), 0);
+        }
+    }
+}
+
+TEST(SplitPointsFromSampleTest, NoSplitPointsWhenTheChunkIsEstimatedSmall) {
+    std::vector<BSONObj> sampledKeys;
+    for (int i = 0; i < 100; i++) {
+        sampledKeys.push_back(BSON(kPattern << i));
+    }
+
+    // A tenth of a 5MB collection is estimated to be in the chunk, below the 1MB limit
+    auto splitKeys =
+        splitPointsFromSample(sampledKeys, 1000, 5 << 20, BSON(kPattern << 0), 1 << 20);
+    ASSERT(splitKeys);
+    ASSERT(splitKeys->empty());
+}
+
+TEST(SplitPointsFromSampleTest, TooFewSampledKeysAreNotTrusted) {
+    std::vector<BSONObj> sampledKeys;
+    for (int i = 0; i < 50; i++) {
+        sampledKeys.push_back(BSON(kPattern << i));
+    }
+
+    // The chunk is estimated at 100MB, i.e. 201 chunks of which most would hold no sampled key
+    auto splitKeys =
+        splitPointsFromSample(sampledKeys, 100, 200 << 20, BSON(kPattern << 0), 1 << 20);
+    ASSERT(!splitKeys);
+}
+
+TEST(SplitPointsFromSampleTest, NoSampledKeysAreNotTrusted) {
+    // A chunk which no sampled document fell into may still be far over the limit, so it must not
+    // be reported as needing no split
+    auto splitKeys = splitPointsFromSample({}, 1000, 64LL << 30, BSON(kPattern << 0), 64 << 20);
+    ASSERT(!splitKeys);
+
+    std::vector<BSONObj> sampledKeys{BSON(kPattern << 1)};
+    splitKeys = splitPointsFromSample(sampledKeys, 1000, 64LL << 30, BSON(kPattern << 0), 64 << 20);
+    ASSERT(!splitKeys);
+}
+
 }  // namespace
 }  // namespace mongo
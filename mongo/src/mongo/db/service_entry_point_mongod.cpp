@@ -45,6 +45,7 @@
 #include "mongo/db/curop_metrics.h"
 #include "mongo/db/cursor_manager.h"
 #include "mongo/db/dbdirectclient.h"
+#include "mongo/db/ftdc/burst_trigger.h"
 #include "mongo/db/initialize_operation_session_info.h"
 #include "mongo/db/introspect.h"
 #include "mongo/db/jsobj.h"
@@ -53,6 +54,7 @@
 #include "mongo/db/logical_session_id.h"
 #include "mongo/db/logical_session_id_helpers.h"
 #include "mongo/db/logical_time_validator.h"
+#include "mongo/db/operation_trace.h"
 #include "mongo/db/ops/write_ops.h"
 #include "mongo/db/ops/write_ops_exec.h"
 #include "mongo/db/query/find.h"
@@ -67,6 +69,7 @@
 #include "mongo/db/server_options.h"
 #include "mongo/db/session_catalog.h"
 #include "mongo/db/stats/counters.h"
+#include "mongo/db/stats/query_stats_store.h"
 #include "mongo/db/stats/top.h"
 #include "mongo/rpc/factory.h"
 #include "mongo/rpc/metadata.h"
@@ -934,6 +937,8 @@ DbResponse runCommands(OperationContext* opCtx, const Message& message) {
                 stdx::lock_guard<Client> lk(*opCtx->getClient());
                 CurOp::get(opCtx)->setLogicalOp_inlock(c->getLogicalOp());
             }
+            opCtx->lockState()->setLogicalOp(c->getLogicalOp());
+            OperationTrace::maybeSample(opCtx, request.getCommandName(), c->getLogicalOp());
 
             execCommandDatabase(opCtx, c, request, replyBuilder.get());
         } catch (const DBException& ex) {
@@ -1162,6 +1167,29 @@ DbResponse receivedGetMore(OperationContext* opCtx,
     return dbresponse;
 }
 
+/**
+ * Adds the finished operation to the statistics of its query shape. Counters which the operation
+ * did not set are recorded as 0.
+ */
+void recordQueryStats(OperationContext* opCtx, CurOp& currentOp) {
+    const OpDebug& debug = currentOp.debug();
+
+    QueryStatsStore::Execution execution;
+    execution.isGetMore = debug.logicalOp == LogicalOp::opGetMore;
+    execution.micros = debug.executionTimeMicros;
+    execution.docsExamined = std::max(debug.docsExamined, 0LL);
+    execution.keysExamined = std::max(debug.keysExamined, 0LL);
+    execution.nreturned = std::max(debug.nreturned, 0LL);
+    execution.bytesReturned = std::max(debug.responseLength, 0);
+    execution.cpuNanos = std::max(debug.cpuNanos, 0LL);
+    execution.allocBytes = std::max(debug.allocBytes, 0LL);
+    execution.readWriteType = currentOp.getReadWriteType();
+    execution.planSummary = currentOp.getPlanSummary();
+
+    QueryStatsStore::get(opCtx->getServiceContext())
+        .record(debug.queryShapeNs, debug.queryShape, execution);
+}
+
 }  // namespace
 
 /* ݹ̵ջ
@@ -1279,8 +1307,15 @@ DbResponse ServiceEntryPointMongod::handleRequest(OperationContext* opCtx, const
 	//ʱmongodb¼,1Ϊֻ¼,ʱõ,2ʾ¼в  
     bool shouldLogOpDebug = shouldLog(logger::LogSeverity::Debug(1));
 
+    const bool runsCommand = op == dbMsg || op == dbCommand || (op == dbQuery && isCommand);
+    if (!runsCommand) {
+        // Commands are typed and sampled by runCommands() once the command has been identified.
+        opCtx->lockState()->setLogicalOp(networkOpToLogicalOp(op));
+        OperationTrace::maybeSample(opCtx, networkOpToString(op), networkOpToLogicalOp(op));
+    }
+
     DbResponse dbresponse;
-    if (op == dbMsg || op == dbCommand || (op == dbQuery && isCommand)) {
+    if (runsCommand) {
         dbresponse = runCommands(opCtx, m);   //runCommands   °汾 ѯʵ
     } else if (op == dbQuery) {
         invariant(!isCommand);
@@ -1344,6 +1379,15 @@ DbResponse ServiceEntryPointMongod::handleRequest(OperationContext* opCtx, const
             durationCount<Microseconds>(currentOp.elapsedTimeExcludingPauses()),
             currentOp.getReadWriteType());
 
+    // Capture high-frequency diagnostic data if this operation was slow enough to indicate a stall
+    FTDCBurstTrigger::get(opCtx->getServiceContext())
+        ->noteOperationLatency(opCtx->getServiceContext()->getFastClockSource(),
+                               Microseconds(debug.executionTimeMicros));
+
+    if (!debug.queryShape.empty()) {
+        recordQueryStats(opCtx, currentOp);
+    }
+
     const bool shouldSample = serverGlobalParams.sampleRate == 1.0
         ? true
         : c.getPrng().nextCanonicalDouble() < serverGlobalParams.sampleRate;
@@ -0,0 +1,149 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/sorter/sorter.h"
+
+#include <utility>
+#include <vector>
+
+#include "mongo/base/init.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/record_id.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/service_context_noop.h"
+#include "mongo/platform/random.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/unittest/benchmark.h"
+#include "mongo/unittest/temp_dir.h"
+
+// Need access to internal classes
+#include "mongo/db/sorter/sorter.cpp"
+
+namespace mongo {
+namespace {
+
+using unittest::BenchmarkState;
+
+// Stub to avoid including the server environment library.
+MONGO_INITIALIZER(SetGlobalEnvironment)(InitializerContext* context) {
+    setGlobalServiceContext(stdx::make_unique<ServiceContextNoop>());
+    return Status::OK();
+}
+
+/**
+ * Orders index keys and their RecordIds the way an index build does.
+ */
+class IndexKeyComparison {
+public:
+    using Data = std::pair<BSONObj, RecordId>;
+
+    int operator()(const Data& l, const Data& r) const {
+        int x = l.first.woCompare(r.first, _ordering, /*considerfieldname*/ false);
+        if (x) {
+            return x;
+        }
+        return l.second.compare(r.second);
+    }
+
+private:
+    const Ordering _ordering = Ordering::make(BSONObj());
+};
+
+using IndexKeySorter = Sorter<BSONObj, RecordId>;
+
+/**
+ * Returns 'count' compound index keys in random order.
+ */
+std::vector<BSONObj> makeKeys(long long count) {
+    PseudoRandom random(static_cast<int64_t>(count));
+    std::vector<BSONObj> keys;
+    keys.reserve(count);
+    for (long long i = 0; i < count; ++i) {
+        keys.push_back(BSON("" << random.nextInt32(1000) << "" << random.nextInt64() << ""
+                               << "a string in every key"));
+    }
+    return keys;
+}
+
+/**
+ * Sorts the keys and reads them back in order, 'iterations' times.
+ */
+void runSorts(BenchmarkState& state, const std::vector<BSONObj>& keys, const SortOptions& opts) {
+    while (state.keepRunning()) {
+        std::unique_ptr<IndexKeySorter> sorter(
+            IndexKeySorter::make(opts, IndexKeyComparison()));
+        for (std::size_t i = 0; i < keys.size(); ++i) {
+            sorter->add(keys[i], RecordId(i + 1));
+        }
+
+        std::unique_ptr<IndexKeySorter::Iterator> it(sorter->done());
+        while (it->more()) {
+            auto data = it->next();
+            unittest::doNotOptimize(data);
+        }
+    }
+
+    long long bytes = 0;
+    for (auto&& key : keys) {
+        bytes += key.objsize();
+    }
+    state.setItemsProcessed(static_cast<long long>(state.iterations()) * keys.size());
+    state.setBytesProcessed(static_cast<long long>(state.iterations()) * bytes);
+}
+
+void BM_SorterInMemory(BenchmarkState& state) {
+    const auto keys = makeKeys(state.range());
+    runSorts(state, keys, SortOptions());
+}
+
+// Sorts with a memory limit of range(1) KB, so that the sorter spills sorted runs to files and
+// merges them when read back.
+void BM_SorterSpill(BenchmarkState& state) {
+    const auto keys = makeKeys(state.range(0));
+    unittest::TempDir tempDir("sorterBenchmark");
+    runSorts(state,
+             keys,
+             SortOptions()
+                 .ExtSortAllowed()
+                 .MaxMemoryUsageBytes(state.range(1) * 1024)
+                 .TempDir(tempDir.path()));
+}
+
+MONGO_BENCHMARK(BM_SorterInMemory)->range(1024, 256 * 1024);
+MONGO_BENCHMARK(BM_SorterSpill)
+    ->args({64 * 1024, 256})
+    ->args({256 * 1024, 256})
+    ->args({256 * 1024, 1024})
+    ->args({1024 * 1024, 4096});
+
+}  // namespace
+}  // namespace mongo
+
+MONGO_CREATE_SORTER(mongo::BSONObj, mongo::RecordId, mongo::IndexKeyComparison);
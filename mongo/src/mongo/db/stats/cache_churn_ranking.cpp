@@ -0,0 +1,137 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/stats/cache_churn_ranking.h"
+
+#include <algorithm>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/index/index_descriptor.h"
+#include "mongo/db/namespace_string.h"
+
+namespace mongo {
+
+void CacheChurnRanking::update(const std::vector<BSONObj>& sample,
+                               const std::vector<std::string>& sampledDbNames,
+                               size_t n) {
+    std::vector<Entry> entries;
+
+    // Every table starts out as missed, and is marked as seen once found in 'sample'.
+    for (auto&& previous : _previous) {
+        const StringData ns(previous.first.c_str());
+        if (std::find(sampledDbNames.begin(), sampledDbNames.end(), nsToDatabaseSubstring(ns)) !=
+            sampledDbNames.end()) {
+            ++previous.second.missedSamples;
+        }
+    }
+
+    auto addTable = [&](StringData ns, StringData index, const BSONObj& stats) {
+        if (!stats.hasField("pagesReadIntoCache")) {
+            // The table's statistics couldn't be read, which tells nothing of its churn.
+            return;
+        }
+
+        Counters counters;
+        counters.pagesRead = stats["pagesReadIntoCache"].safeNumberLong();
+        counters.pagesEvicted = stats["unmodifiedPagesEvicted"].safeNumberLong() +
+            stats["modifiedPagesEvicted"].safeNumberLong();
+
+        std::string key = ns.toString();
+        key.push_back('\0');
+        key.append(index.rawData(), index.size());
+
+        Entry entry;
+        entry.ns = ns.toString();
+        entry.index = index.toString();
+        entry.bytesInCache = stats["bytesInCache"].safeNumberLong();
+
+        auto previous = _previous.find(key);
+        if (previous == _previous.end()) {
+            // Nothing is known of the table's churn until there is a baseline to compare with.
+            _previous[key] = counters;
+        } else {
+            if (counters.pagesRead >= previous->second.pagesRead &&
+                counters.pagesEvicted >= previous->second.pagesEvicted) {
+                entry.pagesRead = counters.pagesRead - previous->second.pagesRead;
+                entry.pagesEvicted = counters.pagesEvicted - previous->second.pagesEvicted;
+            } else {
+                entry.pagesRead = counters.pagesRead;
+                entry.pagesEvicted = counters.pagesEvicted;
+            }
+            previous->second = counters;
+        }
+
+        entries.push_back(std::move(entry));
+    };
+
+    for (auto&& collection : sample) {
+        const StringData ns = collection["ns"].valueStringData();
+        addTable(ns, StringData(), collection["collection"].Obj());
+        for (auto&& index : collection["indexes"].Obj()) {
+            addTable(ns, index.fieldNameStringData(), index.Obj());
+        }
+    }
+
+    // Forget the baselines of tables which have been dropped, e.g. temporary collections.
+    std::vector<std::string> dropped;
+    for (auto&& previous : _previous) {
+        if (previous.second.missedSamples >= kMaxMissedSamples) {
+            dropped.push_back(previous.first);
+        }
+    }
+    for (auto&& key : dropped) {
+        _previous.erase(key);
+    }
+
+    const size_t rankedSize = std::min(n, entries.size());
+    std::partial_sort(entries.begin(),
+                      entries.begin() + rankedSize,
+                      entries.end(),
+                      [](const Entry& lhs, const Entry& rhs) {
+                          return lhs.pagesRead + lhs.pagesEvicted >
+                              rhs.pagesRead + rhs.pagesEvicted;
+                      });
+    entries.resize(rankedSize);
+
+    _ranking = std::move(entries);
+}
+
+void CacheChurnRanking::append(BSONObjBuilder* builder) const {
+    for (auto&& entry : _ranking) {
+        BSONObjBuilder entryBuilder(builder->subobjStart(
+            entry.index.empty() ? entry.ns
+                                : IndexDescriptor::makeIndexNamespace(entry.ns, entry.index)));
+        entryBuilder.append("bytesInCache", entry.bytesInCache);
+        entryBuilder.append("pagesReadIntoCache", entry.pagesRead);
+        entryBuilder.append("pagesEvicted", entry.pagesEvicted);
+    }
+}
+
+}  // namespace mongo
@@ -0,0 +1,102 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/util/string_map.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+
+/**
+ * Ranks the collections and indexes of a node by their cache churn, which is the number of their
+ * pages read into the storage engine's cache plus the number of their pages evicted from it between
+ * two samples. Tables with a lot of churn are the ones thrashing the cache.
+ *
+ * This class is not thread-safe.
+ */
+class CacheChurnRanking {
+public:
+    /**
+     * Replaces the ranking with the 'n' tables of 'sample' which churned the most since they were
+     * last sampled. 'sample' holds one document per collection of the databases 'sampledDbNames'
+     * as returned by getCacheResidencyStats(). Tables which an earlier sample held but 'sample'
+     * leaves out, e.g. those of databases whose lock wasn't free or whose statistics couldn't be
+     * read, keep their counters as the baseline of their next sample, unless they have been left
+     * out of kMaxMissedSamples samples of their database in a row, i.e. they were most likely
+     * dropped. Tables sampled for the first time have no churn yet. The storage engine's counters
+     * start from 0 whenever it reopens a table, so for tables whose counters went backwards,
+     * everything counted in 'sample' is taken as churn.
+     */
+    void update(const std::vector<BSONObj>& sample,
+                const std::vector<std::string>& sampledDbNames,
+                size_t n);
+
+    /**
+     * Appends the ranking, most churn first, as one subdocument per table with its bytes in cache
+     * and its pages read into and evicted from the cache since the previous sample. Subdocuments
+     * are named after the table's namespace, or for an index after its index namespace
+     * (<ns>.$<index name>), so that a change in which tables are ranked, or in their order, is a
+     * change in the shape of the section which FTDC does not miss.
+     */
+    void append(BSONObjBuilder* builder) const;
+
+    /**
+     * The number of consecutive samples of its database which a table can be missing from before
+     * its baseline is forgotten.
+     */
+    static const int kMaxMissedSamples = 3;
+
+private:
+    struct Counters {
+        long long pagesRead = 0;
+        long long pagesEvicted = 0;
+        int missedSamples = 0;
+    };
+
+    struct Entry {
+        std::string ns;
+        std::string index;
+        long long bytesInCache = 0;
+        long long pagesRead = 0;
+        long long pagesEvicted = 0;
+    };
+
+    // Counters of every table when it was last sampled, keyed by the namespace and index name
+    // separated by a NUL byte.
+    StringMap<Counters> _previous;
+
+    std::vector<Entry> _ranking;
+};
+
+}  // namespace mongo
@@ -0,0 +1,169 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/stats/cache_churn_ranking.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+BSONObj tableStats(long long bytesInCache, long long pagesRead, long long pagesEvicted) {
+    return BSON("bytesInCache" << bytesInCache << "pagesReadIntoCache" << pagesRead
+                               << "unmodifiedPagesEvicted"
+                               << pagesEvicted
+                               << "modifiedPagesEvicted"
+                               << 0);
+}
+
+BSONObj collectionStats(StringData ns, BSONObj collection, BSONObj indexes) {
+    return BSON("ns" << ns << "collection" << collection << "indexes" << indexes);
+}
+
+BSONObj rankingOf(const CacheChurnRanking& ranking) {
+    BSONObjBuilder builder;
+    ranking.append(&builder);
+    return builder.obj();
+}
+
+BSONObj rankedTable(long long bytesInCache, long long pagesRead, long long pagesEvicted) {
+    return BSON("bytesInCache" << bytesInCache << "pagesReadIntoCache" << pagesRead
+                               << "pagesEvicted"
+                               << pagesEvicted);
+}
+
+TEST(CacheChurnRankingTest, TablesAreRankedByChurnSinceThePreviousSample) {
+    CacheChurnRanking ranking;
+    ranking.update(
+        {collectionStats("test.a", tableStats(100, 10, 0), BSON("_id_" << tableStats(50, 1, 1))),
+         collectionStats("test.b", tableStats(200, 5, 0), BSONObj())},
+        {"test"},
+        3);
+
+    // The first sample is only a baseline, whatever the tables counted before it.
+    auto top = rankingOf(ranking);
+    ASSERT_EQ(3, top.nFields());
+    for (auto&& entry : top) {
+        ASSERT_EQ(0LL, entry["pagesReadIntoCache"].numberLong());
+        ASSERT_EQ(0LL, entry["pagesEvicted"].numberLong());
+    }
+
+    // Only the index of test.a churns between the samples.
+    ranking.update(
+        {collectionStats("test.a", tableStats(100, 10, 0), BSON("_id_" << tableStats(40, 4, 8))),
+         collectionStats("test.b", tableStats(200, 5, 0), BSONObj())},
+        {"test"},
+        1);
+    ASSERT_BSONOBJ_EQ(rankingOf(ranking), BSON("test.a.$_id_" << rankedTable(40, 3, 7)));
+}
+
+TEST(CacheChurnRankingTest, ReorderingTheRankingChangesItsFieldNames) {
+    CacheChurnRanking ranking;
+    ranking.update({collectionStats("test.a", tableStats(100, 0, 0), BSONObj()),
+                    collectionStats("test.b", tableStats(100, 0, 0), BSONObj())},
+                   {"test"},
+                   1);
+    ranking.update({collectionStats("test.a", tableStats(100, 5, 0), BSONObj()),
+                    collectionStats("test.b", tableStats(100, 1, 0), BSONObj())},
+                   {"test"},
+                   1);
+    ASSERT_BSONOBJ_EQ(rankingOf(ranking), BSON("test.a" << rankedTable(100, 5, 0)));
+
+    ranking.update({collectionStats("test.a", tableStats(100, 6, 0), BSONObj()),
+                    collectionStats("test.b", tableStats(100, 9, 0), BSONObj())},
+                   {"test"},
+                   1);
+    ASSERT_BSONOBJ_EQ(rankingOf(ranking), BSON("test.b" << rankedTable(100, 8, 0)));
+}
+
+TEST(CacheChurnRankingTest, TablesMissingFromASampleKeepTheirBaseline) {
+    CacheChurnRanking ranking;
+    ranking.update({collectionStats("test.a", tableStats(100, 10, 0), BSONObj()),
+                    collectionStats("other.b", tableStats(200, 50, 50), BSONObj())},
+                   {"test", "other"},
+                   2);
+
+    // other.b is left out, as when its database lock isn't free.
+    for (int i = 0; i < CacheChurnRanking::kMaxMissedSamples; ++i) {
+        ranking.update({collectionStats("test.a", tableStats(100, 12 + i, 0), BSONObj())},
+                       {"test"},
+                       2);
+    }
+    ASSERT_BSONOBJ_EQ(rankingOf(ranking), BSON("test.a" << rankedTable(100, 1, 0)));
+
+    // other.b's churn is counted from the first sample rather than from its lifetime counters.
+    ranking.update({collectionStats("test.a", tableStats(100, 14, 0), BSONObj()),
+                    collectionStats("other.b", tableStats(200, 54, 51), BSONObj())},
+                   {"test", "other"},
+                   2);
+    ASSERT_BSONOBJ_EQ(rankingOf(ranking),
+                      BSON("other.b" << rankedTable(200, 4, 1) << "test.a"
+                                     << rankedTable(100, 0, 0)));
+}
+
+TEST(CacheChurnRankingTest, TablesWhoseStatisticsCannotBeReadKeepTheirBaseline) {
+    CacheChurnRanking ranking;
+    ranking.update({collectionStats("test.a", tableStats(100, 10, 0), BSONObj())}, {"test"}, 1);
+
+    ranking.update({collectionStats("test.a", BSONObj(), BSONObj())}, {"test"}, 1);
+    ASSERT_BSONOBJ_EQ(rankingOf(ranking), BSONObj());
+
+    ranking.update({collectionStats("test.a", tableStats(100, 11, 0), BSONObj())}, {"test"}, 1);
+    ASSERT_BSONOBJ_EQ(rankingOf(ranking), BSON("test.a" << rankedTable(100, 1, 0)));
+}
+
+TEST(CacheChurnRankingTest, DroppedTablesAreForgotten) {
+    CacheChurnRanking ranking;
+    ranking.update({collectionStats("test.tmp", tableStats(100, 50, 0), BSONObj())}, {"test"}, 1);
+
+    // test.tmp is gone from as many samples of its database as it takes to forget it.
+    for (int i = 0; i < CacheChurnRanking::kMaxMissedSamples; ++i) {
+        ranking.update({}, {"test"}, 1);
+    }
+
+    // A collection created with the same name starts over from a new baseline.
+    ranking.update({collectionStats("test.tmp", tableStats(100, 70, 0), BSONObj())}, {"test"}, 1);
+    ASSERT_BSONOBJ_EQ(rankingOf(ranking), BSON("test.tmp" << rankedTable(100, 0, 0)));
+}
+
+TEST(CacheChurnRankingTest, CountersWhichWentBackwardsAreTakenAsChurn) {
+    CacheChurnRanking ranking;
+    ranking.update({collectionStats("test.a", tableStats(100, 50, 50), BSONObj())}, {"test"}, 1);
+
+    // The table was closed and reopened, which restarted its counters.
+    ranking.update({collectionStats("test.a", tableStats(10, 3, 0), BSONObj())}, {"test"}, 1);
+    auto top = rankingOf(ranking);
+    ASSERT_EQ(3LL, top["test.a"]["pagesReadIntoCache"].numberLong());
+    ASSERT_EQ(0LL, top["test.a"]["pagesEvicted"].numberLong());
+}
+
+}  // namespace
+}  // namespace mongo
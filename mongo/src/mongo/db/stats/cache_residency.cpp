@@ -0,0 +1,158 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/stats/cache_residency.h"
+
+#include <list>
+#include <string>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/catalog/database_catalog_entry.h"
+#include "mongo/db/commands/server_status.h"
+#include "mongo/db/concurrency/d_concurrency.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/stats/cache_churn_ranking.h"
+#include "mongo/db/storage/storage_engine.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/scopeguard.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+namespace {
+
+// How often the cacheResidency server status section samples the cache use of every collection and
+// index. Between samples the section repeats the previous ranking.
+MONGO_EXPORT_SERVER_PARAMETER(cacheResidencySampleIntervalSecs, int, 60);
+
+// The number of collections and indexes with the most cache churn which the cacheResidency server
+// status section reports. 0 leaves the section out of serverStatus, and therefore out of FTDC.
+MONGO_EXPORT_SERVER_PARAMETER(cacheResidencyTopN, int, 10);
+
+}  // namespace
+
+std::vector<BSONObj> getCacheResidencyStats(OperationContext* opCtx,
+                                            unsigned lockTimeoutMs,
+                                            std::vector<std::string>* sampledDbNames) {
+    std::vector<BSONObj> stats;
+
+    Lock::GlobalLock globalLock(opCtx, MODE_IS, lockTimeoutMs);
+    if (!globalLock.isLocked()) {
+        return stats;
+    }
+
+    const Milliseconds dbLockTimeout =
+        lockTimeoutMs == UINT_MAX ? Milliseconds::max() : Milliseconds(lockTimeoutMs);
+
+    StorageEngine* storageEngine = opCtx->getServiceContext()->getGlobalStorageEngine();
+    std::vector<std::string> dbNames;
+    storageEngine->listDatabases(&dbNames);
+
+    for (auto&& dbName : dbNames) {
+        const ResourceId dbResource(RESOURCE_DATABASE, dbName);
+        if (opCtx->lockState()->lock(dbResource, MODE_IS, dbLockTimeout) != LOCK_OK) {
+            continue;
+        }
+        ON_BLOCK_EXIT([&] { opCtx->lockState()->unlock(dbResource); });
+        if (sampledDbNames) {
+            sampledDbNames->push_back(dbName);
+        }
+
+        DatabaseCatalogEntry* dbEntry = storageEngine->getDatabaseCatalogEntry(opCtx, dbName);
+        std::list<std::string> collectionNames;
+        dbEntry->getCollectionNamespaces(&collectionNames);
+
+        for (auto&& ns : collectionNames) {
+            BSONObjBuilder builder;
+            builder.append("ns", ns);
+            if (!storageEngine->appendCacheStats(opCtx, ns, &builder)) {
+                // The storage engine reports nothing for any collection.
+                return stats;
+            }
+            stats.push_back(builder.obj());
+        }
+    }
+
+    return stats;
+}
+
+namespace {
+
+/**
+ * Reports the collections and indexes which cause the most cache churn, so that FTDC records which
+ * ones thrash the cache. Sampling every collection is only done every
+ * cacheResidencySampleIntervalSecs, and never waits for a database lock, so that serverStatus
+ * cannot be held up by it.
+ */
+class CacheResidencyServerStatusSection final : public ServerStatusSection {
+public:
+    CacheResidencyServerStatusSection() : ServerStatusSection("cacheResidency") {}
+
+    bool includeByDefault() const {
+        return cacheResidencyTopN.load() > 0;
+    }
+
+    BSONObj generateSection(OperationContext* opCtx, const BSONElement& configElem) const {
+        const int topN = cacheResidencyTopN.load();
+        if (topN <= 0) {
+            return BSONObj();
+        }
+
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        const Date_t now = Date_t::now();
+        if (_lastSample == Date_t() ||
+            now - _lastSample >= Seconds(cacheResidencySampleIntervalSecs.load())) {
+            std::vector<std::string> sampledDbNames;
+            const auto sample = getCacheResidencyStats(opCtx, 0, &sampledDbNames);
+            _ranking.update(sample, sampledDbNames, static_cast<size_t>(topN));
+            _numCollections = sample.size();
+            _lastSample = now;
+        }
+
+        BSONObjBuilder builder;
+        builder.append("sampledAt", _lastSample);
+        builder.appendNumber("collections", static_cast<long long>(_numCollections));
+        BSONObjBuilder topBuilder(builder.subobjStart("topByChurn"));
+        _ranking.append(&topBuilder);
+        topBuilder.doneFast();
+        return builder.obj();
+    }
+
+private:
+    mutable stdx::mutex _mutex;
+    mutable CacheChurnRanking _ranking;
+    mutable size_t _numCollections = 0;
+    mutable Date_t _lastSample;
+} cacheResidencyServerStatusSection;
+
+}  // namespace
+}  // namespace mongo
@@ -0,0 +1,57 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#pragma once
+
+#include <climits>
+#include <vector>
+
+#include "mongo/bson/bsonobj.h"
+
+namespace mongo {
+
+class OperationContext;
+
+/**
+ * Returns one document per collection on this node, of the form
+ *
+ *     {ns: <string>, collection: {<stats>}, indexes: {<index name>: {<stats>}, ...}}
+ *
+ * describing how much of the collection and of each of its indexes is held in the storage engine's
+ * cache, as reported by StorageEngine::appendCacheStats(). Returns no documents if the storage
+ * engine does not report this.
+ *
+ * Each database is locked in intent shared mode while its collections are read. Databases whose
+ * lock cannot be acquired within 'lockTimeoutMs' are skipped. If 'sampledDbNames' is not null, the
+ * names of the databases which were not skipped are appended to it.
+ */
+std::vector<BSONObj> getCacheResidencyStats(OperationContext* opCtx,
+                                            unsigned lockTimeoutMs = UINT_MAX,
+                                            std::vector<std::string>* sampledDbNames = nullptr);
+
+}  // namespace mongo
@@ -263,4 +263,77 @@ void OperationLatencyHistogram::increment(uint64_t latency, Command::ReadWriteTy
     }
 }
 
+AtomicOperationLatencyHistogram::HistogramData* AtomicOperationLatencyHistogram::_getData(
+    Command::ReadWriteType type) {
+    switch (type) {
+        case Command::ReadWriteType::kRead:
+            return &_reads;
+        case Command::ReadWriteType::kWrite:
+            return &_writes;
+        case Command::ReadWriteType::kCommand:
+            return &_commands;
+        default:
+            MONGO_UNREACHABLE;
+    }
+}
+
+void AtomicOperationLatencyHistogram::increment(uint64_t latency, Command::ReadWriteType type) {
+    HistogramData* data = _getData(type);
+    data->buckets[OperationLatencyHistogram::_getBucket(latency)].fetchAndAdd(1);
+    data->entryCount.fetchAndAdd(1);
+    data->sum.fetchAndAdd(latency);
+}
+
+void AtomicOperationLatencyHistogram::incrementBucket(uint64_t latency,
+                                                      Command::ReadWriteType type) {
+    _getData(type)->buckets[OperationLatencyHistogram::_getBucket(latency)].fetchAndAdd(1);
+}
+
+void AtomicOperationLatencyHistogram::addTo(OperationLatencyHistogram* histogram) const {
+    _addTo(_reads, &histogram->_reads);
+    _addTo(_writes, &histogram->_writes);
+    _addTo(_commands, &histogram->_commands);
+}
+
+void AtomicOperationLatencyHistogram::_addTo(const HistogramData& data,
+                                             OperationLatencyHistogram::HistogramData* out) {
+    for (int i = 0; i < OperationLatencyHistogram::kMaxBuckets; i++) {
+        out->buckets[i] += data.buckets[i].loadRelaxed();
+    }
+    out->entryCount += data.entryCount.loadRelaxed();
+    out->sum += data.sum.loadRelaxed();
+}
+
+void AtomicOperationLatencyTotals::increment(uint64_t latency, Command::ReadWriteType type) {
+    Totals* totals;
+    switch (type) {
+        case Command::ReadWriteType::kRead:
+            totals = &_reads;
+            break;
+        case Command::ReadWriteType::kWrite:
+            totals = &_writes;
+            break;
+        case Command::ReadWriteType::kCommand:
+            totals = &_commands;
+            break;
+        default:
+            MONGO_UNREACHABLE;
+    }
+
+    totals->entryCount.fetchAndAdd(1);
+    totals->sum.fetchAndAdd(latency);
+}
+
+void AtomicOperationLatencyTotals::addTo(OperationLatencyHistogram* histogram) const {
+    _addTo(_reads, &histogram->_reads);
+    _addTo(_writes, &histogram->_writes);
+    _addTo(_commands, &histogram->_commands);
+}
+
+void AtomicOperationLatencyTotals::_addTo(const Totals& totals,
+                                          OperationLatencyHistogram::HistogramData* out) {
+    out->entryCount += totals.entryCount.loadRelaxed();
+    out->sum += totals.sum.loadRelaxed();
+}
+
 }  // namespace mongo
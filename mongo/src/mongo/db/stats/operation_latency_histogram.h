@@ -30,6 +30,7 @@
 #include <array>
 
 #include "mongo/db/commands.h"
+#include "mongo/platform/atomic_word.h"
 
 namespace mongo {
 
@@ -68,6 +69,9 @@ public:
     void append(bool includeHistograms, BSONObjBuilder* builder) const;
 
 private:
+    friend class AtomicOperationLatencyHistogram;
+    friend class AtomicOperationLatencyTotals;
+
     struct HistogramData {
         std::array<uint64_t, kMaxBuckets> buckets{};
         uint64_t entryCount = 0;
@@ -87,4 +91,70 @@ private:
 
     HistogramData _reads, _writes, _commands;
 };
+
+/**
+ * Stores the same statistics as OperationLatencyHistogram, but may be incremented by several
+ * threads at once without a lock: each increment is three atomic additions. The statistics are
+ * read by adding them into an OperationLatencyHistogram.
+ */
+class AtomicOperationLatencyHistogram {
+public:
+    /**
+     * Increments the bucket of the histogram based on the operation type.
+     */
+    void increment(uint64_t latency, Command::ReadWriteType type);
+
+    /**
+     * Increments only the bucket, leaving the operation count and latency total to be kept in an
+     * AtomicOperationLatencyTotals.
+     */
+    void incrementBucket(uint64_t latency, Command::ReadWriteType type);
+
+    /**
+     * Adds the current contents of this histogram to 'histogram'.
+     */
+    void addTo(OperationLatencyHistogram* histogram) const;
+
+private:
+    struct HistogramData {
+        std::array<AtomicUInt64, OperationLatencyHistogram::kMaxBuckets> buckets;
+        AtomicUInt64 entryCount;
+        AtomicUInt64 sum;
+    };
+
+    HistogramData* _getData(Command::ReadWriteType type);
+
+    static void _addTo(const HistogramData& data, OperationLatencyHistogram::HistogramData* out);
+
+    HistogramData _reads, _writes, _commands;
+};
+
+/**
+ * The operation counts and latency totals of an AtomicOperationLatencyHistogram, for callers which
+ * share one histogram between several threads but give each group of threads its own totals. Every
+ * operation adds to the totals, while it only adds to the bucket of its latency, so the totals are
+ * where the threads contend most.
+ */
+class AtomicOperationLatencyTotals {
+public:
+    /**
+     * Counts an operation of the specified type and latency.
+     */
+    void increment(uint64_t latency, Command::ReadWriteType type);
+
+    /**
+     * Adds the current totals to those of 'histogram'.
+     */
+    void addTo(OperationLatencyHistogram* histogram) const;
+
+private:
+    struct Totals {
+        AtomicUInt64 entryCount;
+        AtomicUInt64 sum;
+    };
+
+    static void _addTo(const Totals& totals, OperationLatencyHistogram::HistogramData* out);
+
+    Totals _reads, _writes, _commands;
+};
 }  // namespace mongo
@@ -89,4 +89,50 @@ TEST(OperationLatencyHistogram, CheckBucketCountsAndTotalLatency) {
         ASSERT_EQUALS(bucket["count"].Long(), (i < kMaxBuckets - 1) ? 3 : 2);
     }
 }
+TEST(OperationLatencyHistogram, AtomicHistogramMatchesHistogram) {
+    OperationLatencyHistogram hist;
+    AtomicOperationLatencyHistogram atomicHist;
+    for (int i = 0; i < kMaxBuckets; i++) {
+        for (auto type : {Command::ReadWriteType::kRead,
+                          Command::ReadWriteType::kWrite,
+                          Command::ReadWriteType::kCommand}) {
+            hist.increment(kLowerBounds[i] + i, type);
+            atomicHist.increment(kLowerBounds[i] + i, type);
+        }
+    }
+
+    OperationLatencyHistogram fromAtomic;
+    atomicHist.addTo(&fromAtomic);
+    BSONObjBuilder expected;
+    hist.append(true, &expected);
+    BSONObjBuilder actual;
+    fromAtomic.append(true, &actual);
+    ASSERT_BSONOBJ_EQ(expected.obj(), actual.obj());
+}
+
+TEST(OperationLatencyHistogram, AtomicHistogramWithSplitTotalsMatchesHistogram) {
+    OperationLatencyHistogram hist;
+    AtomicOperationLatencyHistogram atomicHist;
+    std::array<AtomicOperationLatencyTotals, 3> atomicTotals;
+    for (int i = 0; i < kMaxBuckets; i++) {
+        for (auto type : {Command::ReadWriteType::kRead,
+                          Command::ReadWriteType::kWrite,
+                          Command::ReadWriteType::kCommand}) {
+            hist.increment(kLowerBounds[i] + i, type);
+            atomicHist.incrementBucket(kLowerBounds[i] + i, type);
+            atomicTotals[i % atomicTotals.size()].increment(kLowerBounds[i] + i, type);
+        }
+    }
+
+    OperationLatencyHistogram fromAtomic;
+    atomicHist.addTo(&fromAtomic);
+    for (auto&& totals : atomicTotals) {
+        totals.addTo(&fromAtomic);
+    }
+    BSONObjBuilder expected;
+    hist.append(true, &expected);
+    BSONObjBuilder actual;
+    fromAtomic.append(true, &actual);
+    ASSERT_BSONOBJ_EQ(expected.obj(), actual.obj());
+}
 }  // namespace mongo
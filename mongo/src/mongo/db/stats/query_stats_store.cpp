@@ -0,0 +1,178 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/stats/query_stats_store.h"
+
+#include <algorithm>
+#include <functional>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/service_context.h"
+
+namespace mongo {
+
+namespace {
+
+// The maximum number of query shapes kept in the store. 0 disables recording.
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryStatsStoreSize, int, 1000);
+
+const auto getQueryStatsStore = ServiceContext::declareDecoration<QueryStatsStore>();
+
+}  // namespace
+
+QueryStatsStore& QueryStatsStore::get(ServiceContext* service) {
+    return getQueryStatsStore(service);
+}
+
+bool QueryStatsStore::isEnabled() {
+    return internalQueryStatsStoreSize.load() > 0;
+}
+
+void QueryStatsStore::record(StringData ns, StringData shape, const Execution& execution) {
+    const int maxShapes = internalQueryStatsStoreSize.load();
+    if (maxShapes <= 0) {
+        return;
+    }
+    const size_t partitionCapacity =
+        std::max<size_t>(1, (maxShapes + kNumPartitions - 1) / kNumPartitions);
+
+    std::string key;
+    key.reserve(ns.size() + 1 + shape.size());
+    key.append(ns.rawData(), ns.size());
+    key.push_back('\0');
+    key.append(shape.rawData(), shape.size());
+
+    const Date_t now = Date_t::now();
+    auto& partition = _partitions[std::hash<std::string>()(key) % kNumPartitions];
+    size_t evicted = 0;
+    {
+        stdx::lock_guard<stdx::mutex> lk(partition.mutex);
+        auto it = partition.shapes.find(key);
+        if (it == partition.shapes.end()) {
+            while (partition.shapes.size() >= partitionCapacity) {
+                partition.shapes.erase(std::prev(partition.shapes.end()));
+                ++evicted;
+            }
+
+            ShapeStats newStats;
+            newStats.nsLength = ns.size();
+            newStats.firstSeen = now;
+            newStats.minExecMicros = execution.micros;
+            partition.shapes.add(key, std::move(newStats));
+            it = partition.shapes.begin();
+        }
+
+        ShapeStats& stats = it->second;
+        stats.lastSeen = now;
+        if (execution.isGetMore) {
+            stats.getMoreCount++;
+        } else {
+            stats.execCount++;
+        }
+        stats.totalExecMicros += execution.micros;
+        stats.minExecMicros = std::min(stats.minExecMicros, execution.micros);
+        stats.maxExecMicros = std::max(stats.maxExecMicros, execution.micros);
+        stats.docsExamined += execution.docsExamined;
+        stats.keysExamined += execution.keysExamined;
+        stats.nreturned += execution.nreturned;
+        stats.bytesReturned += execution.bytesReturned;
+        stats.totalCpuNanos += execution.cpuNanos;
+        stats.totalAllocBytes += execution.allocBytes;
+        if (!execution.planSummary.empty() && execution.planSummary != stats.lastPlanSummary) {
+            stats.lastPlanSummary = execution.planSummary.toString();
+        }
+        stats.latencies.increment(execution.micros, execution.readWriteType);
+    }
+
+    _recorded.fetchAndAdd(1);
+    if (evicted) {
+        _evicted.fetchAndAdd(evicted);
+    }
+}
+
+std::vector<BSONObj> QueryStatsStore::getStats(bool includeHistograms) const {
+    std::vector<BSONObj> result;
+    for (auto&& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> lk(partition.mutex);
+        for (auto&& entry : partition.shapes) {
+            result.push_back(_toBSON(entry.first, entry.second, includeHistograms));
+        }
+    }
+    return result;
+}
+
+void QueryStatsStore::appendSummary(BSONObjBuilder* builder) const {
+    long long numShapes = 0;
+    for (auto&& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> lk(partition.mutex);
+        numShapes += partition.shapes.size();
+    }
+    builder->appendNumber("shapes", numShapes);
+    builder->appendNumber("recorded", static_cast<long long>(_recorded.load()));
+    builder->appendNumber("evicted", static_cast<long long>(_evicted.load()));
+}
+
+void QueryStatsStore::clear() {
+    for (auto&& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> lk(partition.mutex);
+        partition.shapes.clear();
+    }
+}
+
+BSONObj QueryStatsStore::_toBSON(const std::string& key,
+                                 const ShapeStats& stats,
+                                 bool includeHistograms) {
+    BSONObjBuilder builder;
+    builder.append("ns", StringData(key.data(), stats.nsLength));
+    builder.append("queryShape", StringData(key).substr(stats.nsLength + 1));
+    builder.append("firstSeen", stats.firstSeen);
+    builder.append("lastSeen", stats.lastSeen);
+    builder.append("execCount", stats.execCount);
+    builder.append("getMoreCount", stats.getMoreCount);
+    builder.append("totalExecMicros", stats.totalExecMicros);
+    builder.append("minExecMicros", stats.minExecMicros);
+    builder.append("maxExecMicros", stats.maxExecMicros);
+    builder.append("docsExamined", stats.docsExamined);
+    builder.append("keysExamined", stats.keysExamined);
+    builder.append("nreturned", stats.nreturned);
+    builder.append("bytesReturned", stats.bytesReturned);
+    builder.append("totalCpuNanos", stats.totalCpuNanos);
+    builder.append("totalAllocBytes", stats.totalAllocBytes);
+    builder.append("lastPlanSummary", stats.lastPlanSummary);
+    {
+        BSONObjBuilder latencyBuilder(builder.subobjStart("latencyStats"));
+        stats.latencies.append(includeHistograms, &latencyBuilder);
+    }
+    return builder.obj();
+}
+
+}  // namespace mongo
@@ -0,0 +1,156 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+
+#pragma once
+
+#include <array>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/commands.h"
+#include "mongo/db/stats/operation_latency_histogram.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/lru_cache.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+class ServiceContext;
+
+/**
+ * Accumulates execution statistics per query shape, where a shape is a namespace together with the
+ * plan cache key of a query on it. Operations are recorded when they finish, so the most expensive
+ * shapes can be found without turning on the profiler.
+ *
+ * The store holds at most 'internalQueryStatsStoreSize' shapes, evicting the least recently
+ * recorded ones, and is split into partitions with their own mutexes so that concurrent operations
+ * rarely contend. Setting the parameter to 0 stops recording.
+ *
+ * This class is thread-safe.
+ */
+class QueryStatsStore {
+    MONGO_DISALLOW_COPYING(QueryStatsStore);
+
+public:
+    static const size_t kNumPartitions = 16;
+
+    static QueryStatsStore& get(ServiceContext* service);
+
+    /**
+     * Returns true if executions should be recorded. Callers use this to avoid computing the shape
+     * of queries when the store is disabled.
+     */
+    static bool isEnabled();
+
+    /**
+     * The measurements taken from a single operation on a query, which is either the command that
+     * started it or a getMore fetching further results from its cursor.
+     */
+    struct Execution {
+        bool isGetMore = false;
+        long long micros = 0;
+        long long docsExamined = 0;
+        long long keysExamined = 0;
+        long long nreturned = 0;
+        long long bytesReturned = 0;
+        long long cpuNanos = 0;
+        long long allocBytes = 0;
+        Command::ReadWriteType readWriteType = Command::ReadWriteType::kRead;
+        StringData planSummary;
+    };
+
+    QueryStatsStore() = default;
+
+    /**
+     * Adds 'execution' to the statistics of the query shape 'shape' on 'ns', creating them if this
+     * is the first execution seen for the shape.
+     */
+    void record(StringData ns, StringData shape, const Execution& execution);
+
+    /**
+     * Returns one document per query shape, with the latency histograms included if
+     * 'includeHistograms' is true. Each partition is locked only while it is being copied.
+     */
+    std::vector<BSONObj> getStats(bool includeHistograms) const;
+
+    /**
+     * Appends the number of shapes held and the counts of executions recorded and shapes evicted.
+     */
+    void appendSummary(BSONObjBuilder* builder) const;
+
+    /**
+     * Discards the statistics of all query shapes.
+     */
+    void clear();
+
+private:
+    struct ShapeStats {
+        size_t nsLength = 0;
+        Date_t firstSeen;
+        Date_t lastSeen;
+        long long execCount = 0;
+        long long getMoreCount = 0;
+        long long totalExecMicros = 0;
+        long long minExecMicros = 0;
+        long long maxExecMicros = 0;
+        long long docsExamined = 0;
+        long long keysExamined = 0;
+        long long nreturned = 0;
+        long long bytesReturned = 0;
+        long long totalCpuNanos = 0;
+        long long totalAllocBytes = 0;
+        std::string lastPlanSummary;
+        OperationLatencyHistogram latencies;
+    };
+
+    // Keyed by the namespace and shape separated by a NUL byte, which cannot appear in a namespace.
+    // Eviction is done by hand so that the capacity can change at runtime.
+    using ShapeCache = LRUCache<std::string, ShapeStats>;
+
+    struct Partition {
+        Partition() : shapes(std::numeric_limits<size_t>::max()) {}
+
+        mutable stdx::mutex mutex;
+        ShapeCache shapes;
+    };
+
+    static BSONObj _toBSON(const std::string& key, const ShapeStats& stats, bool includeHistograms);
+
+    std::array<Partition, kNumPartitions> _partitions;
+
+    AtomicUInt64 _recorded;
+    AtomicUInt64 _evicted;
+};
+
+}  // namespace mongo
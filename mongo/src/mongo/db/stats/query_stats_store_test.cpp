@@ -0,0 +1,145 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/stats/query_stats_store.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace {
+
+QueryStatsStore::Execution makeExecution(long long micros, long long nreturned) {
+    QueryStatsStore::Execution execution;
+    execution.micros = micros;
+    execution.docsExamined = 2 * nreturned;
+    execution.keysExamined = 3 * nreturned;
+    execution.nreturned = nreturned;
+    execution.bytesReturned = 100 * nreturned;
+    execution.cpuNanos = 1000 * micros;
+    execution.allocBytes = 64 * nreturned;
+    execution.planSummary = "IXSCAN { a: 1 }"_sd;
+    return execution;
+}
+
+ServerParameter* storeSizeParameter() {
+    return ServerParameterSet::getGlobal()->getMap().find("internalQueryStatsStoreSize")->second;
+}
+
+TEST(QueryStatsStoreTest, ExecutionsOfTheSameShapeAreAggregated) {
+    QueryStatsStore store;
+    store.record("test.coll", "eqa", makeExecution(10, 1));
+    auto getMore = makeExecution(30, 4);
+    getMore.isGetMore = true;
+    store.record("test.coll", "eqa", getMore);
+    store.record("test.coll", "eqb", makeExecution(5, 0));
+    store.record("test.other", "eqa", makeExecution(7, 2));
+
+    auto stats = store.getStats(false);
+    ASSERT_EQ(3U, stats.size());
+
+    bool found = false;
+    for (auto&& shape : stats) {
+        if (shape["ns"].str() != "test.coll" || shape["queryShape"].str() != "eqa") {
+            continue;
+        }
+        found = true;
+        ASSERT_EQ(1, shape["execCount"].numberLong());
+        ASSERT_EQ(1, shape["getMoreCount"].numberLong());
+        ASSERT_EQ(40, shape["totalExecMicros"].numberLong());
+        ASSERT_EQ(10, shape["minExecMicros"].numberLong());
+        ASSERT_EQ(30, shape["maxExecMicros"].numberLong());
+        ASSERT_EQ(10, shape["docsExamined"].numberLong());
+        ASSERT_EQ(15, shape["keysExamined"].numberLong());
+        ASSERT_EQ(5, shape["nreturned"].numberLong());
+        ASSERT_EQ(500, shape["bytesReturned"].numberLong());
+        ASSERT_EQ(40000, shape["totalCpuNanos"].numberLong());
+        ASSERT_EQ(320, shape["totalAllocBytes"].numberLong());
+        ASSERT_EQ("IXSCAN { a: 1 }", shape["lastPlanSummary"].str());
+        ASSERT_EQ(2, shape["latencyStats"]["reads"]["ops"].numberLong());
+        ASSERT_EQ(40, shape["latencyStats"]["reads"]["latency"].numberLong());
+    }
+    ASSERT(found);
+
+    BSONObjBuilder summary;
+    store.appendSummary(&summary);
+    ASSERT_BSONOBJ_EQ(BSON("shapes" << 3 << "recorded" << 4 << "evicted" << 0), summary.obj());
+}
+
+TEST(QueryStatsStoreTest, LeastRecentlyRecordedShapesAreEvicted) {
+    ASSERT_OK(storeSizeParameter()->setFromString(std::to_string(QueryStatsStore::kNumPartitions)));
+    ON_BLOCK_EXIT([] { storeSizeParameter()->setFromString("1000").transitional_ignore(); });
+
+    // Each partition holds one shape, so recording more shapes than partitions must evict.
+    QueryStatsStore store;
+    const int numShapes = 4 * QueryStatsStore::kNumPartitions;
+    for (int i = 0; i < numShapes; i++) {
+        store.record("test.coll", std::to_string(i), makeExecution(1, 1));
+    }
+
+    auto stats = store.getStats(false);
+    ASSERT_LTE(stats.size(), QueryStatsStore::kNumPartitions);
+
+    BSONObjBuilder summary;
+    store.appendSummary(&summary);
+    auto summaryObj = summary.obj();
+    ASSERT_EQ(numShapes, summaryObj["recorded"].numberLong());
+    ASSERT_EQ(numShapes - static_cast<long long>(stats.size()), summaryObj["evicted"].numberLong());
+
+    // The last shape recorded is always kept.
+    bool foundLast = false;
+    for (auto&& shape : stats) {
+        foundLast = foundLast || shape["queryShape"].str() == std::to_string(numShapes - 1);
+    }
+    ASSERT(foundLast);
+}
+
+TEST(QueryStatsStoreTest, NothingIsRecordedWhenDisabled) {
+    ASSERT_OK(storeSizeParameter()->setFromString("0"));
+    ON_BLOCK_EXIT([] { storeSizeParameter()->setFromString("1000").transitional_ignore(); });
+    ASSERT_FALSE(QueryStatsStore::isEnabled());
+
+    QueryStatsStore store;
+    store.record("test.coll", "eqa", makeExecution(10, 1));
+    ASSERT_EQ(0U, store.getStats(false).size());
+}
+
+TEST(QueryStatsStoreTest, ClearDiscardsAllShapes) {
+    QueryStatsStore store;
+    store.record("test.coll", "eqa", makeExecution(10, 1));
+    store.clear();
+    ASSERT_EQ(0U, store.getStats(true).size());
+}
+
+}  // namespace
+}  // namespace mongo
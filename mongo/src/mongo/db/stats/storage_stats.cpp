@@ -33,6 +33,8 @@
 #include "mongo/db/db_raii.h"
 #include "mongo/db/index/index_access_method.h"
 #include "mongo/db/index/index_descriptor.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/storage/storage_engine.h"
 
 #include "mongo/db/stats/storage_stats.h"
 
@@ -128,4 +130,27 @@ Status appendCollectionRecordCount(OperationContext* opCtx,
 
     return Status::OK();
 }
+
+Status appendCollectionCacheResidency(OperationContext* opCtx,
+                                      const NamespaceString& nss,
+                                      BSONObjBuilder* result) {
+    AutoGetCollectionForReadCommand ctx(opCtx, nss);
+    if (!ctx.getDb()) {
+        return {ErrorCodes::BadValue,
+                str::stream() << "Database [" << nss.db().toString() << "] not found."};
+    }
+
+    if (!ctx.getCollection()) {
+        return {ErrorCodes::BadValue,
+                str::stream() << "Collection [" << nss.toString() << "] not found."};
+    }
+
+    StorageEngine* storageEngine = opCtx->getServiceContext()->getGlobalStorageEngine();
+    if (!storageEngine->appendCacheStats(opCtx, nss.ns(), result)) {
+        return {ErrorCodes::CommandNotSupported,
+                "The storage engine does not report cache residency statistics."};
+    }
+
+    return Status::OK();
+}
 }  // namespace mongo
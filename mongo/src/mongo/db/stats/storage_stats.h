@@ -51,4 +51,12 @@ Status appendCollectionRecordCount(OperationContext* opCtx,
                                    const NamespaceString& nss,
                                    BSONObjBuilder* builder);
 
+/**
+ * Appends to 'builder' how much of the collection represented by 'nss' and of each of its indexes
+ * is held in the storage engine's cache.
+ */
+Status appendCollectionCacheResidency(OperationContext* opCtx,
+                                      const NamespaceString& nss,
+                                      BSONObjBuilder* builder);
+
 };  // namespace mongo
@@ -33,6 +33,9 @@
 
 #include "mongo/db/stats/top.h"
 
+#include <algorithm>
+
+#include "mongo/db/client.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/service_context.h"
 #include "mongo/util/log.h"
@@ -54,8 +57,116 @@ db.runCommand( { top: 1 } )
 */
 const auto getTop = ServiceContext::declareDecoration<Top>();
 
+// A client forgets all of the shards it has cached once it has used this many collections.
+const size_t kMaxCachedCollections = 1000;
+
+AtomicUInt32 nextClientShard;
+
+const auto getClientCache = Client::declareDecoration<Top::ClientCache>();
+
+/**
+ * Counterpart to Top::UsageData which may be incremented without a lock.
+ */
+struct AtomicUsageData {
+    void inc(long long micros) {
+        count.fetchAndAdd(1);
+        time.fetchAndAdd(micros);
+    }
+
+    void addTo(Top::UsageData* usage) const {
+        usage->time += time.loadRelaxed();
+        usage->count += count.loadRelaxed();
+    }
+
+    AtomicInt64 time;
+    AtomicInt64 count;
+};
+
 }  // namespace
 
+struct Top::StatsShard {
+    explicit StatsShard(AtomicOperationLatencyHistogram* histogram)
+        : opLatencyHistogram(histogram) {}
+
+    AtomicUsageData total;
+    AtomicUsageData readLock;
+    AtomicUsageData writeLock;
+    AtomicUsageData queries;
+    AtomicUsageData getmore;
+    AtomicUsageData insert;
+    AtomicUsageData update;
+    AtomicUsageData remove;
+    AtomicUsageData commands;
+
+    // Every operation adds to the histogram's count and sum, so each shard keeps its own.
+    AtomicOperationLatencyTotals opLatencyTotals;
+
+    // The buckets of the collection's histogram, which all of its shards share. At over a kilobyte
+    // they are too large to keep a copy per shard, and operations spread over several of them.
+    AtomicOperationLatencyHistogram* const opLatencyHistogram;
+};
+
+struct Top::CollectionStats {
+    ~CollectionStats() {
+        for (auto&& shard : shards) {
+            delete shard.load();
+        }
+    }
+
+    /**
+     * Must be called with Top::_lock held.
+     */
+    StatsShard* getOrCreateShard(int index) {
+        StatsShard* shard = shards[index].load();
+        if (!shard) {
+            shard = new StatsShard(&opLatencyHistogram);
+            shards[index].store(shard);
+        }
+        return shard;
+    }
+
+    /**
+     * Adds up the shards.
+     */
+    CollectionData snapshot() const {
+        CollectionData data;
+        for (auto&& slot : shards) {
+            const StatsShard* shard = slot.load();
+            if (!shard) {
+                continue;
+            }
+            shard->total.addTo(&data.total);
+            shard->readLock.addTo(&data.readLock);
+            shard->writeLock.addTo(&data.writeLock);
+            shard->queries.addTo(&data.queries);
+            shard->getmore.addTo(&data.getmore);
+            shard->insert.addTo(&data.insert);
+            shard->update.addTo(&data.update);
+            shard->remove.addTo(&data.remove);
+            shard->commands.addTo(&data.commands);
+            shard->opLatencyTotals.addTo(&data.opLatencyHistogram);
+        }
+        opLatencyHistogram.addTo(&data.opLatencyHistogram);
+        return data;
+    }
+
+    // Written only with Top::_lock held, but read without it.
+    std::array<AtomicWord<StatsShard*>, kNumShards> shards;
+
+    AtomicOperationLatencyHistogram opLatencyHistogram;
+};
+
+struct Top::ClientCache {
+    const int shard = nextClientShard.fetchAndAdd(1) % kNumShards;
+
+    // The Top, and its epoch, that the entries in 'shards' were looked up from.
+    const Top* top = nullptr;
+    unsigned long long epoch = 0;
+
+    // The shared_ptr keeps the counters alive even if the collection is dropped concurrently.
+    StringMap<std::pair<std::shared_ptr<CollectionStats>, StatsShard*>> shards;
+};
+
 Top::UsageData::UsageData(const UsageData& older, const UsageData& newer) {
     // this won't be 100% accurate on rollovers and drop(), but at least it won't be negative
     time = (newer.time >= older.time) ? (newer.time - older.time) : newer.time;
@@ -96,30 +207,68 @@ void Top::record(OperationContext* opCtx,
     if (ns[0] == '?')
         return;
 
+    // Usually this client has already used 'ns', and this is just a lookup in its own cache. After
+    // a drop the epoch changes, so the first operation on each namespace takes the slow path,
+    // which checks '_lastDropped'.
+    auto& cache = getClientCache(opCtx->getClient());
+    StatsShard* shard = nullptr;
+    if (cache.top == this && cache.epoch == _epoch.load()) {
+        auto it = cache.shards.find(ns);
+        if (it != cache.shards.end()) {
+            shard = it->second.second;
+        }
+    }
+
+    if (!shard) {
+        shard = _getShardSlow(&cache, ns, command || logicalOp == LogicalOp::opQuery);
+        if (!shard) {
+            return;
+        }
+    }
+
+	//ʼͳ
+    _record(opCtx, shard, logicalOp, lockType, micros, readWriteType);
+}
+
+Top::StatsShard* Top::_getShardSlow(ClientCache* cache, StringData ns, bool ignoreIfJustDropped) {
 	//ݱMapҵñڱжӦhashλ
-    auto hashedNs = UsageMap::HashedKey(ns);
+    auto hashedNs = StringMap<std::shared_ptr<CollectionStats>>::HashedKey(ns);
     stdx::lock_guard<SimpleMutex> lk(_lock);
 
 	//nsѾɾıֱӷ
-    if ((command || logicalOp == LogicalOp::opQuery) && ns == _lastDropped) {
+    if (ignoreIfJustDropped && ns == _lastDropped) {
         _lastDropped = "";
-        return;
+        return nullptr;
     }
+
+    const auto epoch = _epoch.load();
+    if (cache->top != this || cache->epoch != epoch ||
+        cache->shards.size() >= kMaxCachedCollections) {
+        cache->shards.clear();
+        cache->top = this;
+        cache->epoch = epoch;
+    }
+
 	//ҵıӦCollectionData
-    CollectionData& coll = _usage[hashedNs];
-	//ʼͳ
-    _record(opCtx, coll, logicalOp, lockType, micros, readWriteType);
+    auto& stats = _usage[hashedNs];
+    if (!stats) {
+        stats = std::make_shared<CollectionStats>();
+    }
+    StatsShard* shard = stats->getOrCreateShard(cache->shard);
+    cache->shards[ns] = std::make_pair(stats, shard);
+    return shard;
 }
 
 //Top::record  opʱͳ
 void Top::_record(OperationContext* opCtx,
-                  CollectionData& c,
+                  StatsShard* shard,
                   LogicalOp logicalOp,
                   LockType lockType,
                   long long micros,
                   Command::ReadWriteType readWriteType) {
+    auto& c = *shard;
     //ϸͳ
-    _incrementHistogram(opCtx, micros, &c.opLatencyHistogram, readWriteType);
+    _incrementHistogram(opCtx, micros, c.opLatencyHistogram, readWriteType, &c.opLatencyTotals);
     //ñʱӼɾĲgetMore command
     c.total.inc(micros);
 	//д
@@ -164,6 +313,7 @@ void Top::_record(OperationContext* opCtx,
 void Top::collectionDropped(StringData ns, bool databaseDropped) {
     stdx::lock_guard<SimpleMutex> lk(_lock);
     _usage.erase(ns);
+    _epoch.fetchAndAdd(1);
     if (!databaseDropped) {
         // If a collection drop occurred, there will be a subsequent call to record for this
         // collection namespace which must be ignored. This does not apply to a database drop.
@@ -171,16 +321,30 @@ void Top::collectionDropped(StringData ns, bool databaseDropped) {
     }
 }
 
-void Top::cloneMap(Top::UsageMap& out) const {
+std::vector<std::pair<std::string, std::shared_ptr<const Top::CollectionStats>>> Top::_copyStats()
+    const {
+    std::vector<std::pair<std::string, std::shared_ptr<const CollectionStats>>> stats;
     stdx::lock_guard<SimpleMutex> lk(_lock);
-    out = _usage;
+    stats.reserve(_usage.size());
+    for (auto&& entry : _usage) {
+        stats.emplace_back(entry.first, entry.second);
+    }
+    return stats;
+}
+
+void Top::cloneMap(Top::UsageMap& out) const {
+    out.clear();
+    for (auto&& entry : _copyStats()) {
+        out[entry.first] = entry.second->snapshot();
+    }
 }
 //
 //ServiceEntryPointMongod::handleRequest->Top::incrementGlobalLatencyStatsлȡдʱͳ(db.serverStatus().opLatencies)
 //TopCommand::run->Top::appendȡϸcountʱͳ(db.runCommand( { top: 1 } ))
 void Top::append(BSONObjBuilder& b) {
-    stdx::lock_guard<SimpleMutex> lk(_lock);
-    _appendToUsageMap(b, _usage);
+    UsageMap usage;
+    cloneMap(usage);
+    _appendToUsageMap(b, usage);
 }
 
 //Top::append
@@ -227,10 +391,21 @@ void Top::_appendStatsEntry(BSONObjBuilder& b, const char* statsName, const Usag
 //db.collection.latencyStats( { histograms:false})
 //Ķ д commandʱͳ
 void Top::appendLatencyStats(StringData ns, bool includeHistograms, BSONObjBuilder* builder) {
-    auto hashedNs = UsageMap::HashedKey(ns);
-    stdx::lock_guard<SimpleMutex> lk(_lock);
+    std::shared_ptr<const CollectionStats> stats;
+    {
+        stdx::lock_guard<SimpleMutex> lk(_lock);
+        auto it = _usage.find(ns);
+        if (it != _usage.end()) {
+            stats = it->second;
+        }
+    }
+
+    OperationLatencyHistogram histogram;
+    if (stats) {
+        histogram = stats->snapshot().opLatencyHistogram;
+    }
     BSONObjBuilder latencyStatsBuilder;
-    _usage[hashedNs].opLatencyHistogram.append(includeHistograms, &latencyStatsBuilder);
+    histogram.append(includeHistograms, &latencyStatsBuilder);
     builder->append("ns", ns);
     builder->append("latencyStats", latencyStatsBuilder.obj());
 }
@@ -263,15 +438,20 @@ featdoc_1:PRIMARY>
 void Top::incrementGlobalLatencyStats(OperationContext* opCtx,
                                       uint64_t latency,
                                       Command::ReadWriteType readWriteType) {
-    stdx::lock_guard<SimpleMutex> guard(_lock);
-    _incrementHistogram(opCtx, latency, &_globalHistogramStats, readWriteType);
+    _incrementHistogram(opCtx,
+                        latency,
+                        &_globalHistogramStats[getClientCache(opCtx->getClient()).shard],
+                        readWriteType);
 }
 
 //GlobalHistogramServerStatusSectiongenerateSectionӿڵãdb.serverStatus().opLatenciesȡʱϢ
 void Top::appendGlobalLatencyStats(bool includeHistograms, BSONObjBuilder* builder) {
-    stdx::lock_guard<SimpleMutex> guard(_lock);
+    OperationLatencyHistogram histogram;
+    for (auto&& shard : _globalHistogramStats) {
+        shard.addTo(&histogram);
+    }
 	//OperationLatencyHistogram::append
-    _globalHistogramStats.append(includeHistograms, builder);
+    histogram.append(includeHistograms, builder);
 }
 
 //Top::incrementGlobalLatencyStats  дʱ
@@ -279,11 +459,17 @@ void Top::appendGlobalLatencyStats(bool includeHistograms, BSONObjBuilder* build
 //Top::_record   Top::incrementGlobalLatencyStatsִ
 void Top::_incrementHistogram(OperationContext* opCtx,
                               long long latency,
-                              OperationLatencyHistogram* histogram,
-                              Command::ReadWriteType readWriteType) {
+                              AtomicOperationLatencyHistogram* histogram,
+                              Command::ReadWriteType readWriteType,
+                              AtomicOperationLatencyTotals* totals) {
     // Only update histogram if operation came from a user.
     Client* client = opCtx->getClient();
     if (client->isFromUserConnection() && !client->isInDirectClient()) {
+        if (totals) {
+            histogram->incrementBucket(latency, readWriteType);
+            totals->increment(latency, readWriteType);
+            return;
+        }
 		//OperationLatencyHistogram::increment 
         histogram->increment(latency, readWriteType);
     }
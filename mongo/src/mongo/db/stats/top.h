@@ -29,11 +29,16 @@
 
 #pragma once
 
+#include <array>
 #include <boost/date_time/posix_time/posix_time.hpp>
+#include <memory>
+#include <utility>
+#include <vector>
 
 #include "mongo/db/commands.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/stats/operation_latency_histogram.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/util/concurrency/mutex.h"
 #include "mongo/util/net/message.h"
 #include "mongo/util/string_map.h"
@@ -115,6 +120,12 @@ public:
     //mapÿռһοTop::record
     typedef StringMap<CollectionData> UsageMap;
 
+    /**
+     * Remembers, for one client, which shard it records into and where that shard lives for each
+     * collection it has recently used, so that record() doesn't need '_lock'. Defined in top.cpp.
+     */
+    struct ClientCache;
+
 public:
     void record(OperationContext* opCtx,
                 StringData ns,
@@ -152,18 +163,54 @@ private:
 
     void _appendStatsEntry(BSONObjBuilder& b, const char* statsName, const UsageData& map) const;
 
+    // Number of shards each collection's counters, and the global histogram, are split into. A
+    // collection's latency histogram is not split, see StatsShard.
+    static const int kNumShards = 16;
+
+    /**
+     * One shard of the counters for a collection. Defined in top.cpp.
+     */
+    struct StatsShard;
+
+    /**
+     * Every client is assigned one of kNumShards shards, and the counters for each collection are
+     * split into the same number of shards, which are allocated the first time a client assigned
+     * to them touches the collection. Operations on different clients therefore usually increment
+     * different cache lines, and reading the counters means adding all of the shards together.
+     * Defined in top.cpp.
+     */
+    struct CollectionStats;
+
+    /**
+     * Looks up, or creates, the shard of the counters for 'ns' belonging to 'cache'. Returns
+     * nullptr if this operation should not be counted because it follows a drop of 'ns'.
+     */
+    StatsShard* _getShardSlow(ClientCache* cache, StringData ns, bool ignoreIfJustDropped);
+
     void _record(OperationContext* opCtx,
-                 CollectionData& c,
+                 StatsShard* shard,
                  LogicalOp logicalOp,
                  LockType lockType,
                  long long micros,
                  Command::ReadWriteType readWriteType);
 
+    /**
+     * If 'totals' is not null, the operation count and latency total go there rather than into
+     * 'histogram'.
+     */
     void _incrementHistogram(OperationContext* opCtx,
                              long long latency,
-                             OperationLatencyHistogram* histogram,
-                             Command::ReadWriteType readWriteType);
+                             AtomicOperationLatencyHistogram* histogram,
+                             Command::ReadWriteType readWriteType,
+                             AtomicOperationLatencyTotals* totals = nullptr);
 
+    /**
+     * Returns the counters for every collection, taking '_lock' only long enough to copy the map.
+     */
+    std::vector<std::pair<std::string, std::shared_ptr<const CollectionStats>>> _copyStats() const;
+
+    // Protects '_usage' and '_lastDropped'. Only taken by record() the first time a client touches
+    // a collection, or after a drop.
     mutable SimpleMutex _lock;
     //дdb.serverStatus().opLatenciesؼбͳ ---ȫγ
     //db.collection.latencyStats( { histograms:true})  --- γ
@@ -173,10 +220,14 @@ private:
     
     //Top._globalHistogramStatsȫ(б)Ĳʱͳ-ȫγ
     //CollectionData.opLatencyHistogramǱĶдcommandͳ-γ
-    OperationLatencyHistogram _globalHistogramStats;
+    std::array<AtomicOperationLatencyHistogram, kNumShards> _globalHistogramStats;
     //ÿϸqpsʱͳ   db.runCommand( { top: 1 } )ȡ
-    UsageMap _usage;  //mapÿռһοTop::record
+    StringMap<std::shared_ptr<CollectionStats>> _usage;  //mapÿռһοTop::record
     std::string _lastDropped;
+
+    // Incremented whenever counters are removed from '_usage', so that clients forget the shards
+    // they have cached.
+    AtomicUInt64 _epoch;
 };
 
 }  // namespace mongo
@@ -29,6 +29,8 @@
 #include "mongo/platform/basic.h"
 
 #include "mongo/db/stats/top.h"
+
+#include "mongo/db/query/query_test_service_context.h"
 #include "mongo/unittest/unittest.h"
 
 namespace {
@@ -39,4 +41,68 @@ TEST(TopTest, CollectionDropped) {
     Top().collectionDropped("coll");
 }
 
+TEST(TopTest, CountsAreSummedAcrossClients) {
+    QueryTestServiceContext serviceContext;
+    auto otherClient = serviceContext.getServiceContext()->makeClient("TopTest");
+    auto opCtx = serviceContext.makeOperationContext();
+    auto otherOpCtx = otherClient->makeOperationContext();
+
+    Top top;
+    top.record(opCtx.get(),
+               "test.coll",
+               LogicalOp::opInsert,
+               Top::LockType::WriteLocked,
+               10,
+               false,
+               Command::ReadWriteType::kWrite);
+    for (auto micros : {5, 7}) {
+        top.record(otherOpCtx.get(),
+                   "test.coll",
+                   LogicalOp::opQuery,
+                   Top::LockType::ReadLocked,
+                   micros,
+                   false,
+                   Command::ReadWriteType::kRead);
+    }
+
+    Top::UsageMap usage;
+    top.cloneMap(usage);
+    ASSERT_EQ(1U, usage.size());
+    const auto& coll = usage.find("test.coll")->second;
+    ASSERT_EQ(3, coll.total.count);
+    ASSERT_EQ(22, coll.total.time);
+    ASSERT_EQ(1, coll.insert.count);
+    ASSERT_EQ(10, coll.writeLock.time);
+    ASSERT_EQ(2, coll.queries.count);
+    ASSERT_EQ(12, coll.readLock.time);
+}
+
+TEST(TopTest, DroppedCollectionCountsAreDiscarded) {
+    QueryTestServiceContext serviceContext;
+    auto opCtx = serviceContext.makeOperationContext();
+
+    Top top;
+    auto recordQuery = [&] {
+        top.record(opCtx.get(),
+                   "test.coll",
+                   LogicalOp::opQuery,
+                   Top::LockType::ReadLocked,
+                   1,
+                   false,
+                   Command::ReadWriteType::kRead);
+    };
+    recordQuery();
+    top.collectionDropped("test.coll");
+
+    // The first query after the drop is ignored, since it is assumed to be the drop itself.
+    recordQuery();
+    Top::UsageMap usage;
+    top.cloneMap(usage);
+    ASSERT_EQ(0U, usage.size());
+
+    recordQuery();
+    top.cloneMap(usage);
+    ASSERT_EQ(1, usage.find("test.coll")->second.queries.count);
+}
+
 }  // namespace
@@ -340,6 +340,12 @@ void KeyString::resetToKey(const BSONObj& obj, Ordering ord, Discriminator discr
 void KeyString::_appendAllElementsForIndexing(const BSONObj& obj,
                                               Ordering ord,
                                               Discriminator discriminator) {
+    // A key is rarely much larger once encoded than it is as BSON, so make room for it up front
+    // rather than growing the buffer as we go.
+    const int expectedBytes = obj.objsize();
+    _buffer.reserveBytes(expectedBytes);
+    _buffer.claimReservedBytes(expectedBytes);
+
     int elemCount = 0;
     BSONObjIterator it(obj);
     while (auto elem = it.next()) {
@@ -1046,22 +1052,29 @@ void KeyString::_appendPreshiftedIntegerPortion(uint64_t value, bool isNegative,
 
     const size_t bytesNeeded = (64 - countLeadingZeros64(value) + 7) / 8;
 
-    // Append the low bytes of value in big endian order.
-    value = endian::nativeToBig(value);
-    const void* firstUsedByte = reinterpret_cast<const char*>((&value) + 1) - bytesNeeded;
-
     if (isNegative) {
         _append(uint8_t(CType::kNumericNegative1ByteInt - (bytesNeeded - 1)), invert);
-        _appendBytes(firstUsedByte, bytesNeeded, !invert);
     } else {
         _append(uint8_t(CType::kNumericPositive1ByteInt + (bytesNeeded - 1)), invert);
-        _appendBytes(firstUsedByte, bytesNeeded, invert);
     }
+
+    // Append the low bytes of value in big endian order. Rather than copying a variable number of
+    // bytes, write all eight with the used ones first and then drop the rest.
+    const size_t unusedBytes = sizeof(value) - bytesNeeded;
+    _append(endian::nativeToBig(value << (unusedBytes * 8)), isNegative ? !invert : invert);
+    _buffer.setlen(_buffer.len() - unusedBytes);
 }
 
 template <typename T>
 void KeyString::_append(const T& thing, bool invert) {
-    _appendBytes(&thing, sizeof(thing), invert);
+    // Unlike _appendBytes(), the size is known here, so the copy compiles down to a single store.
+    char* const base = _buffer.skip(sizeof(thing));
+
+    if (invert) {
+        memcpy_flipBits(base, &thing, sizeof(thing));
+    } else {
+        memcpy(base, &thing, sizeof(thing));
+    }
 }
 
 void KeyString::_appendBytes(const void* source, size_t bytes, bool invert) {
@@ -0,0 +1,155 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/record_id.h"
+#include "mongo/db/storage/key_string.h"
+#include "mongo/platform/decimal128.h"
+#include "mongo/unittest/benchmark.h"
+
+namespace mongo {
+namespace {
+
+using unittest::BenchmarkState;
+
+const Ordering kAllAscending = Ordering::make(BSONObj());
+
+enum class KeyType { kInt, kDouble, kDecimal, kString, kCompound, kNumKeyTypes };
+
+const char* keyTypeName(KeyType type) {
+    switch (type) {
+        case KeyType::kInt:
+            return "int";
+        case KeyType::kDouble:
+            return "double";
+        case KeyType::kDecimal:
+            return "decimal";
+        case KeyType::kString:
+            return "string";
+        case KeyType::kCompound:
+            return "compound";
+        case KeyType::kNumKeyTypes:
+            break;
+    }
+    MONGO_UNREACHABLE;
+}
+
+/**
+ * Returns an index key of the given type, 'n' distinguishing keys of the same type. Keys with
+ * larger 'n' sort after keys with smaller 'n', but only differ from them near their end.
+ */
+BSONObj makeKey(KeyType type, int n) {
+    switch (type) {
+        case KeyType::kInt:
+            return BSON("" << 1000000 + n);
+        case KeyType::kDouble:
+            return BSON("" << 1000000.5 + n);
+        case KeyType::kDecimal:
+            return BSON("" << Decimal128(1000000 + n));
+        case KeyType::kString:
+            return BSON("" << (std::string(64, 'x') + std::to_string(n)));
+        case KeyType::kCompound:
+            return BSON("" << 1 << ""
+                           << "prefix"
+                           << ""
+                           << 2.5
+                           << ""
+                           << n);
+        case KeyType::kNumKeyTypes:
+            break;
+    }
+    MONGO_UNREACHABLE;
+}
+
+KeyType keyType(BenchmarkState& state) {
+    auto type = static_cast<KeyType>(state.range());
+    state.setLabel(keyTypeName(type));
+    return type;
+}
+
+void BM_KeyStringEncode(BenchmarkState& state) {
+    const auto key = makeKey(keyType(state), 0);
+    KeyString ks(KeyString::kLatestVersion);
+    long long bytes = 0;
+    while (state.keepRunning()) {
+        ks.resetToKey(key, kAllAscending, RecordId(1));
+        bytes += ks.getSize();
+    }
+    state.setItemsProcessed(state.iterations());
+    state.setBytesProcessed(bytes);
+}
+
+void BM_KeyStringDecode(BenchmarkState& state) {
+    const KeyString ks(
+        KeyString::kLatestVersion, makeKey(keyType(state), 0), kAllAscending, RecordId(1));
+    while (state.keepRunning()) {
+        auto key = KeyString::toBson(ks.getBuffer(), ks.getSize(), kAllAscending, ks.getTypeBits());
+        unittest::doNotOptimize(key);
+    }
+    state.setItemsProcessed(state.iterations());
+    state.setBytesProcessed(static_cast<long long>(state.iterations()) * ks.getSize());
+}
+
+void BM_KeyStringCompare(BenchmarkState& state) {
+    const auto type = keyType(state);
+    const KeyString left(KeyString::kLatestVersion, makeKey(type, 0), kAllAscending, RecordId(1));
+    const KeyString right(KeyString::kLatestVersion, makeKey(type, 1), kAllAscending, RecordId(1));
+    while (state.keepRunning()) {
+        auto result = left.compare(right);
+        unittest::doNotOptimize(result);
+    }
+    state.setItemsProcessed(state.iterations());
+}
+
+// The BSON comparison KeyString replaces, for reference.
+void BM_BSONKeyCompare(BenchmarkState& state) {
+    const auto type = keyType(state);
+    const auto left = makeKey(type, 0);
+    const auto right = makeKey(type, 1);
+    while (state.keepRunning()) {
+        auto result = left.woCompare(right, kAllAscending, false);
+        unittest::doNotOptimize(result);
+    }
+    state.setItemsProcessed(state.iterations());
+}
+
+void allKeyTypes(unittest::Benchmark* benchmark) {
+    for (int type = 0; type < static_cast<int>(KeyType::kNumKeyTypes); ++type) {
+        benchmark->arg(type);
+    }
+}
+
+MONGO_BENCHMARK(BM_KeyStringEncode)->apply(allKeyTypes);
+MONGO_BENCHMARK(BM_KeyStringDecode)->apply(allKeyTypes);
+MONGO_BENCHMARK(BM_KeyStringCompare)->apply(allKeyTypes);
+MONGO_BENCHMARK(BM_BSONKeyCompare)->apply(allKeyTypes);
+
+}  // namespace
+}  // namespace mongo
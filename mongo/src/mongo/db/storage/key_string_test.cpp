@@ -1313,3 +1313,68 @@ TEST_F(KeyStringTest, DecimalFromUniformDoublePerf) {
     }
     perfTest(version, numbers);
 }
+
+namespace {
+/**
+ * Encodes each of 'keys' as an index entry a sufficient number of times to take at least
+ * kMinPerfMicros microseconds. Logs the elapsed time per key generated.
+ */
+void keyGenerationPerfTest(KeyString::Version version,
+                           const std::vector<BSONObj>& keys,
+                           StringData shape) {
+    KeyString ks(version);
+    uint64_t micros = 0;
+    uint64_t iters;
+    uint64_t bytes = 0;
+    for (iters = 16; iters < (1 << 30) && micros < kMinPerfMicros; iters *= 2) {
+        Timer t;
+
+        bytes = 0;
+        for (uint64_t i = 0; i < iters; i++) {
+            for (size_t j = 0; j < keys.size(); j++) {
+                ks.resetToKey(keys[j], ALL_ASCENDING, RecordId(j + 1));
+                bytes += ks.getSize();
+            }
+        }
+
+        micros = t.micros();
+    }
+    invariant(bytes > 0);
+
+    log() << 1E3 * micros / static_cast<double>(iters * keys.size()) << " ns per "
+          << mongo::KeyString::versionToString(version) << " " << shape << " key, "
+          << bytes / static_cast<double>(micros) << " MB/s"
+          << (kDebugBuild ? " (DEBUG BUILD!)" : "");
+}
+}  // namespace
+
+TEST_F(KeyStringTest, KeyGenerationPerf) {
+    std::mt19937 gen(newSeed());
+    std::uniform_int_distribution<long long> uniformInt64(std::numeric_limits<long long>::min(),
+                                                          std::numeric_limits<long long>::max());
+    std::exponential_distribution<double> expReal(1e-3);
+
+    std::vector<BSONObj> longs;
+    std::vector<BSONObj> doubles;
+    std::vector<BSONObj> strings;
+    std::vector<BSONObj> oids;
+    std::vector<BSONObj> compound;
+    for (uint64_t x = 0; x < kMinPerfSamples; x++) {
+        const long long l = uniformInt64(gen);
+        const double d = expReal(gen);
+        const std::string str = "user" + std::to_string(l);
+        const OID oid = OID::gen();
+
+        longs.push_back(BSON("" << l));
+        doubles.push_back(BSON("" << d));
+        strings.push_back(BSON("" << str));
+        oids.push_back(BSON("" << oid));
+        compound.push_back(BSON("" << str << "" << l << "" << d << "" << oid));
+    }
+
+    keyGenerationPerfTest(version, longs, "int64");
+    keyGenerationPerfTest(version, doubles, "double");
+    keyGenerationPerfTest(version, strings, "string");
+    keyGenerationPerfTest(version, oids, "ObjectId");
+    keyGenerationPerfTest(version, compound, "compound");
+}
@@ -43,6 +43,7 @@
 
 namespace mongo {
 
+class BSONObjBuilder;
 class IndexDescriptor;
 class JournalListener;
 class OperationContext;
@@ -165,6 +166,18 @@ public:
 
     virtual int64_t getIdentSize(OperationContext* opCtx, StringData ident) = 0;
 
+    /**
+     * Appends how much of 'ident' is held in the engine's cache and how much of it has been read
+     * into and evicted from the cache. Returns false, having appended nothing, if the engine does
+     * not report this. Appends nothing but returns true if the statistics of 'ident' in particular
+     * could not be read.
+     */
+    virtual bool appendIdentCacheStats(OperationContext* opCtx,
+                                       StringData ident,
+                                       BSONObjBuilder* builder) {
+        return false;
+    }
+
     virtual Status repairIdent(OperationContext* opCtx, StringData ident) = 0;
 
     virtual Status dropIdent(OperationContext* opCtx, StringData ident) = 0;
@@ -0,0 +1,177 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/kv/kv_engine_bm.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "mongo/db/catalog/collection_options.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/operation_context_noop.h"
+#include "mongo/db/storage/record_store.h"
+#include "mongo/platform/random.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/unittest/benchmark.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+namespace {
+
+using unittest::BenchmarkState;
+
+stdx::function<std::unique_ptr<KVHarnessHelper>()> benchmarkFactory =
+    []() -> std::unique_ptr<KVHarnessHelper> { fassertFailed(40681); };
+
+const std::string kNs = "benchmark.coll";
+
+/**
+ * An engine with a single empty record store, created for each run of a benchmark.
+ */
+class RecordStoreFixture {
+public:
+    RecordStoreFixture() : _helper(benchmarkFactory()), _engine(_helper->getEngine()) {
+        OperationContextNoop opCtx(_engine->newRecoveryUnit());
+        uassertStatusOK(_engine->createRecordStore(&opCtx, kNs, kNs, CollectionOptions()));
+        _rs = _engine->getRecordStore(&opCtx, kNs, kNs, CollectionOptions());
+    }
+
+    ~RecordStoreFixture() {
+        // The record store must not outlive its engine.
+        _rs.reset();
+    }
+
+    std::unique_ptr<OperationContext> newOperationContext() {
+        return stdx::make_unique<OperationContextNoop>(_engine->newRecoveryUnit());
+    }
+
+    RecordStore* recordStore() {
+        return _rs.get();
+    }
+
+    /**
+     * Inserts 'count' copies of 'doc' in batches, and returns their RecordIds.
+     */
+    std::vector<RecordId> load(const BSONObj& doc, long long count) {
+        const long long kBatchSize = 1000;
+        std::vector<RecordId> ids;
+        auto opCtx = newOperationContext();
+        for (long long inserted = 0; inserted < count;) {
+            WriteUnitOfWork wuow(opCtx.get());
+            for (long long i = 0; i < kBatchSize && inserted < count; ++i, ++inserted) {
+                ids.push_back(uassertStatusOK(_rs->insertRecord(
+                    opCtx.get(), doc.objdata(), doc.objsize(), Timestamp(), false)));
+            }
+            wuow.commit();
+        }
+        return ids;
+    }
+
+private:
+    std::unique_ptr<KVHarnessHelper> _helper;
+    KVEngine* _engine;
+    std::unique_ptr<RecordStore> _rs;
+};
+
+/**
+ * Returns a document of about 'size' bytes.
+ */
+BSONObj makeDocument(long long size) {
+    BSONObjBuilder builder;
+    builder.append("_id", OID::gen());
+    builder.append("a", 1);
+    builder.append("b", "a short string value");
+    builder.append("pad", std::string(std::max(0LL, size - builder.len() - 16), 'x'));
+    return builder.obj();
+}
+
+// Inserts one document of range() bytes per write unit of work, like an unbatched insert.
+void BM_RecordStoreInsert(BenchmarkState& state) {
+    RecordStoreFixture fixture;
+    const auto doc = makeDocument(state.range());
+    auto opCtx = fixture.newOperationContext();
+    while (state.keepRunning()) {
+        WriteUnitOfWork wuow(opCtx.get());
+        auto id = uassertStatusOK(fixture.recordStore()->insertRecord(
+            opCtx.get(), doc.objdata(), doc.objsize(), Timestamp(), false));
+        unittest::doNotOptimize(id);
+        wuow.commit();
+    }
+    state.setItemsProcessed(state.iterations());
+    state.setBytesProcessed(static_cast<long long>(state.iterations()) * doc.objsize());
+}
+
+// Reads all range() documents in order, which is the work a CollectionScan stage hands to the
+// storage engine.
+void BM_RecordStoreScan(BenchmarkState& state) {
+    RecordStoreFixture fixture;
+    const auto doc = makeDocument(256);
+    fixture.load(doc, state.range());
+    auto opCtx = fixture.newOperationContext();
+    while (state.keepRunning()) {
+        auto cursor = fixture.recordStore()->getCursor(opCtx.get());
+        while (auto record = cursor->next()) {
+            unittest::doNotOptimize(record->data.data());
+        }
+        opCtx->recoveryUnit()->abandonSnapshot();
+    }
+    state.setItemsProcessed(static_cast<long long>(state.iterations()) * state.range());
+    state.setBytesProcessed(static_cast<long long>(state.iterations()) * state.range() *
+                            doc.objsize());
+}
+
+// Looks up documents in random order among range() documents, the way a FetchStage does for the
+// RecordIds an index scan returns.
+void BM_RecordStoreSeekExact(BenchmarkState& state) {
+    RecordStoreFixture fixture;
+    const auto ids = fixture.load(makeDocument(256), state.range());
+    PseudoRandom random(static_cast<int64_t>(state.range()));
+    auto opCtx = fixture.newOperationContext();
+    auto cursor = fixture.recordStore()->getCursor(opCtx.get());
+    while (state.keepRunning()) {
+        auto record = cursor->seekExact(ids[random.nextInt64(ids.size())]);
+        invariant(record);
+        unittest::doNotOptimize(record->data.data());
+    }
+    state.setItemsProcessed(state.iterations());
+}
+
+MONGO_BENCHMARK(BM_RecordStoreInsert)->arg(256)->arg(4096);
+MONGO_BENCHMARK(BM_RecordStoreScan)->range(1000, 100 * 1000, 10);
+MONGO_BENCHMARK(BM_RecordStoreSeekExact)->range(1000, 100 * 1000, 10);
+
+}  // namespace
+
+void registerKVEngineBenchmarkFactory(stdx::function<std::unique_ptr<KVHarnessHelper>()> factory) {
+    benchmarkFactory = std::move(factory);
+}
+
+}  // namespace mongo
@@ -32,6 +32,7 @@
 
 #include <algorithm>
 
+#include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/operation_context_noop.h"
 #include "mongo/db/storage/kv/kv_database_catalog_entry.h"
 #include "mongo/db/storage/kv/kv_engine.h"
@@ -494,4 +495,28 @@ bool KVStorageEngine::supportsRecoverToStableTimestamp() const {
 void KVStorageEngine::replicationBatchIsComplete() const {
     return _engine->replicationBatchIsComplete();
 }
+
+bool KVStorageEngine::appendCacheStats(OperationContext* opCtx,
+                                       StringData ns,
+                                       BSONObjBuilder* builder) {
+    BSONObjBuilder collectionStats;
+    if (!_engine->appendIdentCacheStats(
+            opCtx, _catalog->getCollectionIdent(ns), &collectionStats)) {
+        return false;
+    }
+    builder->append("collection", collectionStats.obj());
+
+    BSONObjBuilder indexStats(builder->subobjStart("indexes"));
+    const BSONCollectionCatalogEntry::MetaData md = _catalog->getMetaData(opCtx, ns);
+    for (auto&& index : md.indexes) {
+        const std::string indexName = index.name();
+        BSONObjBuilder stats;
+        _engine->appendIdentCacheStats(
+            opCtx, _catalog->getIndexIdent(opCtx, ns, indexName), &stats);
+        if (!stats.asTempObj().isEmpty()) {
+            indexStats.append(indexName, stats.obj());
+        }
+    }
+    return true;
+}
 }  // namespace mongo
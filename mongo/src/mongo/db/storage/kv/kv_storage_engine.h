@@ -310,6 +310,10 @@ public:
     StatusWith<std::vector<StorageEngine::CollectionIndexNamePair>> reconcileCatalogAndIdents(
         OperationContext* opCtx) override;
 
+    bool appendCacheStats(OperationContext* opCtx,
+                          StringData ns,
+                          BSONObjBuilder* builder) override;
+
 private:
     class RemoveDBChange;
 
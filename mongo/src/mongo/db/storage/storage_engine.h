@@ -40,6 +40,7 @@
 
 namespace mongo {
 
+class BSONObjBuilder;
 class DatabaseCatalogEntry;
 class JournalListener;
 class OperationContext;
@@ -376,6 +377,21 @@ public:
         return std::vector<CollectionIndexNamePair>();
     };
 
+    /**
+     * Appends how much of the collection 'ns' and of each of its indexes is held in the storage
+     * engine's cache, as a 'collection' subdocument and an 'indexes' subdocument keyed by index
+     * name. Returns false, having appended nothing, if the engine does not report this. Indexes
+     * whose statistics couldn't be read are left out of 'indexes', and 'collection' is empty if the
+     * collection's couldn't be.
+     *
+     * The caller must hold at least an intent shared lock on the collection's database.
+     */
+    virtual bool appendCacheStats(OperationContext* opCtx,
+                                  StringData ns,
+                                  BSONObjBuilder* builder) {
+        return false;
+    }
+
 protected:
     /**
      * The destructor will never be called. See cleanShutdown instead.
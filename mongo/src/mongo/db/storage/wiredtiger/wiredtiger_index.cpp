@@ -619,7 +619,7 @@ protected:
 class WiredTigerIndex::StandardBulkBuilder : public BulkBuilder {
 public:
     StandardBulkBuilder(WiredTigerIndex* idx, OperationContext* opCtx, KVPrefix prefix)
-        : BulkBuilder(idx, opCtx, prefix), _idx(idx) {}
+        : BulkBuilder(idx, opCtx, prefix), _idx(idx), _keyString(idx->keyStringVersion()) {}
 
 	//IndexAccessMethod::commitBulkе,bulkʽд洢棬οopenBulkCursoropen_cursor
     Status addKey(const BSONObj& key, const RecordId& id) {
@@ -629,15 +629,17 @@ public:
                 return s;
         }
 
-        KeyString data(_idx->keyStringVersion(), key, _idx->_ordering, id);
+        // Reuse one encoder for every key so that the build doesn't allocate a buffer per key.
+        _keyString.resetToKey(key, _idx->_ordering, id);
 
         // Can't use WiredTigerCursor since we aren't using the cache.
-        WiredTigerItem item(data.getBuffer(), data.getSize());
+        WiredTigerItem item(_keyString.getBuffer(), _keyString.getSize());
         setKey(_cursor, item.Get());
 
-        WiredTigerItem valueItem = data.getTypeBits().isAllZeros()
+        const KeyString::TypeBits& typeBits = _keyString.getTypeBits();
+        WiredTigerItem valueItem = typeBits.isAllZeros()
             ? emptyItem
-            : WiredTigerItem(data.getTypeBits().getBuffer(), data.getTypeBits().getSize());
+            : WiredTigerItem(typeBits.getBuffer(), typeBits.getSize());
 
         _cursor->set_value(_cursor, valueItem.Get());
 
@@ -655,6 +657,7 @@ public:
 
 private:
     WiredTigerIndex* _idx;
+    KeyString _keyString;
 };
 
 /**
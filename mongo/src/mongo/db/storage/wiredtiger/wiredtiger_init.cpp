@@ -37,6 +37,7 @@
 
 #include "mongo/base/init.h"
 #include "mongo/db/catalog/collection_options.h"
+#include "mongo/db/ftdc/collector.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/service_context_d.h"
@@ -51,6 +52,7 @@
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_server_status.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
 
 namespace mongo {
@@ -109,6 +111,8 @@ public:
         kv->setSortedDataInterfaceExtraOptions(wiredTigerGlobalOptions.indexConfig);
         // Intentionally leaked.
         new WiredTigerServerStatusSection(kv);
+        registerFTDCBurstCollectorFactory(
+            [kv] { return stdx::make_unique<WiredTigerFTDCBurstCollector>(kv); });
         new WiredTigerEngineRuntimeConfigParameter(kv);
 
         KVStorageEngineOptions options;
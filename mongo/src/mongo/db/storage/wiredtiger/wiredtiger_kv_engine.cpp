@@ -694,6 +694,20 @@ int64_t WiredTigerKVEngine::getIdentSize(OperationContext* opCtx, StringData ide
     return WiredTigerUtil::getIdentSize(session->getSession(), _uri(ident));
 }
 
+bool WiredTigerKVEngine::appendIdentCacheStats(OperationContext* opCtx,
+                                               StringData ident,
+                                               BSONObjBuilder* builder) {
+    // Statistics cursors do not need a transaction.
+    WiredTigerSession* session = WiredTigerRecoveryUnit::get(opCtx)->getSessionNoTxn();
+    Status status =
+        WiredTigerUtil::appendTableCacheStats(session->getSession(), _uri(ident), builder);
+    if (!status.isOK()) {
+        // Appending nothing leaves the ident out rather than report its counters as 0.
+        LOG(2) << "unable to retrieve cache statistics of " << ident << ": " << status;
+    }
+    return true;
+}
+
 //޸ident
 Status WiredTigerKVEngine::repairIdent(OperationContext* opCtx, StringData ident) {
     WiredTigerSession* session = WiredTigerRecoveryUnit::get(opCtx)->getSession();
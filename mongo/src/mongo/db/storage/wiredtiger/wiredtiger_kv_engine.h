@@ -162,6 +162,10 @@ public:
 
     virtual int64_t getIdentSize(OperationContext* opCtx, StringData ident);
 
+    bool appendIdentCacheStats(OperationContext* opCtx,
+                               StringData ident,
+                               BSONObjBuilder* builder) override;
+
     virtual Status repairIdent(OperationContext* opCtx, StringData ident);
 
     virtual bool hasIdent(OperationContext* opCtx, StringData ident) const;
@@ -195,6 +199,10 @@ public:
     WT_CONNECTION* getConnection() {
         return _conn;
     }
+
+    WiredTigerSessionCache* getSessionCache() {
+        return _sessionCache.get();
+    }
     void dropSomeQueuedIdents();
     std::list<WiredTigerCachedCursor> filterCursorsWithQueuedDrops(
         std::list<WiredTigerCachedCursor>* cache);
@@ -0,0 +1,84 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/base/init.h"
+#include "mongo/db/storage/kv/kv_engine_bm.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/unittest/temp_dir.h"
+#include "mongo/util/clock_source_mock.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * A non-durable WiredTiger engine in a temporary directory, with a 1GB cache so that benchmarks
+ * measure in-cache performance.
+ */
+class WiredTigerKVBenchmarkHelper : public KVHarnessHelper {
+public:
+    WiredTigerKVBenchmarkHelper() : _dbpath("wt-kv-benchmark") {
+        _engine = _makeEngine();
+    }
+
+    ~WiredTigerKVBenchmarkHelper() {
+        _engine.reset();
+    }
+
+    KVEngine* restartEngine() override {
+        _engine.reset();
+        _engine = _makeEngine();
+        return _engine.get();
+    }
+
+    KVEngine* getEngine() override {
+        return _engine.get();
+    }
+
+private:
+    std::unique_ptr<WiredTigerKVEngine> _makeEngine() {
+        return stdx::make_unique<WiredTigerKVEngine>(
+            kWiredTigerEngineName, _dbpath.path(), _cs.get(), "", 1, false, false, false, false);
+    }
+
+    const std::unique_ptr<ClockSource> _cs = stdx::make_unique<ClockSourceMock>();
+    unittest::TempDir _dbpath;
+    std::unique_ptr<WiredTigerKVEngine> _engine;
+};
+
+MONGO_INITIALIZER(RegisterKVEngineBenchmarkFactory)(InitializerContext*) {
+    registerKVEngineBenchmarkFactory(
+        [] { return std::unique_ptr<KVHarnessHelper>(new WiredTigerKVBenchmarkHelper()); });
+    return Status::OK();
+}
+
+}  // namespace
+}  // namespace mongo
@@ -35,6 +35,7 @@
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
 
 #include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/operation_trace.h"
 #include "mongo/db/server_options.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
@@ -252,13 +253,16 @@ void WiredTigerRecoveryUnit::_txnClose(bool commit) {
     }
 
     int wtRet;
-    if (commit) {
-        wtRet = s->commit_transaction(s, NULL);
-        LOG(3) << "WT commit_transaction for snapshot id " << _mySnapshotId;
-    } else {
-        wtRet = s->rollback_transaction(s, NULL);
-        invariant(!wtRet);
-        LOG(3) << "WT rollback_transaction for snapshot id " << _mySnapshotId;
+    {
+        OperationTrace::Span traceSpan(OperationTrace::Phase::kStorageCommit);
+        if (commit) {
+            wtRet = s->commit_transaction(s, NULL);
+            LOG(3) << "WT commit_transaction for snapshot id " << _mySnapshotId;
+        } else {
+            wtRet = s->rollback_transaction(s, NULL);
+            invariant(!wtRet);
+            LOG(3) << "WT rollback_transaction for snapshot id " << _mySnapshotId;
+        }
     }
 
     if (_isTimestamped) {
@@ -313,6 +317,7 @@ void WiredTigerRecoveryUnit::_txnOpen() { //begin_transaction
 
 	//ҲǻȡWiredTigerSession._sessionͨWiredTigerSessionWT_SESSION* getSession()ȡ
     WT_SESSION* session = _session->getSession(); 
+    OperationTrace::Span traceSpan(OperationTrace::Phase::kStorageBegin);
     if (_readAtTimestamp != Timestamp::min()) {
         uassertStatusOK(_sessionCache->snapshotManager().beginTransactionAtTimestamp(
             _readAtTimestamp, session));
@@ -42,6 +42,7 @@
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
 #include "mongo/util/assert_util.h"
+#include "mongo/util/mongoutils/str.h"
 #include "mongo/util/scopeguard.h"
 
 namespace mongo {
@@ -83,4 +84,66 @@ BSONObj WiredTigerServerStatusSection::generateSection(OperationContext* opCtx,
     return bob.obj();
 }
 
+namespace {
+
+// The cache statistics sampled during a burst, which show cache pressure and eviction stalls.
+const int kBurstCacheStatistics[] = {
+    WT_STAT_CONN_CACHE_BYTES_INUSE,
+    WT_STAT_CONN_CACHE_BYTES_DIRTY,
+    WT_STAT_CONN_CACHE_BYTES_MAX,
+    WT_STAT_CONN_CACHE_BYTES_READ,
+    WT_STAT_CONN_CACHE_BYTES_WRITE,
+    WT_STAT_CONN_CACHE_READ,
+    WT_STAT_CONN_CACHE_WRITE,
+    WT_STAT_CONN_CACHE_EVICTION_APP,
+    WT_STAT_CONN_CACHE_EVICTION_APP_DIRTY,
+    WT_STAT_CONN_CACHE_EVICTION_SERVER_EVICTING,
+    WT_STAT_CONN_CACHE_EVICTION_WORKER_EVICTING,
+};
+
+}  // namespace
+
+WiredTigerFTDCBurstCollector::WiredTigerFTDCBurstCollector(WiredTigerKVEngine* engine)
+    : _engine(engine) {}
+
+std::string WiredTigerFTDCBurstCollector::name() const {
+    return kWiredTigerEngineName;
+}
+
+void WiredTigerFTDCBurstCollector::collect(OperationContext* opCtx, BSONObjBuilder& builder) {
+    auto session = _engine->getSessionCache()->getSession();
+    WT_SESSION* s = session->getSession();
+
+    WT_CURSOR* c = nullptr;
+    int ret = s->open_cursor(s, "statistics:", nullptr, "statistics=(fast)", &c);
+    if (ret != 0) {
+        builder.append("error", "unable to retrieve statistics");
+        builder.append("reason", wiredtiger_strerror(ret));
+    } else {
+        ON_BLOCK_EXIT(c->close, c);
+
+        // Named like the serverStatus section, i.e. by the statistic's description without its
+        // "cache: " prefix.
+        BSONObjBuilder cacheBuilder(builder.subobjStart("cache"));
+        for (int key : kBurstCacheStatistics) {
+            c->set_key(c, key);
+            const char* desc;
+            uint64_t value;
+            if (c->search(c) == 0 && c->get_value(c, &desc, nullptr, &value) == 0) {
+                StringData name(desc);
+                const size_t colon = name.find(':');
+                if (colon != std::string::npos) {
+                    name = name.substr(colon + 1);
+                }
+                cacheBuilder.appendNumber(str::ltrim(name.toString()),
+                                          static_cast<long long>(value));
+            }
+            c->reset(c);
+        }
+        cacheBuilder.done();
+    }
+
+    WiredTigerKVEngine::appendGlobalStats(builder);
+}
+
 }  // namespace mongo
@@ -31,6 +31,7 @@
 #pragma once
 
 #include "mongo/db/commands/server_status.h"
+#include "mongo/db/ftdc/collector.h"
 
 namespace mongo {
 
@@ -51,4 +52,22 @@ private:
     WiredTigerKVEngine* _engine;
 };
 
+/**
+ * Collects the WiredTiger cache counters and the ticket holder counters during an FTDC burst.
+ *
+ * Unlike the serverStatus section, it takes neither the global lock nor a ticket, so its samples
+ * aren't held up by the stalls they should show, and it reads only the few cache statistics it
+ * reports. It relies on FTDC stopping before the storage engine shuts down.
+ */
+class WiredTigerFTDCBurstCollector final : public FTDCCollectorInterface {
+public:
+    explicit WiredTigerFTDCBurstCollector(WiredTigerKVEngine* engine);
+
+    std::string name() const override;
+    void collect(OperationContext* opCtx, BSONObjBuilder& builder) override;
+
+private:
+    WiredTigerKVEngine* _engine;
+};
+
 }  // namespace mongo
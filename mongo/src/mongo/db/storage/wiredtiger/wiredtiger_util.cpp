@@ -497,6 +497,43 @@ Status WiredTigerUtil::setTableLogging(WT_SESSION* session, const std::string& u
     return Status::OK();
 }
 
+Status WiredTigerUtil::appendTableCacheStats(WT_SESSION* session,
+                                             const std::string& uri,
+                                             BSONObjBuilder* builder) {
+    invariant(session);
+    invariant(builder);
+    const std::string statsUri = "statistics:" + uri;
+    WT_CURSOR* c = NULL;
+    int ret = session->open_cursor(session, statsUri.c_str(), NULL, "statistics=(fast)", &c);
+    if (ret != 0) {
+        return Status(ErrorCodes::CursorNotFound,
+                      str::stream() << "unable to open cursor at URI " << statsUri
+                                    << ". reason: "
+                                    << wiredtiger_strerror(ret));
+    }
+    invariant(c);
+    ON_BLOCK_EXIT(c->close, c);
+
+    auto readStat = [&](int statisticsKey) -> long long {
+        c->set_key(c, statisticsKey);
+        uint64_t value;
+        if (c->search(c) != 0 || c->get_value(c, NULL, NULL, &value) != 0) {
+            return 0;
+        }
+        return _castStatisticsValue<long long>(value);
+    };
+
+    builder->appendNumber("bytesInCache", readStat(WT_STAT_DSRC_CACHE_BYTES_INUSE));
+    builder->appendNumber("dirtyBytesInCache", readStat(WT_STAT_DSRC_CACHE_BYTES_DIRTY));
+    builder->appendNumber("bytesReadIntoCache", readStat(WT_STAT_DSRC_CACHE_BYTES_READ));
+    builder->appendNumber("bytesWrittenFromCache", readStat(WT_STAT_DSRC_CACHE_BYTES_WRITE));
+    builder->appendNumber("pagesRequestedFromCache", readStat(WT_STAT_DSRC_CACHE_PAGES_REQUESTED));
+    builder->appendNumber("pagesReadIntoCache", readStat(WT_STAT_DSRC_CACHE_READ));
+    builder->appendNumber("unmodifiedPagesEvicted", readStat(WT_STAT_DSRC_CACHE_EVICTION_CLEAN));
+    builder->appendNumber("modifiedPagesEvicted", readStat(WT_STAT_DSRC_CACHE_EVICTION_DIRTY));
+    return Status::OK();
+}
+
 Status WiredTigerUtil::exportTableToBSON(WT_SESSION* session,
                                          const std::string& uri,
                                          const std::string& config,
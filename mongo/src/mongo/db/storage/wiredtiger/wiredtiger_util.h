@@ -176,6 +176,15 @@ public:
 
     static int64_t getIdentSize(WT_SESSION* s, const std::string& uri);
 
+    /**
+     * Appends how many bytes of the table at 'uri' are in the cache, and how many pages and bytes
+     * of it have been read into and evicted from the cache since the table was last opened. Only
+     * reads counters WiredTiger maintains anyway, so this is cheap enough to call for every table.
+     */
+    static Status appendTableCacheStats(WT_SESSION* session,
+                                        const std::string& uri,
+                                        BSONObjBuilder* builder);
+
 
     /**
      * Return amount of memory to use for the WiredTiger cache based on either the startup
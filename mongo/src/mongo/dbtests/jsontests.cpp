@@ -40,6 +40,7 @@
 #include "mongo/dbtests/dbtests.h"
 #include "mongo/platform/decimal128.h"
 #include "mongo/util/log.h"
+#include "mongo/util/timer.h"
 
 
 namespace JsonTests {
@@ -2526,6 +2527,36 @@ class NumericIntMin : public Base {
     }
 };
 
+class NumericDigitCounts : public Base {
+    virtual BSONObj bson() const {
+        BSONObjBuilder b;
+        b.append("a", 999999999999999999LL);
+        b.append("b", -999999999999999999LL);
+        b.append("c", 9999999999999999999.0);
+        b.append("d", 2147483648LL);
+        b.append("e", -2147483647);
+        b.append("f", 0);
+        return b.obj();
+    }
+    virtual string json() const {
+        return "{ a : 999999999999999999, b : -999999999999999999, c : 9999999999999999999, "
+               "d : 2147483648, e : -2147483647, f : 0 }";
+    }
+};
+
+class NumericNotIntegers : public Base {
+    virtual BSONObj bson() const {
+        BSONObjBuilder b;
+        b.append("a", 1.5);
+        b.append("b", 12000.0);
+        b.append("c", 16.0);
+        b.append("d", 0.25);
+        return b.obj();
+    }
+    virtual string json() const {
+        return "{ a : 1.5, b : 12e3, c : 0x10, d : 25E-2 }";
+    }
+};
 
 class NumericLimits : public Base {
     virtual BSONObj bson() const {
@@ -2689,6 +2720,45 @@ class MaxKey : public Base {
 
 }  // namespace FromJsonTests
 
+namespace PerfTests {
+
+/**
+ * Logs the time taken to parse and to serialize a document typical of what gets logged or
+ * exported, so changes to the JSON code can be compared.
+ */
+class ParseAndSerialize {
+public:
+    void run() {
+        const string json =
+            "{ \"_id\" : { \"$oid\" : \"5a1b2c3d4e5f6a7b8c9d0e1f\" }, \"name\" : \"Jane Doe\", "
+            "\"email\" : \"jane.doe@example.com\", \"age\" : 42, \"score\" : 87.25, "
+            "\"joined\" : { \"$date\" : \"2017-03-14T15:09:26.535Z\" }, "
+            "\"tags\" : [ \"alpha\", \"beta\", \"gamma\" ], "
+            "\"address\" : { \"street\" : \"123 Main St\", \"city\" : \"Springfield\", "
+            "\"zip\" : 12345 }, \"notes\" : \"line one\\nline \\\"two\\\"\" }";
+        const BSONObj obj = fromjson(json);
+        const int iters = 10000;
+
+        Timer parseTimer;
+        for (int i = 0; i < iters; i++) {
+            ASSERT_EQUALS(fromjson(json).objsize(), obj.objsize());
+        }
+        const long long parseMicros = parseTimer.micros();
+
+        Timer serializeTimer;
+        for (int i = 0; i < iters; i++) {
+            ASSERT_FALSE(obj.jsonString().empty());
+        }
+        const long long serializeMicros = serializeTimer.micros();
+
+        ::mongo::log() << "fromjson: " << 1000.0 * parseMicros / iters
+                       << " ns per document, jsonString: " << 1000.0 * serializeMicros / iters
+                       << " ns per document";
+    }
+};
+
+}  // namespace PerfTests
+
 class All : public Suite {
 public:
     All() : Suite("json") {}
@@ -2938,6 +3008,8 @@ public:
         add<FromJsonTests::ObjectId2>();
         add<FromJsonTests::NumericIntMin>();
         add<FromJsonTests::NumericLongMin>();
+        add<FromJsonTests::NumericDigitCounts>();
+        add<FromJsonTests::NumericNotIntegers>();
         add<FromJsonTests::NumericTypes>();
         add<FromJsonTests::NumericTypesJS>();
         add<FromJsonTests::NumericLimits>();
@@ -2951,6 +3023,7 @@ public:
         add<FromJsonTests::NullFieldUnquoted>();
         add<FromJsonTests::MinKey>();
         add<FromJsonTests::MaxKey>();
+        add<PerfTests::ParseAndSerialize>();
     }
 };
 
@@ -43,7 +43,7 @@
 #include "mongo/util/scopeguard.h"
 
 // One interesting implementation note herein concerns how setup() and
-// refresh() are invoked outside of the global lock, but setTimeout is not.
+// refresh() are invoked outside of the specific pool lock, but setTimeout is not.
 // This implementation detail simplifies mocks, allowing them to return
 // synchronously sometimes, whereas having timeouts fire instantly adds little
 // value. In practice, dumping the locks is always safe (because we restrict
@@ -78,8 +78,7 @@ public:
      */
     template <typename Callback>
     void runWithActiveClient(Callback&& cb) {
-        runWithActiveClient(stdx::unique_lock<stdx::mutex>(_parent->_mutex),
-                            std::forward<Callback>(cb));
+        runWithActiveClient(stdx::unique_lock<stdx::mutex>(_mutex), std::forward<Callback>(cb));
     }
 
     template <typename Callback>
@@ -90,7 +89,7 @@ public:
 
         const auto guard = MakeGuard([&] {
             invariant(!lk.owns_lock());
-            stdx::lock_guard<stdx::mutex> lk(_parent->_mutex);
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
             _activeClients--;
         });
 
@@ -104,8 +103,15 @@ public:
     ~SpecificPool();
 
     /**
-     * Gets a connection from the specific pool. Sinks a unique_lock from the
-     * parent to preserve the lock on _mutex
+     * Acquires the mutex guarding this specific pool's connections and requests.
+     */
+    stdx::unique_lock<stdx::mutex> lock() {
+        return stdx::unique_lock<stdx::mutex>(_mutex);
+    }
+
+    /**
+     * Gets a connection from the specific pool. Sinks a unique_lock to preserve
+     * the lock on _mutex
      */
     void getConnection(const HostAndPort& hostAndPort,
                        Milliseconds timeout,
@@ -120,8 +126,8 @@ public:
     void processFailure(const Status& status, stdx::unique_lock<stdx::mutex> lk);
 
     /**
-     * Returns a connection to a specific pool. Sinks a unique_lock from the
-     * parent to preserve the lock on _mutex
+     * Returns a connection to a specific pool. Sinks a unique_lock to preserve
+     * the lock on _mutex
      */
     void returnConnection(ConnectionInterface* connection, stdx::unique_lock<stdx::mutex> lk);
 
@@ -184,6 +190,9 @@ private:
 
     const HostAndPort _hostAndPort;
 
+    // Guards all of the state below
+    stdx::mutex _mutex;
+
 
 	/*
 	ConnectionPool ÿ Shard άһӳأӳذ4Сĳӣڹӵ:
@@ -256,6 +265,7 @@ droppedProcessingPool
 };
 
 constexpr Milliseconds ConnectionPool::kDefaultHostTimeout;
+constexpr size_t ConnectionPool::kNumPoolStripes;
 size_t const ConnectionPool::kDefaultMaxConns = std::numeric_limits<size_t>::max();
 size_t const ConnectionPool::kDefaultMinConns = 1;
 size_t const ConnectionPool::kDefaultMaxConnecting = std::numeric_limits<size_t>::max();
@@ -272,16 +282,25 @@ ConnectionPool::ConnectionPool(std::unique_ptr<DependentTypeFactoryInterface> im
 
 ConnectionPool::~ConnectionPool() = default;
 
+ConnectionPool::PoolStripe& ConnectionPool::_getStripe(const HostAndPort& hostAndPort) const {
+    return _stripes[std::hash<HostAndPort>()(hostAndPort) % kNumPoolStripes];
+}
+
 void ConnectionPool::dropConnections(const HostAndPort& hostAndPort) {
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    auto& stripe = _getStripe(hostAndPort);
+    stdx::unique_lock<stdx::mutex> stripeLk(stripe.mutex);
 
-    auto iter = _pools.find(hostAndPort);
+    auto iter = stripe.pools.find(hostAndPort);
 
-    if (iter == _pools.end())
+    if (iter == stripe.pools.end())
         return;
 
-    iter->second->runWithActiveClient(std::move(lk), [&](decltype(lk) lk) {
-        iter->second->processFailure(
+    auto pool = iter->second.get();
+    auto lk = pool->lock();
+    stripeLk.unlock();
+
+    pool->runWithActiveClient(std::move(lk), [&](decltype(lk) lk) {
+        pool->processFailure(
             Status(ErrorCodes::PooledConnectionsDropped, "Pooled connections dropped"),
             std::move(lk));
     });
@@ -293,20 +312,26 @@ void ConnectionPool::get(const HostAndPort& hostAndPort,
                          GetConnectionCallback cb) {
     SpecificPool* pool;
 
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    auto& stripe = _getStripe(hostAndPort);
+    stdx::unique_lock<stdx::mutex> stripeLk(stripe.mutex);
 
-    auto iter = _pools.find(hostAndPort);
+    auto iter = stripe.pools.find(hostAndPort);
 	//ȡhostAndPortӦӳ
-    if (iter == _pools.end()) {
+    if (iter == stripe.pools.end()) {
         auto handle = stdx::make_unique<SpecificPool>(this, hostAndPort);
         pool = handle.get();
-        _pools[hostAndPort] = std::move(handle);
+        stripe.pools[hostAndPort] = std::move(handle);
     } else {
         pool = iter->second.get();
     }
 
     invariant(pool);
 
+    // Hand over from the stripe lock to the specific pool lock. Becoming an active client under
+    // the pool lock keeps the pool from being shut down once the stripe lock is released.
+    auto lk = pool->lock();
+    stripeLk.unlock();
+
     pool->runWithActiveClient(std::move(lk), [&](decltype(lk) lk) {
 		//SpecificPool::getConnection
         pool->getConnection(hostAndPort, timeout, std::move(lk), std::move(cb));
@@ -314,24 +339,30 @@ void ConnectionPool::get(const HostAndPort& hostAndPort,
 }
 
 void ConnectionPool::appendConnectionStats(ConnectionPoolStats* stats) const {
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
-
-    for (const auto& kv : _pools) {
-        HostAndPort host = kv.first;
-
-        auto& pool = kv.second;
-        ConnectionStatsPer hostStats{pool->inUseConnections(lk),
-                                     pool->availableConnections(lk),
-                                     pool->createdConnections(lk),
-                                     pool->refreshingConnections(lk)};
-        stats->updateStatsForHost(_name, host, hostStats);
+    for (auto& stripe : _stripes) {
+        stdx::lock_guard<stdx::mutex> stripeLk(stripe.mutex);
+
+        for (const auto& kv : stripe.pools) {
+            HostAndPort host = kv.first;
+
+            auto& pool = kv.second;
+            auto lk = pool->lock();
+            ConnectionStatsPer hostStats{pool->inUseConnections(lk),
+                                         pool->availableConnections(lk),
+                                         pool->createdConnections(lk),
+                                         pool->refreshingConnections(lk)};
+            stats->updateStatsForHost(_name, host, hostStats);
+        }
     }
 }
 
 size_t ConnectionPool::getNumConnectionsPerHost(const HostAndPort& hostAndPort) const {
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
-    auto iter = _pools.find(hostAndPort);
-    if (iter != _pools.end()) {
+    auto& stripe = _getStripe(hostAndPort);
+    stdx::lock_guard<stdx::mutex> stripeLk(stripe.mutex);
+
+    auto iter = stripe.pools.find(hostAndPort);
+    if (iter != stripe.pools.end()) {
+        auto lk = iter->second->lock();
         return iter->second->openConnections(lk);
     }
 
@@ -339,14 +370,19 @@ size_t ConnectionPool::getNumConnectionsPerHost(const HostAndPort& hostAndPort)
 }
 
 void ConnectionPool::returnConnection(ConnectionInterface* conn) {
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    auto& stripe = _getStripe(conn->getHostAndPort());
+    stdx::unique_lock<stdx::mutex> stripeLk(stripe.mutex);
+
+    auto iter = stripe.pools.find(conn->getHostAndPort());
 
-    auto iter = _pools.find(conn->getHostAndPort());
+    invariant(iter != stripe.pools.end());
 
-    invariant(iter != _pools.end());
+    auto pool = iter->second.get();
+    auto lk = pool->lock();
+    stripeLk.unlock();
 
-    iter->second->runWithActiveClient(std::move(lk), [&](decltype(lk) lk) {
-        iter->second->returnConnection(conn, std::move(lk));
+    pool->runWithActiveClient(std::move(lk), [&](decltype(lk) lk) {
+        pool->returnConnection(conn, std::move(lk));
     });
 }
 
@@ -722,7 +758,9 @@ void ConnectionPool::SpecificPool::spawnConnections(stdx::unique_lock<stdx::mute
 
 // Called every second after hostTimeout until all processing connections reap
 void ConnectionPool::SpecificPool::shutdown() {
-    stdx::unique_lock<stdx::mutex> lk(_parent->_mutex);
+    auto& stripe = _parent->_getStripe(_hostAndPort);
+    stdx::unique_lock<stdx::mutex> stripeLk(stripe.mutex);
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
 
     // We're racing:
     //
@@ -756,7 +794,10 @@ void ConnectionPool::SpecificPool::shutdown() {
     invariant(_requests.empty());
     invariant(_checkedOutPool.empty());
 
-    _parent->_pools.erase(_hostAndPort);
+    // Nothing else can reach this pool: new clients must first take the stripe lock, which we
+    // hold. Release our own mutex before destroying it along with the pool.
+    lk.unlock();
+    stripe.pools.erase(_hostAndPort);
 }
 
 template <typename OwnershipPoolType>
@@ -27,6 +27,7 @@
 
 #pragma once
 
+#include <array>
 #include <memory>
 #include <queue>
 
@@ -150,8 +151,22 @@ public:
     size_t getNumConnectionsPerHost(const HostAndPort& hostAndPort) const;
 
 private:
+    /**
+     * One slice of the host to specific pool map. The stripe mutex only guards lookup, insertion
+     * and removal of specific pools; each SpecificPool guards its own connections and requests
+     * with a mutex of its own. When both are needed the stripe mutex is acquired first.
+     */
+    struct PoolStripe {
+        stdx::mutex mutex;
+        stdx::unordered_map<HostAndPort, std::unique_ptr<SpecificPool>> pools;
+    };
+
+    static constexpr size_t kNumPoolStripes = 16;
+
     void returnConnection(ConnectionInterface* connection);
 
+    PoolStripe& _getStripe(const HostAndPort& hostAndPort) const;
+
     std::string _name;
 
     // Options are set at startup and never changed at run time, so these are
@@ -160,9 +175,9 @@ private:
 
     const std::unique_ptr<DependentTypeFactoryInterface> _factory;
 
-    // The global mutex for specific pool access and the generation counter
-    mutable stdx::mutex _mutex;
-    stdx::unordered_map<HostAndPort, std::unique_ptr<SpecificPool>> _pools;
+    // Specific pools, spread over stripes by host so that requests to different hosts do not
+    // contend on a single mutex
+    mutable std::array<PoolStripe, kNumPoolStripes> _stripes;
 };
 
 class ConnectionPool::ConnectionHandleDeleter {
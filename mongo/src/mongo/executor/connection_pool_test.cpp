@@ -34,10 +34,15 @@
 #include "mongo/executor/connection_pool_test_fixture.h"
 
 #include "mongo/executor/connection_pool.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/future.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/scopeguard.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 namespace executor {
@@ -1308,6 +1313,167 @@ TEST_F(ConnectionPoolTest, RefreshTimeoutsDontTimeoutRequests) {
     ASSERT(!conn2);
 }
 
+/**
+ * Thread safe stand-ins for the mocks in connection_pool_test_fixture.h, which share static state
+ * and so can only be driven from one thread. Connections set up and refresh successfully and
+ * immediately, and timers never fire.
+ */
+class ConcurrentTimer final : public ConnectionPool::TimerInterface {
+public:
+    void setTimeout(Milliseconds timeout, TimeoutCallback cb) override {}
+    void cancelTimeout() override {}
+};
+
+class ConcurrentConnection final : public ConnectionPool::ConnectionInterface {
+public:
+    ConcurrentConnection(const HostAndPort& hostAndPort, size_t generation)
+        : _hostAndPort(hostAndPort), _generation(generation) {}
+
+    void indicateSuccess() override {
+        _status = Status::OK();
+    }
+
+    void indicateFailure(Status status) override {
+        _status = std::move(status);
+    }
+
+    const HostAndPort& getHostAndPort() const override {
+        return _hostAndPort;
+    }
+
+    bool isHealthy() override {
+        return true;
+    }
+
+private:
+    void setTimeout(Milliseconds timeout, TimeoutCallback cb) override {}
+
+    void cancelTimeout() override {}
+
+    void indicateUsed() override {
+        _lastUsed = Date_t::now();
+    }
+
+    Date_t getLastUsed() const override {
+        return _lastUsed;
+    }
+
+    const Status& getStatus() const override {
+        return _status;
+    }
+
+    void setup(Milliseconds timeout, SetupCallback cb) override {
+        cb(this, Status::OK());
+    }
+
+    void resetToUnknown() override {
+        _status = ConnectionPool::kConnectionStateUnknown;
+    }
+
+    void refresh(Milliseconds timeout, RefreshCallback cb) override {
+        cb(this, Status::OK());
+    }
+
+    size_t getGeneration() const override {
+        return _generation;
+    }
+
+    const HostAndPort _hostAndPort;
+    const size_t _generation;
+    Date_t _lastUsed;
+    Status _status = Status::OK();
+};
+
+class ConcurrentPoolImpl final : public ConnectionPool::DependentTypeFactoryInterface {
+public:
+    std::unique_ptr<ConnectionPool::ConnectionInterface> makeConnection(
+        const HostAndPort& hostAndPort, size_t generation) override {
+        return stdx::make_unique<ConcurrentConnection>(hostAndPort, generation);
+    }
+
+    std::unique_ptr<ConnectionPool::TimerInterface> makeTimer() override {
+        return stdx::make_unique<ConcurrentTimer>();
+    }
+
+    Date_t now() override {
+        return Date_t::now();
+    }
+};
+
+/**
+ * Contention benchmark: many threads check connections out of and back into pools for many hosts
+ * at once. Verifies that every request is satisfied and that no host opens more connections than
+ * there are threads, and logs the throughput.
+ */
+TEST(ConnectionPoolContentionTest, ManyThreadsManyHosts) {
+    ConnectionPool pool(stdx::make_unique<ConcurrentPoolImpl>(), "contention test pool");
+
+    const size_t kThreads = 32;
+    const size_t kHosts = 64;
+    const size_t kIterations = 5000;
+
+    std::vector<HostAndPort> hosts;
+    for (size_t i = 0; i < kHosts; ++i) {
+        hosts.emplace_back("host" + std::to_string(i), 27017);
+    }
+
+    AtomicWord<long long> completed{0};
+    AtomicWord<long long> failed{0};
+
+    stdx::mutex mutex;
+    stdx::condition_variable cv;
+
+    Timer timer;
+
+    std::vector<stdx::thread> threads;
+    for (size_t t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&, t] {
+            for (size_t i = 0; i < kIterations; ++i) {
+                const auto& host = hosts[(t * kIterations + i) % kHosts];
+                pool.get(host,
+                         Milliseconds(5000),
+                         [&](StatusWith<ConnectionPool::ConnectionHandle> swConn) {
+                             if (swConn.isOK()) {
+                                 swConn.getValue()->indicateSuccess();
+                             } else {
+                                 failed.fetchAndAdd(1);
+                             }
+                             // Returns the connection, if any, to the pool.
+                             swConn = Status(ErrorCodes::InternalError, "done");
+
+                             if (completed.addAndFetch(1) ==
+                                 static_cast<long long>(kThreads * kIterations)) {
+                                 stdx::lock_guard<stdx::mutex> lk(mutex);
+                                 cv.notify_all();
+                             }
+                         });
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    {
+        stdx::unique_lock<stdx::mutex> lk(mutex);
+        cv.wait(lk, [&] {
+            return completed.load() == static_cast<long long>(kThreads * kIterations);
+        });
+    }
+
+    const auto micros = timer.micros();
+    unittest::log() << "connection pool contention: " << kThreads << " threads, " << kHosts
+                    << " hosts, " << kThreads * kIterations << " checkouts in " << micros / 1000
+                    << "ms (" << (kThreads * kIterations * 1000000) / std::max(micros, 1LL)
+                    << " checkouts/s)";
+
+    ASSERT_EQ(0, failed.load());
+    for (const auto& host : hosts) {
+        ASSERT_LTE(pool.getNumConnectionsPerHost(host), kThreads);
+    }
+}
+
 }  // namespace connection_pool_test_details
 }  // namespace executor
 }  // namespace mongo
@@ -46,6 +46,10 @@ void testAtomicWordBasicOperations() {
     w.store(1);
     ASSERT_EQUALS(WordType(1), w.load());
 
+    w.storeRelaxed(3);
+    ASSERT_EQUALS(WordType(3), w.loadRelaxed());
+    w.store(1);
+
     ASSERT_EQUALS(WordType(1), w.swap(2));
     ASSERT_EQUALS(WordType(2), w.load());
 
@@ -122,6 +126,10 @@ TEST(AtomicWordTests, BasicOperationsFloat) {
     w.store(1);
     ASSERT_EQUALS(WordType(1), w.load());
 
+    w.storeRelaxed(3);
+    ASSERT_EQUALS(WordType(3), w.loadRelaxed());
+    w.store(1);
+
     ASSERT_EQUALS(WordType(1), w.swap(2));
     ASSERT_EQUALS(WordType(2), w.load());
 
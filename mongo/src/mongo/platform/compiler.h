@@ -145,6 +145,14 @@
  *    MONGO_COMPILER_NORETURN. In almost all cases MONGO_UNREACHABLE is preferred.
  *
  *
+ * MONGO_COMPILER_TLS_INITIAL_EXEC
+ *
+ *    Instructs the compiler to use the initial-exec model for a thread_local variable, so that it
+ *    is reached at a fixed offset from the thread pointer rather than through __tls_get_addr, which
+ *    may allocate. Use it for thread locals which are read from signal handlers or updated on very
+ *    hot paths. Expands to nothing where the compiler has no such model.
+ *
+ *
  * MONGO_WARN_UNUSED_RESULT_CLASS
  *
  *    Tells the compiler that a class defines a type for which checking results is necessary.  Types
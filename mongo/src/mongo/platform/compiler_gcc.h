@@ -83,3 +83,5 @@
 #define MONGO_COMPILER_ALWAYS_INLINE [[gnu::always_inline]]
 
 #define MONGO_COMPILER_UNREACHABLE __builtin_unreachable()
+
+#define MONGO_COMPILER_TLS_INITIAL_EXEC __attribute__((__tls_model__("initial-exec")))
@@ -67,3 +67,5 @@
 #define MONGO_COMPILER_ALWAYS_INLINE __forceinline
 
 #define MONGO_COMPILER_UNREACHABLE __assume(false)
+
+#define MONGO_COMPILER_TLS_INITIAL_EXEC
@@ -60,6 +60,8 @@ public:
         return *this;
     }
     BSONObjBuilder getInPlaceReplyBuilder(std::size_t reserveBytes) override {
+        // Start from a buffer of the right size so the reservation below does not reallocate.
+        _builder.reserveBytes(reserveBytes + BSONObj::kMinBSONLength);
         BSONObjBuilder bob = _builder.beginBody();
         // Eagerly reserve space and claim our reservation immediately so we can actually write data
         // to it.
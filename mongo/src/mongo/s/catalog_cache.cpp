@@ -32,8 +32,10 @@
 
 #include "mongo/s/catalog_cache.h"
 
+#include "mongo/base/counter.h"
 #include "mongo/base/status.h"
 #include "mongo/base/status_with.h"
+#include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/query/collation/collator_factory_interface.h"
 #include "mongo/db/repl/optime_with.h"
 #include "mongo/platform/unordered_set.h"
@@ -44,6 +46,7 @@
 #include "mongo/s/grid.h"
 #include "mongo/util/concurrency/with_lock.h"
 #include "mongo/util/log.h"
+#include "mongo/util/scopeguard.h"
 #include "mongo/util/timer.h"
 
 namespace mongo {
@@ -53,6 +56,23 @@ namespace {
 // server is found to be inconsistent.
 const int kMaxInconsistentRoutingInfoRefreshAttempts = 3;
 
+// Config server reads started by the cache, and callers which waited for one of them to complete
+// instead of issuing their own. joined / (started + joined) is the fraction of identical reads
+// saved by sharing them.
+Counter64 collectionRefreshesStarted;
+Counter64 collectionRefreshesJoined;
+Counter64 databaseLoadsStarted;
+Counter64 databaseLoadsJoined;
+
+ServerStatusMetricField<Counter64> displayCollectionRefreshesStarted(
+    "catalogCache.collectionRefreshes.started", &collectionRefreshesStarted);
+ServerStatusMetricField<Counter64> displayCollectionRefreshesJoined(
+    "catalogCache.collectionRefreshes.joined", &collectionRefreshesJoined);
+ServerStatusMetricField<Counter64> displayDatabaseLoadsStarted(
+    "catalogCache.databaseLoads.started", &databaseLoadsStarted);
+ServerStatusMetricField<Counter64> displayDatabaseLoadsJoined("catalogCache.databaseLoads.joined",
+                                                              &databaseLoadsJoined);
+
 /**
  * Given an (optional) initial routing table and a set of changed chunks returned by the catalog
  * cache loader, produces a new routing table with the changes applied.
@@ -213,6 +233,9 @@ StatusWith<CachedCollectionRoutingInfo>
                                            std::make_shared<Notification<Status>>());
 				//ȡdbEntry¶Ӧnssϵchunks·Ϣ
                 _scheduleCollectionRefresh(ul, dbEntry, std::move(collEntry.routingInfo), nss, 1);
+                collectionRefreshesStarted.increment();
+            } else {
+                collectionRefreshesJoined.increment();
             }
 
             // Wait on the notification outside of the mutex
@@ -378,14 +401,38 @@ void CatalogCache::purgeAllDatabases() {
 //ȴcachezлȡcacheûcfgƼconfig.databaseconfig.collectionsлȡdbName⼰ıϢ
 std::shared_ptr<CatalogCache::DatabaseInfoEntry> CatalogCache::_getDatabase(OperationContext* opCtx,
                                                                             StringData dbName) {
-    stdx::lock_guard<stdx::mutex> lg(_mutex);
+    stdx::unique_lock<stdx::mutex> ul(_mutex, stdx::try_to_lock);
+
+    // Database loads hold the mutex, so only a caller which has to wait for it can be sharing one
+    bool joinedLoad = false;
+    if (!ul.owns_lock()) {
+        {
+            stdx::lock_guard<stdx::mutex> lg(_loadingDatabaseMutex);
+            joinedLoad = (dbName == _loadingDatabase);
+        }
+        ul.lock();
+    }
 
 	//dbϢѾڣֱӷ
     auto it = _databases.find(dbName);
     if (it != _databases.end()) {
+        if (joinedLoad) {
+            databaseLoadsJoined.increment();
+        }
         return it->second;
     }
 
+    databaseLoadsStarted.increment();
+
+    {
+        stdx::lock_guard<stdx::mutex> lg(_loadingDatabaseMutex);
+        _loadingDatabase = dbName.toString();
+    }
+    ON_BLOCK_EXIT([this] {
+        stdx::lock_guard<stdx::mutex> lg(_loadingDatabaseMutex);
+        _loadingDatabase.clear();
+    });
+
 	//ûл棬cfgлȡ
 
 
@@ -204,6 +204,13 @@ private:
 
     // Map from DB name to the info for that database
     DatabaseInfoMap _databases; 
+
+    // Protects _loadingDatabase. Taken only by callers of _getDatabase which find _mutex held, so
+    // that they can tell whether they are waiting for the load of the database they need.
+    stdx::mutex _loadingDatabaseMutex;
+
+    // Name of the database being loaded from the config server by _getDatabase, if any
+    std::string _loadingDatabase;
 };
 
 /**
@@ -135,6 +135,11 @@ public:
         MONGO_UNREACHABLE;
     }
 
+    Status appendCacheResidency(const NamespaceString& nss,
+                                BSONObjBuilder* builder) const final {
+        MONGO_UNREACHABLE;
+    }
+
     BSONObj getCollectionOptions(const NamespaceString& nss) final {
         MONGO_UNREACHABLE;
     }
@@ -165,6 +170,14 @@ public:
         MONGO_UNREACHABLE;
     }
 
+    std::vector<BSONObj> getQueryStats(bool includeHistograms) const final {
+        MONGO_UNREACHABLE;
+    }
+
+    std::vector<BSONObj> getCacheResidency() const final {
+        MONGO_UNREACHABLE;
+    }
+
     std::string getShardName(OperationContext* opCtx) const final {
         MONGO_UNREACHABLE;
     }
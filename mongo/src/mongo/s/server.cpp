@@ -50,6 +50,7 @@
 #include "mongo/db/auth/authz_manager_external_state_s.h"
 #include "mongo/db/auth/user_cache_invalidator_job.h"
 #include "mongo/db/client.h"
+#include "mongo/db/commands/cpu_sampling_profiler.h"
 #include "mongo/db/ftdc/ftdc_mongos.h"
 #include "mongo/db/generic_cursor_manager.h"
 #include "mongo/db/generic_cursor_manager_mongos.h"
@@ -416,6 +417,7 @@ static ExitCode runMongosServer() {
     }
 
     startMongoSFTDC();
+    startCpuSamplingProfiler();
 
     Status status = getGlobalAuthorizationManager()->initialize(NULL);
     if (!status.isOK()) {
@@ -35,6 +35,7 @@
 #include "mongo/config.h"
 #include "mongo/db/client.h"
 #include "mongo/db/dbmessage.h"
+#include "mongo/db/operation_trace.h"
 #include "mongo/db/stats/counters.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/transport/message_compressor_manager.h"
@@ -49,6 +50,7 @@
 #include "mongo/util/exit.h"
 #include "mongo/util/log.h"
 #include "mongo/util/net/message.h"
+#include "mongo/util/net/message_buffer_pool.h"
 #include "mongo/util/net/socket_exception.h"
 #include "mongo/util/net/thread_idle_callback.h"
 #include "mongo/util/quick_exit.h"
@@ -390,7 +392,15 @@ void ServiceStateMachine::_sinkMessage(ThreadGuard guard, Message toSink) {
 	//boost-asioݷͼص
     if (_transportMode == transport::Mode::kSynchronous) {
 		//ASIOSinkTicketݳɹִ_sinkCallback
-        _sinkCallback(_session()->getTransportLayer()->wait(std::move(ticket)));
+        auto status = _session()->getTransportLayer()->wait(std::move(ticket));
+
+        // The reply has been written out, so its buffer can be reused for the next one built on
+        // this thread.
+        SharedBuffer replyBuf = toSink.sharedBuffer();
+        toSink.reset();
+        MessageBufferPool::release(std::move(replyBuf));
+
+        _sinkCallback(std::move(status));
     } else if (_transportMode == transport::Mode::kAsynchronous) {
 		//ASIOSinkTicketݳɹִ_sinkCallback
 		_session()->getTransportLayer()->asyncWait(
@@ -453,6 +463,7 @@ void ServiceStateMachine::_sinkCallback(Status status) {
     ThreadGuard guard(this);
 
     dassert(state() == State::SinkWait);
+    OperationTrace::onMessageDone(Client::getCurrent());
 	//log() << "ddd test .. ServiceStateMachine::_sinkCallback ";
 
     // If there was an error sinking the message to the client, then we should print an error and
@@ -528,6 +539,7 @@ void ServiceStateMachine::_processMessage(ThreadGuard guard) {
 
 	//
     networkCounter.hitLogicalIn(_inMessage.size());
+    OperationTrace::onMessageStart(Client::getCurrent());
 
     // Pass sourced Message to handler to generate response.
     //ȡһΨһUniqueOperationContextһͻ˶ӦһUniqueOperationContext
@@ -566,9 +578,11 @@ void ServiceStateMachine::_processMessage(ThreadGuard guard) {
             uassertStatusOK(swm.getStatus());
             toSink = swm.getValue();
         }
+        OperationTrace::onSinkStart(Client::getCurrent());
         _sinkMessage(std::move(guard), std::move(toSink));
 
     } else {
+        OperationTrace::onMessageDone(Client::getCurrent());
         _state.store(State::Source);
         _inMessage.reset();
         return _scheduleNextWithGuard(std::move(guard), ServiceExecutor::kDeferredTask);
@@ -0,0 +1,329 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kDefault
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/unittest/benchmark.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+
+#include "mongo/db/jsobj.h"
+#include "mongo/logger/redaction.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/debug_util.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/time_support.h"
+#include "mongo/util/version.h"
+
+namespace mongo {
+namespace unittest {
+
+namespace {
+
+// Upper bound on the iterations of a single run, so that an empty loop body terminates.
+const std::size_t kMaxIterations = 1000 * 1000 * 1000;
+
+std::vector<std::unique_ptr<Benchmark>>& registeredBenchmarks() {
+    static auto benchmarks = new std::vector<std::unique_ptr<Benchmark>>();
+    return *benchmarks;
+}
+
+std::string makeRunName(const std::string& name, const std::vector<long long>& args) {
+    str::stream ss;
+    ss << name;
+    for (auto arg : args) {
+        ss << '/' << arg;
+    }
+    return ss;
+}
+
+struct RunResult {
+    std::size_t iterations;
+    Nanoseconds elapsed;
+    long long itemsProcessed;
+    long long bytesProcessed;
+    std::string label;
+
+    double nanosPerIteration() const {
+        return static_cast<double>(durationCount<Nanoseconds>(elapsed)) / iterations;
+    }
+
+    double perSecond(long long count) const {
+        const auto nanos = durationCount<Nanoseconds>(elapsed);
+        return nanos == 0 ? 0 : count * 1e9 / nanos;
+    }
+};
+
+RunResult runOnce(const Benchmark::BenchmarkFunction& fn,
+                  const std::vector<long long>& args,
+                  std::size_t iterations) {
+    BenchmarkState state(args, iterations);
+    fn(state);
+    uassert(40680, "benchmark did not run its keepRunning() loop to the end", state.finished());
+
+    return {iterations,
+            state.elapsed(),
+            state.getItemsProcessed(),
+            state.getBytesProcessed(),
+            state.getLabel()};
+}
+
+/**
+ * Runs a benchmark with increasing numbers of iterations until a run lasts at least 'minTime',
+ * then runs it again with that number of iterations until there are 'repetitions' results.
+ */
+std::vector<RunResult> runBenchmark(const Benchmark::BenchmarkFunction& fn,
+                                    const std::vector<long long>& args,
+                                    Milliseconds minTime,
+                                    int repetitions) {
+    std::vector<RunResult> results;
+    const auto minNanos = durationCount<Nanoseconds>(minTime);
+
+    std::size_t iterations = 1;
+    for (;;) {
+        auto result = runOnce(fn, args, iterations);
+        const auto nanos = durationCount<Nanoseconds>(result.elapsed);
+        if (nanos >= minNanos || iterations >= kMaxIterations) {
+            results.push_back(std::move(result));
+            break;
+        }
+
+        // Aim a little past the minimum time, unless the run was too short to extrapolate from.
+        double multiplier = 10;
+        if (nanos > minNanos / 10) {
+            multiplier = 1.4 * minNanos / nanos;
+        }
+        iterations = std::min(
+            kMaxIterations,
+            std::max(iterations + 1, static_cast<std::size_t>(iterations * multiplier)));
+    }
+
+    while (results.size() < static_cast<std::size_t>(repetitions)) {
+        results.push_back(runOnce(fn, args, iterations));
+    }
+
+    return results;
+}
+
+void printHeader() {
+    std::cout << std::left << std::setw(48) << "Benchmark" << std::right << std::setw(16)
+              << "ns/iteration" << std::setw(14) << "iterations" << std::setw(14) << "items/s"
+              << std::setw(14) << "MB/s"
+              << "  label" << std::endl;
+}
+
+void printResult(const std::string& name, const RunResult& result) {
+    std::cout << std::left << std::setw(48) << name << std::right << std::fixed
+              << std::setprecision(1) << std::setw(16) << result.nanosPerIteration()
+              << std::setw(14) << result.iterations << std::setw(14)
+              << result.perSecond(result.itemsProcessed) << std::setw(14)
+              << result.perSecond(result.bytesProcessed) / (1024 * 1024) << "  " << result.label
+              << std::endl;
+}
+
+BSONObj makeContext() {
+    const auto& version =
+        VersionInfoInterface::instance(VersionInfoInterface::NotEnabledAction::kFallback);
+
+    BSONObjBuilder builder;
+    builder.append("date", dateToISOStringUTC(Date_t::now()));
+    builder.append("version", version.version());
+    builder.append("gitVersion", version.gitVersion());
+    builder.append("allocator", version.allocator());
+    builder.append("debug", kDebugBuild);
+    builder.append("numCores", static_cast<int>(stdx::thread::hardware_concurrency()));
+    return builder.obj();
+}
+
+}  // namespace
+
+namespace benchmark_detail {
+void useCharPointer(const volatile char* ptr) {}
+}  // namespace benchmark_detail
+
+bool BenchmarkState::_keepRunningSlow() {
+    if (!_started) {
+        _started = true;
+        _start = Clock::now();
+        if (_remaining != 0) {
+            --_remaining;
+            return true;
+        }
+    }
+
+    if (!_paused) {
+        pauseTiming();
+    }
+    _finished = true;
+    return false;
+}
+
+void BenchmarkState::pauseTiming() {
+    invariant(!_paused);
+    _elapsed += duration_cast<Nanoseconds>(Clock::now() - _start);
+    _paused = true;
+}
+
+void BenchmarkState::resumeTiming() {
+    invariant(_paused);
+    _paused = false;
+    _start = Clock::now();
+}
+
+long long BenchmarkState::range(std::size_t i) const {
+    invariant(i < _args.size());
+    return _args[i];
+}
+
+Benchmark* Benchmark::arg(long long arg) {
+    return args({arg});
+}
+
+Benchmark* Benchmark::args(std::vector<long long> args) {
+    _args.push_back(std::move(args));
+    return this;
+}
+
+Benchmark* Benchmark::range(long long lo, long long hi, long long multiplier) {
+    invariant(lo > 0 && lo <= hi && multiplier > 1);
+    for (long long i = lo; i < hi; i *= multiplier) {
+        arg(i);
+    }
+    return arg(hi);
+}
+
+std::vector<std::string> Benchmark::_getRunNames() const {
+    if (_args.empty()) {
+        return {_name};
+    }
+
+    std::vector<std::string> names;
+    for (const auto& args : _args) {
+        names.push_back(makeRunName(_name, args));
+    }
+    return names;
+}
+
+Benchmark* Benchmark::registerBenchmark(std::string name, BenchmarkFunction fn) {
+    auto& benchmarks = registeredBenchmarks();
+    benchmarks.push_back(stdx::make_unique<Benchmark>(std::move(name), std::move(fn)));
+    return benchmarks.back().get();
+}
+
+std::vector<std::string> Benchmark::getAllRunNames() {
+    std::vector<std::string> names;
+    for (const auto& benchmark : registeredBenchmarks()) {
+        auto runNames = benchmark->_getRunNames();
+        names.insert(names.end(), runNames.begin(), runNames.end());
+    }
+    return names;
+}
+
+int Benchmark::runAll(const RunOptions& options) {
+    if (kDebugBuild) {
+        warning() << "Benchmarks are running in a debug build, timings are not representative";
+    }
+
+    BSONArrayBuilder resultsBuilder;
+    bool failed = false;
+
+    printHeader();
+    for (const auto& benchmark : registeredBenchmarks()) {
+        std::vector<std::vector<long long>> allArgs = benchmark->_args;
+        if (allArgs.empty()) {
+            allArgs.emplace_back();
+        }
+
+        for (const auto& args : allArgs) {
+            const auto name = makeRunName(benchmark->_name, args);
+            if (name.find(options.filter) == std::string::npos) {
+                continue;
+            }
+
+            std::vector<RunResult> results;
+            try {
+                results =
+                    runBenchmark(benchmark->_fn, args, options.minTime, options.repetitions);
+            } catch (const DBException& ex) {
+                error() << "Benchmark " << name << " failed: " << redact(ex);
+                failed = true;
+                continue;
+            }
+
+            std::sort(results.begin(), results.end(), [](const RunResult& a, const RunResult& b) {
+                return a.nanosPerIteration() < b.nanosPerIteration();
+            });
+            const auto& median = results[results.size() / 2];
+            printResult(name, median);
+
+            BSONObjBuilder resultBuilder(resultsBuilder.subobjStart());
+            resultBuilder.append("name", name);
+            resultBuilder.append("iterations", static_cast<int>(median.iterations));
+            resultBuilder.append("repetitions", static_cast<int>(results.size()));
+            resultBuilder.append("nsPerIteration", median.nanosPerIteration());
+            resultBuilder.append("minNsPerIteration", results.front().nanosPerIteration());
+            resultBuilder.append("maxNsPerIteration", results.back().nanosPerIteration());
+            if (median.itemsProcessed) {
+                resultBuilder.append("itemsPerSecond", median.perSecond(median.itemsProcessed));
+            }
+            if (median.bytesProcessed) {
+                resultBuilder.append("bytesPerSecond", median.perSecond(median.bytesProcessed));
+            }
+            if (!median.label.empty()) {
+                resultBuilder.append("label", median.label);
+            }
+        }
+    }
+
+    if (!options.outFile.empty()) {
+        BSONObjBuilder builder;
+        builder.append("context", makeContext());
+        builder.append("benchmarks", resultsBuilder.arr());
+
+        std::ofstream out(options.outFile, std::ios::out | std::ios::trunc);
+        out << builder.obj().jsonString(Strict, true) << std::endl;
+        if (!out.good()) {
+            error() << "Failed to write the benchmark results to " << options.outFile;
+            return EXIT_FAILURE;
+        }
+    }
+
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+}  // namespace unittest
+}  // namespace mongo
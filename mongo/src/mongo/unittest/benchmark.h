@@ -0,0 +1,272 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+/*
+ * A micro benchmark framework, modeled after Google Benchmark.
+ *
+ * A benchmark is a function taking a BenchmarkState, which times the body of its keepRunning()
+ * loop. The framework picks the number of iterations so that each run lasts long enough to
+ * measure, and reports the time per iteration along with any items or bytes processed:
+ *
+ *     void BM_BSONObjBuild(BenchmarkState& state) {
+ *         while (state.keepRunning()) {
+ *             BSONObjBuilder b;
+ *             ...
+ *         }
+ *         state.setItemsProcessed(state.iterations());
+ *     }
+ *     MONGO_BENCHMARK(BM_BSONObjBuild)->arg(10)->arg(100);
+ *
+ * Work done before the first call to keepRunning() is not timed. Benchmarks are linked against
+ * benchmark_main, see benchmark_main.cpp for the command line options.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
+#include "mongo/platform/compiler.h"
+#include "mongo/stdx/chrono.h"
+#include "mongo/stdx/functional.h"
+#include "mongo/util/duration.h"
+
+/**
+ * Registers FUNCTION, a void(BenchmarkState&), as a benchmark named after it. Evaluates to the
+ * registered Benchmark*, so that arguments can be chained on.
+ */
+#define MONGO_BENCHMARK(FUNCTION)                                                  \
+    static ::mongo::unittest::Benchmark* const _BENCHMARK_VAR_NAME(__LINE__) =     \
+        ::mongo::unittest::Benchmark::registerBenchmark(#FUNCTION, FUNCTION)
+
+#define _BENCHMARK_VAR_NAME(LINE) _BENCHMARK_VAR_NAME_IMPL(LINE)
+#define _BENCHMARK_VAR_NAME_IMPL(LINE) mongoBenchmark__##LINE
+
+namespace mongo {
+namespace unittest {
+
+/**
+ * Handed to each run of a benchmark. Times the keepRunning() loop and collects the counters the
+ * benchmark wants reported.
+ */
+class BenchmarkState {
+    MONGO_DISALLOW_COPYING(BenchmarkState);
+
+public:
+    using Clock = stdx::chrono::steady_clock;
+
+    BenchmarkState(std::vector<long long> args, std::size_t iterations)
+        : _args(std::move(args)), _iterations(iterations), _remaining(iterations) {}
+
+    /**
+     * Returns true while there are iterations left to run. The first call starts the timer and
+     * the one returning false stops it.
+     */
+    bool keepRunning() {
+        if (MONGO_likely(_started && _remaining != 0)) {
+            --_remaining;
+            return true;
+        }
+        return _keepRunningSlow();
+    }
+
+    /**
+     * Exclude the work done between pauseTiming() and resumeTiming() from the measured time. Both
+     * read the clock, so avoid calling them on every iteration of very short benchmarks.
+     */
+    void pauseTiming();
+    void resumeTiming();
+
+    /**
+     * Returns the i-th argument this run of the benchmark was registered with.
+     */
+    long long range(std::size_t i = 0) const;
+
+    /**
+     * Returns the number of times the keepRunning() loop runs.
+     */
+    std::size_t iterations() const {
+        return _iterations;
+    }
+
+    /**
+     * Set the number of items or bytes handled by the whole run, which are reported as rates.
+     */
+    void setItemsProcessed(long long items) {
+        _itemsProcessed = items;
+    }
+
+    void setBytesProcessed(long long bytes) {
+        _bytesProcessed = bytes;
+    }
+
+    /**
+     * Attaches a free form string to the results of this run.
+     */
+    void setLabel(StringData label) {
+        _label = label.toString();
+    }
+
+    Nanoseconds elapsed() const {
+        return _elapsed;
+    }
+
+    long long getItemsProcessed() const {
+        return _itemsProcessed;
+    }
+
+    long long getBytesProcessed() const {
+        return _bytesProcessed;
+    }
+
+    const std::string& getLabel() const {
+        return _label;
+    }
+
+    bool finished() const {
+        return _finished;
+    }
+
+private:
+    bool _keepRunningSlow();
+
+    const std::vector<long long> _args;
+    const std::size_t _iterations;
+    std::size_t _remaining;
+
+    bool _started{false};
+    bool _finished{false};
+    bool _paused{false};
+
+    Clock::time_point _start;
+    Nanoseconds _elapsed{0};
+
+    long long _itemsProcessed{0};
+    long long _bytesProcessed{0};
+    std::string _label;
+};
+
+namespace benchmark_detail {
+void useCharPointer(const volatile char* ptr);
+}  // namespace benchmark_detail
+
+/**
+ * Keeps the compiler from optimizing away the computation of 'value', whose result a benchmark
+ * would otherwise discard.
+ */
+template <typename T>
+inline void doNotOptimize(const T& value) {
+#if defined(_MSC_VER)
+    benchmark_detail::useCharPointer(&reinterpret_cast<const volatile char&>(value));
+#else
+    asm volatile("" : : "r,m"(value) : "memory");
+#endif
+}
+
+/**
+ * A registered benchmark function, along with the sets of arguments to run it with.
+ */
+class Benchmark {
+    MONGO_DISALLOW_COPYING(Benchmark);
+
+public:
+    using BenchmarkFunction = stdx::function<void(BenchmarkState&)>;
+
+    /**
+     * Options for runAll().
+     */
+    struct RunOptions {
+        // Only run benchmarks whose full name, e.g. "BM_BSONObjBuild/10", contains this.
+        std::string filter;
+
+        // Minimum duration of the timed run of each benchmark.
+        Milliseconds minTime{500};
+
+        // Number of timed runs of each benchmark. The median is reported.
+        int repetitions{1};
+
+        // If not empty, the path of a file to write the results to as JSON.
+        std::string outFile;
+    };
+
+    Benchmark(std::string name, BenchmarkFunction fn) : _name(std::move(name)), _fn(std::move(fn)) {}
+
+    /**
+     * Adds a run of this benchmark with the given argument(s), available through
+     * BenchmarkState::range(). A benchmark without any runs added is run once without arguments.
+     */
+    Benchmark* arg(long long arg);
+    Benchmark* args(std::vector<long long> args);
+
+    /**
+     * Adds a run for 'lo', each power of 'multiplier' between 'lo' and 'hi', and 'hi'.
+     */
+    Benchmark* range(long long lo, long long hi, long long multiplier = 8);
+
+    /**
+     * Calls 'fn' with this benchmark, to add runs with arguments computed by a helper.
+     */
+    Benchmark* apply(const stdx::function<void(Benchmark*)>& fn) {
+        fn(this);
+        return this;
+    }
+
+    const std::string& getName() const {
+        return _name;
+    }
+
+    /**
+     * Registers a benchmark, which may be done from a static initializer or a MONGO_INITIALIZER.
+     * The returned Benchmark lives until the process exits.
+     */
+    static Benchmark* registerBenchmark(std::string name, BenchmarkFunction fn);
+
+    /**
+     * Returns the full names of the runs of all registered benchmarks.
+     */
+    static std::vector<std::string> getAllRunNames();
+
+    /**
+     * Runs all the registered benchmarks selected by the options and reports their results.
+     * Returns the exit code for the process.
+     */
+    static int runAll(const RunOptions& options);
+
+private:
+    std::vector<std::string> _getRunNames() const;
+
+    const std::string _name;
+    const BenchmarkFunction _fn;
+    std::vector<std::vector<long long>> _args;
+};
+
+}  // namespace unittest
+}  // namespace mongo
@@ -0,0 +1,68 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/allocation_counter.h"
+
+#include "mongo/platform/compiler.h"
+
+namespace mongo {
+
+namespace {
+
+// Only set during startup, before any operations run.
+bool active = false;
+
+// Initial-exec, so that the allocator hook reaches it without going through __tls_get_addr, which
+// may itself allocate.
+MONGO_COMPILER_TLS_INITIAL_EXEC thread_local AtomicInt64 threadAllocatedBytes;
+
+}  // namespace
+
+bool AllocationCounter::isActive() {
+    return active;
+}
+
+void AllocationCounter::activate() {
+    active = true;
+}
+
+void AllocationCounter::onAllocation(size_t bytes) {
+    // Only this thread writes its count, so a plain load and store suffice and the hot allocation
+    // path avoids a locked read-modify-write. Readers on other threads only need to see some
+    // recent value.
+    threadAllocatedBytes.storeRelaxed(threadAllocatedBytes.loadRelaxed() +
+                                      static_cast<long long>(bytes));
+}
+
+const AtomicInt64* AllocationCounter::forCurrentThread() {
+    return &threadAllocatedBytes;
+}
+
+}  // namespace mongo
@@ -0,0 +1,69 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#include "mongo/platform/atomic_word.h"
+
+namespace mongo {
+
+/**
+ * Counts the bytes each thread allocates through the process allocator. The counts are only kept
+ * when the allocator lets us hook its allocation path, which is the case for tcmalloc, and the hook
+ * is installed at startup by calling activate().
+ *
+ * Each thread's count only grows and is only written by its own thread, but may be read by other
+ * threads which have been handed its address.
+ */
+class AllocationCounter {
+public:
+    /**
+     * Returns true once allocations are being counted.
+     */
+    static bool isActive();
+
+    /**
+     * Marks allocations as being counted. Called once, by the allocator hook's installer.
+     */
+    static void activate();
+
+    /**
+     * Adds 'bytes' to the count of the current thread. Called from the allocator's hook, so it
+     * must not allocate.
+     */
+    static void onAllocation(size_t bytes);
+
+    /**
+     * Returns the count of the current thread, which stays valid until the thread exits.
+     */
+    static const AtomicInt64* forCurrentThread();
+};
+
+}  // namespace mongo
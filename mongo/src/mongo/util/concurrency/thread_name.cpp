@@ -50,8 +50,10 @@
 #include "mongo/base/init.h"
 #include "mongo/config.h"
 #include "mongo/platform/atomic_word.h"
+#include "mongo/platform/compiler.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/sampling_profiler.h"
 
 namespace mongo {
 
@@ -107,13 +109,14 @@ MONGO_INITIALIZER(ThreadNameInitializer)(InitializerContext*) {
 // TODO consider making threadName std::string and removing the size limit once we get real
 // thread_local.
 constexpr size_t kMaxThreadNameSize = 63;
-thread_local char threadNameStorage[kMaxThreadNameSize + 1];
+// Initial-exec, like threadName, since the sampling profiler's signal handler reads it.
+MONGO_COMPILER_TLS_INITIAL_EXEC thread_local char threadNameStorage[kMaxThreadNameSize + 1];
 
 }  // namespace
 
 namespace for_debuggers {
 // This needs external linkage to ensure that debuggers can use it.
-thread_local StringData threadName;
+MONGO_COMPILER_TLS_INITIAL_EXEC thread_local StringData threadName;
 }
 using for_debuggers::threadName;
 //߳
@@ -125,6 +128,7 @@ void setThreadName(StringData name) {
     }
     name.copyTo(threadNameStorage, /*null terminate=*/true);
     threadName = StringData(threadNameStorage, name.size());
+    SamplingProfiler::registerCurrentThread();
 
 #if defined(_WIN32)
     // Naming should not be expensive compared to thread creation and connection set up, but if
@@ -183,4 +187,20 @@ StringData getThreadName() {
     return threadName;
 }
 
+size_t copyThreadNameAsyncSignalSafe(char* buffer, size_t size) {
+    if (size == 0) {
+        return 0;
+    }
+
+    StringData name;
+    if (mongoInitializersHaveRun) {
+        name = threadName;
+    }
+    if (name.size() >= size) {
+        name = name.substr(0, size - 1);
+    }
+    name.copyTo(buffer, /*null terminate=*/true);
+    return name.size();
+}
+
 }  // namespace mongo
@@ -45,4 +45,11 @@ void setThreadName(StringData name);
  */
 StringData getThreadName();
 
+/**
+ * Copies the name of the current thread, as previously set, into 'buffer' as a c-string truncated
+ * to fit in 'size' bytes, and returns its length. Unlike getThreadName(), this never names a thread
+ * which has no name yet, for which it copies an empty string, so it is async-signal-safe.
+ */
+size_t copyThreadNameAsyncSignalSafe(char* buffer, size_t size);
+
 }  // namespace mongo
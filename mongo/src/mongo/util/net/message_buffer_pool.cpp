@@ -0,0 +1,169 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/net/message_buffer_pool.h"
+
+#include <array>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/platform/bits.h"
+
+namespace mongo {
+
+namespace {
+
+const size_t kNumSizeClasses = 11;  // 1KB, 2KB, ..., 1MB
+
+// Bytes held in the caches of all threads, bounded by kMaxCachedBytes.
+AtomicWord<long long> totalCachedBytes{0};
+
+class ThreadBufferCache {
+    MONGO_DISALLOW_COPYING(ThreadBufferCache);
+
+public:
+    ThreadBufferCache() = default;
+    ~ThreadBufferCache();
+
+    SharedBuffer take(size_t capacity);
+    void release(SharedBuffer buffer);
+
+private:
+    /**
+     * Returns the index of the free list for buffers of 'capacity' bytes, or -1 if buffers of this
+     * size are not cached.
+     */
+    static int sizeClass(size_t capacity) {
+        if (capacity < MessageBufferPool::kMinBufferSize ||
+            capacity > MessageBufferPool::kMaxBufferSize || (capacity & (capacity - 1))) {
+            return -1;
+        }
+        return countTrailingZeros64(capacity) -
+            countTrailingZeros64(MessageBufferPool::kMinBufferSize);
+    }
+
+    std::array<std::vector<SharedBuffer>, kNumSizeClasses> _freeBuffers;
+    size_t _cachedBytes = 0;
+};
+
+thread_local ThreadBufferCache bufferCache;
+thread_local MessageBufferPool::Stats bufferStats;
+
+// Messages destroyed during thread exit may outlive the cache, so it must not be touched then.
+thread_local bool bufferCacheDestroyed = false;
+
+ThreadBufferCache::~ThreadBufferCache() {
+    bufferCacheDestroyed = true;
+    totalCachedBytes.subtractAndFetch(_cachedBytes);
+}
+
+SharedBuffer ThreadBufferCache::take(size_t capacity) {
+    const int index = sizeClass(capacity);
+    if (index >= 0 && !_freeBuffers[index].empty()) {
+        SharedBuffer buffer = std::move(_freeBuffers[index].back());
+        _freeBuffers[index].pop_back();
+        _cachedBytes -= capacity;
+        totalCachedBytes.subtractAndFetch(capacity);
+        bufferStats.reused++;
+        return buffer;
+    }
+    return SharedBuffer::allocate(capacity);
+}
+
+void ThreadBufferCache::release(SharedBuffer buffer) {
+    const size_t capacity = buffer.capacity();
+    const int index = sizeClass(capacity);
+    if (index < 0 || buffer.isShared() ||
+        _cachedBytes + capacity > MessageBufferPool::kMaxCachedBytesPerThread) {
+        return;
+    }
+    if (totalCachedBytes.addAndFetch(capacity) >
+        static_cast<long long>(MessageBufferPool::kMaxCachedBytes)) {
+        totalCachedBytes.subtractAndFetch(capacity);
+        return;
+    }
+    _freeBuffers[index].push_back(std::move(buffer));
+    _cachedBytes += capacity;
+}
+
+/**
+ * Rounds 'bytes' up to the capacity of the size class that holds it. Requests larger than the
+ * biggest size class are returned unchanged, as those buffers are never cached.
+ */
+size_t roundUpToSizeClass(size_t bytes) {
+    if (bytes > MessageBufferPool::kMaxBufferSize) {
+        return bytes;
+    }
+    size_t capacity = MessageBufferPool::kMinBufferSize;
+    while (capacity < bytes) {
+        capacity *= 2;
+    }
+    return capacity;
+}
+
+}  // namespace
+
+const size_t MessageBufferPool::kMinBufferSize;
+const size_t MessageBufferPool::kMaxBufferSize;
+const size_t MessageBufferPool::kMaxCachedBytesPerThread;
+const size_t MessageBufferPool::kMaxCachedBytes;
+
+SharedBuffer MessageBufferPool::take(size_t minCapacity) {
+    const size_t capacity = roundUpToSizeClass(minCapacity);
+    bufferStats.allocations++;
+    return bufferCacheDestroyed ? SharedBuffer::allocate(capacity) : bufferCache.take(capacity);
+}
+
+void MessageBufferPool::release(SharedBuffer buffer) {
+    if (!buffer || bufferCacheDestroyed) {
+        return;
+    }
+    bufferCache.release(std::move(buffer));
+}
+
+MessageBufferPool::Stats MessageBufferPool::getThreadStats() {
+    return bufferStats;
+}
+
+long long MessageBufferPool::getCachedBytes() {
+    return totalCachedBytes.load();
+}
+
+void MessageBufferPool::appendStats(BSONObjBuilder* builder) {
+    BSONObjBuilder poolBuilder(builder->subobjStart("replyBufferPool"));
+    poolBuilder.append("cachedBytes", getCachedBytes());
+    poolBuilder.append("maxCachedBytes", static_cast<long long>(kMaxCachedBytes));
+    poolBuilder.append("maxCachedBytesPerThread", static_cast<long long>(kMaxCachedBytesPerThread));
+}
+
+}  // namespace mongo
@@ -0,0 +1,97 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+
+#pragma once
+
+#include <cstddef>
+
+#include "mongo/util/shared_buffer.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+
+/**
+ * A per-thread cache of the buffers replies are built in.
+ *
+ * Every reply is built into a freshly allocated buffer which is handed to the transport layer and
+ * freed once it has been sent, so a thread serving a connection goes back to the allocator for
+ * each reply it builds, usually for a buffer of the same size as the last one. Buffers released
+ * through this class are kept in power-of-two size classes and handed out again by take() on the
+ * same thread.
+ *
+ * Only buffers nothing else refers to are cached. Each thread holds at most
+ * kMaxCachedBytesPerThread bytes and all threads together at most kMaxCachedBytes, so that the
+ * thread-per-connection model cannot pin megabytes per connection. Buffers larger than
+ * kMaxBufferSize are never cached, so the occasional 16MB batch does not stay pinned to a thread.
+ */
+class MessageBufferPool {
+public:
+    static const size_t kMinBufferSize = 1024;
+    static const size_t kMaxBufferSize = 1024 * 1024;
+    static const size_t kMaxCachedBytesPerThread = 1024 * 1024;
+    static const size_t kMaxCachedBytes = 64 * 1024 * 1024;
+
+    struct Stats {
+        // Number of buffers handed out by take().
+        long long allocations = 0;
+        // Number of those which were reused rather than allocated.
+        long long reused = 0;
+    };
+
+    /**
+     * Returns an unshared buffer with a capacity of at least 'minCapacity' bytes, reusing one
+     * released earlier on this thread if there is one of the right size.
+     */
+    static SharedBuffer take(size_t minCapacity);
+
+    /**
+     * Offers 'buffer' for reuse by this thread. It is simply freed if it is still referenced
+     * elsewhere, if its capacity is not one of the cached size classes, or if this thread's cache
+     * or the process-wide limit is full.
+     */
+    static void release(SharedBuffer buffer);
+
+    /**
+     * Returns the number of bytes held in the caches of all threads.
+     */
+    static long long getCachedBytes();
+
+    /**
+     * Appends the process-wide cache usage and limit, for serverStatus.
+     */
+    static void appendStats(BSONObjBuilder* builder);
+
+    /**
+     * Returns the counters for the calling thread.
+     */
+    static Stats getThreadStats();
+};
+
+}  // namespace mongo
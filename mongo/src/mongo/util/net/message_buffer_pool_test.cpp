@@ -0,0 +1,201 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kDefault
+
+#include "mongo/platform/basic.h"
+
+#include <vector>
+
+#include "mongo/db/jsobj.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/log.h"
+#include "mongo/util/net/message_buffer_pool.h"
+#include "mongo/util/net/op_msg.h"
+#include "mongo/util/timer.h"
+
+namespace mongo {
+namespace {
+
+TEST(MessageBufferPool, TakeRoundsUpToSizeClass) {
+    ASSERT_EQ(MessageBufferPool::take(1).capacity(), MessageBufferPool::kMinBufferSize);
+    ASSERT_EQ(MessageBufferPool::take(1025).capacity(), 2048U);
+    ASSERT_EQ(MessageBufferPool::take(MessageBufferPool::kMaxBufferSize).capacity(),
+              MessageBufferPool::kMaxBufferSize);
+    ASSERT_EQ(MessageBufferPool::take(MessageBufferPool::kMaxBufferSize + 1).capacity(),
+              MessageBufferPool::kMaxBufferSize + 1);
+}
+
+TEST(MessageBufferPool, ReleasedBufferIsReused) {
+    SharedBuffer buf = MessageBufferPool::take(4096);
+    const char* data = buf.get();
+    MessageBufferPool::release(std::move(buf));
+
+    const auto before = MessageBufferPool::getThreadStats();
+    SharedBuffer reused = MessageBufferPool::take(3000);
+    const auto after = MessageBufferPool::getThreadStats();
+
+    ASSERT_EQ(reused.get(), data);
+    ASSERT_EQ(after.allocations - before.allocations, 1);
+    ASSERT_EQ(after.reused - before.reused, 1);
+}
+
+TEST(MessageBufferPool, SharedBufferIsNotCached) {
+    SharedBuffer buf = MessageBufferPool::take(8192);
+    SharedBuffer otherRef = buf;
+    MessageBufferPool::release(std::move(buf));
+
+    const auto before = MessageBufferPool::getThreadStats();
+    SharedBuffer next = MessageBufferPool::take(8192);
+    ASSERT_NE(next.get(), otherRef.get());
+    ASSERT_EQ(MessageBufferPool::getThreadStats().reused, before.reused);
+}
+
+TEST(MessageBufferPool, LargeBufferIsNotCached) {
+    MessageBufferPool::release(MessageBufferPool::take(2 * MessageBufferPool::kMaxBufferSize));
+
+    const auto before = MessageBufferPool::getThreadStats();
+    MessageBufferPool::take(2 * MessageBufferPool::kMaxBufferSize);
+    ASSERT_EQ(MessageBufferPool::getThreadStats().reused, before.reused);
+}
+
+TEST(MessageBufferPool, CachedBytesAreBoundedPerThread) {
+    const size_t size = MessageBufferPool::kMaxBufferSize;
+    const size_t maxCached = MessageBufferPool::kMaxCachedBytesPerThread / size;
+
+    std::vector<SharedBuffer> buffers;
+    for (size_t i = 0; i < maxCached + 1; i++) {
+        buffers.push_back(MessageBufferPool::take(size));
+    }
+    for (auto&& buf : buffers) {
+        MessageBufferPool::release(std::move(buf));
+    }
+    buffers.clear();
+
+    const auto before = MessageBufferPool::getThreadStats();
+    for (size_t i = 0; i < maxCached + 1; i++) {
+        buffers.push_back(MessageBufferPool::take(size));
+    }
+    ASSERT_EQ(MessageBufferPool::getThreadStats().reused - before.reused,
+              static_cast<long long>(maxCached));
+}
+
+TEST(MessageBufferPool, CachedBytesAreCountedProcessWide) {
+    const long long before = MessageBufferPool::getCachedBytes();
+    MessageBufferPool::release(MessageBufferPool::take(2048));
+    ASSERT_EQ(MessageBufferPool::getCachedBytes() - before, 2048);
+
+    SharedBuffer buf = MessageBufferPool::take(2048);
+    ASSERT_EQ(MessageBufferPool::getCachedBytes(), before);
+}
+
+/**
+ * Builds a reply the way a find or getMore does: reserve the expected size up front, then fill in
+ * a batch of 'numDocs' copies of 'doc'.
+ */
+Message buildReply(int reserveBytes, const BSONObj& doc, int numDocs) {
+    OpMsgBuilder builder;
+    builder.reserveBytes(reserveBytes + BSONObj::kMinBSONLength);
+    {
+        BSONObjBuilder body = builder.beginBody();
+        BSONObjBuilder cursor(body.subobjStart("cursor"));
+        BSONArrayBuilder batch(cursor.subarrayStart("nextBatch"));
+        for (int i = 0; i < numDocs; i++) {
+            batch.append(doc);
+        }
+        batch.doneFast();
+        cursor.append("id", 1LL);
+        cursor.append("ns", "test.coll");
+        cursor.doneFast();
+        body.append("ok", 1.0);
+    }
+    return builder.finish();
+}
+
+void releaseReply(Message reply) {
+    SharedBuffer buf = reply.sharedBuffer();
+    reply.reset();
+    MessageBufferPool::release(std::move(buf));
+}
+
+TEST(MessageBufferPool, ReplyBufferIsReusedForNextReply) {
+    const BSONObj doc = BSON("_id" << 1 << "x"
+                                   << "some string");
+    releaseReply(buildReply(32 * 1024, doc, 10));
+
+    const auto before = MessageBufferPool::getThreadStats();
+    Message reply = buildReply(32 * 1024, doc, 10);
+    const auto after = MessageBufferPool::getThreadStats();
+
+    // Both the initial buffer and the reserved one come from the cache.
+    ASSERT_EQ(after.allocations - before.allocations, 2);
+    ASSERT_EQ(after.reused - before.reused, 2);
+    ASSERT_BSONOBJ_EQ(OpMsg::parse(reply).body["cursor"]["nextBatch"]["9"].Obj(), doc);
+}
+
+/**
+ * Repeatedly builds replies of 'numDocs' documents reserving 'reserveBytes' each, and logs the
+ * time and number of buffer allocations per reply, both when reply buffers are returned to the pool
+ * after being sent, as ServiceStateMachine does, and when they are not.
+ */
+void replyBufferPerf(StringData name, int reserveBytes, int numDocs) {
+    const int iters = 2000;
+    const BSONObj doc = BSON("_id" << 1 << "a" << 2.5 << "s"
+                                   << "a string of about thirty bytes");
+
+    for (bool recycle : {false, true}) {
+        const auto before = MessageBufferPool::getThreadStats();
+        Timer t;
+        for (int i = 0; i < iters; i++) {
+            Message reply = buildReply(reserveBytes, doc, numDocs);
+            if (recycle) {
+                releaseReply(std::move(reply));
+            }
+        }
+        const auto micros = t.micros();
+        const auto after = MessageBufferPool::getThreadStats();
+        const double allocatorCalls = (after.allocations - before.allocations) -
+            (recycle ? after.reused - before.reused : 0);
+
+        log() << name << (recycle ? " with" : " without") << " buffer reuse: "
+              << allocatorCalls / iters << " buffer allocations and "
+              << static_cast<double>(micros) / iters << " us per reply";
+    }
+}
+
+TEST(MessageBufferPool, FindReplyPerf) {
+    replyBufferPerf("find", 32 * 1024, 101);
+}
+
+TEST(MessageBufferPool, SmallGetMoreReplyPerf) {
+    replyBufferPerf("getMore", 4 * 1024, 20);
+}
+
+}  // namespace
+}  // namespace mongo
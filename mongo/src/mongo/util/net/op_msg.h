@@ -35,6 +35,7 @@
 #include "mongo/base/string_data.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/util/net/message.h"
+#include "mongo/util/net/message_buffer_pool.h"
 
 namespace mongo {
 
@@ -175,7 +176,26 @@ class OpMsgBuilder {
     MONGO_DISALLOW_COPYING(OpMsgBuilder);
 
 public:
-    OpMsgBuilder() {
+    OpMsgBuilder() : _buf(0) {
+        _buf.useSharedBuffer(MessageBufferPool::take(MessageBufferPool::kMinBufferSize));
+        skipHeaderAndFlags();
+    }
+
+    /**
+     * Ensures the message can grow by 'bytes' without reallocating, taking a large enough buffer
+     * from the MessageBufferPool if needed. It is an error to call this once anything has been
+     * appended.
+     */
+    void reserveBytes(int bytes) {
+        invariant(_state == kEmpty && !_openBuilder);
+        const int minSize = _buf.len() + bytes;
+        if (minSize <= _buf.getSize())
+            return;
+
+        _buf.reset();
+        SharedBuffer oldBuf = _buf.release();
+        _buf.useSharedBuffer(MessageBufferPool::take(minSize));
+        MessageBufferPool::release(std::move(oldBuf));
         skipHeaderAndFlags();
     }
 
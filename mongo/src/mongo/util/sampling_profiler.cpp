@@ -0,0 +1,532 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kControl
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/sampling_profiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+#include "mongo/config.h"
+#include "mongo/platform/compiler.h"
+#include "mongo/platform/stack_locator.h"
+#include "mongo/util/concurrency/thread_name.h"
+#include "mongo/util/errno_util.h"
+#include "mongo/util/hex.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/time_support.h"
+
+// The signal handler walks the frame pointers, which every build keeps, from the registers of the
+// interrupted thread, so the profiler is limited to the platforms whose frame records it knows.
+#if defined(__linux__) && (defined(__x86_64__) || defined(__aarch64__))
+#define MONGO_HAVE_SAMPLING_PROFILER
+#include <csignal>
+#include <cstdint>
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <sys/time.h>
+#include <ucontext.h>
+#endif
+
+namespace mongo {
+
+namespace {
+
+constexpr size_t kThreadNameTagSize = 64;
+constexpr size_t kOpTypeTagSize = 32;
+constexpr size_t kNamespaceTagSize = 128;
+
+// Number of slots of the ring the signal handler writes its samples to. The ring is drained every
+// kDrainInterval, so it absorbs about 10000 samples per second, i.e. 100 busy CPUs at 100Hz.
+constexpr unsigned kSlotCount = 1024;
+const Milliseconds kDrainInterval{100};
+
+struct OperationTags {
+    // Set while the owning thread rewrites the tags, which the signal handler then ignores. Only
+    // the owning thread, or a signal handler interrupting it, ever touches its tags.
+    volatile sig_atomic_t updating;
+    char opType[kOpTypeTagSize];
+    char ns[kNamespaceTagSize];
+};
+
+// Zero initialized without a constructor, and in the initial-exec TLS model so that the signal
+// handler reaches it without calling into the dynamic linker.
+MONGO_COMPILER_TLS_INITIAL_EXEC thread_local OperationTags operationTags;
+
+struct StackBounds {
+    // Both are 0 until the thread registers. 'high' is written last, so that the signal handler
+    // never sees it without 'low'.
+    volatile uintptr_t low;
+    volatile uintptr_t high;
+};
+
+// The bounds of the current thread's stack, within which the signal handler may read frame records.
+MONGO_COMPILER_TLS_INITIAL_EXEC thread_local StackBounds stackBounds;
+
+void copyTag(StringData tag, char* dest, size_t size) {
+    const size_t length = std::min(tag.size(), size - 1);
+    std::memcpy(dest, tag.rawData(), length);
+    dest[length] = '\0';
+}
+
+#if defined(MONGO_HAVE_SAMPLING_PROFILER)
+
+enum SlotState : int { kEmpty, kWriting, kFull };
+
+struct Slot {
+    AtomicWord<int> state{kEmpty};
+    int frameCount;
+    void* frames[SamplingProfiler::kMaxFrames];
+    char threadName[kThreadNameTagSize];
+    char opType[kOpTypeTagSize];
+    char ns[kNamespaceTagSize];
+};
+
+// Allocated when the profiler first starts and never freed, since a signal may still be delivered
+// after the profiler stops.
+Slot* slots = nullptr;
+
+AtomicWord<unsigned> nextSlot;
+AtomicWord<bool> samplingEnabled;
+AtomicInt64 droppedSampleCount;
+
+struct Registers {
+    uintptr_t pc;
+    uintptr_t fp;
+    uintptr_t sp;
+};
+
+Registers interruptedRegisters(const ucontext_t* context) {
+#if defined(__x86_64__)
+    return {static_cast<uintptr_t>(context->uc_mcontext.gregs[REG_RIP]),
+            static_cast<uintptr_t>(context->uc_mcontext.gregs[REG_RBP]),
+            static_cast<uintptr_t>(context->uc_mcontext.gregs[REG_RSP])};
+#else
+    return {static_cast<uintptr_t>(context->uc_mcontext.pc),
+            static_cast<uintptr_t>(context->uc_mcontext.regs[29]),
+            static_cast<uintptr_t>(context->uc_mcontext.sp)};
+#endif
+}
+
+/**
+ * Captures the interrupted thread's stack into 'frames', innermost first, and returns the number of
+ * frames captured. Only plain loads are used, so this is async-signal-safe, unlike backtrace().
+ *
+ * Each frame record holds the caller's frame pointer followed by the return address. A record is
+ * only followed while it lies between the interrupted stack pointer and the top of the thread's
+ * stack, which is all mapped, and while the records move strictly outwards, so that code which uses
+ * the frame pointer register for something else ends the walk instead of faulting or looping. A
+ * thread whose stack bounds aren't registered only reports the interrupted instruction. When the
+ * thread is interrupted in a function's prologue, before it sets up its frame, its caller is missed.
+ */
+int captureFrames(const ucontext_t* context, void** frames) {
+    const Registers registers = interruptedRegisters(context);
+    int count = 0;
+    frames[count++] = reinterpret_cast<void*>(registers.pc);
+
+    const uintptr_t low = stackBounds.low;
+    const uintptr_t high = stackBounds.high;
+    if (!high || registers.sp < low || registers.sp >= high) {
+        return count;
+    }
+
+    constexpr uintptr_t kRecordSize = 2 * sizeof(uintptr_t);
+    uintptr_t lowest = registers.sp;
+    uintptr_t fp = registers.fp;
+    while (count < SamplingProfiler::kMaxFrames && fp % sizeof(uintptr_t) == 0 && fp >= lowest &&
+           fp <= high - kRecordSize) {
+        const uintptr_t* record = reinterpret_cast<const uintptr_t*>(fp);
+        const uintptr_t returnAddress = record[1];
+        if (!returnAddress) {
+            break;
+        }
+        frames[count++] = reinterpret_cast<void*>(returnAddress);
+        lowest = fp + kRecordSize;
+        fp = record[0];
+    }
+    return count;
+}
+
+void handleProfilingSignal(int, siginfo_t*, void* context) {
+    if (!samplingEnabled.load()) {
+        return;
+    }
+
+    const int savedErrno = errno;
+
+    Slot& slot = slots[nextSlot.fetchAndAdd(1) % kSlotCount];
+    if (slot.state.compareAndSwap(kEmpty, kWriting) != kEmpty) {
+        droppedSampleCount.addAndFetch(1);
+        errno = savedErrno;
+        return;
+    }
+
+    slot.frameCount = captureFrames(static_cast<const ucontext_t*>(context), slot.frames);
+
+    copyThreadNameAsyncSignalSafe(slot.threadName, sizeof(slot.threadName));
+    if (operationTags.updating) {
+        slot.opType[0] = '\0';
+        slot.ns[0] = '\0';
+    } else {
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+        std::memcpy(slot.opType, operationTags.opType, sizeof(slot.opType));
+        std::memcpy(slot.ns, operationTags.ns, sizeof(slot.ns));
+    }
+
+    slot.state.store(kFull);
+    errno = savedErrno;
+}
+
+Status setProfilingTimer(int frequencyHz) {
+    struct itimerval timer;
+    timer.it_interval.tv_sec = 0;
+    timer.it_interval.tv_usec = frequencyHz ? 1000 * 1000 / frequencyHz : 0;
+    timer.it_value = timer.it_interval;
+    if (setitimer(ITIMER_PROF, &timer, nullptr) != 0) {
+        return Status(ErrorCodes::InternalError,
+                      str::stream() << "Failed to set the profiling timer: "
+                                    << errnoWithDescription());
+    }
+    return Status::OK();
+}
+
+Status installProfilingSignalHandler() {
+    if (slots) {
+        return Status::OK();
+    }
+
+    slots = new Slot[kSlotCount];
+
+    struct sigaction action;
+    std::memset(&action, 0, sizeof(action));
+    action.sa_sigaction = &handleProfilingSignal;
+    action.sa_flags = SA_RESTART | SA_SIGINFO;
+    sigemptyset(&action.sa_mask);
+    if (sigaction(SIGPROF, &action, nullptr) != 0) {
+        return Status(ErrorCodes::InternalError,
+                      str::stream() << "Failed to install the profiling signal handler: "
+                                    << errnoWithDescription());
+    }
+    return Status::OK();
+}
+
+StringData withoutTrailingDigits(StringData name) {
+    size_t length = name.size();
+    while (length > 0 && std::isdigit(static_cast<unsigned char>(name[length - 1]))) {
+        --length;
+    }
+    return length ? name.substr(0, length) : name;
+}
+
+/**
+ * Returns the name of the function containing 'address', without its parameters.
+ */
+std::string symbolize(void* address) {
+    Dl_info dli;
+    if (!dladdr(address, &dli)) {
+        return str::stream() << address;
+    }
+
+    if (!dli.dli_sname) {
+        StringData file(dli.dli_fname ? dli.dli_fname : "");
+        file = file.substr(file.rfind('/') + 1);
+        return str::stream() << file << "+0x"
+                             << integerToHex(static_cast<unsigned long long>(
+                                    static_cast<char*>(address) -
+                                    static_cast<char*>(dli.dli_fbase)));
+    }
+
+    int status;
+    char* demangled = abi::__cxa_demangle(dli.dli_sname, 0, 0, &status);
+    if (!demangled) {
+        return dli.dli_sname;
+    }
+    std::string name = demangled;
+    free(demangled);
+
+    // Strip off the parameters, which are verbose and would split the flamegraph by overload.
+    const auto parameters = name.find('(');
+    if (parameters != std::string::npos && parameters > 0) {
+        name.resize(parameters);
+    }
+    return name;
+}
+
+#endif  // MONGO_HAVE_SAMPLING_PROFILER
+
+/**
+ * Appends 'frame' to the collapsed stack 'line', replacing the characters which delimit frames.
+ */
+void appendFrame(StringData frame, std::string* line) {
+    if (!line->empty()) {
+        line->push_back(';');
+    }
+    if (frame.empty()) {
+        line->push_back('-');
+        return;
+    }
+    for (char c : frame) {
+        line->push_back(c == ';' || c == '\n' ? ':' : c);
+    }
+}
+
+}  // namespace
+
+SamplingProfiler& SamplingProfiler::get() {
+    // Never destroyed, so that the drain thread needn't be joined at exit.
+    static SamplingProfiler* profiler = new SamplingProfiler();
+    return *profiler;
+}
+
+void SamplingProfiler::registerCurrentThread() {
+#if defined(MONGO_HAVE_SAMPLING_PROFILER)
+    if (stackBounds.high) {
+        return;
+    }
+    const StackLocator locator;
+    if (!locator.begin() || !locator.end()) {
+        return;
+    }
+    // The stack grows down, so it begins at its highest address.
+    stackBounds.low = reinterpret_cast<uintptr_t>(locator.end());
+    stackBounds.high = reinterpret_cast<uintptr_t>(locator.begin());
+#endif
+}
+
+void SamplingProfiler::setOperationTags(StringData opType, StringData ns) {
+    registerCurrentThread();
+    operationTags.updating = 1;
+    // The tags are plain memory, so keep the compiler from moving their stores outside of the
+    // window in which the signal handler ignores them.
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+    copyTag(opType, operationTags.opType, sizeof(operationTags.opType));
+    copyTag(ns, operationTags.ns, sizeof(operationTags.ns));
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+    operationTags.updating = 0;
+}
+
+void SamplingProfiler::clearOperationTags() {
+    setOperationTags(StringData(), StringData());
+}
+
+Status SamplingProfiler::setFrequency(int frequencyHz) {
+    if (frequencyHz < 0 || frequencyHz > 1000) {
+        return Status(ErrorCodes::BadValue,
+                      "The sampling frequency must be between 0 and 1000 samples per second");
+    }
+
+#if defined(MONGO_HAVE_SAMPLING_PROFILER)
+    stdx::lock_guard<stdx::mutex> setFrequencyLk(_setFrequencyMutex);
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    if (frequencyHz == _frequencyHz) {
+        return Status::OK();
+    }
+
+    if (frequencyHz == 0) {
+        samplingEnabled.store(false);
+        auto status = setProfilingTimer(0);
+        _frequencyHz = 0;
+        _stopped.notify_all();
+        lk.unlock();
+        _drainer.join();
+        log() << "Stopped the sampling CPU profiler";
+        return status;
+    }
+
+    auto status = installProfilingSignalHandler();
+    if (!status.isOK()) {
+        return status;
+    }
+
+    const bool wasRunning = _frequencyHz;
+    samplingEnabled.store(true);
+    status = setProfilingTimer(frequencyHz);
+    if (!status.isOK()) {
+        samplingEnabled.store(wasRunning);
+        return status;
+    }
+    _frequencyHz = frequencyHz;
+
+    if (!wasRunning) {
+        _drainer = stdx::thread([this] { _drainThread(); });
+    }
+    log() << "Sampling CPU profiler running at " << frequencyHz << " samples per second";
+    return Status::OK();
+#else
+    if (frequencyHz == 0) {
+        return Status::OK();
+    }
+    return Status(ErrorCodes::IllegalOperation,
+                  "The sampling CPU profiler is not supported on this platform");
+#endif
+}
+
+int SamplingProfiler::getFrequency() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _frequencyHz;
+}
+
+void SamplingProfiler::_drainThread() {
+    setThreadName("SamplingProfiler");
+
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    while (_frequencyHz) {
+        _stopped.wait_for(lk, kDrainInterval.toSystemDuration());
+        _drain();
+    }
+}
+
+void SamplingProfiler::_drain() {
+#if defined(MONGO_HAVE_SAMPLING_PROFILER)
+    std::string key;
+    for (unsigned i = 0; i < kSlotCount; ++i) {
+        Slot& slot = slots[i];
+        if (slot.state.load() != kFull) {
+            continue;
+        }
+
+        key.clear();
+        key.append(withoutTrailingDigits(slot.threadName).toString());
+        key.push_back('\0');
+        key.append(slot.opType);
+        key.push_back('\0');
+        key.append(slot.ns);
+        key.push_back('\0');
+        key.append(reinterpret_cast<const char*>(slot.frames), slot.frameCount * sizeof(void*));
+        slot.state.store(kEmpty);
+
+        auto it = _stacks.find(key);
+        if (it != _stacks.end()) {
+            ++it->second;
+        } else if (_stacks.size() < kMaxDistinctStacks) {
+            _stacks.emplace(key, 1);
+        } else {
+            droppedSampleCount.addAndFetch(1);
+            continue;
+        }
+        _sampleCount.addAndFetch(1);
+    }
+#endif
+}
+
+std::vector<std::string> SamplingProfiler::getCollapsedStacks(bool reset,
+                                                              long long* sampleCount,
+                                                              long long* droppedCount) {
+    std::vector<std::pair<std::string, long long>> stacks;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _drain();
+        stacks.assign(_stacks.begin(), _stacks.end());
+        const long long samples = _sampleCount.load();
+        const long long dropped = getDroppedSampleCount();
+        if (sampleCount) {
+            *sampleCount = samples;
+        }
+        if (droppedCount) {
+            *droppedCount = dropped;
+        }
+        if (reset) {
+            _stacks.clear();
+            _sampleCount.store(0);
+#if defined(MONGO_HAVE_SAMPLING_PROFILER)
+            // The signal handler may drop samples concurrently, so subtract rather than store 0.
+            droppedSampleCount.subtractAndFetch(dropped);
+#endif
+        }
+    }
+
+    std::sort(stacks.begin(),
+              stacks.end(),
+              [](const std::pair<std::string, long long>& lhs,
+                 const std::pair<std::string, long long>& rhs) { return lhs.second > rhs.second; });
+
+    std::vector<std::string> collapsed;
+    collapsed.reserve(stacks.size());
+
+#if defined(MONGO_HAVE_SAMPLING_PROFILER)
+    stdx::unordered_map<void*, std::string> symbols;
+    for (auto&& stack : stacks) {
+        const std::string& key = stack.first;
+        std::string line;
+
+        // The key holds the thread name, operation type and namespace tags, each null terminated,
+        // followed by the frames from the innermost out.
+        size_t pos = 0;
+        for (int tag = 0; tag < 3; ++tag) {
+            const size_t end = key.find('\0', pos);
+            appendFrame(StringData(key.data() + pos, end - pos), &line);
+            pos = end + 1;
+        }
+
+        for (size_t i = (key.size() - pos) / sizeof(void*); i-- > 0;) {
+            void* address;
+            std::memcpy(&address, key.data() + pos + i * sizeof(void*), sizeof(address));
+
+            // Except for the innermost frame, which is where the thread was interrupted, frames
+            // hold return addresses, which may belong to the next function when the call is the
+            // last instruction of its caller.
+            if (i) {
+                address = static_cast<char*>(address) - 1;
+            }
+            auto symbol = symbols.find(address);
+            if (symbol == symbols.end()) {
+                symbol = symbols.emplace(address, symbolize(address)).first;
+            }
+            appendFrame(symbol->second, &line);
+        }
+
+        line.push_back(' ');
+        line.append(std::to_string(stack.second));
+        collapsed.push_back(std::move(line));
+    }
+#endif
+
+    return collapsed;
+}
+
+long long SamplingProfiler::getSampleCount() const {
+    return _sampleCount.load();
+}
+
+long long SamplingProfiler::getDroppedSampleCount() const {
+#if defined(MONGO_HAVE_SAMPLING_PROFILER)
+    return droppedSampleCount.load();
+#else
+    return 0;
+#endif
+}
+
+}  // namespace mongo
@@ -0,0 +1,157 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/status.h"
+#include "mongo/base/string_data.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/stdx/unordered_map.h"
+
+namespace mongo {
+
+/**
+ * A process-wide sampling CPU profiler which can be left running in production.
+ *
+ * While it runs, a SIGPROF timer interrupts the threads which consume CPU time 'frequencyHz' times
+ * per second of CPU time. The signal handler captures the interrupted thread's stack by walking its
+ * frame pointers, and its tags, which are the thread's name and the type and namespace of the
+ * operation it is running, into a fixed ring of slots. It only reads registered stack memory and
+ * initial-exec thread locals, so it neither allocates nor locks. Threads register their stack bounds
+ * when they are named or tag an operation; samples of unregistered threads hold only the
+ * interrupted frame. A background thread drains the ring every 100ms into a table counting the
+ * samples of each distinct tagged stack. Thread names are counted without their trailing digits,
+ * so that e.g. all connection threads share the "conn" tag.
+ *
+ * The counts are reported as collapsed stacks, one line per distinct stack in the form
+ * "thread;opType;ns;outermostFrame;...;innermostFrame count", which flamegraph tools consume
+ * directly. Frames are symbolized only when the stacks are reported.
+ */
+class SamplingProfiler {
+    MONGO_DISALLOW_COPYING(SamplingProfiler);
+
+public:
+    /**
+     * Maximum number of frames captured for each sample; deeper stacks lose their outermost
+     * frames.
+     */
+    static constexpr int kMaxFrames = 64;
+
+    /**
+     * Maximum number of distinct tagged stacks counted; samples of further stacks are dropped.
+     */
+    static constexpr size_t kMaxDistinctStacks = 100 * 1000;
+
+    /**
+     * Returns the process-wide profiler.
+     */
+    static SamplingProfiler& get();
+
+    /**
+     * Records the bounds of the current thread's stack, within which the signal handler may walk
+     * its frames. Only the first call on each thread does any work.
+     */
+    static void registerCurrentThread();
+
+    /**
+     * Tags the samples taken on the current thread with the type and namespace of the operation it
+     * runs, until they are replaced or cleared. The tags are truncated to a fixed size.
+     */
+    static void setOperationTags(StringData opType, StringData ns);
+
+    /**
+     * Clears the operation tags of the current thread.
+     */
+    static void clearOperationTags();
+
+    /**
+     * Starts sampling at 'frequencyHz' samples per second of CPU time, or changes the frequency if
+     * the profiler is already running. A frequency of 0 stops it. Fails on platforms whose frame
+     * records the signal handler can't walk.
+     */
+    Status setFrequency(int frequencyHz);
+
+    /**
+     * Returns the sampling frequency, which is 0 when the profiler isn't running.
+     */
+    int getFrequency() const;
+
+    /**
+     * Returns the collapsed stacks counted so far, most samples first, and clears them if 'reset'
+     * is true. If not null, 'sampleCount' and 'droppedSampleCount' are set to the counts which go
+     * with the returned stacks, and are reset along with them.
+     */
+    std::vector<std::string> getCollapsedStacks(bool reset,
+                                                long long* sampleCount = nullptr,
+                                                long long* droppedSampleCount = nullptr);
+
+    /**
+     * Returns the number of samples counted so far.
+     */
+    long long getSampleCount() const;
+
+    /**
+     * Returns the number of samples dropped because the ring or the table of stacks was full.
+     */
+    long long getDroppedSampleCount() const;
+
+private:
+    SamplingProfiler() = default;
+
+    void _drainThread();
+    void _drain();
+
+    // Serializes starting and stopping the profiler, which joins the drain thread without holding
+    // _mutex.
+    stdx::mutex _setFrequencyMutex;
+
+    mutable stdx::mutex _mutex;
+
+    // Signals the drain thread that the profiler stopped.
+    stdx::condition_variable _stopped;
+
+    stdx::thread _drainer;
+
+    // Guarded by _mutex.
+    int _frequencyHz = 0;
+
+    // Samples of each distinct tagged stack, keyed by the raw tags and frame addresses. Guarded by
+    // _mutex.
+    stdx::unordered_map<std::string, long long> _stacks;
+
+    AtomicInt64 _sampleCount;
+};
+
+}  // namespace mongo
@@ -0,0 +1,106 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/sampling_profiler.h"
+
+#include <algorithm>
+
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+namespace {
+
+TEST(SamplingProfilerTest, RejectsOutOfRangeFrequencies) {
+    auto& profiler = SamplingProfiler::get();
+    ASSERT_EQ(ErrorCodes::BadValue, profiler.setFrequency(-1));
+    ASSERT_EQ(ErrorCodes::BadValue, profiler.setFrequency(1001));
+    ASSERT_EQ(0, profiler.getFrequency());
+}
+
+TEST(SamplingProfilerTest, SamplesAreTaggedWithTheOperation) {
+    auto& profiler = SamplingProfiler::get();
+    auto status = profiler.setFrequency(1000);
+    if (status == ErrorCodes::IllegalOperation) {
+        return;
+    }
+    ASSERT_OK(status);
+    ASSERT_EQ(1000, profiler.getFrequency());
+
+    SamplingProfiler::setOperationTags("find", "test.coll");
+
+    // Burn CPU until the profiler has counted a sample of this thread, which the timer only
+    // interrupts while it consumes CPU time.
+    std::vector<std::string> stacks;
+    volatile unsigned long long sink = 0;
+    const Date_t deadline = Date_t::now() + Seconds(30);
+    while (Date_t::now() < deadline) {
+        for (int i = 0; i < 1000 * 1000; ++i) {
+            sink = sink + i;
+        }
+        stacks = profiler.getCollapsedStacks(false);
+        if (std::any_of(stacks.begin(), stacks.end(), [](const std::string& stack) {
+                return stack.find(";find;test.coll;") != std::string::npos;
+            })) {
+            break;
+        }
+    }
+    SamplingProfiler::clearOperationTags();
+    ASSERT_OK(profiler.setFrequency(0));
+    ASSERT_EQ(0, profiler.getFrequency());
+
+    ASSERT_GT(profiler.getSampleCount(), 0);
+    ASSERT_TRUE(std::any_of(stacks.begin(), stacks.end(), [](const std::string& stack) {
+        return stack.find(";find;test.coll;") != std::string::npos;
+    }));
+
+    // Each collapsed stack ends with its count.
+    for (auto&& stack : stacks) {
+        ASSERT_NE(std::string::npos, stack.rfind(' '));
+        ASSERT_GT(std::stoll(stack.substr(stack.rfind(' ') + 1)), 0);
+    }
+
+    // The sample count goes with the stacks, and is reset with them.
+    long long sampleCount;
+    stacks = profiler.getCollapsedStacks(true, &sampleCount);
+    ASSERT_FALSE(stacks.empty());
+    long long stackSamples = 0;
+    for (auto&& stack : stacks) {
+        stackSamples += std::stoll(stack.substr(stack.rfind(' ') + 1));
+    }
+    ASSERT_EQ(sampleCount, stackSamples);
+
+    ASSERT_TRUE(profiler.getCollapsedStacks(false, &sampleCount).empty());
+    ASSERT_EQ(0, sampleCount);
+    ASSERT_EQ(0, profiler.getSampleCount());
+}
+
+}  // namespace
+}  // namespace mongo
@@ -30,10 +30,13 @@
 #include "mongo/platform/basic.h"
 
 #include <cctype>
+#include <cstring>
+#include <ostream>
 
 #include "mongo/util/stringutils.h"
 
 #include "mongo/base/parse_number.h"
+#include "mongo/util/assert_util.h"
 #include "mongo/util/hex.h"
 
 namespace mongo {
@@ -186,45 +189,87 @@ int versionCmp(const StringData rhs, const StringData lhs) {
     return LexNumCmp::cmp(rhs, lhs, false);
 }
 
-std::string escape(StringData sd, bool escape_slash) {
-    StringBuilder ret;
-    ret.reset(sd.size());
-    for (const auto& c : sd) {
-        switch (c) {
-            case '"':
-                ret << "\\\"";
-                break;
-            case '\\':
-                ret << "\\\\";
-                break;
-            case '/':
-                ret << (escape_slash ? "\\/" : "/");
-                break;
-            case '\b':
-                ret << "\\b";
-                break;
-            case '\f':
-                ret << "\\f";
-                break;
-            case '\n':
-                ret << "\\n";
-                break;
-            case '\r':
-                ret << "\\r";
-                break;
-            case '\t':
-                ret << "\\t";
-                break;
-            default:
-                if (c >= 0 && c <= 0x1f) {
-                    // For c < 0x7f, ASCII value == Unicode code point.
-                    ret << "\\u00" << toHexLower(&c, 1);
-                } else {
-                    ret << c;
-                }
+namespace {
+
+/**
+ * The escape sequence escape() substitutes for each character, indexed by unsigned character
+ * value. Characters which are copied as is have an empty entry, so runs of them can be copied in
+ * one go. '/' is only escaped on request and so is handled by the caller.
+ */
+class EscapeTable {
+public:
+    EscapeTable() {
+        for (int c = 0; c <= 0x1f; c++) {
+            // For c < 0x7f, ASCII value == Unicode code point.
+            const char ch = c;
+            set(c, "\\u00" + toHexLower(&ch, 1));
+        }
+        set('"', "\\\"");
+        set('\\', "\\\\");
+        set('\b', "\\b");
+        set('\f', "\\f");
+        set('\n', "\\n");
+        set('\r', "\\r");
+        set('\t', "\\t");
+    }
+
+    StringData operator[](char c) const {
+        const unsigned char index = c;
+        return StringData(_sequences[index], _lengths[index]);
+    }
+
+private:
+    void set(unsigned char c, const std::string& sequence) {
+        invariant(sequence.size() < sizeof(_sequences[c]));
+        memcpy(_sequences[c], sequence.data(), sequence.size());
+        _lengths[c] = sequence.size();
+    }
+
+    char _sequences[256][8] = {};
+    unsigned char _lengths[256] = {};
+};
+
+const EscapeTable& escapeTable() {
+    // A function static rather than a global, since escape() may be used by other initializers.
+    static const EscapeTable table;
+    return table;
+}
+
+/**
+ * Calls 'append' with the pieces of the escaped form of 'sd': runs of characters which need no
+ * escaping are passed through as a single piece.
+ */
+template <typename Append>
+void escapeInPieces(StringData sd, bool escape_slash, Append&& append) {
+    const EscapeTable& table = escapeTable();
+    const char* runStart = sd.rawData();
+    const char* const end = runStart + sd.size();
+    for (const char* p = runStart; p != end; ++p) {
+        StringData sequence = table[*p];
+        if (sequence.empty()) {
+            if (*p != '/' || !escape_slash)
+                continue;
+            sequence = "\\/"_sd;
         }
+        append(runStart, p - runStart);
+        append(sequence.rawData(), sequence.size());
+        runStart = p + 1;
     }
-    return ret.str();
+    append(runStart, end - runStart);
+}
+
+}  // namespace
+
+std::string escape(StringData sd, bool escape_slash) {
+    std::string ret;
+    ret.reserve(sd.size());
+    escapeInPieces(sd, escape_slash, [&](const char* data, size_t len) { ret.append(data, len); });
+    return ret;
+}
+
+void writeEscaped(std::ostream& out, StringData sd, bool escape_slash) {
+    escapeInPieces(
+        sd, escape_slash, [&](const char* data, size_t len) { out.write(data, len); });
 }
 
 boost::optional<size_t> parseUnsignedBase10Integer(StringData fieldName) {
@@ -32,6 +32,7 @@
 #include <ctype.h>
 
 #include <boost/optional.hpp>
+#include <iosfwd>
 #include <memory>
 #include <string>
 #include <vector>
@@ -106,6 +107,12 @@ int versionCmp(const StringData rhs, const StringData lhs);
  */
 std::string escape(StringData s, bool escape_slash = false);
 
+/**
+ * Writes 's' to 'out' escaped the same way as by escape(), without building an intermediate
+ * string.
+ */
+void writeEscaped(std::ostream& out, StringData s, bool escape_slash = false);
+
 /**
  * Converts 'integer' from a base-10 string to a size_t value or returns boost::none if 'integer'
  * is not a valid base-10 string. A valid string is not allowed to have anything but decimal
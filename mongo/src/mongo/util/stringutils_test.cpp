@@ -27,6 +27,8 @@
  *    then also delete it in the license file.
  */
 
+#include <sstream>
+
 #include "mongo/unittest/unittest.h"
 
 #include "mongo/util/hex.h"
@@ -263,4 +265,24 @@ TEST(StringUtilsTest, WhitespaceWithinNumberFailsToParse) {
     boost::optional<size_t> result = parseUnsignedBase10Integer(" 10");
     ASSERT(!result);
 }
+
+TEST(StringUtilsTest, Escape) {
+    ASSERT_EQUALS("", escape(""));
+    ASSERT_EQUALS("plain text", escape("plain text"));
+    ASSERT_EQUALS("a\\\"b\\\\c", escape("a\"b\\c"));
+    ASSERT_EQUALS("\\b\\f\\n\\r\\t", escape("\b\f\n\r\t"));
+    ASSERT_EQUALS("\\u0000\\u001f", escape(StringData("\0\x1f", 2)));
+    ASSERT_EQUALS("a/b", escape("a/b"));
+    ASSERT_EQUALS("a\\/b", escape("a/b", true));
+    ASSERT_EQUALS("\xc3\xa9\x7f", escape("\xc3\xa9\x7f"));
+}
+
+TEST(StringUtilsTest, WriteEscapedMatchesEscape) {
+    const std::string input = "x\"y/z\n\x01\xff end";
+    for (bool escapeSlash : {false, true}) {
+        std::stringstream ss;
+        writeEscaped(ss, input, escapeSlash);
+        ASSERT_EQUALS(escape(input, escapeSlash), ss.str());
+    }
+}
 }  // namespace mongo
@@ -34,6 +34,7 @@
 
 #include <algorithm>
 #include <gperftools/malloc_extension.h>
+#include <gperftools/malloc_hook.h>
 #include <valgrind/valgrind.h>
 
 #include "mongo/base/disallow_copying.h"
@@ -42,6 +43,7 @@
 #include "mongo/base/status.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/server_parameters.h"
+#include "mongo/util/allocation_counter.h"
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/processinfo.h"
 
@@ -148,5 +150,26 @@ MONGO_INITIALIZER_GENERAL(TcmallocConfigurationDefaults,
     return tcmallocMaxTotalThreadCacheBytesParameter.setFromString(std::to_string(cacheSize));
 }
 
+// Whether to count the bytes allocated by each thread, from which the allocations of each
+// operation are reported.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(tcmallocEnableAllocationAccounting, bool, true);
+
+void countAllocation(const void* ptr, size_t size) {
+    AllocationCounter::onAllocation(size);
+}
+
+MONGO_INITIALIZER_GENERAL(TcmallocAllocationAccounting,
+                          ("EndStartupOptionHandling"),
+                          ("default"))
+(InitializerContext*) {
+    if (!tcmallocEnableAllocationAccounting || RUNNING_ON_VALGRIND) {
+        return Status::OK();
+    }
+
+    MallocHook::AddNewHook(&countAllocation);
+    AllocationCounter::activate();
+    return Status::OK();
+}
+
 }  // namespace
 }  // namespace mongo